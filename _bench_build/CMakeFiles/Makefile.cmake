@@ -0,0 +1,128 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/miniconda/share/cmake/nlohmann_json/nlohmann_jsonConfig.cmake"
+  "/root/miniconda/share/cmake/nlohmann_json/nlohmann_jsonConfigVersion.cmake"
+  "/root/miniconda/share/cmake/nlohmann_json/nlohmann_jsonTargets.cmake"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CTest.cmake"
+  "/usr/share/cmake-3.25/Modules/CTestTargets.cmake"
+  "/usr/share/cmake-3.25/Modules/CTestUseLaunchers.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCXXSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFileCXX.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/DartConfiguration.tcl.in"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPython/Support.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPython3.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "DartConfiguration.tcl"
+  "generated/chapterforge_version.hpp"
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "CMakeFiles/Experimental.dir/DependInfo.cmake"
+  "CMakeFiles/Nightly.dir/DependInfo.cmake"
+  "CMakeFiles/Continuous.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyMemoryCheck.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyStart.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyUpdate.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyConfigure.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyBuild.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyTest.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyCoverage.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyMemCheck.dir/DependInfo.cmake"
+  "CMakeFiles/NightlySubmit.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalStart.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalUpdate.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalConfigure.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalBuild.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalTest.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalCoverage.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalMemCheck.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalSubmit.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousStart.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousUpdate.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousConfigure.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousBuild.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousTest.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousCoverage.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousMemCheck.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousSubmit.dir/DependInfo.cmake"
+  "CMakeFiles/chapterforge.dir/DependInfo.cmake"
+  "CMakeFiles/chapterforge_cli.dir/DependInfo.cmake"
+  "CMakeFiles/toc.dir/DependInfo.cmake"
+  "CMakeFiles/toc_check.dir/DependInfo.cmake"
+  "CMakeFiles/generate_test_assets.dir/DependInfo.cmake"
+  "CMakeFiles/parser_fallback_check.dir/DependInfo.cmake"
+  "CMakeFiles/parser_safety_check.dir/DependInfo.cmake"
+  "CMakeFiles/parser_large_mdat.dir/DependInfo.cmake"
+  "CMakeFiles/mux_memory.dir/DependInfo.cmake"
+  "CMakeFiles/large_output.dir/DependInfo.cmake"
+  "CMakeFiles/atom_scanner_unit.dir/DependInfo.cmake"
+  "CMakeFiles/sample_table_unit.dir/DependInfo.cmake"
+  "CMakeFiles/file_writer_unit.dir/DependInfo.cmake"
+  "CMakeFiles/box_writer_unit.dir/DependInfo.cmake"
+  "CMakeFiles/byte_order_unit.dir/DependInfo.cmake"
+  "CMakeFiles/image_fixtures.dir/DependInfo.cmake"
+  "CMakeFiles/overload_variants.dir/DependInfo.cmake"
+  "CMakeFiles/chapter_start_rules.dir/DependInfo.cmake"
+  "CMakeFiles/helper_unit.dir/DependInfo.cmake"
+  "CMakeFiles/writer_unit.dir/DependInfo.cmake"
+  "CMakeFiles/parser_unit.dir/DependInfo.cmake"
+  "CMakeFiles/read_unit.dir/DependInfo.cmake"
+  "CMakeFiles/probe_unit.dir/DependInfo.cmake"
+  "CMakeFiles/plan_unit.dir/DependInfo.cmake"
+  "CMakeFiles/chapter_reader_unit.dir/DependInfo.cmake"
+  "CMakeFiles/coalesced_reads_unit.dir/DependInfo.cmake"
+  "CMakeFiles/parallel_read_unit.dir/DependInfo.cmake"
+  "CMakeFiles/read_budget_unit.dir/DependInfo.cmake"
+  "CMakeFiles/source_latency_unit.dir/DependInfo.cmake"
+  "CMakeFiles/parse_cache_unit.dir/DependInfo.cmake"
+  "CMakeFiles/sidecar_index_unit.dir/DependInfo.cmake"
+  "CMakeFiles/stream_parser_unit.dir/DependInfo.cmake"
+  "CMakeFiles/batch_read_unit.dir/DependInfo.cmake"
+  "CMakeFiles/parallel_write_unit.dir/DependInfo.cmake"
+  "CMakeFiles/in_place_update_unit.dir/DependInfo.cmake"
+  "CMakeFiles/parse_bench.dir/DependInfo.cmake"
+  "CMakeFiles/mux_bench.dir/DependInfo.cmake"
+  "CMakeFiles/sample_table_bench.dir/DependInfo.cmake"
+  "CMakeFiles/chapter_reader_bench.dir/DependInfo.cmake"
+  "CMakeFiles/write_bench.dir/DependInfo.cmake"
+  )
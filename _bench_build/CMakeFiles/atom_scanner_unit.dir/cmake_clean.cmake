@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/atom_scanner_unit.dir/tests/atom_scanner_unit.cpp.o"
+  "CMakeFiles/atom_scanner_unit.dir/tests/atom_scanner_unit.cpp.o.d"
+  "atom_scanner_unit"
+  "atom_scanner_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/atom_scanner_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/batch_read_unit.dir/tests/batch_read_unit.cpp.o"
+  "CMakeFiles/batch_read_unit.dir/tests/batch_read_unit.cpp.o.d"
+  "batch_read_unit"
+  "batch_read_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/batch_read_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/byte_order_unit.dir/tests/byte_order_unit.cpp.o"
+  "CMakeFiles/byte_order_unit.dir/tests/byte_order_unit.cpp.o.d"
+  "byte_order_unit"
+  "byte_order_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/byte_order_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
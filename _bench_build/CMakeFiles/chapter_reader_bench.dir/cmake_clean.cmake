@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/chapter_reader_bench.dir/bench/chapter_reader_bench.cpp.o"
+  "CMakeFiles/chapter_reader_bench.dir/bench/chapter_reader_bench.cpp.o.d"
+  "chapter_reader_bench"
+  "chapter_reader_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/chapter_reader_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/chapter_reader_unit.dir/tests/chapter_reader_unit.cpp.o"
+  "CMakeFiles/chapter_reader_unit.dir/tests/chapter_reader_unit.cpp.o.d"
+  "chapter_reader_unit"
+  "chapter_reader_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/chapter_reader_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/chapter_start_rules.dir/tests/chapter_start_rules.cpp.o"
+  "CMakeFiles/chapter_start_rules.dir/tests/chapter_start_rules.cpp.o.d"
+  "chapter_start_rules"
+  "chapter_start_rules.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/chapter_start_rules.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,68 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/aac_extractor.cpp" "CMakeFiles/chapterforge.dir/src/aac_extractor.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/aac_extractor.cpp.o.d"
+  "/root/repo/src/atom_scanner.cpp" "CMakeFiles/chapterforge.dir/src/atom_scanner.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/atom_scanner.cpp.o.d"
+  "/root/repo/src/box_writer.cpp" "CMakeFiles/chapterforge.dir/src/box_writer.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/box_writer.cpp.o.d"
+  "/root/repo/src/byte_order.cpp" "CMakeFiles/chapterforge.dir/src/byte_order.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/byte_order.cpp.o.d"
+  "/root/repo/src/chapterforge.cpp" "CMakeFiles/chapterforge.dir/src/chapterforge.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/chapterforge.cpp.o.d"
+  "/root/repo/src/coalesced_reads.cpp" "CMakeFiles/chapterforge.dir/src/coalesced_reads.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/coalesced_reads.cpp.o.d"
+  "/root/repo/src/dinf_builder.cpp" "CMakeFiles/chapterforge.dir/src/dinf_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/dinf_builder.cpp.o.d"
+  "/root/repo/src/file_writer.cpp" "CMakeFiles/chapterforge.dir/src/file_writer.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/file_writer.cpp.o.d"
+  "/root/repo/src/frame_store.cpp" "CMakeFiles/chapterforge.dir/src/frame_store.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/frame_store.cpp.o.d"
+  "/root/repo/src/hdlr_builder.cpp" "CMakeFiles/chapterforge.dir/src/hdlr_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/hdlr_builder.cpp.o.d"
+  "/root/repo/src/in_place_update.cpp" "CMakeFiles/chapterforge.dir/src/in_place_update.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/in_place_update.cpp.o.d"
+  "/root/repo/src/input_file.cpp" "CMakeFiles/chapterforge.dir/src/input_file.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/input_file.cpp.o.d"
+  "/root/repo/src/jpeg_entry_builder.cpp" "CMakeFiles/chapterforge.dir/src/jpeg_entry_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/jpeg_entry_builder.cpp.o.d"
+  "/root/repo/src/jpeg_info.cpp" "CMakeFiles/chapterforge.dir/src/jpeg_info.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/jpeg_info.cpp.o.d"
+  "/root/repo/src/layout_planner.cpp" "CMakeFiles/chapterforge.dir/src/layout_planner.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/layout_planner.cpp.o.d"
+  "/root/repo/src/logging.cpp" "CMakeFiles/chapterforge.dir/src/logging.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/logging.cpp.o.d"
+  "/root/repo/src/mapped_file.cpp" "CMakeFiles/chapterforge.dir/src/mapped_file.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/mapped_file.cpp.o.d"
+  "/root/repo/src/mdat_writer.cpp" "CMakeFiles/chapterforge.dir/src/mdat_writer.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/mdat_writer.cpp.o.d"
+  "/root/repo/src/mdhd_builder.cpp" "CMakeFiles/chapterforge.dir/src/mdhd_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/mdhd_builder.cpp.o.d"
+  "/root/repo/src/mdia_builder.cpp" "CMakeFiles/chapterforge.dir/src/mdia_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/mdia_builder.cpp.o.d"
+  "/root/repo/src/meta_builder.cpp" "CMakeFiles/chapterforge.dir/src/meta_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/meta_builder.cpp.o.d"
+  "/root/repo/src/minf_builder.cpp" "CMakeFiles/chapterforge.dir/src/minf_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/minf_builder.cpp.o.d"
+  "/root/repo/src/moov_builder.cpp" "CMakeFiles/chapterforge.dir/src/moov_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/moov_builder.cpp.o.d"
+  "/root/repo/src/mp4_atoms.cpp" "CMakeFiles/chapterforge.dir/src/mp4_atoms.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/mp4_atoms.cpp.o.d"
+  "/root/repo/src/mp4_muxer.cpp" "CMakeFiles/chapterforge.dir/src/mp4_muxer.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/mp4_muxer.cpp.o.d"
+  "/root/repo/src/mp4a_builder.cpp" "CMakeFiles/chapterforge.dir/src/mp4a_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/mp4a_builder.cpp.o.d"
+  "/root/repo/src/mvhd_builder.cpp" "CMakeFiles/chapterforge.dir/src/mvhd_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/mvhd_builder.cpp.o.d"
+  "/root/repo/src/nmhd_builder.cpp" "CMakeFiles/chapterforge.dir/src/nmhd_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/nmhd_builder.cpp.o.d"
+  "/root/repo/src/parse_cache.cpp" "CMakeFiles/chapterforge.dir/src/parse_cache.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/parse_cache.cpp.o.d"
+  "/root/repo/src/parser.cpp" "CMakeFiles/chapterforge.dir/src/parser.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/parser.cpp.o.d"
+  "/root/repo/src/random_access_file.cpp" "CMakeFiles/chapterforge.dir/src/random_access_file.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/random_access_file.cpp.o.d"
+  "/root/repo/src/sample_table.cpp" "CMakeFiles/chapterforge.dir/src/sample_table.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/sample_table.cpp.o.d"
+  "/root/repo/src/sidecar_index.cpp" "CMakeFiles/chapterforge.dir/src/sidecar_index.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/sidecar_index.cpp.o.d"
+  "/root/repo/src/smhd_builder.cpp" "CMakeFiles/chapterforge.dir/src/smhd_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/smhd_builder.cpp.o.d"
+  "/root/repo/src/stbl_audio_builder.cpp" "CMakeFiles/chapterforge.dir/src/stbl_audio_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/stbl_audio_builder.cpp.o.d"
+  "/root/repo/src/stbl_image_builder.cpp" "CMakeFiles/chapterforge.dir/src/stbl_image_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/stbl_image_builder.cpp.o.d"
+  "/root/repo/src/stbl_metadata_builder.cpp" "CMakeFiles/chapterforge.dir/src/stbl_metadata_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/stbl_metadata_builder.cpp.o.d"
+  "/root/repo/src/stbl_text_builder.cpp" "CMakeFiles/chapterforge.dir/src/stbl_text_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/stbl_text_builder.cpp.o.d"
+  "/root/repo/src/stco_builder.cpp" "CMakeFiles/chapterforge.dir/src/stco_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/stco_builder.cpp.o.d"
+  "/root/repo/src/stream_parser.cpp" "CMakeFiles/chapterforge.dir/src/stream_parser.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/stream_parser.cpp.o.d"
+  "/root/repo/src/stsc_builder.cpp" "CMakeFiles/chapterforge.dir/src/stsc_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/stsc_builder.cpp.o.d"
+  "/root/repo/src/stsd_builder.cpp" "CMakeFiles/chapterforge.dir/src/stsd_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/stsd_builder.cpp.o.d"
+  "/root/repo/src/stsz_builder.cpp" "CMakeFiles/chapterforge.dir/src/stsz_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/stsz_builder.cpp.o.d"
+  "/root/repo/src/stts_builder.cpp" "CMakeFiles/chapterforge.dir/src/stts_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/stts_builder.cpp.o.d"
+  "/root/repo/src/tkhd_builder.cpp" "CMakeFiles/chapterforge.dir/src/tkhd_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/tkhd_builder.cpp.o.d"
+  "/root/repo/src/trak_builder.cpp" "CMakeFiles/chapterforge.dir/src/trak_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/trak_builder.cpp.o.d"
+  "/root/repo/src/tx3g_stsd_builder.cpp" "CMakeFiles/chapterforge.dir/src/tx3g_stsd_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/tx3g_stsd_builder.cpp.o.d"
+  "/root/repo/src/udta_builder.cpp" "CMakeFiles/chapterforge.dir/src/udta_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/udta_builder.cpp.o.d"
+  "/root/repo/src/vmhd_builder.cpp" "CMakeFiles/chapterforge.dir/src/vmhd_builder.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/vmhd_builder.cpp.o.d"
+  "/root/repo/src/work_stealing.cpp" "CMakeFiles/chapterforge.dir/src/work_stealing.cpp.o" "gcc" "CMakeFiles/chapterforge.dir/src/work_stealing.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/chapterforge_cli.dir/src/main.cpp.o"
+  "CMakeFiles/chapterforge_cli.dir/src/main.cpp.o.d"
+  "chapterforge_cli"
+  "chapterforge_cli.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/chapterforge_cli.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/coalesced_reads_unit.dir/tests/coalesced_reads_unit.cpp.o"
+  "CMakeFiles/coalesced_reads_unit.dir/tests/coalesced_reads_unit.cpp.o.d"
+  "coalesced_reads_unit"
+  "coalesced_reads_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/coalesced_reads_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
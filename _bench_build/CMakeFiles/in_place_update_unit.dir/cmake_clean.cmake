@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/in_place_update_unit.dir/tests/in_place_update_unit.cpp.o"
+  "CMakeFiles/in_place_update_unit.dir/tests/in_place_update_unit.cpp.o.d"
+  "in_place_update_unit"
+  "in_place_update_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/in_place_update_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
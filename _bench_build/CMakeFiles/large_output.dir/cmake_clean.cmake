@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/large_output.dir/tests/large_output.cpp.o"
+  "CMakeFiles/large_output.dir/tests/large_output.cpp.o.d"
+  "large_output"
+  "large_output.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/large_output.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/mux_bench.dir/bench/mux_bench.cpp.o"
+  "CMakeFiles/mux_bench.dir/bench/mux_bench.cpp.o.d"
+  "mux_bench"
+  "mux_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/mux_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
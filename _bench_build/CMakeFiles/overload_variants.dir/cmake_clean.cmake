@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/overload_variants.dir/tests/overload_variants.cpp.o"
+  "CMakeFiles/overload_variants.dir/tests/overload_variants.cpp.o.d"
+  "overload_variants"
+  "overload_variants.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/overload_variants.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
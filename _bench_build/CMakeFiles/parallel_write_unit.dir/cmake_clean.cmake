@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/parallel_write_unit.dir/tests/parallel_write_unit.cpp.o"
+  "CMakeFiles/parallel_write_unit.dir/tests/parallel_write_unit.cpp.o.d"
+  "parallel_write_unit"
+  "parallel_write_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/parallel_write_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/parse_bench.dir/bench/parse_bench.cpp.o"
+  "CMakeFiles/parse_bench.dir/bench/parse_bench.cpp.o.d"
+  "parse_bench"
+  "parse_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/parse_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
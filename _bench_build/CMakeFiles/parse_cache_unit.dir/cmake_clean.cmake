@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/parse_cache_unit.dir/tests/parse_cache_unit.cpp.o"
+  "CMakeFiles/parse_cache_unit.dir/tests/parse_cache_unit.cpp.o.d"
+  "parse_cache_unit"
+  "parse_cache_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/parse_cache_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/parser_fallback_check.dir/tests/parser_fallback.cpp.o"
+  "CMakeFiles/parser_fallback_check.dir/tests/parser_fallback.cpp.o.d"
+  "parser_fallback_check"
+  "parser_fallback_check.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/parser_fallback_check.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/parser_large_mdat.dir/tests/parser_large_mdat.cpp.o"
+  "CMakeFiles/parser_large_mdat.dir/tests/parser_large_mdat.cpp.o.d"
+  "parser_large_mdat"
+  "parser_large_mdat.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/parser_large_mdat.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/parser_safety_check.dir/tests/parser_safety.cpp.o"
+  "CMakeFiles/parser_safety_check.dir/tests/parser_safety.cpp.o.d"
+  "parser_safety_check"
+  "parser_safety_check.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/parser_safety_check.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/parser_unit.dir/tests/parser_unit.cpp.o"
+  "CMakeFiles/parser_unit.dir/tests/parser_unit.cpp.o.d"
+  "parser_unit"
+  "parser_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/parser_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
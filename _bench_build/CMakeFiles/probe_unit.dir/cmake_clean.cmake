@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/probe_unit.dir/tests/probe_unit.cpp.o"
+  "CMakeFiles/probe_unit.dir/tests/probe_unit.cpp.o.d"
+  "probe_unit"
+  "probe_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/probe_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/read_budget_unit.dir/tests/read_budget_unit.cpp.o"
+  "CMakeFiles/read_budget_unit.dir/tests/read_budget_unit.cpp.o.d"
+  "read_budget_unit"
+  "read_budget_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/read_budget_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
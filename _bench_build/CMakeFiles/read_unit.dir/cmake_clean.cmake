@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/read_unit.dir/tests/read_api_unit.cpp.o"
+  "CMakeFiles/read_unit.dir/tests/read_api_unit.cpp.o.d"
+  "read_unit"
+  "read_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/read_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/sample_table_bench.dir/bench/sample_table_bench.cpp.o"
+  "CMakeFiles/sample_table_bench.dir/bench/sample_table_bench.cpp.o.d"
+  "sample_table_bench"
+  "sample_table_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/sample_table_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/source_latency_unit.dir/tests/source_latency_unit.cpp.o"
+  "CMakeFiles/source_latency_unit.dir/tests/source_latency_unit.cpp.o.d"
+  "source_latency_unit"
+  "source_latency_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/source_latency_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
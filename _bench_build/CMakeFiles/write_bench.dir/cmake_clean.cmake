@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/write_bench.dir/bench/write_bench.cpp.o"
+  "CMakeFiles/write_bench.dir/bench/write_bench.cpp.o.d"
+  "write_bench"
+  "write_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/write_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
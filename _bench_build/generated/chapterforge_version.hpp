@@ -0,0 +1,10 @@
+//
+//  chapterforge_version.hpp
+//
+
+#pragma once
+
+#define CHAPTERFORGE_VERSION "dev"
+#define CHAPTERFORGE_VERSION_DISPLAY "dev+570efef"
+#define CHAPTERFORGE_VERSION_IS_DEV TRUE
+#define CHAPTERFORGE_GIT_HASH "570efef"
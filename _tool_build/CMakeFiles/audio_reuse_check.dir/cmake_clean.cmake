@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/audio_reuse_check.dir/tests/audio_reuse_check.cpp.o"
+  "CMakeFiles/audio_reuse_check.dir/tests/audio_reuse_check.cpp.o.d"
+  "audio_reuse_check"
+  "audio_reuse_check.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/audio_reuse_check.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/box_writer_unit.dir/tests/box_writer_unit.cpp.o"
+  "CMakeFiles/box_writer_unit.dir/tests/box_writer_unit.cpp.o.d"
+  "box_writer_unit"
+  "box_writer_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/box_writer_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
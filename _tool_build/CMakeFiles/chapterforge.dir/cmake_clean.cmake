@@ -0,0 +1,109 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/chapterforge.dir/src/aac_extractor.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/aac_extractor.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/atom_scanner.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/atom_scanner.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/box_writer.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/box_writer.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/byte_order.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/byte_order.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/chapterforge.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/chapterforge.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/coalesced_reads.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/coalesced_reads.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/dinf_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/dinf_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/file_writer.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/file_writer.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/frame_store.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/frame_store.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/hdlr_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/hdlr_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/in_place_update.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/in_place_update.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/input_file.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/input_file.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/jpeg_entry_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/jpeg_entry_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/jpeg_info.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/jpeg_info.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/layout_planner.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/layout_planner.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/logging.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/logging.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/mapped_file.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/mapped_file.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/mdat_writer.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/mdat_writer.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/mdhd_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/mdhd_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/mdia_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/mdia_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/meta_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/meta_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/minf_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/minf_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/moov_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/moov_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/mp4_atoms.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/mp4_atoms.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/mp4_muxer.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/mp4_muxer.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/mp4a_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/mp4a_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/mvhd_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/mvhd_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/nmhd_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/nmhd_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/parse_cache.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/parse_cache.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/parser.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/parser.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/random_access_file.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/random_access_file.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/sample_table.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/sample_table.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/sidecar_index.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/sidecar_index.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/smhd_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/smhd_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/stbl_audio_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/stbl_audio_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/stbl_image_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/stbl_image_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/stbl_metadata_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/stbl_metadata_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/stbl_text_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/stbl_text_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/stco_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/stco_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/stream_parser.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/stream_parser.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/stsc_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/stsc_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/stsd_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/stsd_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/stsz_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/stsz_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/stts_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/stts_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/tkhd_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/tkhd_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/trak_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/trak_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/tx3g_stsd_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/tx3g_stsd_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/udta_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/udta_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/vmhd_builder.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/vmhd_builder.cpp.o.d"
+  "CMakeFiles/chapterforge.dir/src/work_stealing.cpp.o"
+  "CMakeFiles/chapterforge.dir/src/work_stealing.cpp.o.d"
+  "libchapterforge.a"
+  "libchapterforge.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/chapterforge.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
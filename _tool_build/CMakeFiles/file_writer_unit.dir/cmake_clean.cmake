@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/file_writer_unit.dir/tests/file_writer_unit.cpp.o"
+  "CMakeFiles/file_writer_unit.dir/tests/file_writer_unit.cpp.o.d"
+  "file_writer_unit"
+  "file_writer_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/file_writer_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
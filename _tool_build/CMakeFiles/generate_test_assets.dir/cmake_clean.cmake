@@ -0,0 +1,8 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/generate_test_assets"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/generate_test_assets.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/helper_unit.dir/tests/helper_unit.cpp.o"
+  "CMakeFiles/helper_unit.dir/tests/helper_unit.cpp.o.d"
+  "helper_unit"
+  "helper_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/helper_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
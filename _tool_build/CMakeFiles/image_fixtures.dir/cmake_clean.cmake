@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/image_fixtures.dir/tests/image_fixtures.cpp.o"
+  "CMakeFiles/image_fixtures.dir/tests/image_fixtures.cpp.o.d"
+  "image_fixtures"
+  "image_fixtures.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/image_fixtures.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
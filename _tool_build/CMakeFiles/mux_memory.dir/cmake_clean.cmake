@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/mux_memory.dir/tests/mux_memory.cpp.o"
+  "CMakeFiles/mux_memory.dir/tests/mux_memory.cpp.o.d"
+  "mux_memory"
+  "mux_memory.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/mux_memory.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
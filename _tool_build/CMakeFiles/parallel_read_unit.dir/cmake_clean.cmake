@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/parallel_read_unit.dir/tests/parallel_read_unit.cpp.o"
+  "CMakeFiles/parallel_read_unit.dir/tests/parallel_read_unit.cpp.o.d"
+  "parallel_read_unit"
+  "parallel_read_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/parallel_read_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/plan_unit.dir/tests/plan_unit.cpp.o"
+  "CMakeFiles/plan_unit.dir/tests/plan_unit.cpp.o.d"
+  "plan_unit"
+  "plan_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/plan_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/sample_table_unit.dir/tests/sample_table_unit.cpp.o"
+  "CMakeFiles/sample_table_unit.dir/tests/sample_table_unit.cpp.o.d"
+  "sample_table_unit"
+  "sample_table_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/sample_table_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
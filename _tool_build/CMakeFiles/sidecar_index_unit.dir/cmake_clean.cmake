@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/sidecar_index_unit.dir/tests/sidecar_index_unit.cpp.o"
+  "CMakeFiles/sidecar_index_unit.dir/tests/sidecar_index_unit.cpp.o.d"
+  "sidecar_index_unit"
+  "sidecar_index_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/sidecar_index_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
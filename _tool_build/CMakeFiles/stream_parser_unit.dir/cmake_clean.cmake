@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/stream_parser_unit.dir/tests/stream_parser_unit.cpp.o"
+  "CMakeFiles/stream_parser_unit.dir/tests/stream_parser_unit.cpp.o.d"
+  "stream_parser_unit"
+  "stream_parser_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/stream_parser_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
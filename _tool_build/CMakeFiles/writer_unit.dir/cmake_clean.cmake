@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/writer_unit.dir/tests/writer_unit.cpp.o"
+  "CMakeFiles/writer_unit.dir/tests/writer_unit.cpp.o.d"
+  "writer_unit"
+  "writer_unit.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/writer_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,82 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/_tool_build
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(generate_assets "/usr/bin/cmake" "-DPROJECT_ROOT=/root/repo" "-P" "/root/repo/tests/generate_assets.cmake")
+set_tests_properties(generate_assets PROPERTIES  FIXTURES_SETUP "assets" LABELS "core" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;235;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(parser_fallback_check "/root/repo/_tool_build/parser_fallback_check")
+set_tests_properties(parser_fallback_check PROPERTIES  FIXTURES_REQUIRED "assets" LABELS "core" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;256;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(parser_safety_check "/root/repo/_tool_build/parser_safety_check")
+set_tests_properties(parser_safety_check PROPERTIES  LABELS "core" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;264;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(parser_large_mdat "/root/repo/_tool_build/parser_large_mdat")
+set_tests_properties(parser_large_mdat PROPERTIES  LABELS "core" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;271;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(mux_memory "/root/repo/_tool_build/mux_memory")
+set_tests_properties(mux_memory PROPERTIES  LABELS "core" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;277;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(large_output "/root/repo/_tool_build/large_output")
+set_tests_properties(large_output PROPERTIES  LABELS "core" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;285;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(atom_scanner_unit "/root/repo/_tool_build/atom_scanner_unit")
+set_tests_properties(atom_scanner_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;292;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(sample_table_unit "/root/repo/_tool_build/sample_table_unit")
+set_tests_properties(sample_table_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;298;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(file_writer_unit "/root/repo/_tool_build/file_writer_unit")
+set_tests_properties(file_writer_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;304;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(box_writer_unit "/root/repo/_tool_build/box_writer_unit")
+set_tests_properties(box_writer_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;309;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(byte_order_unit "/root/repo/_tool_build/byte_order_unit")
+set_tests_properties(byte_order_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;314;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(image_fixtures "/root/repo/_tool_build/image_fixtures" "/root/repo/testdata")
+set_tests_properties(image_fixtures PROPERTIES  FIXTURES_REQUIRED "assets" LABELS "core" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;321;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(overload_variants "/root/repo/_tool_build/overload_variants" "/root/repo/testdata/input.m4a" "/root/repo/testdata/images/cover.jpg" "/root/repo/_tool_build/test_outputs")
+set_tests_properties(overload_variants PROPERTIES  FIXTURES_REQUIRED "assets" LABELS "core" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;331;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(chapter_start_rules "/root/repo/_tool_build/chapter_start_rules")
+set_tests_properties(chapter_start_rules PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;374;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(helper_unit "/root/repo/_tool_build/helper_unit" "/root/repo/testdata")
+set_tests_properties(helper_unit PROPERTIES  FIXTURES_REQUIRED "assets" LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;383;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(writer_unit "/root/repo/_tool_build/writer_unit")
+set_tests_properties(writer_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;393;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(parser_unit "/root/repo/_tool_build/parser_unit")
+set_tests_properties(parser_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;402;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(read_unit "/root/repo/_tool_build/read_unit")
+set_tests_properties(read_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;410;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(probe_unit "/root/repo/_tool_build/probe_unit")
+set_tests_properties(probe_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;418;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(plan_unit "/root/repo/_tool_build/plan_unit")
+set_tests_properties(plan_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;426;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(chapter_reader_unit "/root/repo/_tool_build/chapter_reader_unit")
+set_tests_properties(chapter_reader_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;434;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(coalesced_reads_unit "/root/repo/_tool_build/coalesced_reads_unit")
+set_tests_properties(coalesced_reads_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;442;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(parallel_read_unit "/root/repo/_tool_build/parallel_read_unit")
+set_tests_properties(parallel_read_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;450;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(read_budget_unit "/root/repo/_tool_build/read_budget_unit")
+set_tests_properties(read_budget_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;458;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(source_latency_unit "/root/repo/_tool_build/source_latency_unit")
+set_tests_properties(source_latency_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;466;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(parse_cache_unit "/root/repo/_tool_build/parse_cache_unit")
+set_tests_properties(parse_cache_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;474;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(sidecar_index_unit "/root/repo/_tool_build/sidecar_index_unit")
+set_tests_properties(sidecar_index_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;482;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(stream_parser_unit "/root/repo/_tool_build/stream_parser_unit")
+set_tests_properties(stream_parser_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;490;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(batch_read_unit "/root/repo/_tool_build/batch_read_unit")
+set_tests_properties(batch_read_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;498;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(parallel_write_unit "/root/repo/_tool_build/parallel_write_unit")
+set_tests_properties(parallel_write_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;506;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(in_place_update_unit "/root/repo/_tool_build/in_place_update_unit")
+set_tests_properties(in_place_update_unit PROPERTIES  LABELS "unit" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;514;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(image_missing_first "/root/repo/_tool_build/chapterforge_cli" "/root/repo/testdata/input.m4a" "/root/repo/testdata/chapters_10s_mixedimg.json" "/root/repo/_tool_build/test_outputs/output_mixedimg.m4a")
+set_tests_properties(image_missing_first PROPERTIES  FIXTURES_REQUIRED "assets" LABELS "core" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;598;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(image_mixed_sizes "/root/repo/_tool_build/chapterforge_cli" "/root/repo/testdata/input.m4a" "/root/repo/testdata/chapters_10s_mixed_sizes.json" "/root/repo/_tool_build/test_outputs/output_mixed_sizes.m4a")
+set_tests_properties(image_mixed_sizes PROPERTIES  FIXTURES_REQUIRED "assets" LABELS "core" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;607;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(image_mixed_sizes_warn "/usr/bin/cmake" "-DCHAPTERFORGE_BIN=/root/repo/_tool_build/chapterforge_cli" "-DINPUT_M4A=/root/repo/testdata/input.m4a" "-DCHAPTER_JSON=/root/repo/testdata/chapters_10s_mixed_sizes.json" "-DOUTPUT_M4A=/root/repo/_tool_build/test_outputs/output_mixed_sizes_warn.m4a" "-P" "/root/repo/tests/check_image_mismatch_warn.cmake")
+set_tests_properties(image_mixed_sizes_warn PROPERTIES  FIXTURES_REQUIRED "assets" LABELS "core" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;616;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(audio_reuse_check "/root/repo/_tool_build/audio_reuse_check" "/root/repo/testdata/input.m4a" "/root/repo/_tool_build/test_outputs/output.m4a")
+set_tests_properties(audio_reuse_check PROPERTIES  DEPENDS "output_tool_checks" FIXTURES_REQUIRED "assets" LABELS "core" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;640;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(output_tool_checks "/usr/bin/cmake" "-DINPUT_M4A=/root/repo/testdata/input.m4a" "-DOUTPUT_M4A=/root/repo/_tool_build/test_outputs/output.m4a" "-DCHAPTER_JSON=/root/repo/testdata/chapters.json" "-DCHAPTERFORGE_BIN=/root/repo/_tool_build/chapterforge_cli" "-DFASTSTART_FLAG=ON" "-DXXD_PATH=/usr/bin/xxd" "-DMP4INFO_PATH=MP4INFO_PATH-NOTFOUND" "-DMP4DUMP_PATH=MP4DUMP_PATH-NOTFOUND" "-DATOMIC_PARSLEY_PATH=ATOMIC_PARSLEY_PATH-NOTFOUND" "-P" "/root/repo/tests/run_tools_with_mux.cmake")
+set_tests_properties(output_tool_checks PROPERTIES  FIXTURES_REQUIRED "assets" LABELS "tooling" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;701;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(metadata_preserve_small "/usr/bin/cmake" "-DINPUT_M4A=/root/repo/testdata/input.m4a" "-DOUTPUT_M4A=/root/repo/_tool_build/test_outputs/output_meta_preserve.m4a" "-DCHAPTER_JSON=/root/repo/testdata/chapters_nometa.json" "-DCHAPTERFORGE_BIN=/root/repo/_tool_build/chapterforge_cli" "-DFASTSTART_FLAG=ON" "-DXXD_PATH=/usr/bin/xxd" "-DMP4INFO_PATH=MP4INFO_PATH-NOTFOUND" "-DMP4DUMP_PATH=MP4DUMP_PATH-NOTFOUND" "-DATOMIC_PARSLEY_PATH=ATOMIC_PARSLEY_PATH-NOTFOUND" "-P" "/root/repo/tests/run_tools_with_mux.cmake")
+set_tests_properties(metadata_preserve_small PROPERTIES  FIXTURES_REQUIRED "assets" LABELS "core" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;717;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(output_tool_checks_aac "/usr/bin/cmake" "-DINPUT_AAC=/root/repo/testdata/input.aac" "-DINPUT_M4A=/root/repo/testdata/input.m4a" "-DOUTPUT_M4A=/root/repo/_tool_build/test_outputs/output_from_aac.m4a" "-DCHAPTER_JSON=/root/repo/testdata/chapters.json" "-DCHAPTERFORGE_BIN=/root/repo/_tool_build/chapterforge_cli" "-DFASTSTART_FLAG=ON" "-DXXD_PATH=/usr/bin/xxd" "-DMP4INFO_PATH=MP4INFO_PATH-NOTFOUND" "-DMP4DUMP_PATH=MP4DUMP_PATH-NOTFOUND" "-DATOMIC_PARSLEY_PATH=ATOMIC_PARSLEY_PATH-NOTFOUND" "-P" "/root/repo/tests/run_aac_with_mux.cmake")
+set_tests_properties(output_tool_checks_aac PROPERTIES  FIXTURES_REQUIRED "assets" LABELS "tooling" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;735;add_test;/root/repo/CMakeLists.txt;0;")
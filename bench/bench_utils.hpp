@@ -0,0 +1,227 @@
+//
+//  bench_utils.hpp
+//  ChapterForge
+//
+//  Benchmark-only helpers: heap accounting, timing and synthetic long-form M4A fixtures.
+//  Include from exactly one translation unit per benchmark executable (it replaces the global
+//  allocation functions).
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "fourcc_utils.hpp"
+#include "parser_test_utils.hpp"
+
+namespace bench {
+
+// Heap traffic since process start; sample before/after a region to get its cost.
+inline std::atomic<uint64_t> g_alloc_bytes{0};
+inline std::atomic<uint64_t> g_alloc_count{0};
+
+struct HeapSnapshot {
+    uint64_t bytes = 0;
+    uint64_t count = 0;
+};
+
+inline HeapSnapshot heap_now() {
+    return {g_alloc_bytes.load(std::memory_order_relaxed),
+            g_alloc_count.load(std::memory_order_relaxed)};
+}
+
+inline double ms_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// Peak resident set size of this process so far, in bytes.
+inline uint64_t peak_rss_bytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc{};
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return pmc.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return static_cast<uint64_t>(usage.ru_maxrss);  // bytes
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;  // KiB
+#endif
+#endif
+}
+
+// Description of a synthetic long-form audiobook: AAC-LC at 44.1 kHz with a sparse mdat, a text
+// chapter track, and an ilst carrying cover art. moov is written after mdat (non-faststart).
+struct LongFixture {
+    double hours = 10.0;
+    uint32_t samples_per_chunk = 21;
+    uint32_t chapters = 120;
+    uint32_t cover_bytes = 150 * 1024;
+    bool faststart = false;
+};
+
+struct LongFixtureInfo {
+    uint64_t file_size = 0;
+    uint64_t moov_size = 0;
+    uint32_t audio_samples = 0;
+};
+
+inline std::vector<uint8_t> make_full_box(uint32_t entry_count) {
+    std::vector<uint8_t> p{0, 0, 0, 0};  // version/flags
+    parser_test_utils::write_u32_be(p, entry_count);
+    return p;
+}
+
+// Write the fixture to `path`. The audio payload is a hole, so the file costs almost no disk.
+inline LongFixtureInfo write_long_fixture(const std::filesystem::path &path,
+                                          const LongFixture &fx) {
+    using namespace parser_test_utils;
+    constexpr uint32_t kTimescale = 44100;
+    constexpr uint32_t kFrame = 1024;
+    LongFixtureInfo info;
+    info.audio_samples = static_cast<uint32_t>(fx.hours * 3600.0 * kTimescale / kFrame);
+
+    std::vector<uint32_t> sizes(info.audio_samples);
+    uint64_t mdat_payload = 0;
+    for (uint32_t i = 0; i < info.audio_samples; ++i) {
+        sizes[i] = 170 + (i * 2654435761u >> 27);  // ~128 kbps with some jitter
+        mdat_payload += sizes[i];
+    }
+    const uint32_t chunk_count =
+        (info.audio_samples + fx.samples_per_chunk - 1) / fx.samples_per_chunk;
+
+    auto build_moov = [&](uint64_t mdat_data_start) {
+        std::vector<uint8_t> stsz{0, 0, 0, 0};
+        write_u32_be(stsz, 0);
+        write_u32_be(stsz, info.audio_samples);
+        for (uint32_t s : sizes) {
+            write_u32_be(stsz, s);
+        }
+        auto stsc = make_full_box(1);
+        write_u32_be(stsc, 1);
+        write_u32_be(stsc, fx.samples_per_chunk);
+        write_u32_be(stsc, 1);
+        auto stco = make_full_box(chunk_count);
+        uint64_t off = mdat_data_start;
+        for (uint32_t c = 0; c < chunk_count; ++c) {
+            write_u32_be(stco, static_cast<uint32_t>(off));
+            for (uint32_t k = 0; k < fx.samples_per_chunk; ++k) {
+                const uint64_t idx = uint64_t(c) * fx.samples_per_chunk + k;
+                if (idx < sizes.size()) {
+                    off += sizes[idx];
+                }
+            }
+        }
+        std::vector<uint8_t> stbl;
+        append_atom(stbl, fourcc("stsd"), make_stsd());
+        append_atom(stbl, fourcc("stts"), make_stts_single(info.audio_samples, kFrame));
+        append_atom(stbl, fourcc("stsc"), stsc);
+        append_atom(stbl, fourcc("stsz"), stsz);
+        append_atom(stbl, fourcc("stco"), stco);
+        const uint32_t duration = info.audio_samples * kFrame;
+
+        // Text chapter track: one sample per chapter (tables only; samples live nowhere).
+        std::vector<uint8_t> tstbl;
+        append_atom(tstbl, fourcc("stsd"), make_stsd_empty());
+        append_atom(tstbl, fourcc("stts"), make_stts_single(fx.chapters, 1000));
+        append_atom(tstbl, fourcc("stsc"), make_stsc_empty());
+        append_atom(tstbl, fourcc("stsz"), make_stsz(fx.chapters, 0));
+        append_atom(tstbl, fourcc("stco"), make_stco_empty());
+
+        // udta/meta/ilst with a covr item.
+        std::vector<uint8_t> data_box{0, 0, 0, 13, 0, 0, 0, 0};
+        data_box.resize(data_box.size() + fx.cover_bytes, 0xAB);
+        std::vector<uint8_t> covr;
+        append_atom(covr, fourcc("data"), data_box);
+        std::vector<uint8_t> ilst;
+        append_atom(ilst, fourcc("covr"), covr);
+        std::vector<uint8_t> meta{0, 0, 0, 0};
+        append_atom(meta, fourcc("hdlr"), make_hdlr(fourcc("mdir")));
+        append_atom(meta, fourcc("ilst"), ilst);
+        std::vector<uint8_t> udta;
+        append_atom(udta, fourcc("meta"), meta);
+
+        std::vector<uint8_t> moov_payload;
+        append_atom(moov_payload, fourcc("mvhd"), std::vector<uint8_t>(100, 0));
+        append_atom(moov_payload, fourcc("trak"),
+                    make_trak(make_mdia(kTimescale, duration, stbl, fourcc("soun"))));
+        append_atom(moov_payload, fourcc("trak"),
+                    make_trak(make_mdia(1000, duration / kTimescale * 1000, tstbl,
+                                        fourcc("text"))));
+        append_atom(moov_payload, fourcc("udta"), udta);
+        std::vector<uint8_t> moov;
+        append_atom(moov, fourcc("moov"), moov_payload);
+        return moov;
+    };
+
+    std::vector<uint8_t> ftyp;
+    std::vector<uint8_t> ftyp_payload{'M', '4', 'A', ' ', 0, 0, 0, 0, 'i', 's', 'o', 'm'};
+    append_atom(ftyp, fourcc("ftyp"), ftyp_payload);
+
+    std::vector<uint8_t> mdat_header;
+    write_u32_be(mdat_header, static_cast<uint32_t>(mdat_payload + 8));
+    write_u32_be(mdat_header, fourcc("mdat"));
+
+    // moov size does not depend on the offsets it stores, so one dry build fixes the layout.
+    const uint64_t moov_size = build_moov(0).size();
+    const uint64_t data_start =
+        ftyp.size() + (fx.faststart ? moov_size : 0) + mdat_header.size();
+    auto moov = build_moov(data_start);
+    info.moov_size = moov.size();
+
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(ftyp.data()), std::streamsize(ftyp.size()));
+        if (fx.faststart) {
+            out.write(reinterpret_cast<const char *>(moov.data()), std::streamsize(moov.size()));
+        }
+        out.write(reinterpret_cast<const char *>(mdat_header.data()),
+                  std::streamsize(mdat_header.size()));
+    }
+    // Extend over the audio payload without writing it (sparse on filesystems that support it).
+    std::filesystem::resize_file(path, data_start + mdat_payload);
+    if (!fx.faststart) {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out.write(reinterpret_cast<const char *>(moov.data()), std::streamsize(moov.size()));
+    }
+    info.file_size = std::filesystem::file_size(path);
+    return info;
+}
+
+}  // namespace bench
+
+void *operator new(std::size_t n) {
+    bench::g_alloc_bytes.fetch_add(n, std::memory_order_relaxed);
+    bench::g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(n ? n : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void *operator new[](std::size_t n) { return ::operator new(n); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
@@ -0,0 +1,141 @@
+//
+//  chapter_reader_bench.cpp
+//  ChapterForge
+//
+//  Compares fetching one chapter image out of 500 via ChapterReader (moov plus one sample)
+//  against read_m4a (every chapter sample decoded and held). Reports wall time, bytes read from
+//  the file and heap traffic.
+//  Usage: chapter_reader_bench [chapters] [index]
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include "bench_utils.hpp"
+#include "chapterforge.hpp"
+
+#ifndef TESTDATA_DIR
+#error "TESTDATA_DIR must be defined"
+#endif
+
+namespace {
+
+constexpr int kRounds = 5;
+
+std::vector<uint8_t> load_bytes(const std::filesystem::path &p) {
+    std::ifstream in(p, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(in)),
+                                std::istreambuf_iterator<char>());
+}
+
+bool write_fixture(const std::filesystem::path &audio, const std::filesystem::path &out,
+                   uint32_t chapters) {
+    bench::LongFixture fx;
+    fx.hours = 2.0;
+    bench::write_long_fixture(audio, fx);
+
+    const std::filesystem::path images_dir = std::filesystem::path(TESTDATA_DIR) / "images";
+    std::vector<std::vector<uint8_t>> jpegs;
+    for (int i = 1; i <= 5; ++i) {
+        jpegs.push_back(load_bytes(images_dir / ("chapter" + std::to_string(i) + ".jpg")));
+    }
+    std::vector<ChapterTextSample> titles;
+    std::vector<ChapterTextSample> urls;
+    std::vector<ChapterImageSample> images;
+    const double step_ms = fx.hours * 3600.0 * 1000 / chapters;
+    for (uint32_t i = 0; i < chapters; ++i) {
+        const auto start = static_cast<uint32_t>(i * step_ms);
+        ChapterTextSample t{};
+        t.text = "Chapter " + std::to_string(i + 1);
+        t.start_ms = start;
+        titles.push_back(t);
+        ChapterTextSample u{};
+        u.href = "https://chapterforge.test/" + std::to_string(i + 1);
+        u.start_ms = start;
+        urls.push_back(u);
+        ChapterImageSample im{};
+        im.start_ms = start;
+        im.data = jpegs[i % jpegs.size()];
+        images.push_back(std::move(im));
+    }
+    const auto status = chapterforge::mux_file_to_m4a(audio.string(), titles, urls, images,
+                                                      MetadataSet{}, out.string(), true);
+    if (!status.ok) {
+        std::fprintf(stderr, "mux failed: %s\n", status.message.c_str());
+    }
+    return status.ok;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const uint32_t chapters = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 500;
+    const size_t index = argc > 2 ? std::stoul(argv[2]) : chapters / 2;
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto audio = dir / "chapterforge_chapter_reader_bench_in.m4a";
+    const auto file = dir / "chapterforge_chapter_reader_bench.m4a";
+    if (!write_fixture(audio, file, chapters)) {
+        return 1;
+    }
+    std::printf("file=%llu MB chapters=%u index=%zu\n",
+                static_cast<unsigned long long>(std::filesystem::file_size(file) >> 20), chapters,
+                index);
+
+    // read_m4a serially and with four extraction threads.
+    size_t full_size = 0;
+    for (unsigned threads : {1u, 4u}) {
+        uint64_t full_bytes = 0;
+        uint64_t full_calls = 0;
+        double full_ms = 1e30;
+        const auto heap = bench::heap_now();
+        for (int r = 0; r < kRounds; ++r) {
+            const auto t0 = std::chrono::steady_clock::now();
+            const auto res = chapterforge::read_m4a(file.string(), {threads});
+            full_size = index < res.images.size() ? res.images[index].data.size() : 0;
+            full_bytes = res.io.bytes;
+            full_calls = res.io.reads;
+            full_ms = std::min(full_ms, bench::ms_since(t0));
+        }
+        const auto after = bench::heap_now();
+        std::printf("read_m4a t=%-3u %8.3f ms  bytes_read=%llu read_calls=%llu  "
+                    "heap=%llu KB allocations=%llu  image=%zu\n",
+                    threads, full_ms, static_cast<unsigned long long>(full_bytes),
+                    static_cast<unsigned long long>(full_calls),
+                    static_cast<unsigned long long>((after.bytes - heap.bytes) / kRounds >> 10),
+                    static_cast<unsigned long long>((after.count - heap.count) / kRounds),
+                    full_size);
+    }
+
+    size_t reader_size = 0;
+    uint64_t reader_bytes = 0;
+    double reader_ms = 1e30;
+    std::vector<uint8_t> buf;
+    const auto heap = bench::heap_now();
+    for (int r = 0; r < kRounds; ++r) {
+        const auto t0 = std::chrono::steady_clock::now();
+        auto reader = chapterforge::ChapterReader::open(file.string());
+        if (!reader) {
+            return 1;
+        }
+        buf.resize(reader->image_size(index));
+        if (!reader->read_image(index, buf)) {
+            return 1;
+        }
+        reader_ms = std::min(reader_ms, bench::ms_since(t0));
+        reader_size = buf.size();
+        reader_bytes = reader->bytes_read();
+    }
+    const auto after = bench::heap_now();
+    std::printf("ChapterReader  %8.3f ms  bytes_read=%llu  heap=%llu KB allocations=%llu  "
+                "image=%zu\n",
+                reader_ms, static_cast<unsigned long long>(reader_bytes),
+                static_cast<unsigned long long>((after.bytes - heap.bytes) / kRounds >> 10),
+                static_cast<unsigned long long>((after.count - heap.count) / kRounds),
+                reader_size);
+
+    std::filesystem::remove(audio);
+    std::filesystem::remove(file);
+    return full_size == reader_size ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+//
+//  mux_bench.cpp
+//  ChapterForge
+//
+//  Measures heap traffic and peak RSS of a full remux (load audio + write output) for synthetic
+//  long-form inputs. Peak RSS is per process, so without arguments the benchmark re-runs itself
+//  once per size (1h, 10h, 24h) and input kind.
+//  Usage: mux_bench [hours m4a|aac]
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+#include "bench_utils.hpp"
+#include "chapterforge.hpp"
+
+namespace {
+
+// ADTS stream with the same frame sizes as the M4A fixture (AAC-LC, 44.1 kHz, stereo).
+void write_adts_fixture(const std::filesystem::path &path, double hours) {
+    const auto frames = static_cast<uint32_t>(hours * 3600.0 * 44100 / 1024);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    std::vector<uint8_t> frame;
+    for (uint32_t i = 0; i < frames; ++i) {
+        const uint32_t len = 7 + 170 + (i * 2654435761u >> 27);
+        frame.assign(len, 0);
+        frame[0] = 0xFF;
+        frame[1] = 0xF1;                                   // MPEG-4, no CRC
+        frame[2] = 0x50;                                   // LC, 44.1 kHz
+        frame[3] = static_cast<uint8_t>(0x80 | (len >> 11));  // stereo
+        frame[4] = static_cast<uint8_t>(len >> 3);
+        frame[5] = static_cast<uint8_t>(((len & 7) << 5) | 0x1F);
+        frame[6] = 0xFC;
+        out.write(reinterpret_cast<const char *>(frame.data()), std::streamsize(frame.size()));
+    }
+}
+
+int run_one(double hours, const std::string &kind) {
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto input = dir / ("chapterforge_mux_bench." + kind);
+    const auto output = dir / "chapterforge_mux_bench_out.m4a";
+    if (kind == "aac") {
+        write_adts_fixture(input, hours);
+    } else {
+        bench::LongFixture fx;
+        fx.hours = hours;
+        bench::write_long_fixture(input, fx);
+    }
+
+    std::vector<ChapterTextSample> titles;
+    for (uint32_t i = 0; i < 120; ++i) {
+        ChapterTextSample t{};
+        t.text = "Chapter " + std::to_string(i + 1);
+        t.start_ms = static_cast<uint32_t>(i * hours * 3600.0 * 1000 / 120);
+        titles.push_back(t);
+    }
+
+    const auto rss_before = bench::peak_rss_bytes();
+    const auto heap_before = bench::heap_now();
+    const auto t0 = std::chrono::steady_clock::now();
+    const auto status =
+        chapterforge::mux_file_to_m4a(input.string(), titles, std::vector<ChapterImageSample>{},
+                                      output.string(), true);
+    const double ms = bench::ms_since(t0);
+    const auto heap_after = bench::heap_now();
+    if (!status.ok) {
+        std::fprintf(stderr, "mux failed: %s\n", status.message.c_str());
+        return 1;
+    }
+    std::printf("%5.1fh %-3s input=%llu MB mux=%.0f ms allocations=%llu heap=%llu MB "
+                "peak_rss=%llu MB (before mux %llu MB)\n",
+                hours, kind.c_str(),
+                static_cast<unsigned long long>(std::filesystem::file_size(input) >> 20), ms,
+                static_cast<unsigned long long>(heap_after.count - heap_before.count),
+                static_cast<unsigned long long>((heap_after.bytes - heap_before.bytes) >> 20),
+                static_cast<unsigned long long>(bench::peak_rss_bytes() >> 20),
+                static_cast<unsigned long long>(rss_before >> 20));
+    std::filesystem::remove(input);
+    std::filesystem::remove(output);
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    if (argc > 2) {
+        return run_one(std::stod(argv[1]), argv[2]);
+    }
+    int rc = 0;
+    for (const char *kind : {"m4a", "aac"}) {
+        for (const char *hours : {"1", "10", "24"}) {
+            const std::string cmd = std::string("\"") + argv[0] + "\" " + hours + " " + kind;
+            rc |= std::system(cmd.c_str());
+        }
+    }
+    return rc == 0 ? 0 : 1;
+}
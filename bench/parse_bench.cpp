@@ -0,0 +1,56 @@
+//
+//  parse_bench.cpp
+//  ChapterForge
+//
+//  Measures parse_mp4 wall time and heap traffic on a synthetic 10-hour audiobook.
+//  Usage: parse_bench [hours] [iterations]
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include "bench_utils.hpp"
+#include "parser.hpp"
+
+int main(int argc, char **argv) {
+    bench::LongFixture fx;
+    int iterations = 5;
+    if (argc > 1) {
+        fx.hours = std::stod(argv[1]);
+    }
+    if (argc > 2) {
+        iterations = std::max(1, std::stoi(argv[2]));
+    }
+
+    const auto path = std::filesystem::temp_directory_path() / "chapterforge_parse_bench.m4a";
+    const auto info = bench::write_long_fixture(path, fx);
+    std::printf("fixture: %.1fh samples=%u file=%llu moov=%llu\n", fx.hours, info.audio_samples,
+                static_cast<unsigned long long>(info.file_size),
+                static_cast<unsigned long long>(info.moov_size));
+
+    double best_ms = 1e30;
+    double total_ms = 0.0;
+    bench::HeapSnapshot per_parse{};
+    for (int i = 0; i < iterations; ++i) {
+        const auto heap_before = bench::heap_now();
+        const auto t0 = std::chrono::steady_clock::now();
+        auto parsed = parse_mp4(path.string());
+        const double ms = bench::ms_since(t0);
+        const auto heap_after = bench::heap_now();
+        if (!parsed || parsed->stsz.empty()) {
+            std::fprintf(stderr, "parse failed\n");
+            return 1;
+        }
+        best_ms = std::min(best_ms, ms);
+        total_ms += ms;
+        per_parse = {heap_after.bytes - heap_before.bytes, heap_after.count - heap_before.count};
+    }
+
+    std::printf("parse_mp4: best=%.3f ms mean=%.3f ms heap_bytes=%llu allocations=%llu\n", best_ms,
+                total_ms / iterations, static_cast<unsigned long long>(per_parse.bytes),
+                static_cast<unsigned long long>(per_parse.count));
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,133 @@
+//
+//  sample_table_bench.cpp
+//  ChapterForge
+//
+//  Microbenchmarks for SampleTable on a 2M-sample track: build cost, random sample -> offset and
+//  time -> sample lookups, and the former per-chunk stsc rescan for comparison.
+//  Usage: sample_table_bench [samples] [stsc_entries]
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "bench_utils.hpp"
+#include "sample_table.hpp"
+
+namespace {
+
+constexpr uint32_t kFrame = 1024;
+
+struct Tables {
+    std::vector<uint8_t> stsz, stsc, stco, stts;
+};
+
+// Chunks alternate between runs of 21- and 20-sample chunks so stsc has `entries` rows.
+Tables make_tables(uint32_t samples, uint32_t entries) {
+    using parser_test_utils::write_u32_be;
+    Tables t;
+    t.stsz = bench::make_full_box(0);  // sample_size = 0 (table follows)
+    write_u32_be(t.stsz, samples);
+    for (uint32_t i = 0; i < samples; ++i) {
+        write_u32_be(t.stsz, 170 + (i * 2654435761u >> 27));
+    }
+    const uint32_t chunks = samples / 20 + 1;
+    const uint32_t run = std::max<uint32_t>(1, chunks / std::max<uint32_t>(1, entries));
+    const uint32_t rows = (chunks + run - 1) / run;
+    t.stsc = bench::make_full_box(rows);
+    for (uint32_t r = 0; r < rows; ++r) {
+        write_u32_be(t.stsc, 1 + r * run);
+        write_u32_be(t.stsc, r % 2 ? 20 : 21);
+        write_u32_be(t.stsc, 1);
+    }
+    t.stco = bench::make_full_box(chunks);
+    for (uint32_t c = 0; c < chunks; ++c) {
+        write_u32_be(t.stco, 4096 + c * 4200);
+    }
+    t.stts = bench::make_full_box(1);
+    write_u32_be(t.stts, samples);
+    write_u32_be(t.stts, kFrame);
+    return t;
+}
+
+// The reader's former mapping: for every chunk, linearly search stsc for the covering entry.
+uint64_t legacy_rescan(const Tables &t) {
+    auto be32 = [](const uint8_t *p) {
+        return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+    };
+    const uint32_t chunks = be32(t.stco.data() + 4);
+    const uint32_t entries = be32(t.stsc.data() + 4);
+    uint64_t checksum = 0;
+    for (uint32_t chunk = 1; chunk <= chunks; ++chunk) {
+        uint32_t per_chunk = be32(t.stsc.data() + 8 + (entries - 1) * 12 + 4);
+        for (uint32_t e = 0; e + 1 < entries; ++e) {
+            const uint8_t *p = t.stsc.data() + 8 + e * 12;
+            if (chunk >= be32(p) && chunk < be32(p + 12)) {
+                per_chunk = be32(p + 4);
+                break;
+            }
+        }
+        checksum += per_chunk;
+    }
+    return checksum;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    uint32_t samples = 2'000'000;
+    uint32_t entries = 2000;
+    if (argc > 1) {
+        samples = static_cast<uint32_t>(std::stoul(argv[1]));
+    }
+    if (argc > 2) {
+        entries = static_cast<uint32_t>(std::stoul(argv[2]));
+    }
+    const Tables t = make_tables(samples, entries);
+    std::printf("tables: samples=%u stsc_bytes=%zu\n", samples, t.stsc.size());
+
+    auto heap_before = bench::heap_now();
+    auto t0 = std::chrono::steady_clock::now();
+    auto table = SampleTable::build(t.stsz, t.stsc, t.stco, t.stts);
+    const double build_ms = bench::ms_since(t0);
+    const auto heap_after = bench::heap_now();
+    if (!table) {
+        std::fprintf(stderr, "build failed\n");
+        return 1;
+    }
+    std::printf("build: %.2f ms heap_bytes=%llu allocations=%llu\n", build_ms,
+                static_cast<unsigned long long>(heap_after.bytes - heap_before.bytes),
+                static_cast<unsigned long long>(heap_after.count - heap_before.count));
+
+    std::mt19937_64 rng(42);
+    constexpr int kLookups = 10'000'000;
+    std::vector<uint32_t> picks(kLookups);
+    for (auto &p : picks) {
+        p = static_cast<uint32_t>(rng() % table->sample_count());
+    }
+    uint64_t sum = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (uint32_t p : picks) {
+        sum += table->offset(p) + table->size(p);
+    }
+    const double offset_ms = bench::ms_since(t0);
+    std::printf("sample->offset: %.2f ns/lookup\n", offset_ms * 1e6 / kLookups);
+
+    const uint64_t span = uint64_t(table->sample_count()) * kFrame;
+    for (auto &p : picks) {
+        p = static_cast<uint32_t>(rng() % span);
+    }
+    t0 = std::chrono::steady_clock::now();
+    for (uint32_t p : picks) {
+        sum += table->sample_at_time(p).value_or(0);
+    }
+    const double time_ms = bench::ms_since(t0);
+    std::printf("time->sample: %.2f ns/lookup\n", time_ms * 1e6 / kLookups);
+
+    t0 = std::chrono::steady_clock::now();
+    sum += legacy_rescan(t);
+    std::printf("legacy per-chunk stsc rescan: %.2f ms (checksum %llu)\n", bench::ms_since(t0),
+                static_cast<unsigned long long>(sum % 1000));
+    return 0;
+}
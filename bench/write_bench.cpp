@@ -0,0 +1,113 @@
+//
+//  write_bench.cpp
+//  ChapterForge
+//
+//  Output path benchmark on an mdat-like payload of many small separately allocated samples
+//  followed by cover-sized images: per-sample std::ofstream writes against FileWriter's buffered
+//  stream writes and its gathered (pwritev) writes, with syscall counts for the latter.
+//  Usage: write_bench [samples] [images]
+//
+
+#include <cstdio>
+#include <span>
+#include <string>
+
+#include "bench_utils.hpp"
+#include "file_writer.hpp"
+
+namespace {
+
+struct Payload {
+    std::vector<std::vector<uint8_t>> samples;
+    uint64_t bytes = 0;
+};
+
+Payload make_payload(uint32_t samples, uint32_t images) {
+    Payload p;
+    p.samples.reserve(samples + images);
+    for (uint32_t i = 0; i < samples; ++i) {
+        p.samples.emplace_back(170 + (i * 2654435761u >> 27), static_cast<uint8_t>(i));
+        p.bytes += p.samples.back().size();
+    }
+    for (uint32_t i = 0; i < images; ++i) {
+        p.samples.emplace_back(150 * 1024 + i * 97, static_cast<uint8_t>(i));
+        p.bytes += p.samples.back().size();
+    }
+    return p;
+}
+
+void report(const char *what, double ms, uint64_t bytes, const FileWriter::Stats *stats) {
+    std::printf("%-22s %8.2f ms %8.1f MB/s", what, ms, bytes / (ms * 1000.0));
+    if (stats != nullptr) {
+        std::printf("  syscalls=%llu writes=%llu vectored=%llu preallocated=%llu",
+                    static_cast<unsigned long long>(stats->syscalls),
+                    static_cast<unsigned long long>(stats->writes),
+                    static_cast<unsigned long long>(stats->vectored_writes),
+                    static_cast<unsigned long long>(stats->preallocated));
+    }
+    std::printf("\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    uint32_t samples = 2'000'000;
+    uint32_t images = 120;
+    if (argc > 1) {
+        samples = static_cast<uint32_t>(std::stoul(argv[1]));
+    }
+    if (argc > 2) {
+        images = static_cast<uint32_t>(std::stoul(argv[2]));
+    }
+    const Payload payload = make_payload(samples, images);
+    const auto path = std::filesystem::temp_directory_path() / "chapterforge_write_bench.bin";
+    std::printf("payload: %u samples + %u images, %.1f MB\n", samples, images,
+                payload.bytes / 1e6);
+
+    auto t0 = std::chrono::steady_clock::now();
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        for (const auto &s : payload.samples) {
+            out.write(reinterpret_cast<const char *>(s.data()), std::streamsize(s.size()));
+        }
+    }
+    report("ofstream per sample", bench::ms_since(t0), payload.bytes, nullptr);
+
+    for (bool preallocate : {false, true}) {
+        t0 = std::chrono::steady_clock::now();
+        auto writer = FileWriter::create(path.string());
+        if (!writer) {
+            std::fprintf(stderr, "cannot create %s\n", path.string().c_str());
+            return 1;
+        }
+        if (preallocate) {
+            writer->reserve(payload.bytes);
+        }
+        std::ostream out(writer.get());
+        for (const auto &s : payload.samples) {
+            out.write(reinterpret_cast<const char *>(s.data()), std::streamsize(s.size()));
+        }
+        writer->close();
+        report(preallocate ? "FileWriter + reserve" : "FileWriter stream", bench::ms_since(t0),
+               payload.bytes, &writer->stats());
+    }
+
+    for (bool preallocate : {false, true}) {
+        t0 = std::chrono::steady_clock::now();
+        auto writer = FileWriter::create(path.string());
+        if (!writer) {
+            return 1;
+        }
+        if (preallocate) {
+            writer->reserve(payload.bytes);
+        }
+        const std::vector<std::span<const uint8_t>> pieces(payload.samples.begin(),
+                                                           payload.samples.end());
+        writer->write_gather(pieces);
+        writer->close();
+        report(preallocate ? "write_gather + reserve" : "write_gather", bench::ms_since(t0),
+               payload.bytes, &writer->stats());
+    }
+    std::filesystem::remove(path);
+    return 0;
+}
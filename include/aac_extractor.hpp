@@ -8,13 +8,15 @@
 
 #pragma once
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "frame_store.hpp"
+
 struct AacExtractResult {
-    std::vector<std::vector<uint8_t>> frames;  // raw AAC frames (ADTS header stripped)
-    std::vector<uint32_t> sizes;               // raw frame sizes
+    FrameStore frames;  // raw AAC frames (ADTS header stripped) and their sizes
 
     uint32_t sample_rate = 0;
     uint8_t sampling_index = 0;
@@ -25,8 +27,11 @@ struct AacExtractResult {
     std::vector<uint8_t> stsd_payload;
     std::vector<uint8_t> stts_payload;
     std::vector<uint8_t> stsc_payload;
-    std::vector<uint8_t> stsz_payload;
+    std::vector<uint8_t> stsz_payload;  // header only when sizes vary (entries are in frames)
     std::vector<uint8_t> stco_payload;
+    // Absolute file offsets of the source's audio chunks (MP4 inputs); an in-place update keeps
+    // the audio where it is and points the new moov at these.
+    std::vector<uint64_t> chunk_offsets;
 
     // Optional: original meta/ilst payloads (when source is MP4/M4A)
     std::vector<uint8_t> meta_payload;
@@ -38,6 +43,11 @@ struct AacExtractResult {
  */
 AacExtractResult extract_adts_frames(const std::vector<uint8_t> &data);
 
+/**
+ * @brief Extract AAC frames from a mapped ADTS file; frames reference the mapping in place.
+ */
+AacExtractResult extract_adts_frames(std::shared_ptr<const MappedFile> file);
+
 /**
  * @brief Extract AAC frames and related tables from an MP4/M4A source.
  *
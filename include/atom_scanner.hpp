@@ -0,0 +1,53 @@
+//
+//  atom_scanner.hpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+
+// Instruction set used to locate fourcc candidates.
+enum class ScanIsa { Scalar, Sse2, Avx2 };
+
+// Best candidate finder supported by this CPU (runtime detected).
+ScanIsa best_scan_isa();
+
+// One fourcc the recovery scan is looking for. `payload`/`offset` describe the first box of this
+// type whose size and table header are consistent with the scanned buffer.
+struct AtomScanTarget {
+    uint32_t type = 0;
+    bool found = false;
+    uint64_t offset = 0;  // box start (size field) within the scanned buffer.
+    std::span<const uint8_t> payload;
+
+    // Target for `type`; `found` skips a table that is already known.
+    static AtomScanTarget of(uint32_t type, bool found = false) { return {type, found, 0, {}}; }
+};
+
+struct AtomScanOptions {
+    // The buffer is consumed in windows of this size; `on_window_done` runs after each one so
+    // callers backed by a mapping can release pages that were already scanned.
+    size_t window_bytes = 8 * 1024 * 1024;
+    std::function<void(size_t begin, size_t end)> on_window_done;
+    // Runs for each candidate of a target still searched for whose box runs past the end of the
+    // buffer, in ascending order; callers scanning a larger input window by window continue
+    // from the first one so that box can be validated whole.
+    std::function<void(uint64_t box, uint64_t size)> on_cut_box;
+    // Force a candidate finder (tests/benchmarks); defaults to best_scan_isa().
+    std::optional<ScanIsa> isa;
+};
+
+// Single pass over `data` that fills every target at once. Candidate fourcc positions are found
+// with SIMD (AVX2/SSE2, memchr fallback), then validated: the box must fit in `data` and sample
+// tables must have entry counts that fit their payload. Stops early once all targets are found.
+// Returns the number of bytes examined.
+uint64_t scan_atoms(std::span<const uint8_t> data, std::span<AtomScanTarget> targets,
+                    const AtomScanOptions &options = {});
@@ -0,0 +1,81 @@
+//
+//  box_writer.hpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Serializes nested MP4 boxes into one contiguous buffer. open() appends a box header with a
+// placeholder size; the returned Scope writes the real size once the box is complete, so
+// nothing needs to be measured up front. Boxes that outgrow 32 bits get the largesize header.
+class BoxWriter {
+  public:
+    // Open box; closing it (explicitly or on destruction) back-patches its size.
+    class Scope {
+      public:
+        Scope(Scope &&other) noexcept : writer_(other.writer_), start_(other.start_) {
+            other.writer_ = nullptr;
+        }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+        Scope &operator=(Scope &&) = delete;
+        ~Scope() { close(); }
+
+        void close() {
+            if (writer_ != nullptr) {
+                writer_->close_box(start_);
+                writer_ = nullptr;
+            }
+        }
+
+      private:
+        friend class BoxWriter;
+        Scope(BoxWriter *writer, size_t start) : writer_(writer), start_(start) {}
+
+        BoxWriter *writer_;
+        size_t start_;
+    };
+
+    explicit BoxWriter(size_t reserve = 0) { buffer_.reserve(reserve); }
+
+    [[nodiscard]] Scope open(uint32_t type);
+
+    void bytes(std::span<const uint8_t> data) {
+        buffer_.insert(buffer_.end(), data.begin(), data.end());
+    }
+
+    size_t size() const { return buffer_.size(); }
+    const std::vector<uint8_t> &buffer() const { return buffer_; }
+    std::vector<uint8_t> release() { return std::move(buffer_); }
+
+  private:
+    void close_box(size_t start);
+
+    std::vector<uint8_t> buffer_;
+};
+
+// Byte image of a fixed-layout payload, built at compile time; builders copy it and patch the
+// few variable fields at their fixed offsets.
+template <size_t N>
+struct FixedPayload {
+    std::array<uint8_t, N> bytes{};
+
+    constexpr void put(size_t at, uint64_t v, int width) {
+        for (int i = 0; i < width; ++i) {
+            bytes[at + i] = static_cast<uint8_t>(v >> (8 * (width - 1 - i)));
+        }
+    }
+    constexpr void put_u16(size_t at, uint16_t v) { put(at, v, 2); }
+    constexpr void put_u24(size_t at, uint32_t v) { put(at, v, 3); }
+    constexpr void put_u32(size_t at, uint32_t v) { put(at, v, 4); }
+
+    std::vector<uint8_t> to_vector() const { return {bytes.begin(), bytes.end()}; }
+};
@@ -0,0 +1,28 @@
+//
+//  byte_order.hpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// Instruction set used to convert sample tables between host and big-endian byte order.
+enum class SwapIsa { Scalar, Ssse3, Avx2, Neon };
+
+// Best conversion kernel supported by this CPU (runtime detected).
+SwapIsa best_swap_isa();
+
+// Bulk conversion between host integers and the big-endian fields of MP4 tables (stsz, stco,
+// co64, stts, stsc). Byte shuffles convert 16 (SSSE3/NEON) or 32 (AVX2) bytes per step; the tail
+// and other CPUs take the scalar path. `out`/`in` need no alignment and must hold 4 or 8 bytes
+// per value. `isa` forces a kernel (tests/benchmarks); it must be supported by the CPU.
+void store_be32(std::span<const uint32_t> values, uint8_t *out, SwapIsa isa = best_swap_isa());
+void load_be32(const uint8_t *in, std::span<uint32_t> values, SwapIsa isa = best_swap_isa());
+void store_be64(std::span<const uint64_t> values, uint8_t *out, SwapIsa isa = best_swap_isa());
+void load_be64(const uint8_t *in, std::span<uint64_t> values, SwapIsa isa = best_swap_isa());
@@ -7,7 +7,12 @@
 //
 
 #pragma once
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <span>
 #include <stdint.h>
 #include <string>
 #include <vector>
@@ -15,6 +20,7 @@
 #include "chapter_image_sample.hpp"
 #include "chapter_text_sample.hpp"
 #include "metadata_set.hpp"
+#include "random_access_source.hpp"
 
 namespace chapterforge {
 
@@ -101,6 +107,39 @@ Status mux_file_to_m4a(const std::string &input_audio_path,
                           const MetadataSet &metadata, const std::string &output_path,
                           bool fast_start = true);  ///< @ingroup api
 
+/// Options for mux_file_to_m4a().
+struct MuxOptions {
+    /// When true, places moov ahead of mdat.
+    bool fast_start{true};
+    /// Threads writing the output; 0 or 1 writes sequentially. Once the layout is planned every
+    /// byte position of the output is known, so the boxes around the mdat payload are written
+    /// first and the payload follows as independent regions written concurrently with positional
+    /// writes: the audio cut at chunk boundaries into ranges of at least 8 MB, each text track
+    /// and the image track. The file is byte-identical to a sequential write. Pays off for
+    /// multi-GB outputs on storage with several queues (NVMe); small files see no gain.
+    unsigned write_threads{1};
+};
+
+/// @overload with mux options (JSON driven).
+Status mux_file_to_m4a(const std::string &input_audio_path,
+                       const std::string &chapter_json_path, const std::string &output_path,
+                       const MuxOptions &options);  ///< @ingroup api
+
+/// @overload with mux options (in-memory titles, URLs, images and metadata).
+Status mux_file_to_m4a(const std::string &input_audio_path,
+                       const std::vector<ChapterTextSample> &text_chapters,
+                       const std::vector<ChapterTextSample> &url_chapters,
+                       const std::vector<ChapterImageSample> &image_chapters,
+                       const MetadataSet &metadata, const std::string &output_path,
+                       const MuxOptions &options);  ///< @ingroup api
+
+/// I/O spent by one read_m4a() call.
+struct IoStats {
+    uint64_t opens{0};  ///< times the file was opened; 0 when reading a RandomAccessSource.
+    uint64_t reads{0};  ///< positional read requests (round trips to a RandomAccessSource).
+    uint64_t bytes{0};  ///< bytes read; a damaged file scanned whole counts its full size.
+};
+
 /**
  * @brief Parse an existing M4A/MP4 file and return its chapter data.
  *
@@ -109,6 +148,11 @@ Status mux_file_to_m4a(const std::string &input_audio_path,
  *
  * On success `status.ok == true` and the vectors are filled; on failure `status.ok == false` and
  * `status.message` contains a short description.
+ *
+ * The file is opened once. Top-level atom headers and moov are fetched with positional reads,
+ * then chapter samples with a few large ones: sample ranges are sorted and adjacent ones merged,
+ * so the read count tracks the number of contiguous runs, not chapters. Only a damaged file
+ * whose sample tables must be recovered is scanned whole.
  */
 struct ReadResult {
     Status status;
@@ -116,10 +160,276 @@ struct ReadResult {
     std::vector<ChapterTextSample> urls;
     std::vector<ChapterImageSample> images;
     MetadataSet metadata;
+    IoStats io;  ///< I/O spent by this call, also reported on failure.
 };
 
 ReadResult read_m4a(const std::string &path);  ///< @ingroup api
 
+/// Options for read_m4a().
+struct ReadOptions {
+    /// Threads used to extract chapter samples; 0 uses the hardware concurrency. The text tracks
+    /// and chunks of the image track are read concurrently with positional reads through one
+    /// file handle or source. The result is identical for every thread count.
+    unsigned threads{1};
+    /// Upper bound on bytes read from the file (0 = unlimited). A read that would exceed it fails
+    /// the call with a status message instead of touching the file.
+    uint64_t max_bytes{0};
+    /// Stream reads only: bytes held in memory while a stream is buffered (its moov not yet
+    /// seen) before the rest spills to a temporary file.
+    uint64_t spill_threshold{16ull * 1024 * 1024};
+};
+
+/// @overload with extraction options.
+ReadResult read_m4a(const std::string &path, const ReadOptions &options);  ///< @ingroup api
+
+/**
+ * @overload reading from a caller-provided byte source (memory, object storage, ...).
+ *
+ * Parsing and extraction issue the same positional reads as for a file. When the source reports
+ * a minimum request size, small reads are widened into read-ahead and nearby sample ranges are
+ * fetched together, so a high-latency source sees few round trips (`io.reads`). A damaged input
+ * whose sample tables must be recovered is scanned in 8 MB windows read one after the other, so
+ * memory stays bounded while the scan, like that of a mapped file, may cover the whole input.
+ */
+ReadResult read_m4a(std::shared_ptr<RandomAccessSource> source,
+                    const ReadOptions &options = {});  ///< @ingroup api
+
+/**
+ * @overload reading from a stream that can only be read once, front to back (a pipe, stdin).
+ *
+ * The stream is consumed in chunks and parsed as it arrives. Once moov has been seen only the
+ * chapter samples are kept, and reading stops as soon as the last of them has arrived; so a
+ * fast-start file is never buffered. Everything before a trailing moov is buffered, in memory up
+ * to `options.spill_threshold` and in a temporary file beyond. `io.reads` counts the chunks read
+ * and `io.bytes` the bytes consumed; `options.max_bytes` bounds the latter.
+ */
+ReadResult read_m4a(std::istream &in, const ReadOptions &options = {});  ///< @ingroup api
+
+/// Options for read_m4a_batch().
+struct BatchOptions {
+    /// Files read at once; 0 uses the hardware concurrency.
+    unsigned threads{0};
+    /// Applied to every file. `read.threads` stays 1 by default: the batch parallelises across
+    /// files, not within one.
+    ReadOptions read;
+};
+
+/// Receives one file's result: its index into the `paths` passed to read_m4a_batch().
+using BatchResultFn = std::function<void(size_t index, ReadResult result)>;
+
+/**
+ * @brief Read many files in one process, e.g. to index a whole library.
+ *
+ * Files are spread over `options.threads` workers that steal from each other, so a few huge
+ * files do not leave the other workers idle. Each result goes to `on_result` as soon as its file
+ * is done, in completion order, and is not kept afterwards; calls to `on_result` never overlap,
+ * so it needs no locking. A worker waits while `on_result` runs, which bounds the results in
+ * flight to one per worker. Per-file failures are reported in the result's status and do not stop
+ * the batch. Returns the number of files whose status is not ok.
+ */
+size_t read_m4a_batch(const std::vector<std::string> &paths, const BatchOptions &options,
+                      const BatchResultFn &on_result);  ///< @ingroup api
+
+/// Counters of the parse cache, see set_parse_cache_capacity().
+struct ParseCacheStats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t evictions{0};  ///< entries dropped to stay within the byte budget.
+    uint64_t entries{0};
+    uint64_t bytes{0};  ///< moov copies and sample tables currently held.
+    uint64_t max_bytes{0};
+};
+
+/**
+ * @brief Enable the in-process cache of parsed container structure; 0 disables and empties it.
+ *
+ * While enabled, read_m4a() on a path and mux_file_to_m4a() with an .m4a/.mp4 input reuse the
+ * parsed moov (tracks, sample tables, ilst) of a file seen before instead of reading and parsing
+ * it again. Entries are keyed by device, inode, size and modification time taken from the opened
+ * file, so a replaced or rewritten file is parsed afresh; the least recently used entries are
+ * dropped once `max_bytes` is exceeded. Damaged files that need a recovery scan are not cached.
+ * Disabled by default; safe to use from several threads.
+ */
+void set_parse_cache_capacity(uint64_t max_bytes);  ///< @ingroup api
+/// Drop the cached entries of `path` (spelled as passed to the read or mux call); returns how
+/// many were dropped.
+size_t invalidate_parse_cache(const std::string &path);  ///< @ingroup api
+void clear_parse_cache();                                 ///< @ingroup api
+ParseCacheStats parse_cache_stats();                      ///< @ingroup api
+
+/**
+ * @brief Write the sidecar index `<path>.cfidx` of an .m4a/.mp4 file.
+ *
+ * The index keeps the file's track tables, metadata and audio chunk layout in a memory-mappable
+ * form. Afterwards read_m4a() on the path and mux_file_to_m4a() with it as input map the index
+ * instead of reading and parsing the file's moov. The index records the file's size and
+ * modification time and is ignored once either changes (or when it is damaged); rewrite it after
+ * editing the file. Files whose sample tables need a recovery scan are refused.
+ */
+Status write_index(const std::string &path);  ///< @ingroup api
+
+/// Per-track summary reported by probe_m4a().
+struct ProbeTrack {
+    uint32_t track_id{0};
+    std::string handler;  ///< handler type as fourcc text, e.g. "soun", "text", "vide".
+    std::string name;     ///< hdlr name.
+    uint32_t timescale{0};
+    uint64_t duration{0};  ///< in timescale units.
+    uint64_t duration_ms{0};
+    uint32_t sample_count{0};
+};
+
+/**
+ * @brief Lightweight summary of an M4A/MP4 file produced by probe_m4a().
+ *
+ * `bytes_read` counts every byte read from the file: top-level atom headers plus the moov atom
+ * (plus a tail window when damaged top-level sizes force a tail search).
+ */
+struct ProbeResult {
+    Status status;
+    std::vector<ProbeTrack> tracks;
+    uint64_t audio_duration_ms{0};
+    size_t chapter_count{0};
+    std::vector<uint32_t> chapter_starts_ms;
+    bool has_urls{false};
+    bool has_images{false};
+    bool has_cover{false};
+    uint64_t moov_size{0};
+    uint64_t bytes_read{0};
+};
+
+/**
+ * @brief Summarize tracks, durations and chapters without reading media data.
+ *
+ * Locates moov by walking top-level atom headers with positional reads (falling back to a
+ * tail-window search when sizes are damaged), reads only moov and parses it in memory. mdat
+ * payloads and chapter samples are never read, so cost is O(moov) regardless of file size.
+ */
+ProbeResult probe_m4a(const std::string &path);  ///< @ingroup api
+
+/**
+ * @brief Random access to individual chapters of an M4A file.
+ *
+ * open() locates and parses only `moov` (like probe_m4a()) and keeps the file open. Titles, URLs
+ * and images are then fetched one chapter at a time with positional reads of exactly that sample,
+ * so serving chapter N's image costs one read of its bytes regardless of how many chapters the
+ * file has. URLs and images are paired with titles by start time, as in read_m4a().
+ *
+ * Accessors are not thread-safe; use one reader per thread.
+ */
+class ChapterReader {
+  public:
+    /// Returns nullptr when the file cannot be opened or has no parsable moov; `status` (if
+    /// given) carries the reason.
+    static std::unique_ptr<ChapterReader> open(const std::string &path,
+                                               Status *status = nullptr);  ///< @ingroup api
+
+    ~ChapterReader();
+    ChapterReader(const ChapterReader &) = delete;
+    ChapterReader &operator=(const ChapterReader &) = delete;
+
+    /// Number of chapters (title samples).
+    size_t count() const;
+    /// Start time of chapter `i` in milliseconds.
+    uint32_t start_ms(size_t i) const;
+    /// Title of chapter `i`; empty when `i` is out of range or the sample cannot be read.
+    std::string title(size_t i);
+    /// URL (href) of chapter `i`; empty when the chapter has none.
+    std::string url(size_t i);
+    /// Size in bytes of chapter `i`'s image; 0 when the chapter has none.
+    size_t image_size(size_t i) const;
+    /// Read chapter `i`'s image into the front of `dst`, which must hold at least image_size(i)
+    /// bytes. Returns false when there is no image, `dst` is too small or the read fails.
+    bool read_image(size_t i, std::span<uint8_t> dst);
+
+    /// Bytes read from the file so far (moov plus every sample fetched).
+    uint64_t bytes_read() const;
+
+  private:
+    struct Impl;
+    explicit ChapterReader(std::unique_ptr<Impl> impl);
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Replace the chapters and metadata of an existing M4A without rewriting its audio.
+ *
+ * The file gets the moov and chapter tracks mux_file_to_m4a() would write for the same inputs,
+ * but its audio stays where it is: only the new chapter samples (into free space or appended) and
+ * the moov are written. The moov is rewritten in place when it fits the old one plus adjacent
+ * `free` boxes; otherwise it is appended and the old one becomes `free`, so the file is then no
+ * longer fast-start. Space of replaced chapter samples becomes `free` and is reused by later
+ * updates.
+ *
+ * The update is crash-safe: new data only goes where nothing refers to it yet, and the few bytes
+ * that switch the file over are first made durable in `<path>.cfupdate`. Until that journal is
+ * complete the file is unchanged; after a crash past that point the next update or
+ * recover_chapter_update() on the path finishes it. Readers must not use the file while it is
+ * updated. An existing `<path>.cfidx` index is rewritten for the new chapters, or removed if that
+ * fails.
+ *
+ * @param path M4A/MP4 file with AAC audio to update.
+ * @param text_chapters Chapter titles (text/start_ms; href optional).
+ * @param url_chapters Optional URL track; leave empty to omit.
+ * @param image_chapters Optional JPEG data per chapter; leave empty to omit.
+ * @param metadata Top-level metadata; the file's own ilst is kept if empty.
+ */
+Status update_chapters_in_place(const std::string &path,
+                                const std::vector<ChapterTextSample> &text_chapters,
+                                const std::vector<ChapterTextSample> &url_chapters,
+                                const std::vector<ChapterImageSample> &image_chapters,
+                                const MetadataSet &metadata);  ///< @ingroup api
+
+/// @overload chapters and metadata from a JSON file, as for mux_file_to_m4a().
+Status update_chapters_in_place(const std::string &path,
+                                const std::string &chapter_json_path);  ///< @ingroup api
+
+/// Finish an update_chapters_in_place() of `path` interrupted by a crash, if one is pending.
+Status recover_chapter_update(const std::string &path);  ///< @ingroup api
+
+/// Per-track placement reported by plan_m4a().
+struct PlanTrack {
+    std::string handler;  ///< "soun", "text" or "vide".
+    std::string name;     ///< hdlr name that will be written.
+    uint32_t sample_count{0};
+    uint32_t chunk_count{0};
+    uint64_t bytes{0};   ///< payload bytes inside mdat.
+    uint64_t offset{0};  ///< absolute file offset of the track's first chunk.
+};
+
+/**
+ * @brief Exact output layout of a mux, computed without writing anything.
+ *
+ * Offsets and sizes match byte for byte what mux_file_to_m4a() would produce for the same
+ * inputs. Tracks are listed in mdat order (audio, titles, URLs, images).
+ */
+struct PlanResult {
+    Status status;
+    uint64_t file_size{0};
+    uint64_t moov_offset{0};
+    uint64_t moov_size{0};
+    uint64_t mdat_offset{0};
+    uint64_t mdat_size{0};
+    bool fast_start{true};
+    std::vector<PlanTrack> tracks;
+};
+
+/**
+ * @brief Dry-run a mux: report the output size and layout without creating the output file.
+ *
+ * Audio is indexed (sample sizes only) and the full moov is built, but no media payload is
+ * copied, so cost is independent of how the output would be written.
+ */
+PlanResult plan_m4a(const std::string &input_audio_path, const std::string &chapter_json_path,
+                    bool fast_start = true);  ///< @ingroup api
+
+/// @overload in-memory chapter data; mirrors the matching mux_file_to_m4a() overload.
+PlanResult plan_m4a(const std::string &input_audio_path,
+                    const std::vector<ChapterTextSample> &text_chapters,
+                    const std::vector<ChapterTextSample> &url_chapters,
+                    const std::vector<ChapterImageSample> &image_chapters,
+                    const MetadataSet &metadata, bool fast_start = true);  ///< @ingroup api
+
 /// @}
 
 }  // namespace chapterforge
@@ -0,0 +1,56 @@
+//
+//  coalesced_reads.hpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace chapterforge {
+class RandomAccessSource;
+}
+
+// Fetches many small ranges (chapter samples) with few positional reads. Ranges are sorted by
+// offset and merged while the hole to the next range is at most `max_gap` bytes and the merged
+// span stays within `max_span` (a single larger range still gets a span of its own). Spans are
+// read one at a time into a reused buffer, so memory is bounded by the largest span.
+class CoalescedReads {
+  public:
+    struct Range {
+        uint64_t offset = 0;
+        uint32_t size = 0;
+    };
+    // Receives the index of a range (in the order passed to read()) and its bytes, which stay
+    // valid only for the duration of the call.
+    using Visitor = std::function<void(size_t, std::span<const uint8_t>)>;
+
+    // Reading a hole this small costs less than another read call.
+    static constexpr uint64_t kDefaultMaxGap = 32 * 1024;
+    static constexpr uint64_t kDefaultMaxSpan = 4 * 1024 * 1024;
+
+    explicit CoalescedReads(uint64_t max_gap = kDefaultMaxGap,
+                            uint64_t max_span = kDefaultMaxSpan)
+        : max_gap_(max_gap), max_span_(max_span) {}
+
+    // Visits every range in offset order. Returns false when a range lies outside the source or
+    // a read fails; ranges of earlier spans have been visited by then.
+    bool read(chapterforge::RandomAccessSource &source, std::span<const Range> ranges,
+              const Visitor &visit);
+
+    // Merged spans issued by the last read(), i.e. read_at calls before short-read retries.
+    size_t span_count() const { return span_count_; }
+
+  private:
+    uint64_t max_gap_;
+    uint64_t max_span_;
+    std::vector<uint8_t> buffer_;
+    size_t span_count_ = 0;
+};
@@ -0,0 +1,106 @@
+//
+//  file_writer.hpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <streambuf>
+#include <string>
+
+#include "mapped_file.hpp"
+
+// Buffered, seekable output file usable as the streambuf of a std::ostream. Stream writes go
+// through a 4 MiB page-aligned buffer. Besides them it can gather many separate byte ranges into
+// few vectored writes (pwritev), and move byte ranges of a mapped input straight into the output:
+// with copy_file_range on Linux (the data never enters process memory), otherwise by large
+// positional writes sourced from the mapping.
+class FileWriter : public std::streambuf {
+  public:
+    // Calls into the OS after create(), by kind, and the bytes they moved.
+    struct Stats {
+        uint64_t syscalls = 0;         // every call below plus hole probing (lseek)
+        uint64_t writes = 0;           // pwrite / WriteFile
+        uint64_t vectored_writes = 0;  // pwritev
+        uint64_t kernel_copies = 0;    // copy_file_range
+        uint64_t bytes_written = 0;    // through writes and vectored writes
+        uint64_t preallocated = 0;     // bytes reserved by reserve()
+    };
+
+    // Create or truncate `path`. Returns nullptr when the file cannot be opened.
+    static std::unique_ptr<FileWriter> create(const std::string &path);
+    // Open the existing `path` for writing in place, keeping its contents and size. Several such
+    // writers may fill disjoint ranges of one file concurrently. Returns nullptr on failure.
+    static std::unique_ptr<FileWriter> open_in_place(const std::string &path);
+
+    ~FileWriter() override;
+    FileWriter(const FileWriter &) = delete;
+    FileWriter &operator=(const FileWriter &) = delete;
+
+    // Append `length` bytes of `source` starting at `offset` at the current position. Holes in a
+    // sparse source stay holes where the kernel copy path is used. Returns false on range or I/O
+    // errors.
+    bool copy_range(const MappedFile &source, uint64_t offset, uint64_t length);
+
+    // Append `pieces` back to back at the current position with as few vectored writes as the
+    // OS allows (IOV_MAX pieces each); the bytes are not copied into the buffer. Returns false on
+    // I/O errors.
+    bool write_gather(std::span<const std::span<const uint8_t>> pieces);
+
+    // Allocate `size` bytes of disk space up front without changing the file size, so a large
+    // output is laid out contiguously (fallocate with FALLOC_FL_KEEP_SIZE, F_PREALLOCATE, or the
+    // allocation size on Windows). Best effort: false when unsupported, which is harmless.
+    bool reserve(uint64_t size);
+
+    // Flush the buffer and wait until everything written so far is on stable storage (fsync,
+    // F_FULLFSYNC on macOS, FlushFileBuffers on Windows). Returns false on any write error.
+    bool persist();
+
+    // Flush and close. Returns false if any write (including earlier ones) failed.
+    bool close();
+
+    // Bytes moved by the kernel without passing through userspace.
+    uint64_t kernel_copied_bytes() const { return kernel_copied_; }
+    const Stats &stats() const { return stats_; }
+
+  protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char *s, std::streamsize n) override;
+    int sync() override;
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                     std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+  private:
+    FileWriter() = default;
+
+    static std::unique_ptr<FileWriter> open_file(const std::string &path, bool truncate);
+    bool flush_buffer();
+    bool write_at(uint64_t pos, const uint8_t *data, size_t length);
+    bool kernel_copy(const MappedFile &source, uint64_t &offset, uint64_t &length);
+
+    struct AlignedFree {
+        void operator()(char *p) const;
+    };
+
+    std::unique_ptr<char[], AlignedFree> buffer_;
+    size_t buffer_size_ = 0;
+    Stats stats_;
+    uint64_t buffer_pos_ = 0;  // file offset of pbase()
+    uint64_t end_ = 0;         // highest offset written so far
+    uint64_t kernel_copied_ = 0;
+    bool kernel_copy_supported_ = true;
+    bool sparse_tail_ = false;  // file ends in a skipped hole that still needs extending
+    bool failed_ = false;
+#if defined(_WIN32)
+    void *handle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
@@ -0,0 +1,81 @@
+//
+//  fixed_boxes.hpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#pragma once
+
+#include "box_writer.hpp"
+
+// Compile-time payload images of the fixed-layout header boxes (version 0, as Apple writes them)
+// with the offsets of their variable fields.
+namespace fixed_boxes {
+
+// Identity transform in 16.16 / 2.30 fixed point.
+template <size_t N>
+constexpr void put_unity_matrix(FixedPayload<N> &p, size_t at) {
+    p.put_u32(at, 0x00010000);       // a
+    p.put_u32(at + 16, 0x00010000);  // d
+    p.put_u32(at + 32, 0x40000000);  // w
+}
+
+struct Tkhd {
+    static constexpr size_t kFlags = 1;
+    static constexpr size_t kTrackId = 12;
+    static constexpr size_t kDuration = 20;
+    static constexpr size_t kLayer = 32;
+    static constexpr size_t kAlternateGroup = 34;
+    static constexpr size_t kVolume = 36;
+    static constexpr size_t kWidth = 76;
+    static constexpr size_t kHeight = 80;
+    static constexpr FixedPayload<84> kTemplate = [] {
+        FixedPayload<84> p;
+        put_unity_matrix(p, 40);
+        return p;
+    }();
+};
+
+struct Mvhd {
+    static constexpr size_t kTimescale = 12;
+    static constexpr size_t kDuration = 16;
+    static constexpr size_t kNextTrackId = 96;
+    static constexpr FixedPayload<100> kTemplate = [] {
+        FixedPayload<100> p;
+        p.put_u32(20, 0x00010000);  // rate 1.0
+        p.put_u16(24, 0x0100);      // volume 1.0
+        // Matrix as the golden files carry it: a = d = 1.0, w left 0.
+        p.put_u32(36, 0x00010000);
+        p.put_u32(48, 0x00010000);
+        return p;
+    }();
+};
+
+struct Mdhd {
+    static constexpr size_t kTimescale = 12;
+    static constexpr size_t kDuration = 16;
+    static constexpr size_t kLanguage = 20;
+    static constexpr FixedPayload<24> kTemplate{};
+};
+
+// Fixed part of hdlr; the NUL-terminated name follows.
+struct Hdlr {
+    static constexpr size_t kHandlerType = 8;
+    static constexpr FixedPayload<24> kTemplate{};
+};
+
+struct Smhd {
+    static constexpr FixedPayload<8> kTemplate{};  // balance 0
+};
+
+struct Vmhd {
+    static constexpr FixedPayload<12> kTemplate = [] {
+        FixedPayload<12> p;
+        p.put_u24(1, 1);  // flags = 1, required by Apple
+        return p;
+    }();
+};
+
+}  // namespace fixed_boxes
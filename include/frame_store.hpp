@@ -0,0 +1,88 @@
+//
+//  frame_store.hpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "mapped_file.hpp"
+
+// Storage for many small media frames. Frames either live packed in one owned buffer (appended,
+// e.g. in-memory ADTS) or are referenced in place inside a source mapping (M4A and mapped ADTS
+// input), so neither path allocates per frame.
+//
+// Only frame sizes are kept per frame (4 bytes). Positions are stored as runs: frames laid out
+// back to back with a fixed gap between them (0 for M4A chunks, the ADTS header size for ADTS
+// streams), so a typical input needs a handful of runs. Frames are read in order through a
+// Cursor.
+class FrameStore {
+  public:
+    FrameStore() = default;
+
+    // Empty store referencing frames inside `source`; fill it with add().
+    static FrameStore view(std::shared_ptr<const MappedFile> source);
+
+    // View mode: reference the frame at `offset` of the source. Frames must be added in output
+    // order. Returns false when the frame lies outside the mapping.
+    bool add(uint64_t offset, uint32_t size);
+
+    // Owned mode: pre-size the index and the packed buffer, then append frames.
+    void reserve(size_t frames, size_t bytes);
+    void append(std::span<const uint8_t> frame);
+
+    size_t size() const { return sizes_.size(); }
+    bool empty() const { return sizes_.empty(); }
+    uint64_t total_bytes() const { return total_bytes_; }
+    bool is_view() const { return source_ != nullptr; }
+    // Mapping backing a view, nullptr for owned stores.
+    const MappedFile *source() const { return source_.get(); }
+    // Number of contiguous runs the frames were folded into.
+    size_t run_count() const { return runs_.size(); }
+
+    std::span<const uint32_t> sizes() const { return sizes_; }
+
+    // Sequential reader; next() must be called at most size() times.
+    class Cursor {
+      public:
+        explicit Cursor(const FrameStore &store) : store_(&store) {}
+        // Start at frame `first` (< size()); costs a walk over the frames of its run.
+        Cursor(const FrameStore &store, size_t first);
+        std::span<const uint8_t> next();
+
+      private:
+        const FrameStore *store_;
+        size_t frame_ = 0;
+        size_t run_ = 0;
+        uint64_t pos_ = 0;
+    };
+
+    // Copy viewed frames into an owned buffer and drop the mapping (needed when the source file
+    // is about to be overwritten). No-op for owned stores.
+    void materialize();
+
+  private:
+    struct Run {
+        uint64_t offset;  // position of the run's first frame
+        uint64_t first;   // index of the run's first frame
+        uint32_t gap;     // bytes between consecutive frames of the run
+    };
+
+    const uint8_t *base() const { return source_ ? source_->data() : owned_.data(); }
+    void push(uint64_t offset, uint32_t size);
+
+    std::shared_ptr<const MappedFile> source_;
+    std::vector<uint8_t> owned_;
+    std::vector<uint32_t> sizes_;
+    std::vector<Run> runs_;
+    uint64_t end_ = 0;  // end of the last frame
+    uint64_t total_bytes_ = 0;
+};
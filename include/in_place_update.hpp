@@ -0,0 +1,78 @@
+//
+//  in_place_update.hpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "random_access_file.hpp"
+
+// Building blocks of an in-place chapter update (see update_mp4_in_place): the top-level box map
+// of an existing file and the commit journal that switches it to a new moov.
+//
+// An update first writes everything new (chapter samples, a relocated moov) into bytes no box
+// refers to: the payload of free boxes or boxes appended as `free`. Only then does it record the
+// few header and moov bytes that switch the file over in a journal (`<media>.cfupdate`), make the
+// journal durable and apply it. A crash before the journal is complete leaves the old file plus
+// unused free space; a crash after it leaves a journal that replay_journal() applies again.
+namespace in_place {
+
+struct Box {
+    uint32_t type = 0;
+    uint64_t offset = 0;
+    uint64_t size = 0;  // including the header
+
+    uint64_t end() const { return offset + size; }
+};
+
+struct BoxMap {
+    std::vector<Box> boxes;
+    // Where new boxes may be appended: the file size, or the start of a free box cut short by an
+    // interrupted append (it is dropped from `boxes`).
+    uint64_t end = 0;
+};
+
+// Walk the top-level box headers of `file`. nullopt when a header is damaged, a box other than a
+// trailing free box runs past the end, or a box extends to end of file (size 0), which leaves no
+// room to append behind it.
+std::optional<BoxMap> scan_boxes(RandomAccessFile &file);
+
+// free, skip and wide boxes: bytes nothing refers to.
+bool is_free(const Box &box);
+
+// Header of a box of `size` bytes, `header_size` (8, or 16 with a 64-bit largesize) long.
+std::vector<uint8_t> box_header(uint32_t type, uint64_t size, size_t header_size = 8);
+
+// Bytes to write at an absolute file offset.
+struct Edit {
+    uint64_t offset = 0;
+    std::vector<uint8_t> bytes;
+};
+
+// `<media_path>.cfupdate`
+std::string journal_path(const std::string &media_path);
+
+// Durably record `edits` for the file at `media_path`, which is `file_size` bytes long when they
+// are applied. Returns false on I/O errors.
+bool write_journal(const std::string &media_path, uint64_t file_size,
+                   const std::vector<Edit> &edits);
+
+enum class Replay {
+    None,       // no journal
+    Applied,    // edits written and made durable, journal removed
+    Discarded,  // torn or damaged journal, or one for a file of another size; removed unapplied
+    Failed,     // the edits could not be written; the journal is kept for the next attempt
+};
+
+// Apply and remove the pending journal of `media_path`, if any.
+Replay replay_journal(const std::string &media_path);
+
+}  // namespace in_place
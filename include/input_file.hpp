@@ -0,0 +1,90 @@
+//
+//  input_file.hpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "random_access_file.hpp"
+#include "random_access_source.hpp"
+
+// One opened input shared by every stage of a read: top-level walk, moov, recovery scans and
+// sample extraction. It wraps a file opened once by path, or a caller-provided source, and is
+// itself the source those stages read from. Every request is counted and charged against an
+// optional byte budget; for sources that report a minimum request size, smaller reads are
+// widened into read-ahead blocks that later reads are served from.
+class InputFile : public chapterforge::RandomAccessSource {
+  public:
+    struct Stats {
+        uint64_t opens = 0;  // 1 for a file opened by path, 0 for a wrapped source
+        uint64_t reads = 0;  // requests issued to the file or source
+        uint64_t bytes = 0;  // bytes fetched, plus the file size once mapped
+    };
+
+    // `byte_budget` 0 means unlimited. Returns nullptr when the file cannot be opened.
+    static std::unique_ptr<InputFile> open(const std::string &path, uint64_t byte_budget = 0);
+    // Read through `source`; `name` identifies it in log and status messages.
+    static std::unique_ptr<InputFile> wrap(std::shared_ptr<chapterforge::RandomAccessSource> source,
+                                           std::string name, uint64_t byte_budget = 0);
+
+    const std::string &name() const { return name_; }
+    bool is_file() const { return file_ != nullptr; }
+    // Identity of a file opened by path; wrapped sources have none.
+    const FileIdentity *identity() const { return file_ ? &file_->identity() : nullptr; }
+
+    uint64_t size() const override { return source_->size(); }
+    // Safe to call from several threads; read-ahead blocks are shared under a lock that is never
+    // held across a request to the source.
+    bool read_at(uint64_t offset, void *dst, size_t length) override;
+    uint64_t min_request_size() const override { return source_->min_request_size(); }
+
+    // Whole file for recovery scans, mapped once from the same handle and charged in full against
+    // the budget. nullptr for wrapped sources (scanned through read_at() instead) and when the
+    // mapping does not fit or fails.
+    std::shared_ptr<const MappedFile> map();
+
+    bool budget_exceeded() const { return budget_exceeded_.load(std::memory_order_relaxed); }
+    Stats stats() const;
+
+  private:
+    // Blocks kept for serving small reads; enough for the parse walk (ftyp, moov, mdat headers)
+    // plus the chapter sample runs.
+    static constexpr size_t kReadAheadBlocks = 4;
+
+    struct Block {
+        uint64_t offset = 0;
+        std::vector<uint8_t> bytes;
+    };
+
+    InputFile() = default;
+    // Reserve `bytes` of the budget; false, latching budget_exceeded(), when it does not fit.
+    bool charge(uint64_t bytes);
+    // One counted, charged request to the underlying source.
+    bool fetch(uint64_t offset, void *dst, size_t length);
+
+    std::string name_;
+    std::shared_ptr<chapterforge::RandomAccessSource> source_;
+    RandomAccessFile *file_ = nullptr;  // source_ when opened by path
+    std::shared_ptr<const MappedFile> mapping_;
+
+    uint64_t budget_ = 0;
+    std::atomic<uint64_t> charged_{0};
+    std::atomic<bool> budget_exceeded_{false};
+    std::atomic<uint64_t> reads_{0};
+    std::atomic<uint64_t> bytes_{0};
+
+    std::mutex cache_mutex_;
+    std::deque<Block> blocks_;  // most recently fetched last
+};
@@ -0,0 +1,65 @@
+//
+//  layout_planner.hpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Stores final chunk offsets per track (relative to payload_start), used for stco/co64 patching.
+struct MdatOffsets {
+    std::vector<uint64_t> audio_offsets;
+    std::vector<std::vector<uint64_t>> text_offsets;  // one entry per text track
+    std::vector<uint64_t> image_offsets;
+
+    uint64_t payload_start = 0;  // absolute file offset where mdat payload begins
+
+    // True when some absolute chunk offset does not fit a 32-bit stco entry.
+    bool needs_co64() const;
+};
+
+// Places the chunks of every track inside one mdat payload from per-sample sizes and chunk
+// plans alone; no sample data is needed. Tracks follow the Apple convention used by write_mdat:
+// audio first, then text tracks in order, then images.
+class LayoutPlanner {
+  public:
+    // Per-track placement; chunk offsets are relative to the track's first byte.
+    struct Track {
+        std::vector<uint64_t> chunk_offsets;
+        uint32_t sample_count = 0;
+        uint64_t bytes = 0;
+    };
+
+    // An empty chunk plan means one sample per chunk; samples beyond the plan form one trailing
+    // chunk (matching write_mdat).
+    void set_audio(std::span<const uint32_t> sample_sizes, std::span<const uint32_t> chunk_plan);
+    void add_text(std::span<const uint32_t> sample_sizes, std::span<const uint32_t> chunk_plan);
+    void set_image(std::span<const uint32_t> sample_sizes, std::span<const uint32_t> chunk_plan);
+
+    const Track &audio() const { return audio_; }
+    const std::vector<Track> &text() const { return text_; }
+    const Track &image() const { return image_; }
+
+    // Bytes of mdat payload (excluding the box header).
+    uint64_t payload_size() const;
+
+    // mdat header bytes for a payload: 8, or 16 when the box needs a 64-bit largesize.
+    static uint64_t mdat_header_size(uint64_t payload_size);
+
+    // Chunk offsets for stco patching once the payload position in the file is known.
+    MdatOffsets offsets(uint64_t payload_start) const;
+
+  private:
+    static Track place(std::span<const uint32_t> sample_sizes,
+                       std::span<const uint32_t> chunk_plan);
+
+    Track audio_;
+    std::vector<Track> text_;
+    Track image_;
+};
@@ -0,0 +1,65 @@
+//
+//  mapped_file.hpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+class RandomAccessFile;
+
+// Read-only memory mapping of an entire file. Parsed views (spans) point directly into the
+// mapping; holders keep it alive through the shared_ptr returned by open(). On POSIX the file
+// descriptor stays open alongside the mapping.
+class MappedFile {
+  public:
+    // Map `path` read-only. Returns nullptr when the file cannot be opened or mapped. Empty files
+    // map successfully and expose an empty span.
+    static std::shared_ptr<const MappedFile> open(const std::string &path);
+    // Map a file that is already open for positional reads, without opening it again. The
+    // mapping holds its own duplicate of the handle, so it may outlive `file`.
+    static std::shared_ptr<const MappedFile> map(const RandomAccessFile &file);
+
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const uint8_t *data() const { return data_; }
+    size_t size() const { return size_; }
+    std::span<const uint8_t> bytes() const { return {data_, size_}; }
+
+    // Descriptor of the mapped file for kernel-side copies (copy_file_range); -1 where
+    // unavailable (Windows, empty files).
+    int native_fd() const { return fd_; }
+
+    // Access-pattern hints (no-ops where unsupported). release() drops already consumed pages
+    // from the process working set; later reads fault them back in from the file.
+    void advise_sequential() const;
+    void release(size_t offset, size_t length) const;
+
+  private:
+    MappedFile() = default;
+    // Map the open file behind `handle` (a file descriptor, or a HANDLE on Windows); takes
+    // ownership of it. `what` names the file in log messages.
+#if defined(_WIN32)
+    static std::shared_ptr<const MappedFile> map_handle(void *handle, const std::string &what);
+#else
+    static std::shared_ptr<const MappedFile> map_handle(int fd, const std::string &what);
+#endif
+
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+    int fd_ = -1;
+#if defined(_WIN32)
+    void *file_handle_ = nullptr;
+    void *mapping_handle_ = nullptr;
+#endif
+};
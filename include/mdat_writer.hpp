@@ -8,41 +8,54 @@
 
 #pragma once
 #include <cstdint>
-#include <fstream>
+#include <ostream>
+#include <string>
 #include <vector>
 
+#include "file_writer.hpp"
+#include "frame_store.hpp"
+#include "layout_planner.hpp"
 #include "mp4_atoms.hpp"
 
-// Stores final chunk offsets per track, used for STCO patching.
-struct MdatOffsets {
-    std::vector<uint32_t> audio_offsets;
-    std::vector<std::vector<uint32_t>> text_offsets;  // one entry per text track
-    std::vector<uint32_t> image_offsets;
-
-    uint64_t payload_start = 0;  // absolute file offset where mdat payload begins
-};
-
-// Write mdat and return offsets (relative to payload_start)
-MdatOffsets write_mdat(std::ofstream &out, const std::vector<std::vector<uint8_t>> &audio_samples,
+// Write mdat and return offsets (relative to payload_start). Payloads beyond 4 GB get a 16-byte
+// largesize header (see LayoutPlanner::mdat_header_size). When `out` is backed by a FileWriter,
+// large runs of mapped audio are copied file-to-file instead of through memory.
+MdatOffsets write_mdat(std::ostream &out, const FrameStore &audio_samples,
                        const std::vector<std::vector<std::vector<uint8_t>>> &text_tracks_samples,
                        const std::vector<std::vector<uint8_t>> &image_samples,
                        const std::vector<uint32_t> &audio_chunk_sizes,
                        const std::vector<std::vector<uint32_t>> &text_chunk_sizes,
                        const std::vector<uint32_t> &image_chunk_sizes);
 
-// Patch a single stco atom.
-void patch_stco_table(Atom *stco, const std::vector<uint32_t> &offsets,
+// Write the header of an mdat box carrying `payload_size` bytes, with its final size.
+void write_mdat_header(std::ostream &out, uint64_t payload_size);
+
+// Audio ranges written concurrently are at least this long.
+constexpr uint64_t kMinParallelRegion = 8 * 1024 * 1024;
+
+// Write the mdat payload laid out in `planned` into the existing file `path`, as independent
+// regions on up to `threads` threads: the audio cut at chunk boundaries into about `threads`
+// ranges (none shorter than `min_audio_region`), each text track and the image track. Every region
+// goes through its own FileWriter opened in place at its planned offset, so the rest of the file
+// (ftyp, moov, mdat header) is written separately. Returns false when a region fails or its chunks
+// do not land at the planned offsets; `stats`, when given, receives the summed counters.
+bool write_mdat_payload_parallel(
+    const std::string &path, unsigned threads, const MdatOffsets &planned,
+    const FrameStore &audio_samples,
+    const std::vector<std::vector<std::vector<uint8_t>>> &text_tracks_samples,
+    const std::vector<std::vector<uint8_t>> &image_samples,
+    const std::vector<uint32_t> &audio_chunk_sizes,
+    const std::vector<std::vector<uint32_t>> &text_chunk_sizes,
+    const std::vector<uint32_t> &image_chunk_sizes, FileWriter::Stats *stats = nullptr,
+    uint64_t min_audio_region = kMinParallelRegion);
+
+// Patch a single stco or co64 atom. Returns false when an offset does not fit a 32-bit stco.
+bool patch_stco_table(Atom *stco, const std::vector<uint64_t> &offsets,
                       uint64_t mdat_payload_start);
 
-// Patch stco boxes in moov (audio, text tracks, image). If patch_audio is false,
+// Patch stco/co64 boxes in moov (audio, text tracks, image). If patch_audio is false,
 // audio stco (first one) is left untouched.
-void patch_all_stco(Atom *moov, const MdatOffsets &offs, bool patch_audio = true);
-
-// Compute chunk offsets without writing, given starting payload offset.
-MdatOffsets compute_mdat_offsets(uint64_t payload_start,
-                                 const std::vector<std::vector<uint8_t>> &audio_samples,
-                                 const std::vector<std::vector<std::vector<uint8_t>>> &text_tracks_samples,
-                                 const std::vector<std::vector<uint8_t>> &image_samples,
-                                 const std::vector<uint32_t> &audio_chunk_sizes,
-                                 const std::vector<std::vector<uint32_t>> &text_chunk_sizes,
-                                 const std::vector<uint32_t> &image_chunk_sizes);
+bool patch_all_stco(Atom *moov, const MdatOffsets &offs, bool patch_audio = true);
+
+// Convert all stco boxes in moov to co64 (64-bit chunk offsets) and refresh box sizes.
+void promote_stco_to_co64(Atom *moov);
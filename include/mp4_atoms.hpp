@@ -8,12 +8,15 @@
 
 #pragma once
 #include <cstdint>
-#include <fstream>
+#include <ostream>
 #include <memory>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "box_writer.hpp"
+#include "byte_order.hpp"
 #include "fourcc_utils.hpp"
 
 // Forward declaration.
@@ -27,7 +30,7 @@ class Atom {
     std::vector<uint8_t> payload;   // Raw payload (before children)
     std::vector<AtomPtr> children;  // Nested boxes
 
-    uint32_t box_size = 0;  // Computed via fix_size_recursive()
+    uint64_t box_size = 0;  // Computed via fix_size_recursive(); includes the header
 
     Atom() = default;
     explicit Atom(uint32_t t) : type(t) {}
@@ -41,17 +44,29 @@ class Atom {
     // Add child atom.
     void add(AtomPtr child);
 
-    // Recursive search for atoms of given type.
+    // Recursive search for atoms of given type, in tree order.
     std::vector<Atom *> find(const std::string &t);
 
-    // Recursive size computation.
+    // Recursive size computation. Boxes beyond 4 GB get a 16-byte largesize header.
     void fix_size_recursive();
 
     // Return size (must call fix_size_recursive first)
-    uint32_t size() const;
+    uint64_t size() const;
 
-    // Write atom to file.
-    void write(std::ofstream &out) const;
+    // True when the box needs the 64-bit largesize header.
+    bool is_large() const { return box_size > 0xFFFFFFFFULL; }
+
+    // Append the box with all children to `out`; sizes are taken from the bytes written, so
+    // fix_size_recursive() is not required.
+    void serialize(BoxWriter &out) const;
+    // The whole box in one contiguous buffer, ready for a single write.
+    std::vector<uint8_t> serialize() const;
+
+    // Write atom to stream (one write of the serialized box).
+    void write(std::ostream &out) const;
+
+  private:
+    void find_into(uint32_t want, std::vector<Atom *> &out);
 };
 
 // ------------- Helper write functions ---------------------------------------
@@ -87,6 +102,13 @@ inline void write_u64(std::vector<uint8_t> &p, uint64_t v) {
     p.push_back(v & 0xFF);
 }
 
+// A table of 32-bit fields (stsz, stco entries) appended with one resize.
+inline void write_u32_array(std::vector<uint8_t> &p, std::span<const uint32_t> values) {
+    const size_t at = p.size();
+    p.resize(at + values.size() * 4);
+    store_be32(values, p.data() + at);
+}
+
 inline void write_fixed16_16(std::vector<uint8_t> &out, float f) {
     uint32_t v = static_cast<uint32_t>(f * 65536.0f);
     write_u32(out, v);
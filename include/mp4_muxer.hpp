@@ -22,7 +22,8 @@
 #include "stbl_text_builder.hpp"
 
 // Complete MP4 writer: takes raw AAC (ADTS) bytes, chapter text/image samples,
-// audio config, and metadata.
+// audio config, and metadata. With write_threads > 1 the mdat payload is written as independent
+// regions concurrently once the layout is planned (see write_mdat_payload_parallel).
 // Exposed for embedding; prefer the higher-level helper in chapterforge.hpp when linking externally.
 bool write_mp4(const std::string &path, const AacExtractResult &aac,
                const std::vector<ChapterTextSample> &text_chapters,
@@ -31,7 +32,52 @@ bool write_mp4(const std::string &path, const AacExtractResult &aac,
                const std::vector<std::pair<std::string, std::vector<ChapterTextSample>>>
                    &extra_text_tracks = {},
                const std::vector<uint8_t> *ilst_payload = nullptr,
-               const std::vector<uint8_t> *meta_payload = nullptr);
+               const std::vector<uint8_t> *meta_payload = nullptr, unsigned write_threads = 1);
+
+// Output layout computed from sample sizes alone; byte-exact with what write_mp4 produces.
+struct Mp4Layout {
+    struct Track {
+        std::string handler;  // "soun", "text" or "vide"
+        std::string name;
+        uint32_t samples = 0;
+        uint32_t chunks = 0;
+        uint64_t bytes = 0;   // payload bytes inside mdat
+        uint64_t offset = 0;  // absolute file offset of the track's first chunk
+    };
+
+    uint64_t file_size = 0;
+    uint64_t moov_offset = 0;
+    uint64_t moov_size = 0;
+    uint64_t mdat_offset = 0;
+    uint64_t mdat_size = 0;
+    std::vector<Track> tracks;  // in mdat order: audio, text tracks, image
+};
+
+// Dry run of write_mp4: builds moov and plans mdat without writing anything.
+bool plan_mp4(const AacExtractResult &aac, const std::vector<ChapterTextSample> &text_chapters,
+              const std::vector<ChapterImageSample> &image_chapters, Mp4aConfig audio_cfg,
+              const MetadataSet &meta, bool fast_start,
+              const std::vector<std::pair<std::string, std::vector<ChapterTextSample>>>
+                  &extra_text_tracks,
+              const std::vector<uint8_t> *ilst_payload, const std::vector<uint8_t> *meta_payload,
+              Mp4Layout &layout);
+
+// Replace the chapter tracks and metadata of the MP4 at `path`, from which `aac` was extracted
+// (extract_from_mp4), without moving or copying its audio. The new moov replaces the old one when
+// it fits the old moov plus adjacent free boxes, otherwise it is appended and the old one becomes
+// free. The new chapter samples go into free space (the rest of that slot or another free box) or
+// are appended. Mdat boxes left without referenced samples become free as well. The switch is
+// committed through an update journal (see in_place_update.hpp), so a crash leaves either the old
+// or the new file. Returns false when the file cannot be updated in place; its content is then
+// unchanged, at most unused free space was appended.
+bool update_mp4_in_place(const std::string &path, const AacExtractResult &aac,
+                         const std::vector<ChapterTextSample> &text_chapters,
+                         const std::vector<ChapterImageSample> &image_chapters,
+                         Mp4aConfig audio_cfg, const MetadataSet &meta,
+                         const std::vector<std::pair<std::string, std::vector<ChapterTextSample>>>
+                             &extra_text_tracks,
+                         const std::vector<uint8_t> *ilst_payload,
+                         const std::vector<uint8_t> *meta_payload);
 
 #ifdef CHAPTERFORGE_TESTING
 namespace chapterforge::testing {
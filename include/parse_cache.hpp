@@ -0,0 +1,117 @@
+//
+//  parse_cache.hpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "parser.hpp"
+#include "random_access_file.hpp"
+#include "sample_table.hpp"
+
+class InputFile;
+
+// Parsed container structure of one input, shared read-only between calls and threads: the
+// ParsedMp4 (owning its moov) and the sample tables derived from it, each built once on first
+// use so a consumer pays only for the tables it needs.
+class ParsedInput {
+  public:
+    // `audio_chunks`, when given, is used instead of building the audio table on first use.
+    explicit ParsedInput(ParsedMp4 parsed,
+                         std::optional<SampleTable> audio_chunks = std::nullopt);
+
+    const ParsedMp4 &parsed() const { return parsed_; }
+
+    // Per-sample table of parsed().tracks[index]; nullptr when its tables are inconsistent.
+    const SampleTable *track_table(size_t index) const;
+    // Chunk-level table of the selected audio track (ParsedMp4::stsz/stsc/stco); nullptr when
+    // inconsistent.
+    const SampleTable *audio_chunks() const;
+
+    // Bytes held: moov (or the mapped sidecar) plus the tables built so far.
+    uint64_t bytes() const { return bytes_.load(std::memory_order_relaxed); }
+
+  private:
+    struct LazyTable {
+        std::once_flag once;
+        std::optional<SampleTable> table;
+    };
+    const SampleTable *finish(LazyTable &lazy, std::optional<SampleTable> table) const;
+
+    ParsedMp4 parsed_;
+    std::unique_ptr<LazyTable[]> tracks_;
+    mutable LazyTable audio_;
+    mutable std::atomic<uint64_t> bytes_{0};
+};
+
+// Process-wide LRU cache of ParsedInput keyed by FileIdentity, so repeated reads and muxes of the
+// same file skip moov parsing and sample-table building. Disabled (capacity 0) by default. The
+// byte budget covers the moov copies and sample tables held; the least recently used entries are
+// dropped once it is exceeded. Thread-safe.
+class ParseCache {
+  public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t entries = 0;
+        uint64_t bytes = 0;
+        uint64_t max_bytes = 0;
+    };
+
+    static ParseCache &instance();
+
+    // 0 disables the cache and drops every entry; otherwise entries are trimmed to fit.
+    void set_capacity(uint64_t max_bytes);
+    bool enabled() const { return max_bytes_.load(std::memory_order_relaxed) != 0; }
+
+    // Counts a hit or a miss; nullptr on a miss.
+    std::shared_ptr<const ParsedInput> find(const FileIdentity &id);
+    // `path` is kept only for invalidate(). Entries larger than the whole budget are not kept.
+    void insert(const FileIdentity &id, const std::string &path,
+                std::shared_ptr<const ParsedInput> entry);
+
+    // Drop every entry read from `path` (any identity); returns how many were dropped.
+    size_t invalidate(const std::string &path);
+    void clear();
+    Stats stats() const;
+
+  private:
+    struct IdentityHash {
+        size_t operator()(const FileIdentity &id) const;
+    };
+    struct Node {
+        FileIdentity id;
+        std::string path;
+        std::shared_ptr<const ParsedInput> entry;
+    };
+
+    // Drop least recently used entries until the held bytes fit. Caller holds mutex_.
+    void trim();
+
+    mutable std::mutex mutex_;
+    std::atomic<uint64_t> max_bytes_{0};
+    std::list<Node> lru_;  // most recently used first
+    std::unordered_map<FileIdentity, std::list<Node>::iterator, IdentityHash> index_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+};
+
+// Parse `input`, going through ParseCache when it is enabled and the input is a file opened by
+// path, and loading its sidecar index (see sidecar_index.hpp) instead of parsing when a valid one
+// exists. Inputs whose sample tables had to be recovered by a flat scan are never cached.
+std::shared_ptr<const ParsedInput> parse_input(InputFile &input);
@@ -12,15 +12,24 @@
 #include <istream>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
+#include "mapped_file.hpp"
+
+class InputFile;
+
 struct Mp4AtomInfo {
     uint32_t type;
     uint64_t size;    // total atom size.
     uint64_t offset;  // offset in file.
+    uint32_t header_size = 8;  // 8, or 16 for 64-bit extended sizes.
 };
 
+// Non-owning view into the mapped input file.
+using ByteView = std::span<const uint8_t>;
+
 namespace parser_detail {
 struct TrackParseResult {
     uint32_t track_id = 0;
@@ -30,36 +39,49 @@ struct TrackParseResult {
     uint32_t timescale = 0;
     uint64_t duration = 0;
     uint32_t sample_count = 0;
-    std::vector<uint8_t> stsd;
-    std::vector<uint8_t> stts;
-    std::vector<uint8_t> stsc;
-    std::vector<uint8_t> stsz;
-    std::vector<uint8_t> stco;
+    // Sample table payloads (views into the mapped file).
+    ByteView stsd;
+    ByteView stts;
+    ByteView stsc;
+    ByteView stsz;
+    ByteView stco;       // chunk offsets: stco payload, or co64 when `co64` is set
+    bool co64 = false;  // stco holds 64-bit entries
 };
 }  // namespace parser_detail
 
-// Minimal parsed MP4 data for our authoring needs.
+// Minimal parsed MP4 data for our authoring needs. All payloads are zero-copy views into `source`,
+// `moov`, `contents` or `sidecar`, which keep their bytes alive for as long as the ParsedMp4 (or a
+// copy of it) exists.
 struct ParsedMp4 {
+    std::shared_ptr<const MappedFile> source;
+    // moov read with positional reads (parse_mp4 from an InputFile); empty for mapped parses.
+    std::shared_ptr<const std::vector<uint8_t>> moov;
+    // Sample-table payloads recovered by a windowed scan of an input that is not a mapped file.
+    std::shared_ptr<const std::vector<uint8_t>> contents;
+    // Mapped sidecar index the payloads were loaded from instead of parsing (sidecar_index.hpp).
+    std::shared_ptr<const MappedFile> sidecar;
+
     bool used_fallback_stbl = false;  // true if stbl atoms were recovered via flat scan.
 
     // All parsed tracks (audio/text/video).
     std::vector<parser_detail::TrackParseResult> tracks;
 
     // ilst metadata atom payload (optional).
-    std::vector<uint8_t> ilst_payload;
+    ByteView ilst_payload;
     // raw meta payload (version/flags/reserved + children) to allow verbatim reuse.
-    std::vector<uint8_t> meta_payload;
+    ByteView meta_payload;
 
     // audio track timing info.
     uint32_t audio_timescale = 0;
     uint64_t audio_duration = 0;
 
-    // sample table (copied directly)
-    std::vector<uint8_t> stsd;
-    std::vector<uint8_t> stts;
-    std::vector<uint8_t> stsc;
-    std::vector<uint8_t> stsz;
-    std::vector<uint8_t> stco;
+    // sample table of the selected audio track (views, not copies)
+    ByteView stsd;
+    ByteView stts;
+    ByteView stsc;
+    ByteView stsz;
+    ByteView stco;       // chunk offsets: stco payload, or co64 when `co64` is set
+    bool co64 = false;  // stco holds 64-bit entries
 };
 
 // Utility: read big-endian 32-bit value.
@@ -68,15 +90,25 @@ uint32_t read_u32(std::istream &in);
 // Utility: read big-endian 64-bit value.
 uint64_t read_u64(std::istream &in);
 
-// Main parsing entry point.
+// Main parsing entry point. Maps the file read-only and parses it in place.
 std::optional<ParsedMp4> parse_mp4(const std::string &path);
 
+// Parse through an already open input: the top-level atom headers and moov are fetched with
+// positional reads, so media payloads are never touched. Only when the sample tables must be
+// recovered by a flat scan is the input read further, within the input's budget: a file is mapped
+// from the same handle (`source`), any other source is read in windows and the payloads found are
+// copied into `contents`.
+std::optional<ParsedMp4> parse_mp4(InputFile &input);
+
+// Parse a complete moov atom (header included) already held in memory. The result has no
+// `source`; its views point into `moov`, which must outlive it. No fallback scanning is done.
+std::optional<ParsedMp4> parse_moov_atom(ByteView moov);
+
 #ifdef CHAPTERFORGE_TESTING
-// Test-only wrappers that allow unit tests to exercise lower-level parsing.
-std::optional<parser_detail::TrackParseResult> parse_trak_for_test(std::istream &in,
-                                                                   uint64_t payload_size,
-                                                                   uint64_t file_size,
+// Test-only wrappers that allow unit tests to exercise lower-level parsing. `trak_payload` is the
+// trak box without its header; `file` is a buffer holding the moov atom described by `atom`.
+std::optional<parser_detail::TrackParseResult> parse_trak_for_test(ByteView trak_payload,
                                                                    bool &force_fallback);
-void parse_moov_for_test(std::istream &in, const Mp4AtomInfo &atom, uint64_t file_size,
-                         ParsedMp4 &out, uint32_t &best_audio_samples, bool &force_fallback);
+void parse_moov_for_test(ByteView file, const Mp4AtomInfo &atom, ParsedMp4 &out,
+                         uint32_t &best_audio_samples, bool &force_fallback);
 #endif
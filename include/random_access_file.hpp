@@ -0,0 +1,73 @@
+//
+//  random_access_file.hpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "random_access_source.hpp"
+
+// Identity of a file's contents as far as the file system tells: replacing, rewriting or touching
+// the file yields a different identity.
+struct FileIdentity {
+    uint64_t device = 0;
+    uint64_t inode = 0;
+    uint64_t size = 0;
+    int64_t mtime_ns = 0;
+
+    bool operator==(const FileIdentity &) const = default;
+};
+
+// Read-only file handle for positional reads (pread / ReadFile+OVERLAPPED). No shared cursor, so
+// callers read exactly the ranges they need and several threads may read through one handle;
+// every read is counted for I/O accounting.
+class RandomAccessFile : public chapterforge::RandomAccessSource {
+  public:
+    // Returns nullptr when the file cannot be opened.
+    static std::unique_ptr<RandomAccessFile> open(const std::string &path);
+
+    ~RandomAccessFile() override;
+    RandomAccessFile(const RandomAccessFile &) = delete;
+    RandomAccessFile &operator=(const RandomAccessFile &) = delete;
+
+    uint64_t size() const override { return size_; }
+    // Taken from the open handle, so it describes the file actually being read.
+    const FileIdentity &identity() const { return identity_; }
+
+    // Read exactly `length` bytes at `offset` into `dst`. Returns false on a short read or error.
+    bool read_at(uint64_t offset, void *dst, size_t length) override;
+    // Convenience: read a range into `out` (resized to `length`); clears `out` on failure.
+    bool read_at(uint64_t offset, size_t length, std::vector<uint8_t> &out);
+
+    uint64_t bytes_read() const { return bytes_read_.load(std::memory_order_relaxed); }
+    uint64_t read_calls() const { return read_calls_.load(std::memory_order_relaxed); }
+
+#if defined(_WIN32)
+    void *native_handle() const { return handle_; }
+#else
+    int native_fd() const { return fd_; }
+#endif
+
+  private:
+    RandomAccessFile() = default;
+
+#if defined(_WIN32)
+    void *handle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+    uint64_t size_ = 0;
+    FileIdentity identity_;
+    std::atomic<uint64_t> bytes_read_{0};
+    std::atomic<uint64_t> read_calls_{0};
+};
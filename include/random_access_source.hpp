@@ -0,0 +1,78 @@
+//
+//  random_access_source.hpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace chapterforge {
+
+/**
+ * @brief Positional byte source that the read APIs can parse from instead of a file path.
+ *
+ * Implementations provide the total size and exact-length reads at arbitrary offsets. Reads may
+ * be issued from several threads at once (see ReadOptions::threads), so read_at() must not rely
+ * on a shared cursor.
+ */
+class RandomAccessSource {
+  public:
+    virtual ~RandomAccessSource() = default;
+
+    virtual uint64_t size() const = 0;
+    /// Read exactly `length` bytes at `offset` into `dst`; false on error or short read.
+    virtual bool read_at(uint64_t offset, void *dst, size_t length) = 0;
+    /// Smallest request worth issuing. Sources with a high per-request latency (remote or blob
+    /// storage) return e.g. 256 KiB: small reads are then widened into read-ahead and nearby
+    /// ranges merged, trading bytes for round trips. 0 (the default) disables both.
+    virtual uint64_t min_request_size() const { return 0; }
+};
+
+/// Source over bytes held in memory.
+class MemorySource : public RandomAccessSource {
+  public:
+    explicit MemorySource(std::vector<uint8_t> bytes) : bytes_(std::move(bytes)) {}
+
+    uint64_t size() const override { return bytes_.size(); }
+    bool read_at(uint64_t offset, void *dst, size_t length) override {
+        if (offset > bytes_.size() || length > bytes_.size() - offset) {
+            return false;
+        }
+        std::memcpy(dst, bytes_.data() + offset, length);
+        return true;
+    }
+
+  private:
+    std::vector<uint8_t> bytes_;
+};
+
+/// Source backed by caller-provided callbacks (e.g. HTTP range requests against a blob store).
+class CallbackSource : public RandomAccessSource {
+  public:
+    using ReadFn = std::function<bool(uint64_t offset, void *dst, size_t length)>;
+
+    CallbackSource(uint64_t size, ReadFn read, uint64_t min_request_size = 0)
+        : size_(size), read_(std::move(read)), min_request_(min_request_size) {}
+
+    uint64_t size() const override { return size_; }
+    bool read_at(uint64_t offset, void *dst, size_t length) override {
+        return read_(offset, dst, length);
+    }
+    uint64_t min_request_size() const override { return min_request_; }
+
+  private:
+    uint64_t size_;
+    ReadFn read_;
+    uint64_t min_request_;
+};
+
+}  // namespace chapterforge
@@ -0,0 +1,85 @@
+//
+//  sample_table.hpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+// Flattened sample index of one track, built once from stsz/stsc/stco-or-co64 (+ optional stts)
+// payloads (size/type stripped). Per-sample sizes, file offsets and decode times live in flat
+// arrays, so sample -> offset is O(1) and time -> sample is a binary search.
+class SampleTable {
+  public:
+    // Returns nullopt when the tables are truncated or do not cover every sample with a chunk.
+    // `stts` may be empty; decode times are then unavailable. `co64` marks `stco` as a co64
+    // payload with 64-bit chunk offsets.
+    static std::optional<SampleTable> build(std::span<const uint8_t> stsz,
+                                            std::span<const uint8_t> stsc,
+                                            std::span<const uint8_t> stco,
+                                            std::span<const uint8_t> stts = {},
+                                            bool co64 = false);
+
+    // Chunk-level index only: sizes, samples per chunk and chunk offsets, without the per-sample
+    // offset and decode-time arrays (offsets() and decode_times() stay empty). Used where samples
+    // are walked chunk by chunk and memory matters.
+    static std::optional<SampleTable> build_chunks(std::span<const uint8_t> stsz,
+                                                   std::span<const uint8_t> stsc,
+                                                   std::span<const uint8_t> stco,
+                                                   bool co64 = false);
+
+    // Chunk-level index (as build_chunks) from sample sizes in an stsz payload plus an already
+    // derived chunk plan and chunk offsets, e.g. from a sidecar index. Returns nullopt when the
+    // plan does not cover exactly the stsz samples or the arrays disagree in length.
+    static std::optional<SampleTable> from_chunk_plan(std::span<const uint8_t> stsz,
+                                                      std::span<const uint32_t> samples_per_chunk,
+                                                      std::span<const uint64_t> chunk_offsets);
+
+    // Samples-per-chunk plan from an stsc payload alone (no chunk count known). The last entry
+    // repeats until `sample_count` samples are covered; the final chunk is trimmed so the plan
+    // sums to exactly `sample_count`. Returns an empty plan for malformed tables.
+    static std::vector<uint32_t> derive_chunk_plan(std::span<const uint8_t> stsc,
+                                                   uint32_t sample_count);
+
+    size_t sample_count() const { return sizes_.size(); }
+    size_t chunk_count() const { return samples_per_chunk_.size(); }
+
+    uint32_t size(size_t sample) const { return sizes_[sample]; }
+    uint64_t offset(size_t sample) const { return offsets_[sample]; }
+
+    std::span<const uint32_t> sizes() const { return sizes_; }
+    std::span<const uint64_t> offsets() const { return offsets_; }
+    // Samples per chunk and chunk file offsets, in chunk order.
+    std::span<const uint32_t> samples_per_chunk() const { return samples_per_chunk_; }
+    std::span<const uint64_t> chunk_offsets() const { return chunk_offsets_; }
+
+    // Decode time (track timescale units) of each sample covered by stts. May hold fewer entries
+    // than sample_count() when stts is short or absent.
+    std::span<const uint64_t> decode_times() const { return decode_times_; }
+    // Index of the sample whose decode interval contains `time` (last sample starting at or
+    // before it); nullopt when no timed sample starts at or before `time`.
+    std::optional<size_t> sample_at_time(uint64_t time) const;
+
+  private:
+    SampleTable() = default;
+
+    static std::optional<SampleTable> build_index(std::span<const uint8_t> stsz,
+                                                  std::span<const uint8_t> stsc,
+                                                  std::span<const uint8_t> stco,
+                                                  std::span<const uint8_t> stts, bool co64,
+                                                  bool per_sample);
+
+    std::vector<uint32_t> sizes_;
+    std::vector<uint64_t> offsets_;
+    std::vector<uint32_t> samples_per_chunk_;
+    std::vector<uint64_t> chunk_offsets_;
+    std::vector<uint64_t> decode_times_;
+};
@@ -0,0 +1,41 @@
+//
+//  sidecar_index.hpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "random_access_file.hpp"
+
+class ParsedInput;
+
+// Persistent sidecar index (`<media>.cfidx`) holding what the read and mux paths take from moov:
+// every track's stsd/stts/stsc/stsz/stco payloads (the audio sample sizes, chunk offsets, timing
+// and the chapter sample tables), ilst/meta, and the derived audio chunk plan. Payloads are stored
+// verbatim and 8-byte aligned, so a loaded index is the mapped file itself: ParsedMp4 views point
+// into it and no container parsing happens.
+//
+// Layout (little-endian): a 64-byte header (magic "CFIDX", version, source size and mtime, body
+// size, body hash, track count, header hash), the audio record, one record per track, then the
+// payload blobs. An index is used only when the version, both hashes and the source's size and
+// modification time all match; anything else is ignored and the source is parsed instead.
+namespace sidecar_index {
+
+// `<media_path>.cfidx`
+std::string path_for(const std::string &media_path);
+
+// Write the index of `input` (the structure of the file identified by `source`) to `path`,
+// replacing any existing one atomically. Returns false on I/O errors.
+bool write(const ParsedInput &input, const FileIdentity &source, const std::string &path);
+
+// Load and validate the index at `path` for the file identified by `source`; nullptr when it is
+// missing, stale or damaged.
+std::shared_ptr<const ParsedInput> load(const std::string &path, const FileIdentity &source);
+
+}  // namespace sidecar_index
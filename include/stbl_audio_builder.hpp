@@ -8,20 +8,23 @@
 
 #pragma once
 #include <memory>
+#include <span>
 #include <vector>
 
 #include "mp4_atoms.hpp"
 #include "mp4a_builder.hpp"
 
 std::unique_ptr<Atom> build_audio_stbl(const Mp4aConfig &cfg,
-                                       const std::vector<uint32_t> &sample_sizes,
+                                       std::span<const uint32_t> sample_sizes,
                                        const std::vector<uint32_t> &chunk_sizes,
                                        uint32_t num_samples,
                                        const std::vector<uint8_t> *raw_stsd = nullptr);
 
-// Build stbl from pre-existing box payloads (stsd/stts/stsc/stsz/stco)
+// Build stbl from pre-existing box payloads (stsd/stts/stsc/stsz/stco). A variable-size stsz
+// may be passed as its 12-byte header alone; its entries are then taken from `sample_sizes`.
 std::unique_ptr<Atom> build_audio_stbl_raw(const std::vector<uint8_t> &stsd_payload,
                                            const std::vector<uint8_t> &stts_payload,
                                            const std::vector<uint8_t> &stsc_payload,
                                            const std::vector<uint8_t> &stsz_payload,
-                                           const std::vector<uint8_t> &stco_payload);
+                                           const std::vector<uint8_t> &stco_payload,
+                                           std::span<const uint32_t> sample_sizes = {});
@@ -0,0 +1,123 @@
+//
+//  stream_parser.hpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "parser.hpp"
+#include "random_access_source.hpp"
+
+class ParsedInput;
+
+// Push parser for inputs that can only be read once, front to back (pipes, stdin). Bytes are
+// fed in chunks of any size; top-level atom headers are tracked as they complete, and moov is
+// parsed as soon as its last byte arrives. From then on only the sample ranges of the chapter
+// tracks (every text track and the first video track, merged across small holes as read_m4a
+// fetches them) are kept, so a fast-start file needs no buffering beyond its chapter samples.
+//
+// Until moov has been parsed everything is spooled, because a trailing moov may point anywhere
+// into the mdat already seen: in memory up to `spill_threshold`, then in an anonymous temporary
+// file. Once moov is parsed the needed ranges are copied out and the spool is dropped. A stream
+// whose moov is missing or lacks sample tables stays spooled whole and is handed on as a
+// seekable source, so the regular recovery scan can run on it.
+class StreamParser {
+  public:
+    struct Events {
+        // Every top-level atom header, in stream order.
+        std::function<void(const Mp4AtomInfo &)> atom;
+        // moov parsed; the sample tables are ready and the retained ranges are fixed.
+        std::function<void(const ParsedInput &)> tables;
+    };
+
+    // What a finished stream is read from: `source` spans the whole stream but holds only the
+    // retained bytes (reads outside them fail). `parsed` is null when the stream was kept whole
+    // and must be parsed from `source`.
+    struct Result {
+        std::shared_ptr<const ParsedInput> parsed;
+        std::shared_ptr<chapterforge::RandomAccessSource> source;
+    };
+
+    // A retained byte range of the stream: `size` bytes at `offset`, of which `bytes` holds what
+    // the stream has delivered so far.
+    struct Piece {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        std::vector<uint8_t> bytes;
+    };
+
+    static constexpr uint64_t kDefaultSpillThreshold = 16ull * 1024 * 1024;
+    // Upper bound on retained chapter sample bytes, whatever the sample tables claim.
+    static constexpr uint64_t kMaxRetained = 1ull << 30;
+
+    // `max_bytes` (0 = none) also bounds the retained bytes: a stream whose chapter samples need
+    // more fails once moov is parsed, as do samples beyond kMaxRetained.
+    explicit StreamParser(uint64_t spill_threshold = kDefaultSpillThreshold, Events events = {},
+                          uint64_t max_bytes = 0);
+    ~StreamParser();
+    StreamParser(const StreamParser &) = delete;
+    StreamParser &operator=(const StreamParser &) = delete;
+
+    // Consume the next bytes of the stream. False once the stream cannot be used (error()).
+    bool feed(ByteView bytes);
+    // True once moov is parsed and every retained range is complete; the rest of the stream is
+    // not needed and may be left unread.
+    bool done() const;
+    // End of input; a Result without source on failure, see error().
+    Result finish();
+
+    const std::string &error() const { return error_; }
+    uint64_t consumed() const { return pos_; }
+    // Bytes held in memory or in the spill file right now.
+    uint64_t buffered() const;
+    bool spilled() const { return spool_file_ != nullptr; }
+
+  private:
+    bool fail(std::string message);
+    // A complete top-level header in header_: start the atom's body.
+    bool atom_header();
+    // Store `bytes` at stream offset `offset`: spool them, or copy what the pieces need.
+    bool keep(uint64_t offset, ByteView bytes);
+    bool spool(ByteView bytes);
+    bool read_spool(uint64_t offset, uint8_t *dst, size_t length);
+    // moov complete: parse it and, when usable, switch from spooling to retained pieces.
+    bool moov_complete();
+
+    uint64_t spill_threshold_;
+    Events events_;
+    uint64_t max_bytes_;
+    std::string error_;
+    uint64_t pos_ = 0;
+
+    // Top-level walk state.
+    uint8_t header_[16] = {};
+    size_t header_have_ = 0;
+    uint64_t atom_left_ = 0;     // body bytes left in the current atom
+    bool to_end_ = false;        // current atom extends to the end of the stream
+    bool opaque_ = false;        // walk given up on a bad header; no further atoms tracked
+    bool in_moov_ = false;
+    bool moov_seen_ = false;
+    std::shared_ptr<std::vector<uint8_t>> moov_;
+
+    // Spool of the stream prefix [0, spool_size_) while moov is pending.
+    bool spooling_ = true;
+    std::vector<uint8_t> spool_memory_;
+    std::FILE *spool_file_ = nullptr;
+    uint64_t spool_size_ = 0;
+
+    // Retained ranges once moov is parsed, sorted and disjoint; `next_piece_` is the first one
+    // not yet complete.
+    std::shared_ptr<const ParsedInput> parsed_;
+    std::vector<Piece> pieces_;
+    size_t next_piece_ = 0;
+};
@@ -0,0 +1,19 @@
+//
+//  work_stealing.hpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// Run task(i) once for every i in [0, count) on up to `threads` threads, the calling thread
+// included. Each worker starts on its own contiguous share of the indices and takes them from the
+// front; a worker that runs dry steals the back half of the largest share left, so tasks of very
+// uneven cost (small and huge files) even out without every worker contending on one queue.
+// Returns once all tasks have finished; tasks must not throw.
+void run_work_stealing(size_t count, unsigned threads, const std::function<void(size_t)> &task);
@@ -10,14 +10,15 @@
 
 #include <algorithm>
 #include <chrono>
-#include <fstream>
 #include <optional>
-#include <cstring>
 
+#include "input_file.hpp"
 #include "logging.hpp"
 #include "mp4_atoms.hpp"
 #include "mp4a_builder.hpp"
+#include "parse_cache.hpp"
 #include "parser.hpp"
+#include "sample_table.hpp"
 
 namespace {
 
@@ -27,18 +28,25 @@ constexpr uint8_t kAdtsSyncPattern = 0xF0;
 constexpr size_t kAdtsHeaderNoCrc = 7;
 constexpr size_t kAdtsHeaderWithCrc = 9;
 constexpr size_t kEsdsVersionFlagsSize = 4;
-constexpr size_t kStszHeaderSize = 12;
-constexpr size_t kStscHeaderSize = 8;
-constexpr size_t kStscEntrySize = 12;
 constexpr size_t kEsdsTagLengthFieldMaxBytes = 4;
+constexpr size_t kAdtsReleaseWindow = 8 * 1024 * 1024;
 
 }  // namespace
 
-AacExtractResult extract_adts_frames(const std::vector<uint8_t> &data) {
-    AacExtractResult out;
-
+// Walk ADTS frames in `data`: fills the stream config of `out` and hands the payload offset and
+// size of every frame (header stripped) to `emit`. When `data` is a mapping, scanned pages are
+// released as the walk proceeds so the scan does not pull the whole file into memory.
+template <typename Emit>
+static void scan_adts(ByteView data, AacExtractResult &out, Emit &&emit,
+                      const MappedFile *mapping = nullptr) {
+    bool have_config = false;
     size_t i = 0;
+    size_t released = 0;
     while (i + 7 < data.size()) {
+        if (mapping && i - released >= kAdtsReleaseWindow) {
+            mapping->release(released, i - released);
+            released = i;
+        }
         if (data[i] == kAdtsSyncByte && (data[i + 1] & kAdtsSyncMask) == kAdtsSyncPattern) {
             uint32_t len =
                 ((data[i + 3] & 0x03) << 11) | (data[i + 4] << 3) | ((data[i + 5] & 0xE0) >> 5);
@@ -49,7 +57,8 @@ AacExtractResult extract_adts_frames(const std::vector<uint8_t> &data) {
             }
 
             // Parse header for config on first frame.
-            if (out.frames.empty()) {
+            if (!have_config) {
+                have_config = true;
                 uint8_t profile = (data[i + 2] >> 6) & 0x03;
                 out.audio_object_type = profile + 1;  // 1=MAIN,2=LC,...
                 out.sampling_index = (data[i + 2] >> 2) & 0x0F;
@@ -69,50 +78,50 @@ AacExtractResult extract_adts_frames(const std::vector<uint8_t> &data) {
                 continue;
             }
 
-            size_t payload_len = len - header_size;
-            std::vector<uint8_t> frame(payload_len);
-            std::copy_n(data.begin() + i + header_size, payload_len, frame.begin());
-
-            out.frames.emplace_back(std::move(frame));
-            out.sizes.push_back(static_cast<uint32_t>(payload_len));
+            emit(i + header_size, static_cast<uint32_t>(len - header_size));
 
             i += len;
         } else {
             i++;
         }
     }
+}
 
+AacExtractResult extract_adts_frames(const std::vector<uint8_t> &data) {
+    AacExtractResult out;
+    // Payloads never exceed the input, so one reservation holds every frame.
+    out.frames.reserve(0, data.size());
+    scan_adts(data, out, [&](uint64_t offset, uint32_t size) {
+        out.frames.append({data.data() + offset, size});
+    });
     return out;
 }
 
-// Helpers for MP4 extraction (from container)
-static std::optional<std::vector<uint32_t>> parse_stsz_sizes(
-    const std::vector<uint8_t> &stsz_payload) {
-    if (stsz_payload.size() < kStszHeaderSize) {
-        return std::nullopt;
-    }
-    const uint8_t *p = stsz_payload.data();
-    uint32_t sample_size = (p[4] << 24) | (p[5] << 16) | (p[6] << 8) | p[7];
-    uint32_t sample_count = (p[8] << 24) | (p[9] << 16) | (p[10] << 8) | p[11];
-    std::vector<uint32_t> sizes;
-    if (sample_size != 0) {
-        sizes.assign(sample_count, sample_size);
-        return sizes;
-    }
-    if (stsz_payload.size() < kStszHeaderSize + sample_count * 4) {
-        return std::nullopt;
+AacExtractResult extract_adts_frames(std::shared_ptr<const MappedFile> file) {
+    AacExtractResult out;
+    if (!file) {
+        return out;
     }
-    sizes.reserve(sample_count);
-    size_t pos = kStszHeaderSize;
-    for (uint32_t i = 0; i < sample_count; ++i) {
-        uint32_t s = (p[pos] << 24) | (p[pos + 1] << 16) | (p[pos + 2] << 8) | p[pos + 3];
-        sizes.push_back(s);
-        pos += 4;
+    file->advise_sequential();
+    out.frames = FrameStore::view(file);
+    // Frame count estimate from the first frame so the size index is allocated about once.
+    const auto bytes = file->bytes();
+    if (bytes.size() > 7 && bytes[0] == kAdtsSyncByte) {
+        const uint32_t first =
+            ((bytes[3] & 0x03) << 11) | (bytes[4] << 3) | ((bytes[5] & 0xE0) >> 5);
+        if (first > kAdtsHeaderWithCrc) {
+            out.frames.reserve(bytes.size() / first + bytes.size() / first / 4, 0);
+        }
     }
-    return sizes;
+    scan_adts(
+        bytes, out, [&](uint64_t offset, uint32_t size) { out.frames.add(offset, size); },
+        file.get());
+    file->release(0, file->size());
+    return out;
 }
 
-static void parse_esds_audio_cfg(const std::vector<uint8_t> &stsd_payload, Mp4aConfig &cfg) {
+// Helpers for MP4 extraction (from container)
+static void parse_esds_audio_cfg(ByteView stsd_payload, Mp4aConfig &cfg) {
     for (size_t i = 0; i + 8 <= stsd_payload.size();) {
         uint32_t size = (stsd_payload[i] << 24) | (stsd_payload[i + 1] << 16) |
                         (stsd_payload[i + 2] << 8) | stsd_payload[i + 3];
@@ -160,73 +169,30 @@ static void parse_esds_audio_cfg(const std::vector<uint8_t> &stsd_payload, Mp4aC
     }
 }
 
-static std::vector<uint32_t> derive_chunk_plan(const std::vector<uint8_t> &stsc_payload,
-                                               uint32_t sample_count) {
-    std::vector<uint32_t> plan;
-    if (stsc_payload.size() < kStscHeaderSize + kStscEntrySize) {
-        return plan;
-    }
-    uint32_t entry_count = (stsc_payload[4] << 24) | (stsc_payload[5] << 16) |
-                           (stsc_payload[6] << 8) | stsc_payload[7];
-    size_t pos = kStscHeaderSize;
-    uint32_t consumed = 0;
-    for (uint32_t i = 0; i < entry_count; ++i) {
-        if (pos + kStscEntrySize > stsc_payload.size()) {
-            break;
-        }
-        uint32_t first_chunk = (stsc_payload[pos] << 24) | (stsc_payload[pos + 1] << 16) |
-                               (stsc_payload[pos + 2] << 8) | stsc_payload[pos + 3];
-        uint32_t samples_per_chunk = (stsc_payload[pos + 4] << 24) | (stsc_payload[pos + 5] << 16) |
-                                     (stsc_payload[pos + 6] << 8) | stsc_payload[pos + 7];
-        uint32_t next_first = 0;
-        if (i + 1 < entry_count && pos + kStscEntrySize <= stsc_payload.size() - 4) {
-            next_first = (stsc_payload[pos + 12] << 24) | (stsc_payload[pos + 13] << 16) |
-                         (stsc_payload[pos + 14] << 8) | (stsc_payload[pos + 15]);
-        }
-        uint32_t chunk_count = (next_first > 0) ? (next_first - first_chunk) : 0;
-        if (chunk_count == 0) {
-            while (consumed < sample_count) {
-                plan.push_back(samples_per_chunk);
-                consumed += samples_per_chunk;
-            }
-        } else {
-            for (uint32_t c = 0; c < chunk_count && consumed < sample_count; ++c) {
-                plan.push_back(samples_per_chunk);
-                consumed += samples_per_chunk;
-            }
-        }
-        pos += 12;
-    }
-    return plan;
-}
-
 std::optional<AacExtractResult> extract_from_mp4(const std::string &path) {
     const auto t0 = std::chrono::steady_clock::now();
     CH_LOG("debug", "mp4 reuse start: " << path);
-    std::ifstream f(path, std::ios::binary);
-    if (!f.is_open()) {
-        CH_LOG("debug", "Failed to open MP4: " << path << " (errno=" << errno
-                                               << " msg=" << std::strerror(errno) << ")");
-        return std::nullopt;
-    }
-
-    // Measure file size for safety bounds.
-    f.seekg(0, std::ios::end);
-    const auto file_size = static_cast<uint64_t>(f.tellg());
-    f.seekg(0, std::ios::beg);
-    if (file_size == 0) {
-        CH_LOG("error", "Empty or unreadable MP4: " << path);
+    auto input = InputFile::open(path);
+    if (!input) {
+        CH_LOG("error", "Failed to open " << path);
         return std::nullopt;
     }
+    // Structure and sample tables may come from the parse cache; frames always reference a
+    // mapping of the file being read.
+    const auto parsed_input = parse_input(*input);
     const auto t_open = std::chrono::steady_clock::now();
-    CH_LOG("debug", "calling parse_mp4 size=" << file_size << " path=" << path);
-    auto parsed_opt = parse_mp4(path);
-    if (!parsed_opt) {
+    if (!parsed_input) {
         CH_LOG("error", "Failed to parse MP4 (required moov/stbl atoms not found): " << path);
         return std::nullopt;
     }
-    CH_LOG("debug", "mp4 parsed optional has value for " << path);
-    ParsedMp4 &parsed = *parsed_opt;
+    const ParsedMp4 &parsed = parsed_input->parsed();
+    const auto source = parsed.source ? parsed.source : input->map();
+    if (!source) {
+        CH_LOG("error", "Failed to map " << path);
+        return std::nullopt;
+    }
+    // The mapping also bounds every table.
+    const uint64_t file_size = source->size();
     CH_LOG("debug", "mp4 parsed: stco=" << parsed.stco.size() << " stsc=" << parsed.stsc.size()
                                         << " stsz=" << parsed.stsz.size()
                                         << " stsd=" << parsed.stsd.size());
@@ -235,121 +201,49 @@ std::optional<AacExtractResult> extract_from_mp4(const std::string &path) {
         return std::nullopt;
     }
 
-    auto sizes_opt = parse_stsz_sizes(parsed.stsz);
-    if (!sizes_opt || parsed.stco.empty() || parsed.stsc.empty()) {
-        return std::nullopt;
-    }
-    const auto &sizes = *sizes_opt;
-    if (sizes.empty()) {
+    const SampleTable *table = parsed_input->audio_chunks();
+    if (table == nullptr || table->sample_count() == 0) {
+        CH_LOG("error", "Inconsistent stsz/stsc/stco tables in " << path);
         return std::nullopt;
     }
+    const auto sizes = table->sizes();
     // Sanity: bound sample count to reasonable size relative to file.
     if (sizes.size() > file_size / 8) {  // heuristic: avg sample >= 8 bytes
         CH_LOG("error", "Unreasonable sample count (" << sizes.size()
                                                       << "); aborting parse for " << path);
         return std::nullopt;
     }
-
-    CH_LOG("debug", "mp4 reuse: sizes=" << sizes.size() << " stco_bytes=" << parsed.stco.size()
-                                        << " stsc_bytes=" << parsed.stsc.size()
-                                        << " file_size=" << file_size);
-
-    std::vector<uint32_t> chunk_plan =
-        derive_chunk_plan(parsed.stsc, static_cast<uint32_t>(sizes.size()));
-    if (chunk_plan.empty()) {
-        return std::nullopt;
-    }
-    if (chunk_plan.size() > sizes.size() * 4 || chunk_plan.size() > 1000000) {
+    const auto chunk_plan = table->samples_per_chunk();
+    if (chunk_plan.size() > 1000000) {
         CH_LOG("error", "Unreasonable chunk plan size=" << chunk_plan.size()
                                                         << " samples=" << sizes.size());
         return std::nullopt;
     }
-
-    std::vector<std::vector<uint8_t>> frames;
-    frames.reserve(sizes.size());
-    size_t sample_idx = 0;
-    const uint8_t *pco = parsed.stco.data();
-    uint32_t stco_count = (pco[4] << 24) | (pco[5] << 16) | (pco[6] << 8) | pco[7];
-    // Validate stco table size matches count and fits in file.
-    uint64_t stco_expected = 8ull + 4ull * stco_count;
-    if (parsed.stco.size() < stco_expected || stco_expected > file_size) {
-        CH_LOG("error", "stco table truncated: size=" << parsed.stco.size()
-                                                      << " expected>=" << stco_expected);
-        return std::nullopt;
-    }
-
-    // Validate stsc table size matches entry count (12 bytes each after header).
-    if (parsed.stsc.size() < 8) {
-        return std::nullopt;
-    }
-    uint32_t stsc_entries =
-        (parsed.stsc[4] << 24) | (parsed.stsc[5] << 16) | (parsed.stsc[6] << 8) | parsed.stsc[7];
-    uint64_t stsc_expected = 8ull + 12ull * stsc_entries;
-    if (parsed.stsc.size() < stsc_expected || stsc_expected > file_size) {
-        CH_LOG("error", "stsc table truncated: size=" << parsed.stsc.size()
-                                                      << " expected>=" << stsc_expected);
-        return std::nullopt;
-    }
-    CH_LOG("debug", "mp4 reuse: stco_count=" << stco_count << " stsc_entries=" << stsc_entries
-                                             << " chunk_plan=" << chunk_plan.size());
+    CH_LOG("debug", "mp4 reuse: sizes=" << sizes.size() << " chunks=" << chunk_plan.size()
+                                        << (parsed.co64 ? " co64_bytes=" : " stco_bytes=")
+                                        << parsed.stco.size()
+                                        << " stsc_bytes=" << parsed.stsc.size()
+                                        << " file_size=" << file_size);
 
     const auto t_parse = std::chrono::steady_clock::now();
 
-    size_t stco_pos = 8;
-    for (uint32_t chunk_idx = 0; chunk_idx < stco_count && chunk_idx < chunk_plan.size() &&
-                                 sample_idx < sizes.size();
-         ++chunk_idx) {
-        if (stco_pos + 4 > parsed.stco.size()) {
-            break;
-        }
-        uint32_t chunk_offset = (pco[stco_pos] << 24) | (pco[stco_pos + 1] << 16) |
-                                (pco[stco_pos + 2] << 8) | pco[stco_pos + 3];
-        stco_pos += 4;
-        uint32_t samples_in_chunk = chunk_plan[chunk_idx];
-        uint64_t chunk_size = 0;
-        for (uint32_t i = 0; i < samples_in_chunk && sample_idx + i < sizes.size(); ++i) {
-            chunk_size += sizes[sample_idx + i];
-        }
-        if (chunk_size == 0) {
-            break;
-        }
-
-        // Bounds guard: chunk must fit in file.
-        if (static_cast<uint64_t>(chunk_offset) + chunk_size > file_size) {
-            CH_LOG("error", "Chunk exceeds file size: offset=" << chunk_offset
-                                                               << " size=" << chunk_size
-                                                               << " file_size=" << file_size);
-            break;
-        }
-
-        std::vector<uint8_t> chunk(chunk_size);
-        f.seekg(static_cast<std::streamoff>(chunk_offset), std::ios::beg);
-        f.read(reinterpret_cast<char *>(chunk.data()), static_cast<std::streamsize>(chunk_size));
-        if (f.gcount() != static_cast<std::streamsize>(chunk_size)) {
-            break;
-        }
-        size_t offset = 0;
-        for (uint32_t i = 0; i < samples_in_chunk && sample_idx < sizes.size(); ++i, ++sample_idx) {
-            uint32_t s = sizes[sample_idx];
-            if (offset + s > chunk.size()) {
-                CH_LOG("error", "sample range exceeds chunk: offset=" << offset
-                                                                      << " size=" << s
-                                                                      << " chunk=" << chunk.size());
-                break;
+    // Only sizes and chunk starts are indexed; frame positions fold into per-chunk runs.
+    FrameStore frames = FrameStore::view(source);
+    frames.reserve(sizes.size(), 0);
+    size_t sample = 0;
+    for (size_t chunk = 0; chunk < chunk_plan.size(); ++chunk) {
+        uint64_t offset = table->chunk_offsets()[chunk];
+        for (uint32_t i = 0; i < chunk_plan[chunk]; ++i, ++sample) {
+            if (!frames.add(offset, sizes[sample])) {
+                return std::nullopt;
             }
-            frames.emplace_back(chunk.begin() + offset, chunk.begin() + offset + s);
-            offset += s;
+            offset += sizes[sample];
         }
     }
     const auto t_samples = std::chrono::steady_clock::now();
 
-    if (frames.size() != sizes.size()) {
-        return std::nullopt;
-    }
-
     AacExtractResult out;
     out.frames = std::move(frames);
-    out.sizes = sizes;
     out.sample_rate = parsed.audio_timescale;
     Mp4aConfig cfg;
     cfg.sample_rate = parsed.audio_timescale;
@@ -360,13 +254,29 @@ std::optional<AacExtractResult> extract_from_mp4(const std::string &path) {
     out.channel_config = cfg.channel_count;
     out.sampling_index = cfg.sampling_index;
     out.audio_object_type = cfg.audio_object_type;
-    out.stsd_payload = parsed.stsd;
-    out.stts_payload = parsed.stts;
-    out.stsc_payload = parsed.stsc;
-    out.stsz_payload = parsed.stsz;
-    out.stco_payload = parsed.stco;
-    out.meta_payload = parsed.meta_payload;
-    out.ilst_payload = parsed.ilst_payload;
+    out.stsd_payload.assign(parsed.stsd.begin(), parsed.stsd.end());
+    out.stts_payload.assign(parsed.stts.begin(), parsed.stts.end());
+    out.stsc_payload.assign(parsed.stsc.begin(), parsed.stsc.end());
+    // A variable-size stsz keeps only its header; the entries are already in `frames`.
+    const bool variable_sizes = parsed.stsz.size() >= 8 && parsed.stsz[4] == 0 &&
+                                parsed.stsz[5] == 0 && parsed.stsz[6] == 0 && parsed.stsz[7] == 0;
+    out.stsz_payload.assign(parsed.stsz.begin(),
+                            variable_sizes ? parsed.stsz.begin() + 12 : parsed.stsz.end());
+    if (parsed.co64) {
+        // The output table is rebuilt from the layout anyway; keep the chunk count in a 32-bit
+        // stco (promoted back to co64 by the muxer when the output needs it).
+        out.stco_payload.assign(parsed.stco.begin(), parsed.stco.begin() + 8);
+        out.stco_payload.resize(8 + table->chunk_count() * 4, 0);
+        out.stco_payload[4] = static_cast<uint8_t>(table->chunk_count() >> 24);
+        out.stco_payload[5] = static_cast<uint8_t>(table->chunk_count() >> 16);
+        out.stco_payload[6] = static_cast<uint8_t>(table->chunk_count() >> 8);
+        out.stco_payload[7] = static_cast<uint8_t>(table->chunk_count());
+    } else {
+        out.stco_payload.assign(parsed.stco.begin(), parsed.stco.end());
+    }
+    out.chunk_offsets.assign(table->chunk_offsets().begin(), table->chunk_offsets().end());
+    out.meta_payload.assign(parsed.meta_payload.begin(), parsed.meta_payload.end());
+    out.ilst_payload.assign(parsed.ilst_payload.begin(), parsed.ilst_payload.end());
     const auto t_done = std::chrono::steady_clock::now();
     const auto open_ms =
         std::chrono::duration_cast<std::chrono::milliseconds>(t_open - t0).count();
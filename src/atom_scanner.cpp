@@ -0,0 +1,299 @@
+//
+//  atom_scanner.cpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#include "atom_scanner.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CHAPTERFORGE_SCAN_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#include "fourcc_utils.hpp"
+#include "logging.hpp"
+
+namespace {
+
+constexpr size_t kMaxFirstBytes = 8;
+
+// Distinct first characters of the fourccs still being searched for.
+struct FirstBytes {
+    uint8_t bytes[kMaxFirstBytes] = {};
+    size_t count = 0;
+};
+
+// Returns the first position in [pos, end) holding one of the first bytes, or `end`.
+using CandidateFinder = size_t (*)(const uint8_t *data, size_t pos, size_t end,
+                                   const FirstBytes &set);
+
+inline uint32_t be32(const uint8_t *p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) |
+           uint32_t(p[3]);
+}
+
+inline unsigned count_trailing_zeros(uint32_t v) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long idx = 0;
+    _BitScanForward(&idx, v);
+    return static_cast<unsigned>(idx);
+#else
+    return static_cast<unsigned>(__builtin_ctz(v));
+#endif
+}
+
+size_t find_scalar(const uint8_t *data, size_t pos, size_t end, const FirstBytes &set) {
+    if (set.count == 0) {  // more distinct first bytes than tracked: every byte is a candidate
+        return pos;
+    }
+    if (set.count == 1) {
+        const void *hit = std::memchr(data + pos, set.bytes[0], end - pos);
+        return hit ? static_cast<size_t>(static_cast<const uint8_t *>(hit) - data) : end;
+    }
+    for (; pos < end; ++pos) {
+        for (size_t k = 0; k < set.count; ++k) {
+            if (data[pos] == set.bytes[k]) {
+                return pos;
+            }
+        }
+    }
+    return end;
+}
+
+#if defined(CHAPTERFORGE_SCAN_X86)
+size_t find_sse2(const uint8_t *data, size_t pos, size_t end, const FirstBytes &set) {
+    __m128i needles[kMaxFirstBytes];
+    for (size_t k = 0; k < set.count; ++k) {
+        needles[k] = _mm_set1_epi8(static_cast<char>(set.bytes[k]));
+    }
+    while (pos + 16 <= end) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+        __m128i hits = _mm_cmpeq_epi8(v, needles[0]);
+        for (size_t k = 1; k < set.count; ++k) {
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(v, needles[k]));
+        }
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hits));
+        if (mask != 0) {
+            return pos + count_trailing_zeros(mask);
+        }
+        pos += 16;
+    }
+    return find_scalar(data, pos, end, set);
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("avx2")))
+#endif
+size_t find_avx2(const uint8_t *data, size_t pos, size_t end, const FirstBytes &set) {
+    __m256i needles[kMaxFirstBytes];
+    for (size_t k = 0; k < set.count; ++k) {
+        needles[k] = _mm256_set1_epi8(static_cast<char>(set.bytes[k]));
+    }
+    while (pos + 32 <= end) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+        __m256i hits = _mm256_cmpeq_epi8(v, needles[0]);
+        for (size_t k = 1; k < set.count; ++k) {
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(v, needles[k]));
+        }
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+        if (mask != 0) {
+            return pos + count_trailing_zeros(mask);
+        }
+        pos += 32;
+    }
+    return find_scalar(data, pos, end, set);
+}
+
+bool cpu_has_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4] = {};
+    __cpuid(regs, 1);
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    const bool avx = (regs[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif  // CHAPTERFORGE_SCAN_X86
+
+CandidateFinder finder_for(ScanIsa isa, const FirstBytes &set) {
+    if (set.count == 0) {
+        return find_scalar;
+    }
+#if defined(CHAPTERFORGE_SCAN_X86)
+    switch (isa) {
+        case ScanIsa::Avx2:
+            return find_avx2;
+        case ScanIsa::Sse2:
+            return find_sse2;
+        case ScanIsa::Scalar:
+            break;
+    }
+#else
+    (void)isa;
+#endif
+    return find_scalar;
+}
+
+// Full-box sample tables carry version/flags + entry_count; the entries must fit the payload.
+bool table_fits(std::span<const uint8_t> p, uint64_t header, uint64_t entry_size) {
+    if (p.size() < header || p[0] != 0) {
+        return false;
+    }
+    const uint64_t count = be32(p.data() + header - 4);
+    return header + count * entry_size <= p.size();
+}
+
+// Structural plausibility check for a candidate box payload.
+bool plausible_payload(uint32_t type, std::span<const uint8_t> p) {
+    switch (type) {
+        case fourcc("stts"):
+            return table_fits(p, 8, 8);
+        case fourcc("stsc"):
+            return table_fits(p, 8, 12);
+        case fourcc("stco"):
+            return table_fits(p, 8, 4);
+        case fourcc("co64"):
+            return table_fits(p, 8, 8);
+        case fourcc("stsz"):
+            if (p.size() < 12 || p[0] != 0) {
+                return false;
+            }
+            // Constant sample size means no per-sample entries follow.
+            return be32(p.data() + 4) != 0 || table_fits(p, 12, 4);
+        case fourcc("stsd"): {
+            if (p.size() < 8 || p[0] != 0) {
+                return false;
+            }
+            if (be32(p.data() + 4) == 0) {
+                return true;
+            }
+            if (p.size() < 16) {
+                return false;
+            }
+            const uint32_t entry = be32(p.data() + 8);
+            return entry >= 8 && entry <= p.size() - 8;
+        }
+        case fourcc("ilst"): {
+            if (p.size() < 8) {
+                return true;
+            }
+            const uint32_t first = be32(p.data());
+            return first >= 8 && first <= p.size();
+        }
+        default:
+            return true;
+    }
+}
+
+}  // namespace
+
+ScanIsa best_scan_isa() {
+#if defined(CHAPTERFORGE_SCAN_X86)
+    static const ScanIsa isa = cpu_has_avx2() ? ScanIsa::Avx2 : ScanIsa::Sse2;
+    return isa;
+#else
+    return ScanIsa::Scalar;
+#endif
+}
+
+uint64_t scan_atoms(std::span<const uint8_t> data, std::span<AtomScanTarget> targets,
+                    const AtomScanOptions &options) {
+    size_t remaining = 0;
+    bool overflow = false;
+    FirstBytes first;
+    for (const auto &t : targets) {
+        if (t.found) {
+            continue;
+        }
+        ++remaining;
+        const uint8_t b = static_cast<uint8_t>(t.type >> 24);
+        if (std::find(first.bytes, first.bytes + first.count, b) != first.bytes + first.count) {
+            continue;
+        }
+        if (first.count == kMaxFirstBytes) {
+            overflow = true;
+        } else {
+            first.bytes[first.count++] = b;
+        }
+    }
+    if (overflow) {
+        first.count = 0;
+    }
+    if (remaining == 0 || data.size() < 8) {
+        return 0;
+    }
+
+    const ScanIsa isa = options.isa.value_or(best_scan_isa());
+    const CandidateFinder find = finder_for(isa, first);
+    const size_t window = std::max<size_t>(options.window_bytes, 64);
+    const uint8_t *base = data.data();
+    // A fourcc at position i belongs to a box starting at i - 4.
+    const size_t last_type_pos = data.size() - 4;
+
+    size_t win_begin = 0;
+    size_t scanned_to = 0;
+    while (win_begin < data.size() && remaining > 0) {
+        const size_t win_end = std::min(data.size(), win_begin + window);
+        // Candidates never straddle windows: the whole buffer is addressable, so bytes before a
+        // type field (the size) and after it (the payload) are read directly.
+        size_t pos = std::max<size_t>(win_begin, 4);
+        const size_t stop = std::min(win_end, last_type_pos + 1);
+        while (pos < stop && remaining > 0) {
+            pos = find(base, pos, stop, first);
+            if (pos >= stop) {
+                break;
+            }
+            const uint32_t type = be32(base + pos);
+            for (auto &t : targets) {
+                if (t.found || t.type != type) {
+                    continue;
+                }
+                const uint64_t box = pos - 4;
+                const uint32_t size = be32(base + box);
+                if (size < 8) {
+                    break;
+                }
+                if (box + size > data.size()) {
+                    if (options.on_cut_box) {
+                        options.on_cut_box(box, size);
+                    }
+                    break;
+                }
+                auto payload = data.subspan(static_cast<size_t>(box + 8), size - 8);
+                if (!plausible_payload(type, payload)) {
+                    break;
+                }
+                t.found = true;
+                t.offset = box;
+                t.payload = payload;
+                --remaining;
+                CH_LOG("debug", "recovery scan: " << fourcc_to_string(type) << " @" << box
+                                                  << " bytes=" << payload.size());
+                break;
+            }
+            ++pos;
+        }
+        scanned_to = remaining == 0 ? std::min(pos, win_end) : win_end;
+        if (options.on_window_done) {
+            options.on_window_done(win_begin, scanned_to);
+        }
+        win_begin = win_end;
+    }
+    return scanned_to;
+}
@@ -0,0 +1,37 @@
+//
+//  box_writer.cpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#include "box_writer.hpp"
+
+BoxWriter::Scope BoxWriter::open(uint32_t type) {
+    const size_t start = buffer_.size();
+    // size, patched by close_box(), then the type
+    const uint8_t header[8] = {0, 0, 0, 0, static_cast<uint8_t>(type >> 24),
+                               static_cast<uint8_t>(type >> 16), static_cast<uint8_t>(type >> 8),
+                               static_cast<uint8_t>(type)};
+    bytes(header);
+    return Scope(this, start);
+}
+
+void BoxWriter::close_box(size_t start) {
+    uint64_t size = buffer_.size() - start;
+    uint8_t *header = buffer_.data() + start;
+    if (size > 0xFFFFFFFFULL) {
+        // size = 1 and a 64-bit largesize after the type. Only boxes past 4 GB pay for the move.
+        size += 8;
+        buffer_.insert(buffer_.begin() + static_cast<std::ptrdiff_t>(start + 8), 8, 0);
+        header = buffer_.data() + start;
+        for (int i = 0; i < 8; ++i) {
+            header[8 + i] = static_cast<uint8_t>(size >> (56 - 8 * i));
+        }
+        size = 1;
+    }
+    for (int i = 0; i < 4; ++i) {
+        header[i] = static_cast<uint8_t>(size >> (24 - 8 * i));
+    }
+}
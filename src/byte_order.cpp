@@ -0,0 +1,182 @@
+//
+//  byte_order.cpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#include "byte_order.hpp"
+
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CHAPTERFORGE_SWAP_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define CHAPTERFORGE_SWAP_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+constexpr bool kLittleEndian = std::endian::native == std::endian::little;
+
+// Reverse the bytes of each `Width`-byte element; `in` and `out` may not overlap. A converted
+// table reads back with the same operation, so loads and stores share the kernels.
+using SwapFn = void (*)(const uint8_t *in, uint8_t *out, size_t count);
+
+template <size_t Width>
+void swap_scalar(const uint8_t *in, uint8_t *out, size_t count) {
+    if (!kLittleEndian) {
+        std::memcpy(out, in, count * Width);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i, in += Width, out += Width) {
+        for (size_t b = 0; b < Width; ++b) {
+            out[b] = in[Width - 1 - b];
+        }
+    }
+}
+
+#if defined(CHAPTERFORGE_SWAP_X86)
+// Byte order within each 16-byte lane for 4- and 8-byte elements.
+#define CHAPTERFORGE_REVERSE32 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12
+#define CHAPTERFORGE_REVERSE64 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8
+
+template <size_t Width>
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("ssse3")))
+#endif
+void swap_ssse3(const uint8_t *in, uint8_t *out, size_t count) {
+    const __m128i mask = Width == 4 ? _mm_setr_epi8(CHAPTERFORGE_REVERSE32)
+                                    : _mm_setr_epi8(CHAPTERFORGE_REVERSE64);
+    constexpr size_t kPerStep = 16 / Width;
+    size_t i = 0;
+    for (; i + kPerStep <= count; i += kPerStep) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i * Width));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i * Width), _mm_shuffle_epi8(v, mask));
+    }
+    swap_scalar<Width>(in + i * Width, out + i * Width, count - i);
+}
+
+template <size_t Width>
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("avx2")))
+#endif
+void swap_avx2(const uint8_t *in, uint8_t *out, size_t count) {
+    // vpshufb shuffles within 128-bit lanes, so both lanes take the same pattern.
+    const __m256i mask = Width == 4 ? _mm256_setr_epi8(CHAPTERFORGE_REVERSE32,
+                                                       CHAPTERFORGE_REVERSE32)
+                                    : _mm256_setr_epi8(CHAPTERFORGE_REVERSE64,
+                                                       CHAPTERFORGE_REVERSE64);
+    constexpr size_t kPerStep = 32 / Width;
+    size_t i = 0;
+    for (; i + kPerStep <= count; i += kPerStep) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i * Width));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i * Width),
+                            _mm256_shuffle_epi8(v, mask));
+    }
+    swap_scalar<Width>(in + i * Width, out + i * Width, count - i);
+}
+
+#undef CHAPTERFORGE_REVERSE32
+#undef CHAPTERFORGE_REVERSE64
+
+bool cpu_has_ssse3() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4] = {};
+    __cpuid(regs, 1);
+    return (regs[2] & (1 << 9)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+#endif
+}
+
+bool cpu_has_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4] = {};
+    __cpuid(regs, 1);
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    const bool avx = (regs[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif  // CHAPTERFORGE_SWAP_X86
+
+#if defined(CHAPTERFORGE_SWAP_NEON)
+template <size_t Width>
+void swap_neon(const uint8_t *in, uint8_t *out, size_t count) {
+    constexpr size_t kPerStep = 16 / Width;
+    size_t i = 0;
+    for (; i + kPerStep <= count; i += kPerStep) {
+        const uint8x16_t v = vld1q_u8(in + i * Width);
+        vst1q_u8(out + i * Width, Width == 4 ? vrev32q_u8(v) : vrev64q_u8(v));
+    }
+    swap_scalar<Width>(in + i * Width, out + i * Width, count - i);
+}
+#endif
+
+template <size_t Width>
+SwapFn swap_for(SwapIsa isa) {
+    if (!kLittleEndian) {
+        return swap_scalar<Width>;
+    }
+    switch (isa) {
+#if defined(CHAPTERFORGE_SWAP_X86)
+        case SwapIsa::Avx2:
+            return swap_avx2<Width>;
+        case SwapIsa::Ssse3:
+            return swap_ssse3<Width>;
+#endif
+#if defined(CHAPTERFORGE_SWAP_NEON)
+        case SwapIsa::Neon:
+            return swap_neon<Width>;
+#endif
+        default:
+            return swap_scalar<Width>;
+    }
+}
+
+}  // namespace
+
+SwapIsa best_swap_isa() {
+#if defined(CHAPTERFORGE_SWAP_X86)
+    static const SwapIsa isa = cpu_has_avx2()    ? SwapIsa::Avx2
+                               : cpu_has_ssse3() ? SwapIsa::Ssse3
+                                                 : SwapIsa::Scalar;
+    return isa;
+#elif defined(CHAPTERFORGE_SWAP_NEON)
+    return SwapIsa::Neon;
+#else
+    return SwapIsa::Scalar;
+#endif
+}
+
+void store_be32(std::span<const uint32_t> values, uint8_t *out, SwapIsa isa) {
+    swap_for<4>(isa)(reinterpret_cast<const uint8_t *>(values.data()), out, values.size());
+}
+
+void load_be32(const uint8_t *in, std::span<uint32_t> values, SwapIsa isa) {
+    swap_for<4>(isa)(in, reinterpret_cast<uint8_t *>(values.data()), values.size());
+}
+
+void store_be64(std::span<const uint64_t> values, uint8_t *out, SwapIsa isa) {
+    swap_for<8>(isa)(reinterpret_cast<const uint8_t *>(values.data()), out, values.size());
+}
+
+void load_be64(const uint8_t *in, std::span<uint64_t> values, SwapIsa isa) {
+    swap_for<8>(isa)(in, reinterpret_cast<uint8_t *>(values.data()), values.size());
+}
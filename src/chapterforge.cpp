@@ -9,26 +9,41 @@
 #include "chapterforge_version.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <nlohmann/json.hpp>
 #include <optional>
 #include <cctype>
+#include <cstring>
 #include <utility>
+#include <functional>
 #include <chrono>
 #include <map>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 
 #include "aac_extractor.hpp"
 #include "logging.hpp"
+#include "mapped_file.hpp"
 #include "metadata_set.hpp"
 #include "chapter_text_sample.hpp"
 #include "chapter_image_sample.hpp"
+#include "coalesced_reads.hpp"
+#include "in_place_update.hpp"
+#include "input_file.hpp"
 #include "mp4a_builder.hpp"
 #include "mp4_atoms.hpp"
 #include "mp4_muxer.hpp"
+#include "parse_cache.hpp"
 #include "parser.hpp"
+#include "random_access_file.hpp"
+#include "sample_table.hpp"
+#include "sidecar_index.hpp"
+#include "stream_parser.hpp"
+#include "work_stealing.hpp"
 
 using json = nlohmann::json;
 
@@ -70,11 +85,12 @@ static std::optional<AacExtractResult> load_audio(const std::string &path) {
     if (ext == ".m4a" || ext == ".mp4") {
         return extract_from_mp4(path);
     }
-    std::vector<uint8_t> bytes;
-    if (!read_file(path, bytes)) {
+    auto file = MappedFile::open(path);
+    if (!file) {
+        CH_LOG("error", "Failed to open " << path);
         return std::nullopt;
     }
-    auto res = extract_adts_frames(bytes);
+    auto res = extract_adts_frames(std::move(file));
     if (res.frames.empty()) {
         return std::nullopt;
     }
@@ -87,7 +103,7 @@ inline uint32_t be32(const uint8_t *p) {
 }
 
 // Minimal ilst parser to surface top-level metadata into MetadataSet.
-static void parse_ilst_metadata(const std::vector<uint8_t> &ilst, MetadataSet &out) {
+static void parse_ilst_metadata(ByteView ilst, MetadataSet &out) {
     auto extract_data_box = [](const uint8_t *base, size_t len,
                                std::vector<uint8_t> &payload_out, uint32_t &data_type_out) -> bool {
         size_t cursor = 0;
@@ -259,6 +275,54 @@ namespace chapterforge {
 
 namespace {
 Status make_status(bool ok, std::string msg = {}) { return Status{ok, std::move(msg)}; }
+
+// Source ilst/meta payloads reused when the caller provides no metadata.
+struct SourceMetadata {
+    const std::vector<uint8_t> *ilst = nullptr;
+    const std::vector<uint8_t> *meta = nullptr;
+};
+
+SourceMetadata select_source_metadata(const AacExtractResult &aac, const MetadataSet &metadata) {
+    SourceMetadata source;
+    if (metadata_is_empty(metadata)) {
+        if (!aac.meta_payload.empty()) {
+            source.meta = &aac.meta_payload;
+            CH_LOG("debug", "Reusing source meta payload (" << source.meta->size() << " bytes)");
+        }
+        if (!aac.ilst_payload.empty()) {
+            source.ilst = &aac.ilst_payload;
+            CH_LOG("debug", "Reusing source ilst metadata (" << source.ilst->size() << " bytes)");
+        } else {
+            CH_LOG("warn",
+                   "source metadata missing and no metadata provided; output will carry empty ilst");
+        }
+    } else {
+        CH_LOG("debug", "Using metadata provided by caller (overrides source ilst/meta)");
+    }
+    return source;
+}
+
+std::vector<std::pair<std::string, std::vector<ChapterTextSample>>> url_track(
+    const std::vector<ChapterTextSample> &url_chapters) {
+    std::vector<std::pair<std::string, std::vector<ChapterTextSample>>> extra_text_tracks;
+    if (!url_chapters.empty()) {
+        extra_text_tracks.push_back({"Chapter URLs", url_chapters});
+    }
+    return extra_text_tracks;
+}
+
+// Remove the sidecar index of `path` before its chapters change in place: on file systems with
+// coarse modification times an update can leave size and mtime as they were, so a stale index
+// would still validate. `had_index` tells whether there was one; false if it cannot be removed.
+bool remove_sidecar_index(const std::string &path, bool &had_index) {
+    std::error_code ec;
+    had_index = std::filesystem::remove(sidecar_index::path_for(path), ec);
+    if (ec) {
+        CH_LOG("error", "cannot remove the index of " << path << ": " << ec.message());
+        return false;
+    }
+    return true;
+}
 }  // namespace
 
 Status mux_file_to_m4a(const std::string &input_audio_path,
@@ -267,6 +331,19 @@ Status mux_file_to_m4a(const std::string &input_audio_path,
                           const std::vector<ChapterImageSample> &image_chapters,
                           const MetadataSet &metadata, const std::string &output_path,
                           bool fast_start) {
+    MuxOptions options;
+    options.fast_start = fast_start;
+    return mux_file_to_m4a(input_audio_path, text_chapters, url_chapters, image_chapters, metadata,
+                           output_path, options);
+}
+
+Status mux_file_to_m4a(const std::string &input_audio_path,
+                       const std::vector<ChapterTextSample> &text_chapters,
+                       const std::vector<ChapterTextSample> &url_chapters,
+                       const std::vector<ChapterImageSample> &image_chapters,
+                       const MetadataSet &metadata, const std::string &output_path,
+                       const MuxOptions &options) {
+    const bool fast_start = options.fast_start;
     const auto t0 = std::chrono::steady_clock::now();
     CH_LOG("debug", "mux_file_to_m4a(titles+urls+images+meta) input=" << input_audio_path
                                                                       << " output=" << output_path
@@ -283,32 +360,17 @@ Status mux_file_to_m4a(const std::string &input_audio_path,
         CH_LOG("error", msg);
         return make_status(false, msg);
     }
-    const auto t_load = std::chrono::steady_clock::now();
-    Mp4aConfig cfg{};
-    const std::vector<uint8_t> *ilst_ptr = nullptr;
-    const std::vector<uint8_t> *meta_ptr = nullptr;
-    const bool caller_has_meta = !metadata_is_empty(metadata);
-    if (!caller_has_meta) {
-        if (!aac->meta_payload.empty()) {
-            meta_ptr = &aac->meta_payload;
-            CH_LOG("debug", "Reusing source meta payload (" << meta_ptr->size() << " bytes)");
-        }
-        if (!aac->ilst_payload.empty()) {
-            ilst_ptr = &aac->ilst_payload;
-            CH_LOG("debug", "Reusing source ilst metadata (" << ilst_ptr->size() << " bytes)");
-        } else {
-            CH_LOG("warn",
-                   "source metadata missing and no metadata provided; output will carry empty ilst");
-        }
-    } else {
-        CH_LOG("debug", "Using metadata provided by caller (overrides source ilst/meta)");
-    }
-    std::vector<std::pair<std::string, std::vector<ChapterTextSample>>> extra_text_tracks;
-    if (!url_chapters.empty()) {
-        extra_text_tracks.push_back({"Chapter URLs", url_chapters});
+    std::error_code ec;
+    if (aac->frames.is_view() && std::filesystem::equivalent(input_audio_path, output_path, ec)) {
+        // Writing over the source would pull the mapped frames out from under us.
+        aac->frames.materialize();
     }
-    bool ok = write_mp4(output_path, *aac, text_chapters, image_chapters, cfg, metadata,
-                        fast_start, extra_text_tracks, ilst_ptr, meta_ptr);
+    const auto t_load = std::chrono::steady_clock::now();
+    const SourceMetadata source = select_source_metadata(*aac, metadata);
+    const auto extra_text_tracks = url_track(url_chapters);
+    bool ok = write_mp4(output_path, *aac, text_chapters, image_chapters, Mp4aConfig{}, metadata,
+                        fast_start, extra_text_tracks, source.ilst, source.meta,
+                        options.write_threads);
     const auto t1 = std::chrono::steady_clock::now();
     const auto load_ms =
         std::chrono::duration_cast<std::chrono::milliseconds>(t_load - t0).count();
@@ -370,6 +432,15 @@ Status mux_file_to_m4a(const std::string &input_audio_path,
 Status mux_file_to_m4a(const std::string &input_audio_path,
                           const std::string &chapter_json_path, const std::string &output_path,
                           bool fast_start) {
+    MuxOptions options;
+    options.fast_start = fast_start;
+    return mux_file_to_m4a(input_audio_path, chapter_json_path, output_path, options);
+}
+
+Status mux_file_to_m4a(const std::string &input_audio_path,
+                       const std::string &chapter_json_path, const std::string &output_path,
+                       const MuxOptions &options) {
+    const bool fast_start = options.fast_start;
     CH_LOG("debug", "mux_file_to_m4a(json) input=" << input_audio_path
                                                    << " chapters=" << chapter_json_path
                                                    << " output=" << output_path
@@ -393,19 +464,157 @@ Status mux_file_to_m4a(const std::string &input_audio_path,
         url_chapters = std::move(extra_text_tracks.front().second);
     }
     return mux_file_to_m4a(input_audio_path, text_chapters, url_chapters, image_chapters, meta,
-                           output_path, fast_start);
+                           output_path, options);
+}
+
+PlanResult plan_m4a(const std::string &input_audio_path,
+                    const std::vector<ChapterTextSample> &text_chapters,
+                    const std::vector<ChapterTextSample> &url_chapters,
+                    const std::vector<ChapterImageSample> &image_chapters,
+                    const MetadataSet &metadata, bool fast_start) {
+    CH_LOG("debug", "plan_m4a input=" << input_audio_path << " fast_start=" << fast_start);
+    PlanResult result;
+    result.fast_start = fast_start;
+    auto aac = load_audio(input_audio_path);
+    if (!aac) {
+        result.status = make_status(false, "Failed to load audio from " + input_audio_path);
+        CH_LOG("error", result.status.message);
+        return result;
+    }
+    const SourceMetadata source = select_source_metadata(*aac, metadata);
+    Mp4Layout layout;
+    if (!plan_mp4(*aac, text_chapters, image_chapters, Mp4aConfig{}, metadata, fast_start,
+                  url_track(url_chapters), source.ilst, source.meta, layout)) {
+        result.status = make_status(false, "Failed to plan M4A layout for " + input_audio_path);
+        return result;
+    }
+    result.file_size = layout.file_size;
+    result.moov_offset = layout.moov_offset;
+    result.moov_size = layout.moov_size;
+    result.mdat_offset = layout.mdat_offset;
+    result.mdat_size = layout.mdat_size;
+    for (auto &t : layout.tracks) {
+        result.tracks.push_back({std::move(t.handler), std::move(t.name), t.samples, t.chunks,
+                                 t.bytes, t.offset});
+    }
+    result.status = make_status(true);
+    return result;
+}
+
+PlanResult plan_m4a(const std::string &input_audio_path, const std::string &chapter_json_path,
+                    bool fast_start) {
+    std::vector<ChapterTextSample> text_chapters;
+    std::vector<ChapterImageSample> image_chapters;
+    std::vector<std::pair<std::string, std::vector<ChapterTextSample>>> extra_text_tracks;
+    MetadataSet meta;
+    if (!load_chapters_json(chapter_json_path, text_chapters, image_chapters, meta,
+                            extra_text_tracks)) {
+        PlanResult result;
+        result.status = make_status(false, "Failed to load chapters JSON: " + chapter_json_path);
+        CH_LOG("error", result.status.message);
+        return result;
+    }
+    std::vector<ChapterTextSample> url_chapters;
+    if (!extra_text_tracks.empty()) {
+        url_chapters = std::move(extra_text_tracks.front().second);
+    }
+    return plan_m4a(input_audio_path, text_chapters, url_chapters, image_chapters, meta,
+                    fast_start);
+}
+
+Status recover_chapter_update(const std::string &path) {
+    switch (in_place::replay_journal(path)) {
+        case in_place::Replay::Failed:
+            return make_status(false, "Failed to finish the interrupted update of " + path);
+        case in_place::Replay::Applied: {
+            CH_LOG("info", "finished an interrupted chapter update of " << path);
+            invalidate_parse_cache(path);
+            bool had_index = false;
+            if (!remove_sidecar_index(path, had_index)) {
+                return make_status(false, "Failed to remove the stale index of " + path);
+            }
+            break;
+        }
+        case in_place::Replay::None:
+        case in_place::Replay::Discarded:
+            break;
+    }
+    return make_status(true);
+}
+
+Status update_chapters_in_place(const std::string &path,
+                                const std::vector<ChapterTextSample> &text_chapters,
+                                const std::vector<ChapterTextSample> &url_chapters,
+                                const std::vector<ChapterImageSample> &image_chapters,
+                                const MetadataSet &metadata) {
+    const auto t0 = std::chrono::steady_clock::now();
+    CH_LOG("debug", "update_chapters_in_place path=" << path << " titles=" << text_chapters.size()
+                                                     << " urls=" << url_chapters.size()
+                                                     << " images=" << image_chapters.size());
+    // A pending journal describes the file's current state; finish it before reading the file.
+    Status recovered = recover_chapter_update(path);
+    if (!recovered.ok) {
+        return recovered;
+    }
+    bool had_index = false;
+    if (!remove_sidecar_index(path, had_index)) {
+        return make_status(false, "Failed to remove the stale index of " + path);
+    }
+    auto aac = extract_from_mp4(path);
+    if (!aac) {
+        std::string msg = "Failed to load audio from " + path;
+        CH_LOG("error", msg);
+        return make_status(false, msg);
+    }
+    const SourceMetadata source = select_source_metadata(*aac, metadata);
+    const bool ok = update_mp4_in_place(path, *aac, text_chapters, image_chapters, Mp4aConfig{},
+                                        metadata, url_track(url_chapters), source.ilst,
+                                        source.meta);
+    invalidate_parse_cache(path);
+    CH_LOG("debug", "update_chapters_in_place ms="
+                        << std::chrono::duration_cast<std::chrono::milliseconds>(
+                               std::chrono::steady_clock::now() - t0)
+                               .count());
+    if (!ok) {
+        return make_status(false, "Failed to update " + path + " in place");
+    }
+    if (had_index) {
+        const Status indexed = write_index(path);
+        if (!indexed.ok) {
+            CH_LOG("warn", "index of " << path << " not rewritten: " << indexed.message);
+        }
+    }
+    return make_status(true);
+}
+
+Status update_chapters_in_place(const std::string &path, const std::string &chapter_json_path) {
+    std::vector<ChapterTextSample> text_chapters;
+    std::vector<ChapterImageSample> image_chapters;
+    std::vector<std::pair<std::string, std::vector<ChapterTextSample>>> extra_text_tracks;
+    MetadataSet meta;
+    if (!load_chapters_json(chapter_json_path, text_chapters, image_chapters, meta,
+                            extra_text_tracks)) {
+        std::string msg = "Failed to load chapters JSON: " + chapter_json_path;
+        CH_LOG("error", msg);
+        return make_status(false, msg);
+    }
+    std::vector<ChapterTextSample> url_chapters;
+    if (!extra_text_tracks.empty()) {
+        url_chapters = std::move(extra_text_tracks.front().second);
+    }
+    return update_chapters_in_place(path, text_chapters, url_chapters, image_chapters, meta);
 }
 
 }  // namespace chapterforge
 
 namespace {
 
-uint32_t read_u32_be(const std::vector<uint8_t> &buf, size_t off) {
+uint32_t read_u32_be(ByteView buf, size_t off) {
     return (static_cast<uint32_t>(buf[off]) << 24) | (static_cast<uint32_t>(buf[off + 1]) << 16) |
            (static_cast<uint32_t>(buf[off + 2]) << 8) | (static_cast<uint32_t>(buf[off + 3]));
 }
 
-uint16_t read_u16_be(const std::vector<uint8_t> &buf, size_t off) {
+uint16_t read_u16_be(ByteView buf, size_t off) {
     return static_cast<uint16_t>((static_cast<uint16_t>(buf[off]) << 8) |
                                  static_cast<uint16_t>(buf[off + 1]));
 }
@@ -413,300 +622,434 @@ uint16_t read_u16_be(const std::vector<uint8_t> &buf, size_t off) {
 using ::ChapterImageSample;
 using ::ChapterTextSample;
 using ::ParsedMp4;
+using chapterforge::RandomAccessSource;
 
-struct SamplePlan {
-    std::vector<uint64_t> offsets;
-    std::vector<uint32_t> sizes;
-};
-
-std::optional<SamplePlan> build_sample_plan(const parser_detail::TrackParseResult &trk,
-                                            std::istream &) {
-    SamplePlan plan;
-    // stsz: fixed or per-sample sizes
-    const auto &stsz = trk.stsz;
-    if (stsz.size() < 20) {
+std::optional<SampleTable> build_sample_table(const parser_detail::TrackParseResult &trk) {
+    if (trk.timescale == 0) {
         return std::nullopt;
     }
-    // stsz layout (payload only, size/type stripped):
-    // [0..3]  version/flags
-    // [4..7]  sample_size (0 means look at table)
-    // [8..11] sample_count
-    // [12..]  optional entry sizes
-    uint32_t sample_size = read_u32_be(stsz, 4);
-    uint32_t sample_count = read_u32_be(stsz, 8);
-    if (sample_size == 0) {
-        if (stsz.size() < 12 + sample_count * 4) {
-            return std::nullopt;
-        }
-        plan.sizes.reserve(sample_count);
-        for (uint32_t i = 0; i < sample_count; ++i) {
-            plan.sizes.push_back(read_u32_be(stsz, 12 + i * 4));
-        }
-    } else {
-        plan.sizes.assign(sample_count, sample_size);
-    }
+    return SampleTable::build(trk.stsz, trk.stsc, trk.stco, trk.stts, trk.co64);
+}
 
-    // stco: chunk offsets
-    const auto &stco = trk.stco;
-    if (stco.size() < 16) {
-        return std::nullopt;
-    }
-    uint32_t chunk_count = read_u32_be(stco, 4);
-    if (stco.size() < 8 + chunk_count * 4) {
-        return std::nullopt;
-    }
-    std::vector<uint64_t> chunk_offsets;
-    chunk_offsets.reserve(chunk_count);
-    for (uint32_t i = 0; i < chunk_count; ++i) {
-        chunk_offsets.push_back(read_u32_be(stco, 8 + i * 4));
-    }
+uint32_t start_ms(const SampleTable &table, uint32_t timescale, size_t sample) {
+    return static_cast<uint32_t>((table.decode_times()[sample] * 1000) / timescale);
+}
 
-    // stsc: samples per chunk mapping
-    const auto &stsc = trk.stsc;
-    if (stsc.size() < 16) {
-        return std::nullopt;
+struct ExtractedTracks {
+    std::vector<ChapterTextSample> titles;
+    std::vector<ChapterTextSample> urls;
+    std::vector<ChapterImageSample> images;
+};
+
+bool is_url_track_name(const std::string &name) {
+    std::string lower = name;
+    for (auto &c : lower) {
+        c = static_cast<char>(::tolower(static_cast<unsigned char>(c)));
     }
-    uint32_t entry_count = read_u32_be(stsc, 4);
-    if (stsc.size() < 8 + entry_count * 12) {
-        return std::nullopt;
+    return lower.find("url") != std::string::npos;
+}
+
+// Decode a tx3g sample: 16-bit text length, text, then optional boxes (href carries the URL).
+ChapterTextSample decode_tx3g_sample(ByteView buf) {
+    ChapterTextSample chapter_sample{};
+    const size_t sz = buf.size();
+    if (sz < 2) {
+        return chapter_sample;
     }
-    struct StscEntry {
-        uint32_t first_chunk;
-        uint32_t samples_per_chunk;
-    };
-    std::vector<StscEntry> entries;
-    entries.reserve(entry_count);
-    for (uint32_t i = 0; i < entry_count; ++i) {
-        size_t off = 8 + i * 12;
-        uint32_t first_chunk = read_u32_be(stsc, off);
-        uint32_t samples_per_chunk = read_u32_be(stsc, off + 4);
-        entries.push_back({first_chunk, samples_per_chunk});
-    }
-
-    plan.offsets.reserve(plan.sizes.size());
-    size_t sample_index = 0;
-    for (uint32_t chunk_idx = 1; chunk_idx <= chunk_count && sample_index < plan.sizes.size();
-         ++chunk_idx) {
-        // Find current stsc entry
-        uint32_t samples_per_chunk = entries.back().samples_per_chunk;
-        for (size_t e = 0; e + 1 < entries.size(); ++e) {
-            if (chunk_idx >= entries[e].first_chunk && chunk_idx < entries[e + 1].first_chunk) {
-                samples_per_chunk = entries[e].samples_per_chunk;
-                break;
-            }
+    uint16_t text_len = read_u16_be(buf, 0);
+    size_t text_bytes = std::min<size_t>(text_len, sz - 2);
+    chapter_sample.text.assign(reinterpret_cast<const char *>(buf.data() + 2), text_bytes);
+    size_t cursor = 2 + text_bytes;
+    // Optional href box
+    while (cursor + 8 <= sz) {
+        uint32_t box_size = read_u32_be(buf, cursor);
+        uint32_t box_type = read_u32_be(buf, cursor + 4);
+        if (box_size < 8 || cursor + box_size > sz) {
+            break;
         }
-        uint64_t base_offset = chunk_offsets[chunk_idx - 1];
-        uint64_t cursor = base_offset;
-        for (uint32_t s = 0; s < samples_per_chunk && sample_index < plan.sizes.size(); ++s) {
-            plan.offsets.push_back(cursor);
-            cursor += plan.sizes[sample_index];
-            ++sample_index;
+        if (box_type == 0x68726566) {  // 'href'
+            if (box_size >= 8 + 2 + 2 + 1) {
+                uint8_t url_len = buf[cursor + 8 + 2 + 2];
+                size_t url_off = cursor + 8 + 2 + 2 + 1;
+                if (url_off + url_len <= cursor + box_size) {
+                    chapter_sample.href.assign(
+                        reinterpret_cast<const char *>(buf.data() + url_off), url_len);
+                }
+            }
         }
+        cursor += box_size;
     }
-    if (plan.offsets.size() != plan.sizes.size()) {
-        return std::nullopt;
+    return chapter_sample;
+}
+
+// Timed samples of a chapter track that carry data (tx3g needs at least its length field).
+std::vector<size_t> usable_samples(const SampleTable &table, uint32_t min_size) {
+    std::vector<size_t> samples;
+    samples.reserve(table.decode_times().size());
+    for (size_t i = 0; i < table.decode_times().size(); ++i) {
+        if (table.size(i) >= min_size) {
+            samples.push_back(i);
+        }
     }
-    return plan;
+    return samples;
 }
 
+constexpr uint32_t kMinTextSample = 2;
+constexpr uint32_t kMinImageSample = 1;
+
+// Start times of the title samples read_m4a and ChapterReader report as chapters. Sizes come from
+// stsz, so this never touches mdat.
 std::vector<uint32_t> build_start_times_ms(const parser_detail::TrackParseResult &trk) {
     std::vector<uint32_t> starts;
-    if (trk.timescale == 0 || trk.stts.empty()) {
-        return starts;
-    }
-    // stts (decoding time-to-sample) box:
-    // [0..3]=version/flags, [4..7]=entry_count, followed by entry_count pairs
-    // of (sample_count, sample_delta).
-    uint32_t entry_count = read_u32_be(trk.stts, 4);
-    if (trk.stts.size() < 8 + entry_count * 8) {
+    auto table = build_sample_table(trk);
+    if (!table) {
         return starts;
     }
-    uint64_t cum = 0;
-    starts.reserve(trk.sample_count);
-    for (uint32_t i = 0; i < entry_count; ++i) {
-        size_t off = 8 + i * 8;
-        uint32_t count = read_u32_be(trk.stts, off);
-        uint32_t delta = read_u32_be(trk.stts, off + 4);
-        for (uint32_t j = 0; j < count; ++j) {
-            uint32_t ms = static_cast<uint32_t>((cum * 1000) / trk.timescale);
-            starts.push_back(ms);
-            cum += delta;
-        }
+    const auto samples = usable_samples(*table, kMinTextSample);
+    starts.reserve(samples.size());
+    for (size_t s : samples) {
+        starts.push_back(start_ms(*table, trk.timescale, s));
     }
     return starts;
 }
 
-struct ExtractedTracks {
-    std::vector<ChapterTextSample> titles;
-    std::vector<ChapterTextSample> urls;
-    std::vector<ChapterImageSample> images;
+// A chapter track ready for extraction: its sample table (owned by the ParsedInput) and the
+// timed samples carrying data.
+struct TrackSamples {
+    const SampleTable *table = nullptr;
+    uint32_t timescale = 0;
+    std::vector<size_t> samples;
 };
 
-bool is_url_track_name(const std::string &name) {
-    std::string lower = name;
-    for (auto &c : lower) {
-        c = static_cast<char>(::tolower(static_cast<unsigned char>(c)));
+TrackSamples prepare_track(const ParsedInput &input, const parser_detail::TrackParseResult *trk,
+                           uint32_t min_size) {
+    TrackSamples track;
+    if (trk == nullptr) {
+        return track;
     }
-    return lower.find("url") != std::string::npos;
+    track.table = input.track_table(static_cast<size_t>(trk - input.parsed().tracks.data()));
+    if (track.table) {
+        track.timescale = trk->timescale;
+        track.samples = usable_samples(*track.table, min_size);
+    }
+    return track;
 }
 
-std::vector<ChapterTextSample> parse_tx3g_track(const parser_detail::TrackParseResult &trk,
-                                                std::istream &in) {
-    std::vector<ChapterTextSample> out;
-    auto starts = build_start_times_ms(trk);
-    auto plan_opt = build_sample_plan(trk, in);
-    if (!plan_opt) {
-        return out;
-    }
-    const auto &plan = *plan_opt;
-    size_t sample_count = std::min({plan.offsets.size(), plan.sizes.size(), starts.size()});
-    CH_LOG("debug", "tx3g track: plan sizes=" << plan.sizes.size()
-                                              << " offsets=" << plan.offsets.size()
-                                              << " starts=" << starts.size()
-                                              << " sample_count=" << sample_count
-                                              << " size[0]="
-                                              << (plan.sizes.empty() ? 0 : plan.sizes[0]));
-    out.reserve(sample_count);
-    for (size_t i = 0; i < sample_count; ++i) {
-        uint64_t off = plan.offsets[i];
-        uint32_t sz = plan.sizes[i];
-        if (sz < 2) {
-            continue;
-        }
-        std::vector<uint8_t> buf(sz);
-        in.seekg(static_cast<std::streamoff>(off), std::ios::beg);
-        in.read(reinterpret_cast<char *>(buf.data()), sz);
-        uint16_t text_len = read_u16_be(buf, 0);
-        size_t text_bytes = std::min<size_t>(text_len, sz > 2 ? sz - 2 : 0);
-        ChapterTextSample chapter_sample{};
-        chapter_sample.start_ms = starts[i];
-        chapter_sample.text.assign(reinterpret_cast<const char *>(buf.data() + 2), text_bytes);
-        size_t cursor = 2 + text_bytes;
-        // Optional href box
-        while (cursor + 8 <= sz) {
-            uint32_t box_size = read_u32_be(buf, cursor);
-            uint32_t box_type = read_u32_be(buf, cursor + 4);
-            if (box_size < 8 || cursor + box_size > sz) {
-                break;
-            }
-            if (box_type == 0x68726566) {  // 'href'
-                if (box_size >= 8 + 2 + 2 + 1) {
-                    uint8_t url_len = buf[cursor + 8 + 2 + 2];
-                    size_t url_off = cursor + 8 + 2 + 2 + 1;
-                    if (url_off + url_len <= cursor + box_size) {
-                        chapter_sample.href.assign(
-                            reinterpret_cast<const char *>(buf.data() + url_off), url_len);
-                    }
-                }
-            }
-            cursor += box_size;
+// Samples[begin, end) of one track and what to do with them: `visit` gets the index into
+// `track.samples` and the sample bytes. `failed` is raised when they cannot be read.
+struct SampleRun {
+    const TrackSamples *track = nullptr;
+    size_t begin = 0;
+    size_t end = 0;
+    std::function<void(size_t, ByteView)> visit;
+    std::atomic<bool> *failed = nullptr;
+};
+
+// Decode samples[begin, end) into out[begin, end); `out` is pre-sized by the caller.
+SampleRun text_run(const TrackSamples &track, size_t begin, size_t end,
+                   std::vector<ChapterTextSample> &out, std::atomic<bool> &failed) {
+    return {&track, begin, end,
+            [&track, &out](size_t n, ByteView bytes) {
+                out[n] = decode_tx3g_sample(bytes);
+                out[n].start_ms = start_ms(*track.table, track.timescale, track.samples[n]);
+            },
+            &failed};
+}
+
+SampleRun image_run(const TrackSamples &track, size_t begin, size_t end,
+                    std::vector<ChapterImageSample> &out, std::atomic<bool> &failed) {
+    return {&track, begin, end,
+            [&track, &out](size_t n, ByteView bytes) {
+                out[n].start_ms = start_ms(*track.table, track.timescale, track.samples[n]);
+                out[n].data.assign(bytes.begin(), bytes.end());
+            },
+            &failed};
+}
+
+// Fetch all runs as one coalesced batch, so neighbouring runs of different tracks can share a
+// request. Holes up to the source's minimum request size are read through.
+bool read_runs(std::span<const SampleRun> runs, RandomAccessSource &source) {
+    std::vector<CoalescedReads::Range> ranges;
+    std::vector<std::pair<size_t, size_t>> owners;  // run, sample index per range
+    for (size_t r = 0; r < runs.size(); ++r) {
+        const TrackSamples &track = *runs[r].track;
+        for (size_t n = runs[r].begin; n < runs[r].end; ++n) {
+            const size_t sample = track.samples[n];
+            ranges.push_back({track.table->offset(sample), track.table->size(sample)});
+            owners.emplace_back(r, n);
         }
-        out.push_back(std::move(chapter_sample));
     }
-    return out;
+    CoalescedReads reads(std::max(CoalescedReads::kDefaultMaxGap, source.min_request_size()));
+    return reads.read(source, ranges, [&](size_t i, ByteView bytes) {
+        runs[owners[i].first].visit(owners[i].second, bytes);
+    });
 }
 
-std::vector<ChapterImageSample> parse_image_track(const parser_detail::TrackParseResult &trk,
-                                                  std::istream &in) {
-    std::vector<ChapterImageSample> out;
-    auto starts = build_start_times_ms(trk);
-    auto plan_opt = build_sample_plan(trk, in);
-    if (!plan_opt) {
-        return out;
-    }
-    const auto &plan = *plan_opt;
-    size_t sample_count = std::min({plan.offsets.size(), plan.sizes.size(), starts.size()});
-    out.reserve(sample_count);
-    for (size_t i = 0; i < sample_count; ++i) {
-        uint64_t off = plan.offsets[i];
-        uint32_t sz = plan.sizes[i];
-        if (sz == 0) {
-            continue;
-        }
-        std::vector<uint8_t> buf(sz);
-        in.seekg(static_cast<std::streamoff>(off), std::ios::beg);
-        in.read(reinterpret_cast<char *>(buf.data()), sz);
-        ChapterImageSample img_sample{};
-        img_sample.start_ms = starts[i];
-        img_sample.data = std::move(buf);
-        out.push_back(std::move(img_sample));
+// Read a batch; when it fails, retry run by run so one damaged track does not empty the others.
+void read_batch(std::span<const SampleRun> runs, RandomAccessSource &source) {
+    if (read_runs(runs, source)) {
+        return;
+    }
+    for (const SampleRun &run : runs) {
+        if (runs.size() == 1 || !read_runs({&run, 1}, source)) {
+            *run.failed = true;
+        }
     }
-    return out;
 }
 
-ExtractedTracks extract_tracks(const ParsedMp4 &parsed, std::istream &in) {
-    ExtractedTracks ext;
+// Split samples into at most `parts` contiguous groups of similar byte size, none smaller than
+// `min_bytes` (except a lone remainder). Returns group end indices.
+std::vector<size_t> split_by_bytes(const TrackSamples &track, unsigned parts, uint64_t min_bytes) {
+    uint64_t total = 0;
+    for (size_t i : track.samples) {
+        total += track.table->size(i);
+    }
+    const uint64_t target = std::max<uint64_t>(min_bytes, total / std::max(parts, 1u));
+    std::vector<size_t> ends;
+    uint64_t bytes = 0;
+    for (size_t n = 0; n < track.samples.size(); ++n) {
+        bytes += track.table->size(track.samples[n]);
+        if (bytes >= target) {
+            ends.push_back(n + 1);
+            bytes = 0;
+        }
+    }
+    if (ends.empty() || ends.back() != track.samples.size()) {
+        ends.push_back(track.samples.size());
+    }
+    return ends;
+}
+
+// Run every task once on up to `threads` threads, the calling thread included.
+void run_tasks(const std::vector<std::function<void()>> &tasks, unsigned threads) {
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t i = next.fetch_add(1); i < tasks.size(); i = next.fetch_add(1)) {
+            tasks[i]();
+        }
+    };
+    const size_t helpers = std::min<size_t>(threads, tasks.size()) - (tasks.empty() ? 0 : 1);
+    std::vector<std::thread> pool;
+    pool.reserve(helpers);
+    for (size_t i = 0; i < helpers; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto &t : pool) {
+        t.join();
+    }
+}
+
+// Image chunks below this size are not worth a task of their own.
+constexpr uint64_t kMinImageChunkBytes = 1024 * 1024;
+
+// Chapter-related tracks of a parsed file (titles, optional URLs, optional images).
+struct ChapterTracks {
     const parser_detail::TrackParseResult *titles = nullptr;
     const parser_detail::TrackParseResult *urls = nullptr;
     const parser_detail::TrackParseResult *images = nullptr;
+};
+
+ChapterTracks select_chapter_tracks(const ParsedMp4 &parsed) {
+    ChapterTracks sel;
     std::vector<const parser_detail::TrackParseResult *> text_tracks;
 
     for (const auto &trk : parsed.tracks) {
         if (trk.handler_type == 0x74657874) {  // 'text'
             text_tracks.push_back(&trk);
-            if (!urls && is_url_track_name(trk.handler_name)) {
-                urls = &trk;
-            } else if (!titles) {
-                titles = &trk;
+            if (!sel.urls && is_url_track_name(trk.handler_name)) {
+                sel.urls = &trk;
+            } else if (!sel.titles) {
+                sel.titles = &trk;
             }
         } else if (trk.handler_type == 0x76696465) {  // 'vide'
-            if (!images) {
-                images = &trk;
+            if (!sel.images) {
+                sel.images = &trk;
             }
         }
     }
 
     // If we did not conclusively identify a URL track by name, but there are multiple
     // text tracks, treat the second one as URLs (mirrors how we author files).
-    if (!urls && text_tracks.size() > 1) {
-        urls = text_tracks[1];
+    if (!sel.urls && text_tracks.size() > 1) {
+        sel.urls = text_tracks[1];
     }
+    return sel;
+}
 
-    if (titles) {
-        ext.titles = parse_tx3g_track(*titles, in);
+// Extract titles, URLs and images. A single thread plans every sample of every track as one
+// batch of coalesced reads. With several threads the text tracks form one batch and chunks of the
+// image track further batches, read concurrently through the shared source; every batch fills
+// its own slots of pre-sized outputs, so the result does not depend on scheduling.
+ExtractedTracks extract_tracks(const ParsedInput &input, RandomAccessSource &source,
+                               unsigned threads) {
+    ExtractedTracks ext;
+    const ChapterTracks sel = select_chapter_tracks(input.parsed());
+    const TrackSamples titles = prepare_track(input, sel.titles, kMinTextSample);
+    const TrackSamples urls = prepare_track(input, sel.urls, kMinTextSample);
+    const TrackSamples images = prepare_track(input, sel.images, kMinImageSample);
+    if (titles.table) {
+        CH_LOG("debug", "tx3g track: samples=" << titles.table->sample_count()
+                                               << " chunks=" << titles.table->chunk_count()
+                                               << " timed=" << titles.table->decode_times().size());
+    }
+    ext.titles.resize(titles.samples.size());
+    ext.urls.resize(urls.samples.size());
+    ext.images.resize(images.samples.size());
+
+    // A failed read empties its whole track.
+    std::atomic<bool> titles_failed{false};
+    std::atomic<bool> urls_failed{false};
+    std::atomic<bool> images_failed{false};
+    std::vector<std::vector<SampleRun>> batches(1);
+    if (!titles.samples.empty()) {
+        batches[0].push_back(text_run(titles, 0, titles.samples.size(), ext.titles, titles_failed));
     }
-    if (urls) {
-        ext.urls = parse_tx3g_track(*urls, in);
+    if (!urls.samples.empty()) {
+        batches[0].push_back(text_run(urls, 0, urls.samples.size(), ext.urls, urls_failed));
     }
-    if (images) {
-        ext.images = parse_image_track(*images, in);
+    if (!images.samples.empty()) {
+        if (threads <= 1) {
+            batches[0].push_back(
+                image_run(images, 0, images.samples.size(), ext.images, images_failed));
+        } else {
+            size_t begin = 0;
+            for (size_t end : split_by_bytes(images, threads, kMinImageChunkBytes)) {
+                batches.push_back({image_run(images, begin, end, ext.images, images_failed)});
+                begin = end;
+            }
+        }
+    }
+    std::vector<std::function<void()>> tasks;
+    // Largest work first: image chunks, then the text tracks.
+    for (auto it = batches.rbegin(); it != batches.rend(); ++it) {
+        if (!it->empty()) {
+            tasks.emplace_back([&source, &runs = *it] { read_batch(runs, source); });
+        }
+    }
+    run_tasks(tasks, threads);
+
+    if (titles_failed) {
+        ext.titles.clear();
+    }
+    if (urls_failed) {
+        ext.urls.clear();
+    }
+    if (images_failed) {
+        ext.images.clear();
     }
     return ext;
 }
 
-// Require exact start alignment between tracks; no drift tolerance.
-constexpr uint32_t kStartMatchToleranceMs = 0;
+// Tail windows tried when the top-level header walk cannot reach moov (damaged sizes).
+constexpr uint64_t kProbeTailWindows[] = {64 * 1024, 1024 * 1024, 16 * 1024 * 1024};
+constexpr uint64_t kProbeMaxMoov = 256 * 1024 * 1024;
 
-// Align URL track entries to the title track by start time. URLs that share
-// (or are within tolerance of) a title start time are paired; if none is found
-// the slot is left empty but preserved to avoid shifting chapter order. Extras
-// are reported and discarded.
-std::vector<ChapterTextSample> align_urls_to_titles(const std::vector<ChapterTextSample> &titles,
-                                                    const std::vector<ChapterTextSample> &urls) {
-    if (titles.empty()) {
-        return {};
+struct MoovLocation {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+};
+
+// Walk top-level atom headers with positional reads (16 bytes each); payloads are skipped by
+// offset, so mdat is never touched.
+std::optional<MoovLocation> find_moov_by_headers(RandomAccessFile &file) {
+    const uint64_t file_size = file.size();
+    uint64_t pos = 0;
+    uint8_t hdr[16];
+    while (pos + 8 <= file_size) {
+        const size_t want = static_cast<size_t>(std::min<uint64_t>(16, file_size - pos));
+        if (!file.read_at(pos, hdr, want)) {
+            return std::nullopt;
+        }
+        uint64_t size = be32(hdr);
+        const uint32_t type = be32(hdr + 4);
+        if (size == 1) {
+            if (want < 16) {
+                return std::nullopt;
+            }
+            size = (uint64_t(be32(hdr + 8)) << 32) | be32(hdr + 12);
+        } else if (size == 0) {
+            size = file_size - pos;  // atom extends to end of file
+        }
+        if (size < 8 || size > file_size - pos || !is_printable_fourcc(type)) {
+            CH_LOG("debug", "probe: header walk stopped at " << pos << " size=" << size);
+            return std::nullopt;
+        }
+        if (type == fourcc("moov")) {
+            return MoovLocation{pos, size};
+        }
+        pos += size;
+    }
+    return std::nullopt;
+}
+
+// Look for a moov atom that ends exactly at EOF (non-faststart layout) in growing tail windows.
+std::optional<MoovLocation> find_moov_in_tail(RandomAccessFile &file) {
+    const uint64_t file_size = file.size();
+    std::vector<uint8_t> tail;
+    for (uint64_t window : kProbeTailWindows) {
+        window = std::min(window, file_size);
+        const uint64_t base = file_size - window;
+        if (!file.read_at(base, static_cast<size_t>(window), tail)) {
+            return std::nullopt;
+        }
+        for (size_t i = tail.size() >= 8 ? tail.size() - 8 : 0; i-- > 0;) {
+            if (std::memcmp(tail.data() + i + 4, "moov", 4) == 0 &&
+                be32(tail.data() + i) == file_size - (base + i)) {
+                return MoovLocation{base + i, file_size - (base + i)};
+            }
+        }
+        if (base == 0) {
+            break;
+        }
     }
+    return std::nullopt;
+}
 
-    std::multimap<uint32_t, ChapterTextSample> by_start;
-    for (const auto &u : urls) {
-        by_start.emplace(u.start_ms, u);
+bool ilst_has_cover(ByteView ilst) {
+    size_t offset = 0;
+    while (offset + 8 <= ilst.size()) {
+        const uint32_t sz = be32(ilst.data() + offset);
+        if (sz < 8 || offset + sz > ilst.size()) {
+            break;
+        }
+        // covr item holding a data box with a non-empty payload (data header is 16 bytes).
+        if (be32(ilst.data() + offset + 4) == fourcc("covr") && sz > 8 + 16) {
+            return true;
+        }
+        offset += sz;
     }
+    return false;
+}
 
-    std::vector<ChapterTextSample> out;
-    out.reserve(titles.size());
+// Require exact start alignment between tracks; no drift tolerance.
+constexpr uint32_t kStartMatchToleranceMs = 0;
 
-    size_t missing = 0;
-    for (const auto &t : titles) {
+constexpr size_t kNoSample = std::numeric_limits<size_t>::max();
+
+// Align track entries (URLs, images) to the title track by start time. For each title, returns
+// the index of the entry that shares (or is within tolerance of) its start time, or kNoSample;
+// each entry pairs with at most one title, so chapter order never shifts. Extras are discarded.
+std::vector<size_t> align_starts_to_titles(const std::vector<uint32_t> &title_starts,
+                                           const std::vector<uint32_t> &starts) {
+    std::multimap<uint32_t, size_t> by_start;
+    for (size_t i = 0; i < starts.size(); ++i) {
+        by_start.emplace(starts[i], i);
+    }
+
+    std::vector<size_t> out;
+    out.reserve(title_starts.size());
+    for (uint32_t title_start : title_starts) {
         const uint32_t lo =
-            (t.start_ms > kStartMatchToleranceMs) ? t.start_ms - kStartMatchToleranceMs : 0;
-        const uint32_t hi = t.start_ms + kStartMatchToleranceMs;
+            (title_start > kStartMatchToleranceMs) ? title_start - kStartMatchToleranceMs : 0;
+        const uint32_t hi = title_start + kStartMatchToleranceMs;
         auto it = by_start.lower_bound(lo);
 
         auto best = by_start.end();
         uint32_t best_diff = std::numeric_limits<uint32_t>::max();
         while (it != by_start.end() && it->first <= hi) {
             uint32_t diff =
-                (t.start_ms > it->first) ? (t.start_ms - it->first) : (it->first - t.start_ms);
+                (title_start > it->first) ? (title_start - it->first) : (it->first - title_start);
             if (diff < best_diff) {
                 best = it;
                 best_diff = diff;
@@ -718,91 +1061,87 @@ std::vector<ChapterTextSample> align_urls_to_titles(const std::vector<ChapterTex
             out.push_back(best->second);
             by_start.erase(best);
         } else {
-            ChapterTextSample empty{};
-            empty.start_ms = t.start_ms;
-            out.push_back(std::move(empty));
-            ++missing;
+            out.push_back(kNoSample);  // missing entries are normal
         }
     }
-
-    (void)missing;  // Missing entries are normal; placeholders were inserted to align.
-    (void)by_start; // Extra entries are tolerated silently.
-
     return out;
 }
 
-std::vector<ChapterImageSample> align_images_to_titles(const std::vector<ChapterTextSample> &titles,
-                                                       const std::vector<ChapterImageSample> &images) {
-    if (titles.empty()) {
-        return {};
+// Sample-level alignment for read_m4a: unmatched titles get an empty entry at the title's start.
+template <typename Sample>
+std::vector<Sample> align_to_titles(const std::vector<ChapterTextSample> &titles,
+                                    const std::vector<Sample> &samples) {
+    std::vector<uint32_t> title_starts;
+    std::vector<uint32_t> starts;
+    for (const auto &t : titles) {
+        title_starts.push_back(t.start_ms);
     }
-
-    std::multimap<uint32_t, ChapterImageSample> by_start;
-    for (const auto &img : images) {
-        by_start.emplace(img.start_ms, img);
+    for (const auto &sample : samples) {
+        starts.push_back(sample.start_ms);
     }
-
-    std::vector<ChapterImageSample> out;
+    std::vector<Sample> out;
     out.reserve(titles.size());
-
-    size_t missing = 0;
-    for (const auto &t : titles) {
-        const uint32_t lo =
-            (t.start_ms > kStartMatchToleranceMs) ? t.start_ms - kStartMatchToleranceMs : 0;
-        const uint32_t hi = t.start_ms + kStartMatchToleranceMs;
-        auto it = by_start.lower_bound(lo);
-
-        auto best = by_start.end();
-        uint32_t best_diff = std::numeric_limits<uint32_t>::max();
-        while (it != by_start.end() && it->first <= hi) {
-            uint32_t diff =
-                (t.start_ms > it->first) ? (t.start_ms - it->first) : (it->first - t.start_ms);
-            if (diff < best_diff) {
-                best = it;
-                best_diff = diff;
-            }
-            ++it;
-        }
-
-        if (best != by_start.end()) {
-            out.push_back(best->second);
-            by_start.erase(best);
+    const auto index = align_starts_to_titles(title_starts, starts);
+    for (size_t i = 0; i < titles.size(); ++i) {
+        if (index[i] != kNoSample) {
+            out.push_back(samples[index[i]]);
         } else {
-            ChapterImageSample empty{};
-            empty.start_ms = t.start_ms;
+            Sample empty{};
+            empty.start_ms = titles[i].start_ms;
             out.push_back(std::move(empty));
-            ++missing;
         }
     }
-
-    (void)missing;  // Missing entries are normal; placeholders were inserted to align.
-    (void)by_start; // Extra entries are tolerated silently.
-
     return out;
 }
 
+// Locate moov with the top-level header walk, falling back to the tail search.
+std::optional<MoovLocation> locate_moov(RandomAccessFile &file) {
+    auto where = find_moov_by_headers(file);
+    if (!where) {
+        where = find_moov_in_tail(file);
+    }
+    if (where && where->size > kProbeMaxMoov) {
+        return std::nullopt;
+    }
+    return where;
+}
+
 }  // namespace
 
 namespace chapterforge {
 
-ReadResult read_m4a(const std::string &path) {
+namespace {
+
+// Shared body of the read_m4a() overloads. `parsed_input` is parsed from `input` when not given.
+ReadResult read_input(InputFile &input, const ReadOptions &options,
+                      std::shared_ptr<const ParsedInput> parsed_input = nullptr) {
     ReadResult result{};
-    std::ifstream in(path, std::ios::binary);
-    if (!in.is_open()) {
-        result.status = {false, "Failed to open " + path};
-        return result;
+    // Every exit reports what was spent, including budget failures.
+    auto finish = [&](Status status) {
+        const auto stats = input.stats();
+        result.io = {stats.opens, stats.reads, stats.bytes};
+        if (input.budget_exceeded()) {
+            status = {false, "Read budget of " + std::to_string(options.max_bytes) +
+                                 " bytes exceeded for " + input.name()};
+        }
+        result.status = std::move(status);
+        return std::move(result);
+    };
+    if (!parsed_input) {
+        parsed_input = parse_input(input);
     }
-    auto parsed = parse_mp4(path);
-    if (!parsed) {
-        result.status = {false, "Failed to parse " + path};
-        return result;
+    if (!parsed_input) {
+        return finish({false, "Failed to parse " + input.name()});
     }
-    auto ext = extract_tracks(*parsed, in);
+    const ParsedMp4 &parsed = parsed_input->parsed();
+    const unsigned threads =
+        options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    auto ext = extract_tracks(*parsed_input, input, threads);
     result.titles = std::move(ext.titles);
-    result.urls = align_urls_to_titles(result.titles, ext.urls);
-    result.images = align_images_to_titles(result.titles, ext.images);
-    if (!parsed->ilst_payload.empty()) {
-        parse_ilst_metadata(parsed->ilst_payload, result.metadata);
+    result.urls = align_to_titles(result.titles, ext.urls);
+    result.images = align_to_titles(result.titles, ext.images);
+    if (!parsed.ilst_payload.empty()) {
+        parse_ilst_metadata(parsed.ilst_payload, result.metadata);
         CH_LOG("debug", "parsed metadata title='" << result.metadata.title << "' artist='"
                                                   << result.metadata.artist << "' album='"
                                                   << result.metadata.album << "' genre='"
@@ -811,8 +1150,326 @@ ReadResult read_m4a(const std::string &path) {
                                                   << result.metadata.comment
                                                   << "' cover_bytes=" << result.metadata.cover.size());
     }
+    return finish({true, ""});
+}
+
+}  // namespace
+
+ReadResult read_m4a(const std::string &path) { return read_m4a(path, ReadOptions{}); }
+
+ReadResult read_m4a(const std::string &path, const ReadOptions &options) {
+    auto input = InputFile::open(path, options.max_bytes);
+    if (!input) {
+        ReadResult result{};
+        result.status = {false, "Failed to open " + path};
+        return result;
+    }
+    return read_input(*input, options);
+}
+
+ReadResult read_m4a(std::shared_ptr<RandomAccessSource> source, const ReadOptions &options) {
+    if (!source) {
+        ReadResult result{};
+        result.status = {false, "No source to read from"};
+        return result;
+    }
+    auto input = InputFile::wrap(std::move(source), "source", options.max_bytes);
+    return read_input(*input, options);
+}
+
+ReadResult read_m4a(std::istream &in, const ReadOptions &options) {
+    constexpr size_t kChunk = 256 * 1024;
+    StreamParser parser(options.spill_threshold, {}, options.max_bytes);
+    std::vector<char> chunk(kChunk);
+    uint64_t chunks = 0;
+    auto failed = [&](std::string message) {
+        ReadResult result{};
+        result.io = {0, chunks, parser.consumed()};
+        result.status = {false, std::move(message)};
+        return result;
+    };
+    while (!parser.done() && in) {
+        in.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        const auto got = static_cast<size_t>(in.gcount());
+        if (got == 0) {
+            break;
+        }
+        ++chunks;
+        if (options.max_bytes != 0 && parser.consumed() + got > options.max_bytes) {
+            return failed("Read budget of " + std::to_string(options.max_bytes) +
+                          " bytes exceeded for stream");
+        }
+        if (!parser.feed(ByteView(reinterpret_cast<const uint8_t *>(chunk.data()), got))) {
+            return failed(parser.error());
+        }
+    }
+    if (in.bad()) {
+        return failed("Failed to read stream");
+    }
+    auto streamed = parser.finish();
+    if (!streamed.source) {
+        return failed(parser.error());
+    }
+    auto input = InputFile::wrap(std::move(streamed.source), "stream");
+    auto result = read_input(*input, options, std::move(streamed.parsed));
+    result.io = {0, chunks, parser.consumed()};
+    return result;
+}
+
+size_t read_m4a_batch(const std::vector<std::string> &paths, const BatchOptions &options,
+                      const BatchResultFn &on_result) {
+    const unsigned threads =
+        options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::mutex deliver;
+    std::atomic<size_t> failed{0};
+    run_work_stealing(paths.size(), threads, [&](size_t index) {
+        ReadResult result = read_m4a(paths[index], options.read);
+        if (!result.status.ok) {
+            failed.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::lock_guard<std::mutex> lock(deliver);
+        if (on_result) {
+            on_result(index, std::move(result));
+        }
+    });
+    return failed.load();
+}
+
+void set_parse_cache_capacity(uint64_t max_bytes) {
+    ParseCache::instance().set_capacity(max_bytes);
+}
+
+size_t invalidate_parse_cache(const std::string &path) {
+    return ParseCache::instance().invalidate(path);
+}
+
+void clear_parse_cache() { ParseCache::instance().clear(); }
+
+ParseCacheStats parse_cache_stats() {
+    const auto s = ParseCache::instance().stats();
+    return {s.hits, s.misses, s.evictions, s.entries, s.bytes, s.max_bytes};
+}
+
+Status write_index(const std::string &path) {
+    auto input = InputFile::open(path);
+    if (!input) {
+        return {false, "Failed to open " + path};
+    }
+    const auto entry = parse_input(*input);
+    if (!entry) {
+        return {false, "Failed to parse " + path};
+    }
+    if (entry->parsed().used_fallback_stbl) {
+        return {false, "Sample tables of " + path + " are damaged; not indexing"};
+    }
+    const std::string index_path = sidecar_index::path_for(path);
+    if (!sidecar_index::write(*entry, *input->identity(), index_path)) {
+        return {false, "Failed to write " + index_path};
+    }
+    return {true, ""};
+}
+
+ProbeResult probe_m4a(const std::string &path) {
+    ProbeResult result{};
+    auto file = RandomAccessFile::open(path);
+    if (!file) {
+        result.status = {false, "Failed to open " + path};
+        return result;
+    }
+    auto where = locate_moov(*file);
+    if (!where) {
+        result.bytes_read = file->bytes_read();
+        result.status = {false, "No moov atom found in " + path};
+        return result;
+    }
+    std::vector<uint8_t> moov;
+    if (!file->read_at(where->offset, static_cast<size_t>(where->size), moov)) {
+        result.bytes_read = file->bytes_read();
+        result.status = {false, "Failed to read moov from " + path};
+        return result;
+    }
+    result.moov_size = where->size;
+    result.bytes_read = file->bytes_read();
+
+    auto parsed = parse_moov_atom(moov);
+    if (!parsed) {
+        result.status = {false, "Failed to parse moov in " + path};
+        return result;
+    }
+    for (const auto &trk : parsed->tracks) {
+        ProbeTrack t{};
+        t.track_id = trk.track_id;
+        t.handler = fourcc_to_string(trk.handler_type);
+        t.name = trk.handler_name;
+        t.timescale = trk.timescale;
+        t.duration = trk.duration;
+        t.duration_ms = trk.timescale ? trk.duration * 1000 / trk.timescale : 0;
+        t.sample_count = trk.sample_count;
+        result.tracks.push_back(std::move(t));
+    }
+    if (parsed->audio_timescale != 0) {
+        result.audio_duration_ms = parsed->audio_duration * 1000 / parsed->audio_timescale;
+    }
+    const ChapterTracks sel = select_chapter_tracks(*parsed);
+    if (sel.titles) {
+        result.chapter_starts_ms = build_start_times_ms(*sel.titles);
+        result.chapter_count = result.chapter_starts_ms.size();
+    }
+    result.has_urls = sel.urls != nullptr;
+    result.has_images = sel.images != nullptr;
+    result.has_cover = ilst_has_cover(parsed->ilst_payload);
+    CH_LOG("debug", "probe " << path << " moov@" << where->offset << " size=" << where->size
+                             << " bytes_read=" << result.bytes_read
+                             << " chapters=" << result.chapter_count);
     result.status = {true, ""};
     return result;
 }
 
+struct ChapterReader::Impl {
+    std::unique_ptr<RandomAccessFile> file;
+    std::optional<SampleTable> titles;
+    std::optional<SampleTable> urls;
+    std::optional<SampleTable> images;
+    // Per chapter: title sample, start time and the aligned URL/image samples (kNoSample if none).
+    std::vector<size_t> title_samples;
+    std::vector<uint32_t> starts;
+    std::vector<size_t> url_samples;
+    std::vector<size_t> image_samples;
+    std::vector<uint8_t> scratch;
+
+    // Usable samples of `table` paired to the chapters by start time.
+    std::vector<size_t> align(const std::optional<SampleTable> &table, uint32_t timescale,
+                              uint32_t min_size) const {
+        if (!table) {
+            return std::vector<size_t>(starts.size(), kNoSample);
+        }
+        const auto samples = usable_samples(*table, min_size);
+        std::vector<uint32_t> sample_starts;
+        sample_starts.reserve(samples.size());
+        for (size_t s : samples) {
+            sample_starts.push_back(::start_ms(*table, timescale, s));
+        }
+        auto index = align_starts_to_titles(starts, sample_starts);
+        for (auto &i : index) {
+            if (i != kNoSample) {
+                i = samples[i];
+            }
+        }
+        return index;
+    }
+
+    std::optional<ChapterTextSample> read_text(const std::optional<SampleTable> &table,
+                                               size_t sample) {
+        if (!table || sample == kNoSample ||
+            !file->read_at(table->offset(sample), table->size(sample), scratch)) {
+            return std::nullopt;
+        }
+        return decode_tx3g_sample(scratch);
+    }
+};
+
+ChapterReader::ChapterReader(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {}
+
+ChapterReader::~ChapterReader() = default;
+
+std::unique_ptr<ChapterReader> ChapterReader::open(const std::string &path, Status *status) {
+    auto fail = [&](std::string message) -> std::unique_ptr<ChapterReader> {
+        if (status) {
+            *status = {false, std::move(message)};
+        }
+        return nullptr;
+    };
+    auto impl = std::make_unique<Impl>();
+    impl->file = RandomAccessFile::open(path);
+    if (!impl->file) {
+        return fail("Failed to open " + path);
+    }
+    auto where = locate_moov(*impl->file);
+    if (!where) {
+        return fail("No moov atom found in " + path);
+    }
+    std::vector<uint8_t> moov;
+    if (!impl->file->read_at(where->offset, static_cast<size_t>(where->size), moov)) {
+        return fail("Failed to read moov from " + path);
+    }
+    auto parsed = parse_moov_atom(moov);
+    if (!parsed) {
+        return fail("Failed to parse moov in " + path);
+    }
+
+    // Sample tables own their arrays, so the moov buffer is released once they are built.
+    const ChapterTracks sel = select_chapter_tracks(*parsed);
+    if (sel.titles) {
+        impl->titles = build_sample_table(*sel.titles);
+    }
+    if (sel.urls) {
+        impl->urls = build_sample_table(*sel.urls);
+    }
+    if (sel.images) {
+        impl->images = build_sample_table(*sel.images);
+    }
+    if (impl->titles) {
+        impl->title_samples = usable_samples(*impl->titles, kMinTextSample);
+        impl->starts.reserve(impl->title_samples.size());
+        for (size_t s : impl->title_samples) {
+            impl->starts.push_back(::start_ms(*impl->titles, sel.titles->timescale, s));
+        }
+    }
+    impl->url_samples =
+        impl->align(impl->urls, sel.urls ? sel.urls->timescale : 0, kMinTextSample);
+    impl->image_samples =
+        impl->align(impl->images, sel.images ? sel.images->timescale : 0, kMinImageSample);
+    CH_LOG("debug", "chapter reader " << path << " moov@" << where->offset
+                                      << " size=" << where->size
+                                      << " chapters=" << impl->starts.size());
+    if (status) {
+        *status = {true, ""};
+    }
+    return std::unique_ptr<ChapterReader>(new ChapterReader(std::move(impl)));
+}
+
+size_t ChapterReader::count() const { return impl_->starts.size(); }
+
+uint32_t ChapterReader::start_ms(size_t i) const {
+    return i < impl_->starts.size() ? impl_->starts[i] : 0;
+}
+
+std::string ChapterReader::title(size_t i) {
+    if (i >= count()) {
+        return {};
+    }
+    auto sample = impl_->read_text(impl_->titles, impl_->title_samples[i]);
+    return sample ? std::move(sample->text) : std::string{};
+}
+
+std::string ChapterReader::url(size_t i) {
+    if (i >= count()) {
+        return {};
+    }
+    // The URL track wins; fall back to an href carried by the title sample (as the CLI does).
+    if (auto sample = impl_->read_text(impl_->urls, impl_->url_samples[i]);
+        sample && !sample->href.empty()) {
+        return std::move(sample->href);
+    }
+    auto sample = impl_->read_text(impl_->titles, impl_->title_samples[i]);
+    return sample ? std::move(sample->href) : std::string{};
+}
+
+size_t ChapterReader::image_size(size_t i) const {
+    if (i >= count() || impl_->image_samples[i] == kNoSample) {
+        return 0;
+    }
+    return impl_->images->size(impl_->image_samples[i]);
+}
+
+bool ChapterReader::read_image(size_t i, std::span<uint8_t> dst) {
+    const size_t size = image_size(i);
+    if (size == 0 || dst.size() < size) {
+        return false;
+    }
+    return impl_->file->read_at(impl_->images->offset(impl_->image_samples[i]), dst.data(), size);
+}
+
+uint64_t ChapterReader::bytes_read() const { return impl_->file->bytes_read(); }
+
 }  // namespace chapterforge
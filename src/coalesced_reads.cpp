@@ -0,0 +1,77 @@
+//
+//  coalesced_reads.cpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#include "coalesced_reads.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include "logging.hpp"
+#include "random_access_source.hpp"
+
+bool CoalescedReads::read(chapterforge::RandomAccessSource &source,
+                          std::span<const Range> ranges, const Visitor &visit) {
+    span_count_ = 0;
+    for (const auto &r : ranges) {
+        if (r.offset > source.size() || r.size > source.size() - r.offset) {
+            CH_LOG("error", "sample range outside input: offset="
+                                << r.offset << " size=" << r.size << " input_size=" << source.size());
+            return false;
+        }
+    }
+    std::vector<size_t> order(ranges.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return ranges[a].offset < ranges[b].offset;
+    });
+
+    // Plan spans over order[first, last). Ranges may overlap or repeat, so a span ends at the
+    // furthest range end seen.
+    struct Span {
+        uint64_t begin;
+        uint64_t end;
+        size_t first;
+        size_t last;
+    };
+    std::vector<Span> spans;
+    uint64_t largest = 0;
+    for (size_t first = 0; first < order.size();) {
+        Span span{ranges[order[first]].offset, 0, first, first + 1};
+        span.end = span.begin + ranges[order[first]].size;
+        for (; span.last < order.size(); ++span.last) {
+            const Range &r = ranges[order[span.last]];
+            const uint64_t merged_end = std::max(span.end, r.offset + r.size);
+            if (r.offset > span.end + max_gap_ || merged_end - span.begin > max_span_) {
+                break;
+            }
+            span.end = merged_end;
+        }
+        largest = std::max(largest, span.end - span.begin);
+        spans.push_back(span);
+        first = span.last;
+    }
+
+    uint64_t total = 0;
+    buffer_.reserve(static_cast<size_t>(largest));
+    for (const Span &span : spans) {
+        buffer_.resize(static_cast<size_t>(span.end - span.begin));
+        if (!source.read_at(span.begin, buffer_.data(), buffer_.size())) {
+            CH_LOG("error", "read failed at offset=" << span.begin << " size=" << buffer_.size());
+            return false;
+        }
+        ++span_count_;
+        total += buffer_.size();
+        for (size_t n = span.first; n < span.last; ++n) {
+            const Range &r = ranges[order[n]];
+            visit(order[n], {buffer_.data() + (r.offset - span.begin), r.size});
+        }
+    }
+    CH_LOG("debug", "coalesced " << ranges.size() << " ranges into " << span_count_
+                                 << " reads, " << total << " bytes");
+    return true;
+}
@@ -0,0 +1,439 @@
+//
+//  file_writer.cpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#include "file_writer.hpp"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include "logging.hpp"
+
+namespace {
+
+constexpr size_t kBufferSize = 4 * 1024 * 1024;
+// Page alignment lets the kernel copy whole pages out of the buffer.
+constexpr size_t kBufferAlign = 4096;
+#if defined(IOV_MAX)
+constexpr size_t kMaxIov = IOV_MAX;
+#else
+constexpr size_t kMaxIov = 1024;
+#endif
+// Upper bound per write/copy syscall.
+constexpr size_t kMaxIoChunk = 1u << 30;
+
+}  // namespace
+
+std::unique_ptr<FileWriter> FileWriter::create(const std::string &path) {
+    return open_file(path, true);
+}
+
+std::unique_ptr<FileWriter> FileWriter::open_in_place(const std::string &path) {
+    return open_file(path, false);
+}
+
+std::unique_ptr<FileWriter> FileWriter::open_file(const std::string &path, bool truncate) {
+    std::unique_ptr<FileWriter> w(new FileWriter());
+#if defined(_WIN32)
+    HANDLE h = truncate ? CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                      CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr)
+                        : CreateFileA(path.c_str(), GENERIC_WRITE,
+                                      FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                                      FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (h == INVALID_HANDLE_VALUE) {
+        CH_LOG("error", "open for write failed for " << path << " err=" << GetLastError());
+        return nullptr;
+    }
+    w->handle_ = h;
+#else
+    w->fd_ = truncate ? ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666)
+                      : ::open(path.c_str(), O_WRONLY);
+    if (w->fd_ < 0) {
+        CH_LOG("error", "open for write failed for " << path << " errno=" << errno);
+        return nullptr;
+    }
+#endif
+    w->buffer_.reset(
+        static_cast<char *>(::operator new[](kBufferSize, std::align_val_t{kBufferAlign})));
+    w->buffer_size_ = kBufferSize;
+    w->setp(w->buffer_.get(), w->buffer_.get() + w->buffer_size_);
+    return w;
+}
+
+void FileWriter::AlignedFree::operator()(char *p) const {
+    ::operator delete[](p, std::align_val_t{kBufferAlign});
+}
+
+FileWriter::~FileWriter() { close(); }
+
+bool FileWriter::persist() {
+    if (!flush_buffer()) {
+        return false;
+    }
+    ++stats_.syscalls;
+#if defined(_WIN32)
+    if (handle_ == nullptr || !FlushFileBuffers(static_cast<HANDLE>(handle_))) {
+        failed_ = true;
+    }
+#else
+    if (fd_ < 0) {
+        failed_ = true;
+#if defined(__APPLE__)
+    } else if (::fcntl(fd_, F_FULLFSYNC) != 0 && ::fsync(fd_) != 0) {
+#else
+    } else if (::fsync(fd_) != 0) {
+#endif
+        failed_ = true;
+    }
+#endif
+    return !failed_;
+}
+
+bool FileWriter::close() {
+#if defined(_WIN32)
+    if (handle_ != nullptr) {
+        flush_buffer();
+        CloseHandle(static_cast<HANDLE>(handle_));
+        handle_ = nullptr;
+    }
+#else
+    if (fd_ >= 0) {
+        flush_buffer();
+        // A skipped hole at the very end still has to count towards the file size. Only ever
+        // grow the file: writers opened in place may end before bytes written by others.
+        struct stat st {};
+        if (sparse_tail_) {
+            ++stats_.syscalls;
+            if (::fstat(fd_, &st) != 0 || static_cast<uint64_t>(st.st_size) < end_) {
+                ++stats_.syscalls;
+                if (::ftruncate(fd_, static_cast<off_t>(end_)) != 0) {
+                    failed_ = true;
+                }
+            }
+        }
+        if (::close(fd_) != 0) {
+            failed_ = true;
+        }
+        fd_ = -1;
+    }
+#endif
+    return !failed_;
+}
+
+bool FileWriter::write_at(uint64_t pos, const uint8_t *data, size_t length) {
+    size_t done = 0;
+    while (done < length) {
+        const size_t want = std::min(length - done, kMaxIoChunk);
+#if defined(_WIN32)
+        OVERLAPPED ov{};
+        const uint64_t at = pos + done;
+        ov.Offset = static_cast<DWORD>(at & 0xFFFFFFFFu);
+        ov.OffsetHigh = static_cast<DWORD>(at >> 32);
+        DWORD put = 0;
+        ++stats_.syscalls;
+        ++stats_.writes;
+        if (!WriteFile(static_cast<HANDLE>(handle_), data + done, static_cast<DWORD>(want), &put,
+                       &ov) ||
+            put == 0) {
+            CH_LOG("error", "write failed at " << at << " err=" << GetLastError());
+            failed_ = true;
+            return false;
+        }
+#else
+        ++stats_.syscalls;
+        ++stats_.writes;
+        const ssize_t put = ::pwrite(fd_, data + done, want, static_cast<off_t>(pos + done));
+        if (put < 0 && errno == EINTR) {
+            continue;
+        }
+        if (put <= 0) {
+            CH_LOG("error", "write failed at " << pos + done << " errno=" << errno);
+            failed_ = true;
+            return false;
+        }
+#endif
+        done += static_cast<size_t>(put);
+        stats_.bytes_written += static_cast<uint64_t>(put);
+    }
+    if (pos + length >= end_) {
+        sparse_tail_ = false;
+    }
+    end_ = std::max(end_, pos + length);
+    return true;
+}
+
+bool FileWriter::flush_buffer() {
+    const auto pending = static_cast<size_t>(pptr() - pbase());
+    bool ok = !failed_;
+    if (pending > 0) {
+        ok = write_at(buffer_pos_, reinterpret_cast<const uint8_t *>(pbase()), pending) && ok;
+        buffer_pos_ += pending;
+    }
+    setp(buffer_.get(), buffer_.get() + buffer_size_);
+    return ok;
+}
+
+FileWriter::int_type FileWriter::overflow(int_type ch) {
+    if (!flush_buffer()) {
+        return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize FileWriter::xsputn(const char *s, std::streamsize n) {
+    const auto length = static_cast<size_t>(n);
+    if (length <= static_cast<size_t>(epptr() - pptr())) {
+        std::memcpy(pptr(), s, length);
+        pbump(static_cast<int>(length));
+        return n;
+    }
+    if (!flush_buffer()) {
+        return 0;
+    }
+    if (length < buffer_size_) {
+        std::memcpy(pptr(), s, length);
+        pbump(static_cast<int>(length));
+        return n;
+    }
+    // Large writes bypass the buffer.
+    if (!write_at(buffer_pos_, reinterpret_cast<const uint8_t *>(s), length)) {
+        return 0;
+    }
+    buffer_pos_ += length;
+    return n;
+}
+
+int FileWriter::sync() { return flush_buffer() ? 0 : -1; }
+
+FileWriter::pos_type FileWriter::seekoff(off_type off, std::ios_base::seekdir dir,
+                                         std::ios_base::openmode which) {
+    const uint64_t current = buffer_pos_ + static_cast<uint64_t>(pptr() - pbase());
+    if (off == 0 && dir == std::ios_base::cur) {
+        return pos_type(static_cast<off_type>(current));  // tellp() without flushing
+    }
+    int64_t base = 0;
+    if (dir == std::ios_base::cur) {
+        base = static_cast<int64_t>(current);
+    } else if (dir == std::ios_base::end) {
+        base = static_cast<int64_t>(std::max(end_, current));
+    }
+    const int64_t target = base + static_cast<int64_t>(off);
+    if (!(which & std::ios_base::out) || target < 0 || !flush_buffer()) {
+        return pos_type(off_type(-1));
+    }
+    buffer_pos_ = static_cast<uint64_t>(target);
+    return pos_type(static_cast<off_type>(target));
+}
+
+FileWriter::pos_type FileWriter::seekpos(pos_type pos, std::ios_base::openmode which) {
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+bool FileWriter::kernel_copy(const MappedFile &source, uint64_t &offset, uint64_t &length) {
+#if defined(__linux__)
+    if (!kernel_copy_supported_ || source.native_fd() < 0) {
+        return false;
+    }
+    const int in_fd = source.native_fd();
+    while (length > 0) {
+        // Keep holes of sparse sources as holes: skip them in the output instead of writing
+        // zeros. Filesystems without SEEK_DATA support report the whole file as data.
+        uint64_t data_len = length;
+        ++stats_.syscalls;
+        const off_t data = ::lseek(in_fd, static_cast<off_t>(offset), SEEK_DATA);
+        if (data < 0 && errno == ENXIO) {
+            data_len = 0;  // hole up to EOF
+        } else if (data >= 0) {
+            const uint64_t hole = std::min<uint64_t>(static_cast<uint64_t>(data) - offset, length);
+            if (hole > 0) {
+                offset += hole;
+                length -= hole;
+                buffer_pos_ += hole;
+                end_ = std::max(end_, buffer_pos_);
+                sparse_tail_ = true;
+                continue;
+            }
+            ++stats_.syscalls;
+            const off_t next_hole = ::lseek(in_fd, static_cast<off_t>(offset), SEEK_HOLE);
+            if (next_hole > data) {
+                data_len = std::min<uint64_t>(static_cast<uint64_t>(next_hole) - offset, length);
+            }
+        }
+        if (data_len == 0) {
+            buffer_pos_ += length;
+            end_ = std::max(end_, buffer_pos_);
+            offset += length;
+            length = 0;
+            sparse_tail_ = true;
+            break;
+        }
+        loff_t in = static_cast<loff_t>(offset);
+        loff_t out = static_cast<loff_t>(buffer_pos_);
+        ++stats_.syscalls;
+        ++stats_.kernel_copies;
+        const ssize_t copied = ::copy_file_range(in_fd, &in, fd_, &out,
+                                                 std::min<uint64_t>(data_len, kMaxIoChunk), 0);
+        if (copied < 0 && errno == EINTR) {
+            continue;
+        }
+        if (copied <= 0) {
+            // Unsupported by the kernel or across these filesystems (ENOSYS, EXDEV, EINVAL,
+            // EOPNOTSUPP, ...): stop trying and let the caller write from the mapping.
+            CH_LOG("debug", "copy_file_range unavailable errno=" << errno
+                                                                 << ", using buffered writes");
+            kernel_copy_supported_ = false;
+            return false;
+        }
+        offset += static_cast<uint64_t>(copied);
+        length -= static_cast<uint64_t>(copied);
+        buffer_pos_ += static_cast<uint64_t>(copied);
+        kernel_copied_ += static_cast<uint64_t>(copied);
+        end_ = std::max(end_, buffer_pos_);
+        sparse_tail_ = false;
+    }
+    return true;
+#else
+    (void)source;
+    (void)offset;
+    (void)length;
+    return false;
+#endif
+}
+
+bool FileWriter::copy_range(const MappedFile &source, uint64_t offset, uint64_t length) {
+    if (offset > source.size() || length > source.size() - offset) {
+        CH_LOG("error", "copy range exceeds source: offset=" << offset << " length=" << length
+                                                             << " size=" << source.size());
+        failed_ = true;
+        return false;
+    }
+    if (!flush_buffer()) {
+        return false;
+    }
+    if (length == 0 || kernel_copy(source, offset, length)) {
+        return true;
+    }
+    // Fallback: write the remainder straight from the mapping.
+    if (!write_at(buffer_pos_, source.data() + offset, static_cast<size_t>(length))) {
+        return false;
+    }
+    buffer_pos_ += length;
+    return true;
+}
+
+bool FileWriter::write_gather(std::span<const std::span<const uint8_t>> pieces) {
+    if (!flush_buffer()) {
+        return false;
+    }
+#if defined(_WIN32)
+    for (const auto &piece : pieces) {
+        if (!write_at(buffer_pos_, piece.data(), piece.size())) {
+            return false;
+        }
+        buffer_pos_ += piece.size();
+    }
+    return true;
+#else
+    std::vector<iovec> iov;
+    size_t next = 0;
+    while (next < pieces.size()) {
+        // One batch: up to kMaxIov non-empty pieces and kMaxIoChunk bytes.
+        iov.clear();
+        size_t batch_bytes = 0;
+        for (; next < pieces.size() && iov.size() < kMaxIov; ++next) {
+            const auto &piece = pieces[next];
+            if (piece.empty()) {
+                continue;
+            }
+            if (!iov.empty() && batch_bytes + piece.size() > kMaxIoChunk) {
+                break;
+            }
+            iov.push_back({const_cast<uint8_t *>(piece.data()), piece.size()});
+            batch_bytes += piece.size();
+        }
+        size_t first = 0;  // first iovec not completely written
+        while (first < iov.size()) {
+            const int count = static_cast<int>(iov.size() - first);
+            ++stats_.syscalls;
+            ++stats_.vectored_writes;
+            const ssize_t put =
+                ::pwritev(fd_, iov.data() + first, count, static_cast<off_t>(buffer_pos_));
+            if (put < 0 && errno == EINTR) {
+                continue;
+            }
+            if (put <= 0) {
+                CH_LOG("error", "vectored write failed at " << buffer_pos_ << " errno=" << errno);
+                failed_ = true;
+                return false;
+            }
+            stats_.bytes_written += static_cast<uint64_t>(put);
+            buffer_pos_ += static_cast<uint64_t>(put);
+            // Skip what went out; a short write resumes inside the current iovec.
+            size_t left = static_cast<size_t>(put);
+            while (first < iov.size() && left >= iov[first].iov_len) {
+                left -= iov[first].iov_len;
+                ++first;
+            }
+            if (left > 0) {
+                iov[first].iov_base = static_cast<uint8_t *>(iov[first].iov_base) + left;
+                iov[first].iov_len -= left;
+            }
+        }
+        if (buffer_pos_ >= end_) {
+            sparse_tail_ = false;
+        }
+        end_ = std::max(end_, buffer_pos_);
+    }
+    return true;
+#endif
+}
+
+bool FileWriter::reserve(uint64_t size) {
+    if (size == 0) {
+        return true;
+    }
+    ++stats_.syscalls;
+#if defined(_WIN32)
+    FILE_ALLOCATION_INFO info{};
+    info.AllocationSize.QuadPart = static_cast<LONGLONG>(size);
+    const bool ok = SetFileInformationByHandle(static_cast<HANDLE>(handle_), FileAllocationInfo,
+                                               &info, sizeof(info)) != 0;
+#elif defined(__linux__)
+    const bool ok = ::fallocate(fd_, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(size)) == 0;
+#elif defined(__APPLE__)
+    fstore_t store{F_ALLOCATEALL, F_PEOFPOSMODE, 0, static_cast<off_t>(size), 0};
+    const bool ok = ::fcntl(fd_, F_PREALLOCATE, &store) != -1;
+#else
+    const bool ok = false;
+#endif
+    if (!ok) {
+        CH_LOG("debug", "preallocating " << size << " bytes not supported here");
+        return false;
+    }
+    stats_.preallocated = size;
+    return true;
+}
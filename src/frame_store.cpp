@@ -0,0 +1,114 @@
+//
+//  frame_store.cpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#include "frame_store.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "logging.hpp"
+
+FrameStore FrameStore::view(std::shared_ptr<const MappedFile> source) {
+    FrameStore store;
+    store.source_ = std::move(source);
+    return store;
+}
+
+void FrameStore::push(uint64_t offset, uint32_t size) {
+    if (!runs_.empty() && offset >= end_) {
+        Run &run = runs_.back();
+        // The second frame of a run fixes its gap; later frames must keep it.
+        if (sizes_.size() - run.first == 1 &&
+            offset - end_ <= std::numeric_limits<uint32_t>::max()) {
+            run.gap = static_cast<uint32_t>(offset - end_);
+        }
+        if (offset != end_ + run.gap) {
+            runs_.push_back({offset, sizes_.size(), 0});
+        }
+    } else {
+        runs_.push_back({offset, sizes_.size(), 0});
+    }
+    sizes_.push_back(size);
+    end_ = offset + size;
+    total_bytes_ += size;
+}
+
+bool FrameStore::add(uint64_t offset, uint32_t size) {
+    if (!source_ || offset > source_->size() || size > source_->size() - offset) {
+        CH_LOG("error", "frame " << sizes_.size() << " exceeds file size: offset=" << offset
+                                 << " size=" << size
+                                 << " file_size=" << (source_ ? source_->size() : 0));
+        return false;
+    }
+    push(offset, size);
+    return true;
+}
+
+void FrameStore::reserve(size_t frames, size_t bytes) {
+    sizes_.reserve(frames);
+    if (!source_) {
+        owned_.reserve(bytes);
+    }
+}
+
+void FrameStore::append(std::span<const uint8_t> frame) {
+    if (source_) {
+        materialize();
+    }
+    push(owned_.size(), static_cast<uint32_t>(frame.size()));
+    owned_.insert(owned_.end(), frame.begin(), frame.end());
+}
+
+FrameStore::Cursor::Cursor(const FrameStore &store, size_t first)
+    : store_(&store), frame_(first) {
+    const auto &runs = store.runs_;
+    const auto it = std::upper_bound(runs.begin(), runs.end(), uint64_t(first),
+                                     [](uint64_t frame, const Run &run) {
+                                         return frame < run.first;
+                                     });
+    if (it == runs.begin()) {
+        return;
+    }
+    run_ = static_cast<size_t>(it - runs.begin()) - 1;
+    const Run &run = runs[run_];
+    // next() continues from the end of the previous frame of the run.
+    pos_ = run.offset;
+    for (size_t i = run.first; i < first; ++i) {
+        pos_ += (i > run.first ? run.gap : 0) + store.sizes_[i];
+    }
+}
+
+std::span<const uint8_t> FrameStore::Cursor::next() {
+    const auto &runs = store_->runs_;
+    if (run_ + 1 < runs.size() && frame_ == runs[run_ + 1].first) {
+        ++run_;
+    }
+    const Run &run = runs[run_];
+    pos_ = frame_ == run.first ? run.offset : pos_ + run.gap;
+    const uint32_t size = store_->sizes_[frame_++];
+    std::span<const uint8_t> frame{store_->base() + pos_, size};
+    pos_ += size;
+    return frame;
+}
+
+void FrameStore::materialize() {
+    if (!source_) {
+        return;
+    }
+    std::vector<uint8_t> packed;
+    packed.reserve(static_cast<size_t>(total_bytes_));
+    Cursor cursor(*this);
+    for (size_t i = 0; i < sizes_.size(); ++i) {
+        const auto frame = cursor.next();
+        packed.insert(packed.end(), frame.begin(), frame.end());
+    }
+    owned_ = std::move(packed);
+    source_.reset();
+    runs_.assign(sizes_.empty() ? 0 : 1, Run{0, 0, 0});
+    end_ = owned_.size();
+}
@@ -10,21 +10,18 @@
 
 #include <cstring>
 
+#include "fixed_boxes.hpp"
+
 static std::unique_ptr<Atom> build_hdlr(const char type[4], const char *name) {
+    using fixed_boxes::Hdlr;
+    auto fixed = Hdlr::kTemplate;
+    fixed.put_u32(Hdlr::kHandlerType, fourcc(type));
+
     auto h = Atom::create("hdlr");
     auto &p = h->payload;
-
-    write_u8(p, 0);   // version
-    write_u24(p, 0);  // flags
-
-    write_u32(p, 0);             // pre_defined
-    write_u32(p, fourcc(type));  // handler_type
-
-    write_u32(p, 0);  // reserved[0]
-    write_u32(p, 0);  // reserved[1]
-    write_u32(p, 0);  // reserved[2]
-
-    size_t len = strlen(name);
+    const size_t len = strlen(name);
+    p.reserve(fixed.bytes.size() + len + 1);
+    p.assign(fixed.bytes.begin(), fixed.bytes.end());
     p.insert(p.end(), name, name + len);
     p.push_back(0);  // NULL terminated string
 
@@ -0,0 +1,270 @@
+//
+//  in_place_update.cpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#include "in_place_update.hpp"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <ostream>
+
+#include "file_writer.hpp"
+#include "fourcc_utils.hpp"
+#include "logging.hpp"
+#include "mp4_atoms.hpp"
+
+namespace in_place {
+
+namespace {
+
+// Journal layout (little-endian): magic, version, edit count, the media file size the edits
+// expect; per edit its offset, length and bytes; a hash of everything before it.
+constexpr char kMagic[8] = {'C', 'F', 'U', 'P', 'D', '\r', '\n', '\x1a'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = 24;
+constexpr size_t kEditHeaderSize = 16;
+constexpr size_t kHashSize = 8;
+
+inline uint32_t be32(const uint8_t *p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) |
+           uint32_t(p[3]);
+}
+
+void put_u64(std::vector<uint8_t> &out, uint64_t v) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+}
+
+uint64_t get_u64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+// FNV-1a; journals are a few KB to a few MB, written once per update.
+uint64_t hash_bytes(const uint8_t *data, size_t size) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; ++i) {
+        h = (h ^ data[i]) * 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// Make a created or removed directory entry durable; best effort.
+void sync_directory(const std::string &file_path) {
+#if !defined(_WIN32)
+    const auto parent = std::filesystem::path(file_path).parent_path();
+    const std::string dir = parent.empty() ? "." : parent.string();
+    const int fd = ::open(dir.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+#else
+    (void)file_path;
+#endif
+}
+
+bool remove_journal(const std::string &path) {
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    if (ec) {
+        CH_LOG("error", "failed to remove update journal " << path << ": " << ec.message());
+        return false;
+    }
+    sync_directory(path);
+    return true;
+}
+
+struct Journal {
+    uint64_t file_size = 0;
+    std::vector<Edit> edits;
+};
+
+std::optional<Journal> parse_journal(const std::vector<uint8_t> &bytes) {
+    if (bytes.size() < kHeaderSize + kHashSize ||
+        std::memcmp(bytes.data(), kMagic, sizeof(kMagic)) != 0) {
+        return std::nullopt;
+    }
+    const size_t body_end = bytes.size() - kHashSize;
+    if (get_u64(bytes.data() + body_end) != hash_bytes(bytes.data(), body_end)) {
+        return std::nullopt;
+    }
+    const uint64_t header = get_u64(bytes.data() + 8);
+    if (static_cast<uint32_t>(header) != kVersion) {
+        return std::nullopt;
+    }
+    Journal journal;
+    journal.file_size = get_u64(bytes.data() + 16);
+    const uint32_t count = static_cast<uint32_t>(header >> 32);
+    size_t pos = kHeaderSize;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (body_end - pos < kEditHeaderSize) {
+            return std::nullopt;
+        }
+        const uint64_t offset = get_u64(bytes.data() + pos);
+        const uint64_t length = get_u64(bytes.data() + pos + 8);
+        pos += kEditHeaderSize;
+        if (length > body_end - pos) {
+            return std::nullopt;
+        }
+        journal.edits.push_back({offset, std::vector<uint8_t>(bytes.begin() + pos,
+                                                              bytes.begin() + pos + length)});
+        pos += length;
+    }
+    if (pos != body_end) {
+        return std::nullopt;
+    }
+    return journal;
+}
+
+bool apply_edits(const std::string &media_path, const std::vector<Edit> &edits) {
+    auto writer = FileWriter::open_in_place(media_path);
+    if (!writer) {
+        return false;
+    }
+    std::ostream out(writer.get());
+    for (const auto &edit : edits) {
+        out.seekp(static_cast<std::streamoff>(edit.offset));
+        out.write(reinterpret_cast<const char *>(edit.bytes.data()),
+                  static_cast<std::streamsize>(edit.bytes.size()));
+    }
+    return out && writer->persist() && writer->close();
+}
+
+}  // namespace
+
+std::optional<BoxMap> scan_boxes(RandomAccessFile &file) {
+    const uint64_t file_size = file.size();
+    BoxMap map;
+    uint64_t pos = 0;
+    uint8_t hdr[16];
+    while (pos + 8 <= file_size) {
+        const size_t want = static_cast<size_t>(std::min<uint64_t>(16, file_size - pos));
+        if (!file.read_at(pos, hdr, want)) {
+            return std::nullopt;
+        }
+        Box box{be32(hdr + 4), pos, be32(hdr)};
+        if (box.size == 1 && want == 16) {
+            box.size = (uint64_t(be32(hdr + 8)) << 32) | be32(hdr + 12);
+        }
+        if (!is_printable_fourcc(box.type) || box.size < 8) {
+            CH_LOG("debug", "in-place: box walk stopped at " << pos << " size=" << box.size);
+            return std::nullopt;
+        }
+        if (box.size > file_size - pos) {
+            if (!is_free(box)) {
+                CH_LOG("debug", "in-place: box at " << pos << " runs past the end");
+                return std::nullopt;
+            }
+            break;  // cut short by an interrupted append; nothing refers to it
+        }
+        map.boxes.push_back(box);
+        pos += box.size;
+    }
+    // Up to 7 stray bytes after the last box are overwritten by the next append.
+    map.end = pos;
+    return map;
+}
+
+bool is_free(const Box &box) {
+    return box.type == fourcc("free") || box.type == fourcc("skip") || box.type == fourcc("wide");
+}
+
+std::vector<uint8_t> box_header(uint32_t type, uint64_t size, size_t header_size) {
+    std::vector<uint8_t> out;
+    write_u32(out, header_size == 16 ? 1 : static_cast<uint32_t>(size));
+    write_u32(out, type);
+    if (header_size == 16) {
+        write_u64(out, size);
+    }
+    return out;
+}
+
+std::string journal_path(const std::string &media_path) { return media_path + ".cfupdate"; }
+
+bool write_journal(const std::string &media_path, uint64_t file_size,
+                   const std::vector<Edit> &edits) {
+    std::vector<uint8_t> bytes(kMagic, kMagic + sizeof(kMagic));
+    put_u64(bytes, kVersion | (uint64_t(edits.size()) << 32));
+    put_u64(bytes, file_size);
+    for (const auto &edit : edits) {
+        put_u64(bytes, edit.offset);
+        put_u64(bytes, edit.bytes.size());
+        bytes.insert(bytes.end(), edit.bytes.begin(), edit.bytes.end());
+    }
+    put_u64(bytes, hash_bytes(bytes.data(), bytes.size()));
+
+    const std::string path = journal_path(media_path);
+    auto writer = FileWriter::create(path);
+    if (!writer) {
+        return false;
+    }
+    std::ostream out(writer.get());
+    out.write(reinterpret_cast<const char *>(bytes.data()),
+              static_cast<std::streamsize>(bytes.size()));
+    if (!out || !writer->persist() || !writer->close()) {
+        CH_LOG("error", "failed to write update journal " << path);
+        writer.reset();
+        remove_journal(path);
+        return false;
+    }
+    sync_directory(path);
+    return true;
+}
+
+Replay replay_journal(const std::string &media_path) {
+    const std::string path = journal_path(media_path);
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) {
+        return Replay::None;
+    }
+    std::vector<uint8_t> bytes;
+    auto journal_file = RandomAccessFile::open(path);
+    if (!journal_file || !journal_file->read_at(0, static_cast<size_t>(journal_file->size()),
+                                                bytes)) {
+        CH_LOG("error", "failed to read update journal " << path);
+        return Replay::Failed;
+    }
+    journal_file.reset();
+    auto media = RandomAccessFile::open(media_path);
+    if (!media) {
+        CH_LOG("error", "failed to open " << media_path << " to apply " << path);
+        return Replay::Failed;
+    }
+    const uint64_t media_size = media->size();
+    media.reset();
+
+    auto journal = parse_journal(bytes);
+    const bool applies =
+        journal && journal->file_size == media_size &&
+        std::all_of(journal->edits.begin(), journal->edits.end(), [&](const Edit &e) {
+            return e.offset <= media_size && e.bytes.size() <= media_size - e.offset;
+        });
+    if (!applies) {
+        // The journal never became complete, so the edits were never started.
+        CH_LOG("warn", "discarding incomplete update journal " << path);
+        return remove_journal(path) ? Replay::Discarded : Replay::Failed;
+    }
+    if (!apply_edits(media_path, journal->edits)) {
+        CH_LOG("error", "failed to apply update journal " << path << " to " << media_path);
+        return Replay::Failed;
+    }
+    CH_LOG("debug", "applied update journal " << path << " edits=" << journal->edits.size());
+    return remove_journal(path) ? Replay::Applied : Replay::Failed;
+}
+
+}  // namespace in_place
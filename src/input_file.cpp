@@ -0,0 +1,130 @@
+//
+//  input_file.cpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#include "input_file.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "logging.hpp"
+
+std::unique_ptr<InputFile> InputFile::open(const std::string &path, uint64_t byte_budget) {
+    auto file = RandomAccessFile::open(path);
+    if (!file) {
+        return nullptr;
+    }
+    RandomAccessFile *raw = file.get();
+    auto input = wrap(std::move(file), path, byte_budget);
+    input->file_ = raw;
+    return input;
+}
+
+std::unique_ptr<InputFile> InputFile::wrap(
+    std::shared_ptr<chapterforge::RandomAccessSource> source, std::string name,
+    uint64_t byte_budget) {
+    std::unique_ptr<InputFile> input(new InputFile());
+    input->name_ = std::move(name);
+    input->source_ = std::move(source);
+    input->budget_ = byte_budget;
+    return input;
+}
+
+bool InputFile::charge(uint64_t bytes) {
+    if (budget_ == 0) {
+        return true;
+    }
+    const uint64_t before = charged_.fetch_add(bytes, std::memory_order_relaxed);
+    if (before + bytes > budget_) {
+        charged_.fetch_sub(bytes, std::memory_order_relaxed);
+        if (!budget_exceeded_.exchange(true)) {
+            CH_LOG("error", "read budget exceeded: budget=" << budget_ << " used=" << before
+                                                            << " requested=" << bytes);
+        }
+        return false;
+    }
+    return true;
+}
+
+bool InputFile::fetch(uint64_t offset, void *dst, size_t length) {
+    if (!charge(length)) {
+        return false;
+    }
+    reads_.fetch_add(1, std::memory_order_relaxed);
+    if (!source_->read_at(offset, dst, length)) {
+        CH_LOG("error", "read failed for " << name_ << " offset=" << offset << " size=" << length);
+        return false;
+    }
+    bytes_.fetch_add(length, std::memory_order_relaxed);
+    return true;
+}
+
+bool InputFile::read_at(uint64_t offset, void *dst, size_t length) {
+    const uint64_t total = size();
+    if (offset > total || length > total - offset) {
+        return false;
+    }
+    const uint64_t min_request = min_request_size();
+    if (min_request == 0 || length == 0) {
+        return fetch(offset, dst, length);
+    }
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        for (const Block &block : blocks_) {
+            if (offset >= block.offset && offset + length <= block.offset + block.bytes.size()) {
+                std::memcpy(dst, block.bytes.data() + (offset - block.offset), length);
+                return true;
+            }
+        }
+    }
+    if (length >= min_request) {
+        return fetch(offset, dst, length);
+    }
+    // Widen to the minimum request, but never past what is left of the budget. The round trip
+    // runs unlocked so concurrent readers are not serialized behind it; two threads missing the
+    // same block may both fetch it.
+    uint64_t want = std::min(min_request, total - offset);
+    if (budget_ != 0) {
+        const uint64_t used = charged_.load(std::memory_order_relaxed);
+        const uint64_t left = budget_ > used ? budget_ - used : 0;
+        want = std::max<uint64_t>(length, std::min(want, left));
+    }
+    Block block;
+    block.offset = offset;
+    block.bytes.resize(static_cast<size_t>(want));
+    if (!fetch(offset, block.bytes.data(), block.bytes.size())) {
+        return false;
+    }
+    std::memcpy(dst, block.bytes.data(), length);
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    blocks_.push_back(std::move(block));
+    if (blocks_.size() > kReadAheadBlocks) {
+        blocks_.pop_front();
+    }
+    return true;
+}
+
+std::shared_ptr<const MappedFile> InputFile::map() {
+    if (mapping_ || !file_) {
+        return mapping_;
+    }
+    if (!charge(size())) {
+        CH_LOG("error", "not mapping " << name_ << " for a recovery scan: size " << size()
+                                       << " exceeds the read budget");
+        return nullptr;
+    }
+    mapping_ = MappedFile::map(*file_);
+    return mapping_;
+}
+
+InputFile::Stats InputFile::stats() const {
+    Stats s;
+    s.opens = file_ ? 1 : 0;
+    s.reads = reads_.load(std::memory_order_relaxed);
+    s.bytes = bytes_.load(std::memory_order_relaxed) + (mapping_ ? mapping_->size() : 0);
+    return s;
+}
@@ -8,6 +8,8 @@
 
 #include "jpeg_info.hpp"
 
+#include <cstddef>
+
 // Minimal JPEG dimension parser (SOF0/1/2/3/5/6/7/9/10/11/12/13/14/15)
 bool parse_jpeg_info(const std::vector<uint8_t> &data, uint16_t &width, uint16_t &height,
                      bool &is_yuv420) {
@@ -0,0 +1,105 @@
+//
+//  layout_planner.cpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#include "layout_planner.hpp"
+
+#include <algorithm>
+
+bool MdatOffsets::needs_co64() const {
+    // Offsets grow within a track, so each track's last chunk is its largest. Tracks are not
+    // necessarily in file order (an in-place update places chapter samples apart from audio).
+    uint64_t last = audio_offsets.empty() ? 0 : audio_offsets.back();
+    for (const auto &t : text_offsets) {
+        if (!t.empty()) {
+            last = std::max(last, t.back());
+        }
+    }
+    if (!image_offsets.empty()) {
+        last = std::max(last, image_offsets.back());
+    }
+    return payload_start + last > 0xFFFFFFFFULL;
+}
+
+LayoutPlanner::Track LayoutPlanner::place(std::span<const uint32_t> sample_sizes,
+                                          std::span<const uint32_t> chunk_plan) {
+    Track track;
+    track.sample_count = static_cast<uint32_t>(sample_sizes.size());
+    size_t sample = 0;
+    auto add_chunk = [&](uint64_t count) {
+        track.chunk_offsets.push_back(track.bytes);
+        for (uint64_t i = 0; i < count && sample < sample_sizes.size(); ++i, ++sample) {
+            track.bytes += sample_sizes[sample];
+        }
+    };
+    if (chunk_plan.empty()) {
+        track.chunk_offsets.reserve(sample_sizes.size());
+        while (sample < sample_sizes.size()) {
+            add_chunk(1);
+        }
+        return track;
+    }
+    track.chunk_offsets.reserve(chunk_plan.size() + 1);
+    for (uint32_t count : chunk_plan) {
+        if (sample >= sample_sizes.size()) {
+            break;
+        }
+        add_chunk(count);
+    }
+    if (sample < sample_sizes.size()) {
+        add_chunk(sample_sizes.size() - sample);
+    }
+    return track;
+}
+
+void LayoutPlanner::set_audio(std::span<const uint32_t> sample_sizes,
+                              std::span<const uint32_t> chunk_plan) {
+    audio_ = place(sample_sizes, chunk_plan);
+}
+
+void LayoutPlanner::add_text(std::span<const uint32_t> sample_sizes,
+                             std::span<const uint32_t> chunk_plan) {
+    text_.push_back(place(sample_sizes, chunk_plan));
+}
+
+void LayoutPlanner::set_image(std::span<const uint32_t> sample_sizes,
+                              std::span<const uint32_t> chunk_plan) {
+    image_ = place(sample_sizes, chunk_plan);
+}
+
+uint64_t LayoutPlanner::payload_size() const {
+    uint64_t total = audio_.bytes + image_.bytes;
+    for (const auto &t : text_) {
+        total += t.bytes;
+    }
+    return total;
+}
+
+uint64_t LayoutPlanner::mdat_header_size(uint64_t payload_size) {
+    return payload_size + 8 > 0xFFFFFFFFULL ? 16 : 8;
+}
+
+MdatOffsets LayoutPlanner::offsets(uint64_t payload_start) const {
+    MdatOffsets result;
+    result.payload_start = payload_start;
+    uint64_t base = 0;
+    auto relative = [&base](const Track &track) {
+        std::vector<uint64_t> out;
+        out.reserve(track.chunk_offsets.size());
+        for (uint64_t off : track.chunk_offsets) {
+            out.push_back(base + off);
+        }
+        base += track.bytes;
+        return out;
+    };
+    result.audio_offsets = relative(audio_);
+    for (const auto &t : text_) {
+        result.text_offsets.push_back(relative(t));
+    }
+    result.image_offsets = relative(image_);
+    return result;
+}
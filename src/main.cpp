@@ -6,6 +6,9 @@
 //  Copyright © 2025 Till Toenshoff. All rights reserved.
 //
 
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -17,6 +20,11 @@
 #include "logging.hpp"
 #include <nlohmann/json.hpp>
 
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#endif
+
 chapterforge::LogVerbosity parse_level(const std::string &s) {
     if (s == "debug") return chapterforge::LogVerbosity::Debug;
     if (s == "info") return chapterforge::LogVerbosity::Info;
@@ -33,7 +41,8 @@ bool write_bytes(const std::filesystem::path &p, const std::vector<uint8_t> &dat
     return out.good();
 }
 
-bool emit_json(const chapterforge::ReadResult &res, const std::filesystem::path &image_dir) {
+nlohmann::json read_json(const chapterforge::ReadResult &res,
+                         const std::filesystem::path &image_dir) {
     nlohmann::json j;
     const auto &m = res.metadata;
     j["title"] = m.title;
@@ -99,11 +108,101 @@ bool emit_json(const chapterforge::ReadResult &res, const std::filesystem::path
         chapters.push_back(c);
     }
     j["chapters"] = chapters;
+    return j;
+}
 
-    std::cout << j.dump(2) << "\n";
+bool emit_json(const chapterforge::ReadResult &res, const std::filesystem::path &image_dir) {
+    std::cout << read_json(res, image_dir).dump(2) << "\n";
     return true;
 }
 
+bool is_media_path(const std::filesystem::path &p) {
+    std::string ext = p.extension().string();
+    for (auto &c : ext) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return ext == ".m4a" || ext == ".m4b" || ext == ".mp4";
+}
+
+// Batch inputs: every .m4a/.m4b/.mp4 below a directory (sorted), or the lines of a manifest
+// ("-" reads it from stdin); empty lines and lines starting with '#' are skipped.
+bool collect_batch_paths(const std::string &source, std::vector<std::string> &paths) {
+    std::error_code ec;
+    if (source != "-" && std::filesystem::is_directory(source, ec)) {
+        for (std::filesystem::recursive_directory_iterator it(source, ec), end; !ec && it != end;
+             it.increment(ec)) {
+            if (it->is_regular_file(ec) && is_media_path(it->path())) {
+                paths.push_back(it->path().string());
+            }
+        }
+        std::sort(paths.begin(), paths.end());
+        return !ec;
+    }
+    std::ifstream file;
+    if (source != "-") {
+        file.open(source);
+        if (!file.is_open()) {
+            return false;
+        }
+    }
+    std::istream &in = source == "-" ? std::cin : file;
+    for (std::string line; std::getline(in, line);) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.empty() && line[0] != '#') {
+            paths.push_back(std::move(line));
+        }
+    }
+    return true;
+}
+
+// One JSON object per line, written as each file completes.
+int run_batch(const std::string &source, unsigned threads) {
+    std::vector<std::string> paths;
+    if (!collect_batch_paths(source, paths)) {
+        CH_LOG("error", "chapterforge: cannot read batch input " << source);
+        return 1;
+    }
+    chapterforge::BatchOptions options;
+    options.threads = threads;
+    const size_t failed = chapterforge::read_m4a_batch(
+        paths, options, [&](size_t index, chapterforge::ReadResult res) {
+            nlohmann::json j;
+            j["path"] = paths[index];
+            j["ok"] = res.status.ok;
+            if (res.status.ok) {
+                j.update(read_json(res, {}));
+            } else {
+                j["error"] = res.status.message;
+            }
+            std::cout << j.dump() << "\n" << std::flush;
+        });
+    if (failed != 0) {
+        CH_LOG("warn", "chapterforge: " << failed << " of " << paths.size() << " files failed");
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+void emit_plan_json(const chapterforge::PlanResult &plan) {
+    nlohmann::json j;
+    j["file_size"] = plan.file_size;
+    j["fast_start"] = plan.fast_start;
+    j["moov"] = {{"offset", plan.moov_offset}, {"size", plan.moov_size}};
+    j["mdat"] = {{"offset", plan.mdat_offset}, {"size", plan.mdat_size}};
+    nlohmann::json tracks = nlohmann::json::array();
+    for (const auto &t : plan.tracks) {
+        tracks.push_back({{"handler", t.handler},
+                          {"name", t.name},
+                          {"samples", t.sample_count},
+                          {"chunks", t.chunk_count},
+                          {"bytes", t.bytes},
+                          {"offset", t.offset}});
+    }
+    j["tracks"] = tracks;
+    std::cout << j.dump(2) << "\n";
+}
+
 int main(int argc, char **argv) {
     if (argc == 2 && (std::string(argv[1]) == "--version" || std::string(argv[1]) == "-v")) {
         std::cout << "ChapterForge " << CHAPTERFORGE_VERSION_DISPLAY << "\n";
@@ -114,6 +213,11 @@ int main(int argc, char **argv) {
     std::vector<std::string> positional;
     std::filesystem::path export_dir;
     bool fast_start = true;  // Default to fast-start layout.
+    bool plan_only = false;
+    bool index_only = false;
+    bool update_in_place = false;
+    std::string batch_source;
+    unsigned threads = 0;
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
         if (arg == "--faststart") {
@@ -123,9 +227,19 @@ int main(int argc, char **argv) {
         } else if (arg == "--log-level" && i + 1 < argc) {
             chapterforge::set_log_verbosity(parse_level(argv[i + 1]));
             ++i;
+        } else if (arg == "--plan") {
+            plan_only = true;
+        } else if (arg == "--write-index") {
+            index_only = true;
+        } else if (arg == "--update") {
+            update_in_place = true;
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batch_source = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
         } else if (arg == "--export-jpegs" && i + 1 < argc) {
             export_dir = argv[++i];
-        } else if (!arg.empty() && arg[0] == '-') {
+        } else if (arg.size() > 1 && arg[0] == '-') {
             std::cerr << "Unknown option: " << arg << "\n";
             return 2;
         } else {
@@ -133,28 +247,107 @@ int main(int argc, char **argv) {
         }
     }
 
+    // Batch mode: a manifest or directory; JSON Lines go to stdout.
+    if (!batch_source.empty()) {
+        if (!positional.empty() || !export_dir.empty()) {
+            std::cerr << "Invalid arguments. See --help for usage.\n";
+            return 2;
+        }
+        return run_batch(batch_source, threads);
+    }
+
     if (positional.empty()) {
         std::cerr << "ChapterForge " << CHAPTERFORGE_VERSION_DISPLAY << "\n"
                   << "Copyright (c) 2025 Till Toenshoff\n\n"
                   << "Usage for reading:\n"
-                  << "  chapterforge <input.m4a> [--export-jpegs DIR] "
-                  << "[--log-level warn|info|debug]\n\n"
+                  << "  chapterforge <input.m4a|-> [--export-jpegs DIR] "
+                  << "[--log-level warn|info|debug]\n"
+                  << "  (- reads the file from stdin, e.g. curl -s URL | chapterforge -)\n\n"
                   << "Usage for writing:\n"
                   << "  chapterforge <input.aac|input.m4a> <chapters.json> <output.m4a> "
-                  << "[--no-faststart|--faststart] [--log-level warn|info|debug]\n\n"
+                  << "[--no-faststart|--faststart] [--threads N] [--log-level warn|info|debug]\n\n"
+                  << "Usage for planning (dry run, nothing is written):\n"
+                  << "  chapterforge --plan <input.aac|input.m4a> <chapters.json> "
+                  << "[--no-faststart|--faststart]\n\n"
+                  << "Usage for batch reading (one JSON object per line and file):\n"
+                  << "  chapterforge --batch <manifest.txt|directory|-> [--threads N]\n\n"
+                  << "Usage for indexing (writes <input.m4a>.cfidx):\n"
+                  << "  chapterforge --write-index <input.m4a>\n\n"
+                  << "Usage for updating chapters in place (the audio is not rewritten):\n"
+                  << "  chapterforge --update <file.m4a> <chapters.json>\n\n"
                   << "Options:\n"
                   << "  --faststart         Place 'moov' atom before 'mdat' for faster playback start (default).\n"
                   << "  --no-faststart      Write classic layout with 'mdat' before 'moov'.\n"
                   << "  --log-level LEVEL   Set logging verbosity (default: info).\n"
+                  << "  --plan              Print the exact output size and layout as JSON without writing.\n"
+                  << "  --batch SOURCE      Read every file listed in SOURCE (one path per line, - for\n"
+                  << "                      stdin) or found below it (.m4a/.m4b/.mp4).\n"
+                  << "  --threads N         Files read at once in batch mode (default: all cores);\n"
+                  << "                      when writing, threads filling the output (default: 1).\n"
+                  << "  --write-index       Write a sidecar index so later reads and muxes skip parsing.\n"
+                  << "  --update            Replace chapters and metadata of an existing file in place.\n"
                   << "  --export-jpegs DIR  When reading, write chapter images (and cover if any) to DIR.\n"
                   << "                      JSON is always written to stdout when reading.\n";
         return 2;
     }
 
+    // Planning mode: input and chapters; the layout goes to stdout.
+    if (plan_only) {
+        if (positional.size() != 2) {
+            std::cerr << "Invalid arguments. See --help for usage.\n";
+            return 2;
+        }
+        auto plan = chapterforge::plan_m4a(positional[0], positional[1], fast_start);
+        if (!plan.status.ok) {
+            CH_LOG("error", "chapterforge: failed to plan m4a: " << plan.status.message);
+            return 1;
+        }
+        emit_plan_json(plan);
+        return 0;
+    }
+
+    // Indexing mode: one input; writes the sidecar index next to it.
+    if (index_only) {
+        if (positional.size() != 1) {
+            std::cerr << "Invalid arguments. See --help for usage.\n";
+            return 2;
+        }
+        auto status = chapterforge::write_index(positional[0]);
+        if (!status.ok) {
+            CH_LOG("error", "chapterforge: failed to write index: " << status.message);
+            return 1;
+        }
+        std::cout << "Wrote: " << positional[0] << ".cfidx\n";
+        return 0;
+    }
+
+    // Update mode: an existing file and chapters; only chapter samples and moov are written.
+    if (update_in_place) {
+        if (positional.size() != 2) {
+            std::cerr << "Invalid arguments. See --help for usage.\n";
+            return 2;
+        }
+        auto status = chapterforge::update_chapters_in_place(positional[0], positional[1]);
+        if (!status.ok) {
+            CH_LOG("error", "chapterforge: failed to update m4a: " << status.message);
+            return 1;
+        }
+        std::cout << "Updated: " << positional[0] << "\n";
+        return 0;
+    }
+
     // Reading mode: one positional argument (input).
     if (positional.size() == 1) {
         const std::string input_path = positional[0];
-        auto res = chapterforge::read_m4a(input_path);
+        chapterforge::ReadResult res;
+        if (input_path == "-") {
+#if defined(_WIN32)
+            _setmode(_fileno(stdin), _O_BINARY);
+#endif
+            res = chapterforge::read_m4a(std::cin, chapterforge::ReadOptions{0});
+        } else {
+            res = chapterforge::read_m4a(input_path, chapterforge::ReadOptions{0});
+        }
         if (!res.status.ok) {
             CH_LOG("error", "chapterforge: failed to read m4a: " << res.status.message);
             return 1;
@@ -175,8 +368,10 @@ int main(int argc, char **argv) {
     const std::string chapters_path = positional[1];
     const std::string output_path = positional[2];
 
-    auto status =
-        chapterforge::mux_file_to_m4a(input_path, chapters_path, output_path, fast_start);
+    chapterforge::MuxOptions options;
+    options.fast_start = fast_start;
+    options.write_threads = threads;
+    auto status = chapterforge::mux_file_to_m4a(input_path, chapters_path, output_path, options);
     if (!status.ok) {
         CH_LOG("error", "chapterforge: failed to mux m4a: " << status.message);
         return 1;
@@ -0,0 +1,167 @@
+//
+//  mapped_file.cpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#include "mapped_file.hpp"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+
+#include "logging.hpp"
+#include "random_access_file.hpp"
+
+std::shared_ptr<const MappedFile> MappedFile::open(const std::string &path) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        CH_LOG("error", "mmap: cannot open " << path << " err=" << GetLastError());
+        return nullptr;
+    }
+    return map_handle(file, path);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        CH_LOG("error", "mmap: cannot open " << path << " errno=" << errno);
+        return nullptr;
+    }
+    return map_handle(fd, path);
+#endif
+}
+
+std::shared_ptr<const MappedFile> MappedFile::map(const RandomAccessFile &file) {
+#if defined(_WIN32)
+    HANDLE dup = nullptr;
+    if (!DuplicateHandle(GetCurrentProcess(), static_cast<HANDLE>(file.native_handle()),
+                         GetCurrentProcess(), &dup, 0, FALSE, DUPLICATE_SAME_ACCESS)) {
+        CH_LOG("error", "mmap: cannot duplicate handle err=" << GetLastError());
+        return nullptr;
+    }
+    return map_handle(dup, "open file");
+#else
+    int fd = ::dup(file.native_fd());
+    if (fd < 0) {
+        CH_LOG("error", "mmap: cannot duplicate descriptor errno=" << errno);
+        return nullptr;
+    }
+    return map_handle(fd, "open file");
+#endif
+}
+
+#if defined(_WIN32)
+std::shared_ptr<const MappedFile> MappedFile::map_handle(void *handle, const std::string &what) {
+    std::shared_ptr<MappedFile> mf(new MappedFile());
+    HANDLE file = static_cast<HANDLE>(handle);
+    mf->file_handle_ = file;
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size)) {
+        CH_LOG("error", "mmap: cannot stat " << what << " err=" << GetLastError());
+        return nullptr;
+    }
+    if (size.QuadPart == 0) {
+        return mf;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CH_LOG("error", "mmap: CreateFileMapping failed for " << what << " err="
+                                                              << GetLastError());
+        return nullptr;
+    }
+    mf->mapping_handle_ = mapping;
+    void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CH_LOG("error", "mmap: MapViewOfFile failed for " << what << " err=" << GetLastError());
+        return nullptr;
+    }
+    mf->data_ = static_cast<const uint8_t *>(view);
+    mf->size_ = static_cast<size_t>(size.QuadPart);
+    return mf;
+}
+#else
+std::shared_ptr<const MappedFile> MappedFile::map_handle(int fd, const std::string &what) {
+    std::shared_ptr<MappedFile> mf(new MappedFile());
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        CH_LOG("error", "mmap: not a regular file " << what << " errno=" << errno);
+        ::close(fd);
+        return nullptr;
+    }
+    if (st.st_size == 0) {
+        ::close(fd);
+        return mf;
+    }
+    void *addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+        CH_LOG("error", "mmap: mapping failed for " << what << " errno=" << errno);
+        ::close(fd);
+        return nullptr;
+    }
+    mf->fd_ = fd;
+    mf->data_ = static_cast<const uint8_t *>(addr);
+    mf->size_ = static_cast<size_t>(st.st_size);
+    return mf;
+}
+#endif
+
+MappedFile::~MappedFile() {
+#if defined(_WIN32)
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_handle_ != nullptr) {
+        CloseHandle(static_cast<HANDLE>(mapping_handle_));
+    }
+    if (file_handle_ != nullptr) {
+        CloseHandle(static_cast<HANDLE>(file_handle_));
+    }
+#else
+    if (data_ != nullptr) {
+        munmap(const_cast<uint8_t *>(data_), size_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+}
+
+void MappedFile::advise_sequential() const {
+#if !defined(_WIN32)
+    if (data_ != nullptr) {
+        madvise(const_cast<uint8_t *>(data_), size_, MADV_SEQUENTIAL);
+    }
+#endif
+}
+
+void MappedFile::release(size_t offset, size_t length) const {
+#if !defined(_WIN32)
+    if (data_ == nullptr || offset >= size_) {
+        return;
+    }
+    // madvise needs a page-aligned start; only whole pages inside the range are dropped.
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t begin = (offset + page - 1) / page * page;
+    const size_t end = std::min(size_, offset + length) / page * page;
+    if (end > begin) {
+        madvise(const_cast<uint8_t *>(data_) + begin, end - begin, MADV_DONTNEED);
+    }
+#else
+    (void)offset;
+    (void)length;
+#endif
+}
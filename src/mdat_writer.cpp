@@ -8,11 +8,205 @@
 
 #include "mdat_writer.hpp"
 
-#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <span>
+
+#include "byte_order.hpp"
+#include "file_writer.hpp"
+#include "logging.hpp"
+#include "work_stealing.hpp"
+
+namespace {
+
+// Upper bound for one coalesced write; also the granularity at which consumed mapped frames are
+// released.
+constexpr size_t kMaxWriteRun = 8 * 1024 * 1024;
+// Mapped runs at least this long are handed to FileWriter::copy_range; shorter ones (single ADTS
+// frames) are cheaper to buffer.
+constexpr size_t kMinCopyRun = 64 * 1024;
+// Runs at least this long are gathered into vectored writes instead of being copied into the
+// stream buffer; shorter ones (text samples, ADTS frames) are cheaper to memcpy.
+constexpr size_t kMinGatherRun = 4 * 1024;
+// Pieces per FileWriter::write_gather call.
+constexpr size_t kMaxGatherPieces = 1024;
+
+// Sequential sample access for the two sample containers.
+struct VectorCursor {
+    const std::vector<std::vector<uint8_t>> *samples;
+    size_t next_index = 0;
+    std::span<const uint8_t> next() { return (*samples)[next_index++]; }
+};
+VectorCursor cursor_for(const std::vector<std::vector<uint8_t>> &samples, size_t first) {
+    return VectorCursor{&samples, first};
+}
+FrameStore::Cursor cursor_for(const FrameStore &samples, size_t first) {
+    return first == 0 ? FrameStore::Cursor(samples) : FrameStore::Cursor(samples, first);
+}
+
+// Mapped samples have their pages dropped once written.
+bool is_mapped(const std::vector<std::vector<uint8_t>> &) { return false; }
+bool is_mapped(const FrameStore &samples) { return samples.source() != nullptr; }
+void release_written(const std::vector<std::vector<uint8_t>> &, const uint8_t *, const uint8_t *) {}
+void release_written(const FrameStore &samples, const uint8_t *begin, const uint8_t *end) {
+    const MappedFile *source = samples.source();
+    source->release(static_cast<size_t>(begin - source->data()), static_cast<size_t>(end - begin));
+}
+
+// Copy a run of mapped samples file-to-file when the output supports it. Returns false when the
+// caller should write the bytes itself.
+bool copy_run(std::ostream &, const std::vector<std::vector<uint8_t>> &, const uint8_t *, size_t) {
+    return false;
+}
+bool copy_run(std::ostream &out, const FrameStore &samples, const uint8_t *run, size_t length) {
+    const MappedFile *source = samples.source();
+    auto *writer = dynamic_cast<FileWriter *>(out.rdbuf());
+    if (source == nullptr || writer == nullptr || length < kMinCopyRun) {
+        return false;
+    }
+    if (!writer->copy_range(*source, static_cast<uint64_t>(run - source->data()), length)) {
+        out.setstate(std::ios::badbit);
+    }
+    return true;
+}
+
+// Default: one sample per chunk when no plan is provided. Samples beyond the plan form one
+// trailing chunk.
+template <typename Samples>
+std::vector<uint32_t> effective_plan(const Samples &samples,
+                                     const std::vector<uint32_t> &chunk_sizes) {
+    std::vector<uint32_t> plan =
+        chunk_sizes.empty() ? std::vector<uint32_t>(samples.size(), 1) : chunk_sizes;
+    uint64_t planned = 0;
+    for (uint32_t n : plan) {
+        planned += n;
+    }
+    if (planned < samples.size()) {
+        plan.push_back(static_cast<uint32_t>(samples.size() - planned));
+    }
+    return plan;
+}
+
+// Writes one track's samples chunk by chunk, recording chunk offsets relative to payload_start.
+// Samples that are adjacent in memory (packed or mapped frames) go out in a single write, or a
+// single file-to-file copy for long mapped runs. On a FileWriter, runs that are neither tiny nor
+// kernel-copied (e.g. cover images) are collected and written with pwritev. Only chunks
+// [first_chunk, end_chunk) of the plan are written when a range is given.
+template <typename Samples>
+void write_track(std::ostream &out, uint64_t payload_start, const Samples &samples,
+                 const std::vector<uint32_t> &chunk_sizes, std::vector<uint64_t> &offsets,
+                 size_t first_chunk = 0,
+                 size_t end_chunk = std::numeric_limits<size_t>::max()) {
+    if (samples.size() == 0) {
+        return;
+    }
+    const std::vector<uint32_t> plan = effective_plan(samples, chunk_sizes);
+    end_chunk = std::min(end_chunk, plan.size());
+    size_t sample_index = 0;
+    for (size_t c = 0; c < first_chunk && c < plan.size(); ++c) {
+        sample_index += plan[c];
+    }
+    if (first_chunk >= end_chunk || sample_index >= samples.size()) {
+        return;
+    }
+    uint64_t pos = static_cast<uint64_t>(out.tellp());
+    auto cursor = cursor_for(samples, sample_index);
+    const bool mapped = is_mapped(samples);
+    const uint8_t *run = nullptr;
+    size_t run_len = 0;
+    // Written but not yet released source range.
+    const uint8_t *unreleased = nullptr;
+    const uint8_t *written_end = nullptr;
+    auto *writer = dynamic_cast<FileWriter *>(out.rdbuf());
+    std::vector<std::span<const uint8_t>> gather;
+    size_t gather_bytes = 0;
+    auto flush_gather = [&]() {
+        if (!gather.empty() && !writer->write_gather(gather)) {
+            out.setstate(std::ios::badbit);
+        }
+        gather.clear();
+        gather_bytes = 0;
+    };
+    auto flush = [&](bool last) {
+        if (run_len > 0) {
+            if (writer != nullptr && run_len >= kMinGatherRun &&
+                (!mapped || run_len < kMinCopyRun)) {
+                gather.emplace_back(run, run_len);
+                gather_bytes += run_len;
+                if (gather.size() >= kMaxGatherPieces || gather_bytes >= kMaxWriteRun) {
+                    flush_gather();
+                }
+            } else {
+                flush_gather();
+                if (!copy_run(out, samples, run, run_len)) {
+                    out.write(reinterpret_cast<const char *>(run),
+                              static_cast<std::streamsize>(run_len));
+                }
+            }
+            if (mapped && (unreleased == nullptr || run < unreleased)) {
+                unreleased = run;
+            }
+            written_end = run + run_len;
+        }
+        if (last) {
+            flush_gather();
+        }
+        if (unreleased != nullptr &&
+            (last || static_cast<size_t>(written_end - unreleased) >= kMaxWriteRun)) {
+            flush_gather();
+            release_written(samples, unreleased, written_end);
+            unreleased = nullptr;
+        }
+        run = nullptr;
+        run_len = 0;
+    };
+
+    for (size_t c = first_chunk; c < end_chunk; ++c) {
+        const uint32_t chunk_size = plan[c];
+        if (sample_index >= samples.size()) {
+            break;
+        }
+        offsets.push_back(pos - payload_start);
+        for (uint32_t i = 0; i < chunk_size && sample_index < samples.size(); ++i) {
+            const auto sample = cursor.next();
+            if (run_len > 0 && (run + run_len != sample.data() || run_len >= kMaxWriteRun)) {
+                flush(false);
+            }
+            if (run_len == 0) {
+                run = sample.data();
+            }
+            run_len += sample.size();
+            pos += sample.size();
+            ++sample_index;
+        }
+    }
+    flush(true);
+}
+
+uint64_t payload_bytes(const std::vector<std::vector<uint8_t>> &samples) {
+    uint64_t total = 0;
+    for (const auto &s : samples) {
+        total += s.size();
+    }
+    return total;
+}
+
+// stco and co64 boxes under `atom`, in track order.
+void collect_chunk_offset_boxes(Atom *atom, std::vector<Atom *> &out) {
+    if (atom->type == fourcc("stco") || atom->type == fourcc("co64")) {
+        out.push_back(atom);
+    }
+    for (auto &child : atom->children) {
+        collect_chunk_offset_boxes(child.get(), out);
+    }
+}
+
+}  // namespace
 
 // Write the mdat box and collect relative offsets for each track.
 MdatOffsets write_mdat(
-    std::ofstream &out, const std::vector<std::vector<uint8_t>> &audio_samples,
+    std::ostream &out, const FrameStore &audio_samples,
     const std::vector<std::vector<std::vector<uint8_t>>> &text_tracks_samples,
     const std::vector<std::vector<uint8_t>> &image_samples,
     const std::vector<uint32_t> &audio_chunk_sizes,
@@ -20,173 +214,249 @@ MdatOffsets write_mdat(
     const std::vector<uint32_t> &image_chunk_sizes) {
     MdatOffsets result;
 
+    // Payloads past 4 GB need the 64-bit largesize header (size field = 1); the choice is made
+    // up front so payload offsets never move.
+    uint64_t payload_size = audio_samples.total_bytes() + payload_bytes(image_samples);
+    for (const auto &t : text_tracks_samples) {
+        payload_size += payload_bytes(t);
+    }
+    const uint64_t header_size = LayoutPlanner::mdat_header_size(payload_size);
+
     // Start of mdat box.
     uint64_t mdat_header_pos = out.tellp();
+    write_mdat_header(out, payload_size);
 
-    // Size placeholder (4 bytes) + 'mdat'
-    uint8_t header[8] = {0, 0, 0, 0, 'm', 'd', 'a', 't'};
-    out.write(reinterpret_cast<char *>(header), 8);
-
-    // Payload begins right after 'mdat'
+    // Payload begins right after the header.
     uint64_t payload_start = out.tellp();
     result.payload_start = payload_start;
 
-    auto write_track = [&](const std::vector<std::vector<uint8_t>> &samples,
-                           const std::vector<uint32_t> &chunk_sizes,
-                           std::vector<uint32_t> &offsets) {
-        if (samples.empty()) {
-            return;
-        }
-
-        // default: one sample per chunk when no plan is provided.
-        std::vector<uint32_t> plan =
-            chunk_sizes.empty() ? std::vector<uint32_t>(samples.size(), 1) : chunk_sizes;
-
-        size_t sample_index = 0;
-        for (uint32_t chunk_size : plan) {
-            if (sample_index >= samples.size()) {
-                break;
-            }
-            uint64_t pos = out.tellp();
-            uint32_t rel = static_cast<uint32_t>(pos - payload_start);
-            offsets.push_back(rel);
-
-            for (uint32_t i = 0; i < chunk_size && sample_index < samples.size(); ++i) {
-                const auto &sample = samples[sample_index++];
-                out.write(reinterpret_cast<const char *>(sample.data()), sample.size());
-            }
-        }
-
-        // Write any stragglers if plan was shorter than sample count.
-        if (sample_index < samples.size()) {
-            uint64_t pos = out.tellp();
-            uint32_t rel = static_cast<uint32_t>(pos - payload_start);
-            offsets.push_back(rel);
-            for (; sample_index < samples.size(); ++sample_index) {
-                const auto &sample = samples[sample_index];
-                out.write(reinterpret_cast<const char *>(sample.data()), sample.size());
-            }
-        }
-    };
-
     // Apple convention: audio first, then text tracks, then image.
-    write_track(audio_samples, audio_chunk_sizes, result.audio_offsets);
+    write_track(out, payload_start, audio_samples, audio_chunk_sizes, result.audio_offsets);
     for (size_t i = 0; i < text_tracks_samples.size(); ++i) {
-        std::vector<uint32_t> offsets;
+        std::vector<uint64_t> offsets;
         const auto &samples = text_tracks_samples[i];
         const auto &plan =
             (i < text_chunk_sizes.size()) ? text_chunk_sizes[i] : std::vector<uint32_t>();
-        write_track(samples, plan, offsets);
+        write_track(out, payload_start, samples, plan, offsets);
         result.text_offsets.push_back(std::move(offsets));
     }
-    write_track(image_samples, image_chunk_sizes, result.image_offsets);
-
-    // Patch mdat size field.
+    write_track(out, payload_start, image_samples, image_chunk_sizes, result.image_offsets);
+    // Patch mdat size field (32-bit size or 64-bit largesize).
     uint64_t end_pos = out.tellp();
     uint64_t box_size = end_pos - mdat_header_pos;
 
-    if (box_size > 0xFFFFFFFFULL) {
-        throw std::runtime_error("mdat too large ( > 4 GB )");
+    uint8_t size_bytes[8];
+    const int width = header_size == 16 ? 8 : 4;
+    for (int i = 0; i < width; ++i) {
+        size_bytes[i] = static_cast<uint8_t>(box_size >> (8 * (width - 1 - i)));
     }
 
-    uint32_t size32 = static_cast<uint32_t>(box_size);
-    uint8_t size_bytes[4] = {
-        static_cast<uint8_t>((size32 >> 24) & 0xFF), static_cast<uint8_t>((size32 >> 16) & 0xFF),
-        static_cast<uint8_t>((size32 >> 8) & 0xFF), static_cast<uint8_t>((size32) & 0xFF)};
-
-    out.seekp(mdat_header_pos);
-    out.write(reinterpret_cast<char *>(size_bytes), 4);
+    out.seekp(mdat_header_pos + (header_size == 16 ? 8 : 0));
+    out.write(reinterpret_cast<char *>(size_bytes), width);
     out.seekp(end_pos);
 
     return result;
 }
 
-// Update a single stco table with absolute offsets based on the mdat payload start.
-void patch_stco_table(Atom *stco, const std::vector<uint32_t> &offsets,
+void write_mdat_header(std::ostream &out, uint64_t payload_size) {
+    const uint64_t header_size = LayoutPlanner::mdat_header_size(payload_size);
+    const uint64_t box_size = header_size + payload_size;
+    // 32-bit size + 'mdat', or size = 1 + 'mdat' + 64-bit largesize.
+    uint8_t header[16] = {0, 0, 0, 1, 'm', 'd', 'a', 't'};
+    const int width = header_size == 16 ? 8 : 4;
+    uint8_t *size_field = header_size == 16 ? header + 8 : header;
+    for (int i = 0; i < width; ++i) {
+        size_field[i] = static_cast<uint8_t>(box_size >> (8 * (width - 1 - i)));
+    }
+    out.write(reinterpret_cast<char *>(header), static_cast<std::streamsize>(header_size));
+}
+
+bool write_mdat_payload_parallel(
+    const std::string &path, unsigned threads, const MdatOffsets &planned,
+    const FrameStore &audio_samples,
+    const std::vector<std::vector<std::vector<uint8_t>>> &text_tracks_samples,
+    const std::vector<std::vector<uint8_t>> &image_samples,
+    const std::vector<uint32_t> &audio_chunk_sizes,
+    const std::vector<std::vector<uint32_t>> &text_chunk_sizes,
+    const std::vector<uint32_t> &image_chunk_sizes, FileWriter::Stats *stats,
+    uint64_t min_audio_region) {
+    enum class Kind { Audio, Text, Image };
+    // Chunks [first, end) of one track.
+    struct Region {
+        Kind kind;
+        size_t track;
+        size_t first;
+        size_t end;
+    };
+    std::vector<Region> regions;
+
+    // Audio: whole chunks, cut into about `threads` ranges of similar size.
+    const auto &audio_offsets = planned.audio_offsets;
+    if (!audio_offsets.empty()) {
+        const uint64_t audio_end = audio_offsets.front() + audio_samples.total_bytes();
+        const uint64_t target = std::max<uint64_t>(
+            min_audio_region, audio_samples.total_bytes() / std::max(1u, threads));
+        size_t first = 0;
+        for (size_t c = 1; c <= audio_offsets.size(); ++c) {
+            const uint64_t end = c < audio_offsets.size() ? audio_offsets[c] : audio_end;
+            if (end - audio_offsets[first] >= target || c == audio_offsets.size()) {
+                regions.push_back({Kind::Audio, 0, first, c});
+                first = c;
+            }
+        }
+    }
+    for (size_t t = 0; t < text_tracks_samples.size(); ++t) {
+        if (!text_tracks_samples[t].empty()) {
+            regions.push_back({Kind::Text, t, 0, std::numeric_limits<size_t>::max()});
+        }
+    }
+    if (!image_samples.empty()) {
+        regions.push_back({Kind::Image, 0, 0, std::numeric_limits<size_t>::max()});
+    }
+
+    std::mutex mutex;
+    bool ok = true;
+    run_work_stealing(regions.size(), threads, [&](size_t index) {
+        const Region &region = regions[index];
+        const std::vector<uint64_t> *expected = nullptr;
+        switch (region.kind) {
+        case Kind::Audio:
+            expected = &planned.audio_offsets;
+            break;
+        case Kind::Text:
+            expected = region.track < planned.text_offsets.size()
+                           ? &planned.text_offsets[region.track]
+                           : nullptr;
+            break;
+        case Kind::Image:
+            expected = &planned.image_offsets;
+            break;
+        }
+        auto writer = FileWriter::open_in_place(path);
+        bool region_ok =
+            writer != nullptr && expected != nullptr && region.first < expected->size();
+        std::vector<uint64_t> offsets;
+        if (region_ok) {
+            std::ostream out(writer.get());
+            const uint64_t start = planned.payload_start + (*expected)[region.first];
+            out.seekp(static_cast<std::streamoff>(start));
+            switch (region.kind) {
+            case Kind::Audio:
+                write_track(out, planned.payload_start, audio_samples, audio_chunk_sizes, offsets,
+                            region.first, region.end);
+                break;
+            case Kind::Text: {
+                const auto &plan = region.track < text_chunk_sizes.size()
+                                       ? text_chunk_sizes[region.track]
+                                       : std::vector<uint32_t>();
+                write_track(out, planned.payload_start, text_tracks_samples[region.track], plan,
+                            offsets);
+                break;
+            }
+            case Kind::Image:
+                write_track(out, planned.payload_start, image_samples, image_chunk_sizes, offsets);
+                break;
+            }
+            region_ok = static_cast<bool>(out) && writer->close();
+            // Each region must land exactly where moov's chunk offsets point.
+            region_ok &= region.first + offsets.size() == std::min(region.end, expected->size()) &&
+                         std::equal(offsets.begin(), offsets.end(),
+                                    expected->begin() + static_cast<std::ptrdiff_t>(region.first));
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!region_ok) {
+            CH_LOG("error", "parallel mdat region " << index << " failed");
+            ok = false;
+        }
+        if (stats != nullptr && writer != nullptr) {
+            const auto &s = writer->stats();
+            stats->syscalls += s.syscalls;
+            stats->writes += s.writes;
+            stats->vectored_writes += s.vectored_writes;
+            stats->kernel_copies += s.kernel_copies;
+            stats->bytes_written += s.bytes_written;
+            stats->preallocated += s.preallocated;
+        }
+    });
+    CH_LOG("debug", "parallel mdat: regions=" << regions.size() << " threads=" << threads);
+    return ok;
+}
+
+// Update a single stco or co64 table with absolute offsets based on the mdat payload start.
+bool patch_stco_table(Atom *stco, const std::vector<uint64_t> &offsets,
                       uint64_t mdat_payload_start) {
     if (!stco) {
-        return;
+        return true;
     }
     auto &p = stco->payload;
 
     if (p.size() < 8) {
-        return;
+        return true;
     }
 
+    const bool wide = stco->type == fourcc("co64");
+    const size_t entry_size = wide ? 8 : 4;
     uint32_t entry_count = (p[4] << 24) | (p[5] << 16) | (p[6] << 8) | (p[7]);
 
     entry_count = std::min<uint32_t>(entry_count, offsets.size());
+    entry_count = std::min<uint32_t>(entry_count, (p.size() - 8) / entry_size);
 
-    size_t pos = 8;
+    if (wide) {
+        std::vector<uint64_t> absolute(entry_count);
+        for (uint32_t i = 0; i < entry_count; ++i) {
+            absolute[i] = offsets[i] + mdat_payload_start;
+        }
+        store_be64(absolute, p.data() + 8);
+        return true;
+    }
+    std::vector<uint32_t> absolute(entry_count);
     for (uint32_t i = 0; i < entry_count; ++i) {
-        uint32_t abs_offset = offsets[i] + static_cast<uint32_t>(mdat_payload_start);
-
-        p[pos + 0] = (abs_offset >> 24) & 0xFF;
-        p[pos + 1] = (abs_offset >> 16) & 0xFF;
-        p[pos + 2] = (abs_offset >> 8) & 0xFF;
-        p[pos + 3] = (abs_offset) & 0xFF;
-
-        pos += 4;
+        const uint64_t abs_offset = offsets[i] + mdat_payload_start;
+        if (abs_offset > 0xFFFFFFFFULL) {
+            CH_LOG("error", "chunk offset " << abs_offset << " does not fit stco");
+            return false;
+        }
+        absolute[i] = static_cast<uint32_t>(abs_offset);
     }
+    store_be32(absolute, p.data() + 8);
+    return true;
 }
 
-// Patch all stco tables (audio, text tracks, images) found under moov.
-void patch_all_stco(Atom *moov, const MdatOffsets &offs, bool patch_audio) {
-    if (!moov) { return; }
-    auto stcos = moov->find("stco");
+// Patch all stco/co64 tables (audio, text tracks, images) found under moov.
+bool patch_all_stco(Atom *moov, const MdatOffsets &offs, bool patch_audio) {
+    if (!moov) { return true; }
+    std::vector<Atom *> stcos;
+    collect_chunk_offset_boxes(moov, stcos);
+    bool ok = true;
     size_t idx = 0;
     if (patch_audio && stcos.size() > idx) {
-        patch_stco_table(stcos[idx], offs.audio_offsets, offs.payload_start);
+        ok &= patch_stco_table(stcos[idx], offs.audio_offsets, offs.payload_start);
     }
     idx += 1;
     for (size_t t = 0; t < offs.text_offsets.size() && idx < stcos.size(); ++t, ++idx) {
-        patch_stco_table(stcos[idx], offs.text_offsets[t], offs.payload_start);
+        ok &= patch_stco_table(stcos[idx], offs.text_offsets[t], offs.payload_start);
     }
     if (idx < stcos.size() && !offs.image_offsets.empty()) {
-        patch_stco_table(stcos[idx], offs.image_offsets, offs.payload_start);
+        ok &= patch_stco_table(stcos[idx], offs.image_offsets, offs.payload_start);
     }
+    return ok;
 }
 
-// Compute offsets without writing an mdat (used for fast layout calculations).
-MdatOffsets compute_mdat_offsets( uint64_t payload_start,
-                                 const std::vector<std::vector<uint8_t>> &audio_samples,
-                                 const std::vector<std::vector<std::vector<uint8_t>>> &text_tracks_samples,
-                                 const std::vector<std::vector<uint8_t>> &image_samples,
-                                 const std::vector<uint32_t> &audio_chunk_sizes,
-                                 const std::vector<std::vector<uint32_t>> &text_chunk_sizes,
-                                 const std::vector<uint32_t> &image_chunk_sizes) {
-    MdatOffsets result;
-    result.payload_start = payload_start;
-    uint64_t cursor = payload_start;
-
-    auto compute_track = [&](const std::vector<std::vector<uint8_t>> &samples,
-                             const std::vector<uint32_t> &chunk_sizes,
-                             std::vector<uint32_t> &offsets) {
-        if (samples.empty()) { return; }
-        std::vector<uint32_t> plan = chunk_sizes.empty() ? std::vector<uint32_t>(samples.size(), 1) : chunk_sizes;
-        size_t sample_index = 0;
-        for (uint32_t chunk_size : plan) {
-            if (sample_index >= samples.size()) { break; }
-            offsets.push_back(static_cast<uint32_t>(cursor - payload_start));
-            for (uint32_t i = 0; i < chunk_size && sample_index < samples.size(); ++i, ++sample_index) {
-                cursor += samples[sample_index].size();
-            }
-        }
-        if (sample_index < samples.size()) {
-            offsets.push_back(static_cast<uint32_t>(cursor - payload_start));
-            for (; sample_index < samples.size(); ++sample_index) { cursor += samples[sample_index].size(); }
+// Rewrite every stco under moov as a co64 with the same entry count (entries zeroed, to be
+// patched).
+void promote_stco_to_co64(Atom *moov) {
+    if (!moov) { return; }
+    std::vector<Atom *> stcos;
+    collect_chunk_offset_boxes(moov, stcos);
+    for (Atom *stco : stcos) {
+        if (stco->type != fourcc("stco") || stco->payload.size() < 8) {
+            continue;
         }
-    };
-
-    compute_track(audio_samples, audio_chunk_sizes, result.audio_offsets);
-    for (size_t i = 0; i < text_tracks_samples.size(); ++i) {
-        std::vector<uint32_t> offsets;
-        const auto &samples = text_tracks_samples[i];
-        const auto &plan = (i < text_chunk_sizes.size()) ? text_chunk_sizes[i] : std::vector<uint32_t>();
-        compute_track(samples, plan, offsets);
-        result.text_offsets.push_back(std::move(offsets));
+        auto &p = stco->payload;
+        const uint32_t entry_count = (p[4] << 24) | (p[5] << 16) | (p[6] << 8) | (p[7]);
+        p.resize(8);
+        p.resize(8 + size_t(entry_count) * 8, 0);
+        stco->type = fourcc("co64");
     }
-    compute_track(image_samples, image_chunk_sizes, result.image_offsets);
-
-    return result;
+    moov->fix_size_recursive();
 }
@@ -8,25 +8,16 @@
 
 #include "mdhd_builder.hpp"
 
-std::unique_ptr<Atom> build_mdhd(uint32_t timescale, uint64_t duration, uint16_t language) {
-    auto mdhd = Atom::create("mdhd");
-    std::vector<uint8_t> &p = mdhd->payload;
-
-    p.reserve(32);
-
-    write_u8(p, 0);   // version
-    write_u24(p, 0);  // flags
-
-    write_u32(p, 0);  // creation_time
-    write_u32(p, 0);  // modification_time
+#include "fixed_boxes.hpp"
 
-    write_u32(p, timescale);
-    write_u32(p, (uint32_t)duration);
-
-    // language.
-    write_u16(p, language);
-
-    write_u16(p, 0);  // pre-defined
+std::unique_ptr<Atom> build_mdhd(uint32_t timescale, uint64_t duration, uint16_t language) {
+    using fixed_boxes::Mdhd;
+    auto p = Mdhd::kTemplate;
+    p.put_u32(Mdhd::kTimescale, timescale);
+    p.put_u32(Mdhd::kDuration, (uint32_t)duration);
+    p.put_u16(Mdhd::kLanguage, language);
 
+    auto mdhd = Atom::create("mdhd");
+    mdhd->payload = p.to_vector();
     return mdhd;
 }
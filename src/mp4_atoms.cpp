@@ -19,25 +19,23 @@ void Atom::add(AtomPtr child) { children.push_back(std::move(child)); }
 // Recursive find.
 std::vector<Atom *> Atom::find(const std::string &t) {
     std::vector<Atom *> result;
+    find_into(fourcc(t), result);
+    return result;
+}
 
-    uint32_t want = fourcc(t);
-
+void Atom::find_into(uint32_t want, std::vector<Atom *> &out) {
     if (type == want) {
-        result.push_back(this);
+        out.push_back(this);
     }
-
     for (auto &child : children) {
-        auto sub = child->find(t);
-        result.insert(result.end(), sub.begin(), sub.end());
+        child->find_into(want, out);
     }
-
-    return result;
 }
 
 // Compute recursive box size.
 void Atom::fix_size_recursive() {
     // Start with MP4 header: 8 bytes (size + type)
-    uint32_t total = 8;
+    uint64_t total = 8;
 
     // Payload.
     total += payload.size();
@@ -48,36 +46,34 @@ void Atom::fix_size_recursive() {
         total += c->box_size;
     }
 
+    // Too large for the 32-bit size field: size = 1 plus a 64-bit largesize.
+    if (total > 0xFFFFFFFFULL) {
+        total += 8;
+    }
+
     box_size = total;
 }
 
 // Return box size.
-uint32_t Atom::size() const { return box_size; }
-
-// Write atom to file.
-void Atom::write(std::ofstream &out) const {
-    uint32_t s = box_size;
+uint64_t Atom::size() const { return box_size; }
 
-    uint8_t header[8];
-    header[0] = (s >> 24) & 0xFF;
-    header[1] = (s >> 16) & 0xFF;
-    header[2] = (s >> 8) & 0xFF;
-    header[3] = (s) & 0xFF;
-
-    header[4] = (type >> 24) & 0xFF;
-    header[5] = (type >> 16) & 0xFF;
-    header[6] = (type >> 8) & 0xFF;
-    header[7] = (type) & 0xFF;
-
-    out.write(reinterpret_cast<const char *>(header), 8);
-
-    // Write payload.
-    if (!payload.empty()) {
-        out.write(reinterpret_cast<const char *>(payload.data()), payload.size());
-    }
-
-    // Write children.
+void Atom::serialize(BoxWriter &out) const {
+    auto box = out.open(type);
+    out.bytes(payload);
     for (const auto &c : children) {
-        c->write(out);
+        c->serialize(out);
     }
 }
+
+std::vector<uint8_t> Atom::serialize() const {
+    BoxWriter out(static_cast<size_t>(box_size));
+    serialize(out);
+    return out.release();
+}
+
+// Write atom to stream.
+void Atom::write(std::ostream &out) const {
+    const auto bytes = serialize();
+    out.write(reinterpret_cast<const char *>(bytes.data()),
+              static_cast<std::streamsize>(bytes.size()));
+}
@@ -12,23 +12,31 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdlib>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
 #include <map>
 #include <vector>
 #include <limits>
+#include <optional>
 
 #include "aac_extractor.hpp"
 #include "chapter_timing.hpp"
+#include "file_writer.hpp"
+#include "in_place_update.hpp"
 #include "logging.hpp"
 #include "mdat_writer.hpp"
 #include "jpeg_info.hpp"
+#include "layout_planner.hpp"
 #include "metadata_set.hpp"
 #include "chapterforge_version.hpp"
 #include "meta_builder.hpp"
 #include "moov_builder.hpp"
 #include "mp4_atoms.hpp"
+#include "random_access_file.hpp"
+#include "sample_table.hpp"
 #include "stbl_audio_builder.hpp"
 #include "stbl_image_builder.hpp"
 #include "stbl_text_builder.hpp"
@@ -46,8 +54,12 @@ constexpr uint32_t kChapterTimescale = 1000;       // ms resolution for text/ima
 constexpr uint16_t kDefaultImageWidth = 1280;
 constexpr uint16_t kDefaultImageHeight = 720;
 constexpr uint32_t kDefaultAudioChunk = 21;        // chunk size used for derived plans
-constexpr uint32_t kStscHeaderSize = 8;
-constexpr uint32_t kStscEntrySize = 12;
+constexpr uint64_t kFreeBoxSize = 1024 + 8;        // padding box ahead of a trailing moov
+
+constexpr uint8_t kFtypBox[] = {0x00, 0x00, 0x00, 0x24, 'f',  't',  'y',  'p', 'M',
+                                '4',  'V',  ' ',  0x00, 0x00, 0x00, 0x01, 'm', 'p',
+                                '4',  '2',  'i',  's',  'o',  'm',  'M',  '4', 'A',
+                                ' ',  'M',  '4',  'V',  ' ',  'd',  'b',  'y', '1'};
 
 }  // namespace
 
@@ -71,59 +83,6 @@ static std::vector<uint32_t> build_audio_chunk_plan(uint32_t sample_count) {
     return chunks;
 }
 
-// Derive samples-per-chunk plan from stsc payload.
-static std::vector<uint32_t> derive_chunk_plan(const std::vector<uint8_t> &stsc_payload,
-                                               uint32_t sample_count) {
-    std::vector<uint32_t> plan;
-    if (stsc_payload.size() < kStscHeaderSize + kStscEntrySize) {
-        return plan;
-    }
-    uint32_t entry_count = (stsc_payload[4] << 24) | (stsc_payload[5] << 16) |
-                           (stsc_payload[6] << 8) | stsc_payload[7];
-    size_t pos = kStscHeaderSize;
-    uint32_t consumed = 0;
-    for (uint32_t i = 0; i < entry_count; ++i) {
-        if (pos + kStscEntrySize > stsc_payload.size()) {
-            break;
-        }
-        uint32_t first_chunk = (stsc_payload[pos] << 24) | (stsc_payload[pos + 1] << 16) |
-                               (stsc_payload[pos + 2] << 8) | stsc_payload[pos + 3];
-        uint32_t samples_per_chunk = (stsc_payload[pos + 4] << 24) | (stsc_payload[pos + 5] << 16) |
-                                     (stsc_payload[pos + 6] << 8) | stsc_payload[pos + 7];
-        uint32_t next_first = 0;
-        if (i + 1 < entry_count && pos + kStscEntrySize <= stsc_payload.size() - 4) {
-            next_first = (stsc_payload[pos + 12] << 24) | (stsc_payload[pos + 13] << 16) |
-                         (stsc_payload[pos + 14] << 8) | (stsc_payload[pos + 15]);
-        }
-        if (samples_per_chunk == 0) {
-            break;
-        }
-        uint32_t chunk_count = (next_first > 0 && next_first > first_chunk)
-                                   ? (next_first - first_chunk)
-                                   : 0;
-        if (chunk_count == 0) {
-            while (consumed < sample_count) {
-                plan.push_back(samples_per_chunk);
-                consumed += samples_per_chunk;
-            }
-        } else {
-            for (uint32_t c = 0; c < chunk_count && consumed < sample_count; ++c) {
-                plan.push_back(samples_per_chunk);
-                consumed += samples_per_chunk;
-            }
-        }
-        pos += 12;
-    }
-    // Clamp plan length to sample_count to avoid runaway.
-    if (consumed > sample_count) {
-        while (!plan.empty() && consumed > sample_count) {
-            consumed -= plan.back();
-            plan.pop_back();
-        }
-    }
-    return plan;
-}
-
 struct DurationInfo {
     uint32_t audio_timescale = 0;
     uint64_t audio_duration_ts = 0;
@@ -147,6 +106,26 @@ struct ChunkPlans {
     std::vector<uint32_t> image;
 };
 
+// Everything needed to write an output file: the finished moov plus the chapter samples and the
+// planned mdat layout. Audio payload stays in the AacExtractResult.
+struct Mp4Build {
+    AtomPtr moov;
+    std::vector<std::vector<std::vector<uint8_t>>> text_samples;
+    std::vector<std::vector<uint8_t>> image_samples;
+    ChunkPlans chunk_plans;
+    MdatOffsets offsets;
+    Mp4Layout layout;
+};
+
+static std::vector<uint32_t> sample_sizes(const std::vector<std::vector<uint8_t>> &samples) {
+    std::vector<uint32_t> sizes;
+    sizes.reserve(samples.size());
+    for (const auto &s : samples) {
+        sizes.push_back(static_cast<uint32_t>(s.size()));
+    }
+    return sizes;
+}
+
 static std::vector<uint8_t> encode_tx3g_sample(const ChapterTextSample &sample) {
     std::vector<uint8_t> out;
     uint16_t len = static_cast<uint16_t>(sample.text.size());
@@ -311,7 +290,7 @@ static ChunkPlans build_chunk_plans(const AacExtractResult &aac, uint32_t audio_
     ChunkPlans plans;
     plans.audio =
         aac.stsc_payload.empty() ? build_audio_chunk_plan(audio_sample_count)
-                                 : derive_chunk_plan(aac.stsc_payload, audio_sample_count);
+                                 : SampleTable::derive_chunk_plan(aac.stsc_payload, audio_sample_count);
     plans.text.push_back(std::vector<uint32_t>(texts.primary.size(), 1));
     for (const auto &samples : texts.extras) {
         plans.text.emplace_back(samples.size(), 1);
@@ -359,7 +338,7 @@ std::vector<uint32_t> build_audio_chunk_plan_for_test(uint32_t sample_count) {
 }
 std::vector<uint32_t> derive_chunk_plan_for_test(const std::vector<uint8_t> &stsc_payload,
                                                  uint32_t sample_count) {
-    return derive_chunk_plan(stsc_payload, sample_count);
+    return SampleTable::derive_chunk_plan(stsc_payload, sample_count);
 }
 std::vector<uint8_t> encode_tx3g_sample_for_test(const ChapterTextSample &sample) {
     return encode_tx3g_sample(sample);
@@ -385,19 +364,20 @@ TestDurationInfo compute_durations_for_test(
 #endif
 
 // Complete MP4 writer.
-bool write_mp4(const std::string &output_path, const AacExtractResult &aac,
-               const std::vector<ChapterTextSample> &text_chapters,
-               const std::vector<ChapterImageSample> &image_chapters, Mp4aConfig audio_cfg,
-               const MetadataSet &metadata, bool fast_start,
-               const std::vector<std::pair<std::string, std::vector<ChapterTextSample>>>
-                   &extra_text_tracks,
-               const std::vector<uint8_t> *ilst_payload,
-               const std::vector<uint8_t> *meta_payload) {
-    CH_LOG("debug", "write_mp4 begin output=" << output_path << " audio_frames=" << aac.frames.size()
-                                              << " titles=" << text_chapters.size()
-                                             << " images=" << image_chapters.size()
-                                             << " extra_text_tracks=" << extra_text_tracks.size()
-                                             << " fast_start=" << fast_start);
+// Build the moov (chunk offsets not yet patched), the chapter samples and the chunk plans of an
+// output file; the placement of mdat is left to the caller.
+static std::optional<Mp4Build> build_tracks(
+    const AacExtractResult &aac, const std::vector<ChapterTextSample> &text_chapters,
+    const std::vector<ChapterImageSample> &image_chapters, Mp4aConfig audio_cfg,
+    const MetadataSet &metadata,
+    const std::vector<std::pair<std::string, std::vector<ChapterTextSample>>> &extra_text_tracks,
+    const std::vector<uint8_t> *ilst_payload, const std::vector<uint8_t> *meta_payload) {
+    CH_LOG("debug", "build_tracks begin audio_frames=" << aac.frames.size()
+                                                       << " titles=" << text_chapters.size()
+                                                       << " images=" << image_chapters.size()
+                                                       << " extra_text_tracks="
+                                                       << extra_text_tracks.size());
+    Mp4Build build;
     auto now = [] { return std::chrono::steady_clock::now(); };
     auto meta_is_empty = [](const MetadataSet &m) {
         return m.title.empty() && m.artist.empty() && m.album.empty() && m.genre.empty() &&
@@ -406,24 +386,6 @@ bool write_mp4(const std::string &output_path, const AacExtractResult &aac,
     auto t_start = now();
 
     log_inputs(metadata, text_chapters, extra_text_tracks, image_chapters);
-    //
-    // 0) open file.
-    //
-    std::ofstream out(output_path, std::ios::binary);
-    if (!out.is_open()) {
-        CH_LOG("error", "Failed to open output for write: " << output_path);
-        return false;
-    }
-
-    //
-    // Write ftyp (once at head)
-    //
-    static const uint8_t ftyp_box[] = {0x00, 0x00, 0x00, 0x24, 'f',  't',  'y',  'p', 'M',
-                                       '4',  'V',  ' ',  0x00, 0x00, 0x00, 0x01, 'm', 'p',
-                                       '4',  '2',  'i',  's',  'o',  'm',  'M',  '4', 'A',
-                                       ' ',  'M',  '4',  'V',  ' ',  'd',  'b',  'y', '1'};
-    const uint32_t ftyp_size = sizeof(ftyp_box);
-    out.write(reinterpret_cast<const char *>(ftyp_box), sizeof(ftyp_box));
 
     const uint32_t audio_sample_count = (uint32_t)aac.frames.size();
     if (audio_sample_count == 0) {
@@ -434,7 +396,7 @@ bool write_mp4(const std::string &output_path, const AacExtractResult &aac,
     //
     // Build audio samples for mdat.
     //
-    const auto &audio_samples = aac.frames;  // reuse extracted buffers without copying
+    // Audio stays in aac.frames (mapped or packed); only its sizes are needed for the layout.
 
     // Build padded tx3g samples for title and URL tracks.
     auto primary_with_href = merge_href_into_titles(text_chapters, extra_text_tracks);
@@ -443,7 +405,7 @@ bool write_mp4(const std::string &output_path, const AacExtractResult &aac,
     //
     // Image samples: JPEG binary data (may be empty if no images were provided)
     //
-    std::vector<std::vector<uint8_t>> image_samples;
+    std::vector<std::vector<uint8_t>> &image_samples = build.image_samples;
     for (auto &im : image_chapters) {
         image_samples.push_back(im.data);
     }
@@ -481,15 +443,15 @@ bool write_mp4(const std::string &output_path, const AacExtractResult &aac,
     //
     // 4) Build STBL for each track.
     //
-    ChunkPlans chunk_plans =
-        build_chunk_plans(aac, audio_sample_count, prepared_text, image_samples);
+    build.chunk_plans = build_chunk_plans(aac, audio_sample_count, prepared_text, image_samples);
+    const ChunkPlans &chunk_plans = build.chunk_plans;
 
     // Aggregate text tracks (primary + extras) for mdat/offset handling.
-    std::vector<std::vector<std::vector<uint8_t>>> all_text_samples;
+    std::vector<std::vector<std::vector<uint8_t>>> &all_text_samples = build.text_samples;
     all_text_samples.push_back(prepared_text.primary);
     all_text_samples.insert(all_text_samples.end(), prepared_text.extras.begin(),
                             prepared_text.extras.end());
-    std::vector<std::vector<uint32_t>> all_text_chunk_plans = chunk_plans.text;
+    const std::vector<std::vector<uint32_t>> &all_text_chunk_plans = chunk_plans.text;
 
     CH_LOG("debug", "chunk plans: audio=" << chunk_plans.audio.size()
                                            << " text=" << all_text_chunk_plans.size()
@@ -501,10 +463,10 @@ bool write_mp4(const std::string &output_path, const AacExtractResult &aac,
     bool has_image_track = !image_samples.empty();
     if (has_image_track) {
         if (!first_image_dimensions_and_check(image_samples, image_width, image_height)) {
-            return false;
+            return std::nullopt;
         }
         if (!validate_additional_images(image_samples, image_width, image_height)) {
-            return false;
+            return std::nullopt;
         }
     }
     auto t_prep_end = now();
@@ -518,11 +480,12 @@ bool write_mp4(const std::string &output_path, const AacExtractResult &aac,
         // so we preserve the original structure whenever we can.
         CH_LOG("debug", "Reusing source audio stbl");
         stbl_audio = build_audio_stbl_raw(aac.stsd_payload, aac.stts_payload, aac.stsc_payload,
-                                          aac.stsz_payload, aac.stco_payload);
+                                          aac.stsz_payload, aac.stco_payload,
+                                          aac.frames.sizes());
     } else {
         CH_LOG("debug", "Building new audio stbl");
         stbl_audio =
-            build_audio_stbl(audio_cfg, aac.sizes, chunk_plans.audio, audio_sample_count, nullptr);
+            build_audio_stbl(audio_cfg, aac.frames.sizes(), chunk_plans.audio, audio_sample_count, nullptr);
     }
 
     auto stbl_text = build_text_stbl(prepared_text.primary_meta, kChapterTimescale,
@@ -610,71 +573,537 @@ bool write_mp4(const std::string &output_path, const AacExtractResult &aac,
     //
     // 8) Build moov.
     //
-    auto moov = build_moov(mvhd_timescale, mvhd_duration, std::move(trak_audio),
+    auto &moov = build.moov;
+    moov = build_moov(mvhd_timescale, mvhd_duration, std::move(trak_audio),
                            std::move(text_traks), std::move(trak_image), std::move(udta));
     moov->fix_size_recursive();
     CH_LOG("debug", "moov size=" << moov->size() << " mvhd_duration=" << mvhd_duration);
-    auto t_moov_end = now();
 
-    auto t_layout_end = t_moov_end;
-    auto t_write_end = t_moov_end;
+    auto ms = [](auto a, auto b) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(b - a).count();
+    };
+    CH_LOG("debug", "build_tracks timings ms: prep=" << ms(t_start, t_prep_end)
+                                                     << " stbl=" << ms(t_prep_end, t_stbl_end)
+                                                     << " trak=" << ms(t_stbl_end, t_tracks_end)
+                                                     << " moov=" << ms(t_tracks_end, now()));
+    return build;
+}
+
+// Build the complete moov and the mdat layout for an output file without touching disk. The
+// moov's chunk offsets are already patched for the chosen layout.
+static std::optional<Mp4Build> build_mp4(
+    const AacExtractResult &aac, const std::vector<ChapterTextSample> &text_chapters,
+    const std::vector<ChapterImageSample> &image_chapters, Mp4aConfig audio_cfg,
+    const MetadataSet &metadata, bool fast_start,
+    const std::vector<std::pair<std::string, std::vector<ChapterTextSample>>> &extra_text_tracks,
+    const std::vector<uint8_t> *ilst_payload, const std::vector<uint8_t> *meta_payload) {
+    CH_LOG("debug", "build_mp4 begin fast_start=" << fast_start);
+    const auto t_start = std::chrono::steady_clock::now();
+    auto built = build_tracks(aac, text_chapters, image_chapters, audio_cfg, metadata,
+                              extra_text_tracks, ilst_payload, meta_payload);
+    if (!built) {
+        return std::nullopt;
+    }
+    Mp4Build &build = *built;
+    auto &moov = build.moov;
+    const auto &all_text_samples = build.text_samples;
+    const auto &all_text_chunk_plans = build.chunk_plans.text;
+    const auto &image_samples = build.image_samples;
+    const ChunkPlans &chunk_plans = build.chunk_plans;
+    const bool has_image_track = !image_samples.empty();
+
+    //
+    // Lay out mdat from sample sizes alone and place moov before or after it.
+    //
+    LayoutPlanner planner;
+    planner.set_audio(aac.frames.sizes(), chunk_plans.audio);
+    for (size_t i = 0; i < all_text_samples.size(); ++i) {
+        planner.add_text(sample_sizes(all_text_samples[i]), all_text_chunk_plans[i]);
+    }
+    planner.set_image(sample_sizes(image_samples), chunk_plans.image);
+
+    Mp4Layout &layout = build.layout;
+    const uint64_t mdat_header_size = LayoutPlanner::mdat_header_size(planner.payload_size());
+    layout.mdat_size = mdat_header_size + planner.payload_size();
+    auto place_boxes = [&] {
+        layout.moov_size = moov->size();
+        if (fast_start) {
+            // Moov before mdat: offsets assume mdat follows immediately after moov. This
+            // fast-start layout mirrors the golden file and keeps Apple players happy; other valid
+            // layouts have shown sporadic playback regressions despite being spec-compliant.
+            layout.moov_offset = sizeof(kFtypBox);
+            layout.mdat_offset = layout.moov_offset + layout.moov_size;
+            layout.file_size = layout.mdat_offset + layout.mdat_size;
+        } else {
+            // mdat first, then a padding free box and moov at the end of the file.
+            layout.mdat_offset = sizeof(kFtypBox);
+            layout.moov_offset = layout.mdat_offset + layout.mdat_size + kFreeBoxSize;
+            layout.file_size = layout.moov_offset + layout.moov_size;
+        }
+        build.offsets = planner.offsets(layout.mdat_offset + mdat_header_size);
+    };
+    place_boxes();
+    if (build.offsets.needs_co64()) {
+        // Chunks past 4 GB: switch every track to co64. The larger moov shifts a fast-start mdat,
+        // so place again; co64 holds any offset, so one pass settles it.
+        CH_LOG("debug", "chunk offsets exceed 32 bits; writing co64 tables");
+        promote_stco_to_co64(moov.get());
+        place_boxes();
+    }
+    if (!patch_all_stco(moov.get(), build.offsets, true)) {
+        return std::nullopt;
+    }
 
+    auto describe = [&](const char *handler, std::string name, const LayoutPlanner::Track &t,
+                        uint64_t base) {
+        layout.tracks.push_back({handler, std::move(name), t.sample_count,
+                                 static_cast<uint32_t>(t.chunk_offsets.size()), t.bytes,
+                                 build.offsets.payload_start + base});
+        return base + t.bytes;
+    };
+    uint64_t base = describe("soun", "sound handler", planner.audio(), 0);
+    for (size_t i = 0; i < planner.text().size(); ++i) {
+        base = describe("text", i == 0 ? "Chapter Titles" : extra_text_tracks[i - 1].first,
+                        planner.text()[i], base);
+    }
+    if (has_image_track) {
+        describe("vide", "Chapter Images", planner.image(), base);
+    }
+
+    CH_LOG("debug", "build_mp4 ms=" << std::chrono::duration_cast<std::chrono::milliseconds>(
+                                           std::chrono::steady_clock::now() - t_start)
+                                           .count());
+    CH_LOG("debug", "layout: file_size=" << layout.file_size << " moov@" << layout.moov_offset
+                                         << "+" << layout.moov_size << " mdat@"
+                                         << layout.mdat_offset << "+" << layout.mdat_size);
+    return built;
+}
+
+// Padding free box plus moov, written after mdat when not fast-starting.
+static void write_trailing_moov(std::ostream &out, const Atom &moov) {
+    // Size/placement mirrors the golden sample to avoid surprising atom ordering sensitivities.
+    auto free = Atom::create("free");
+    free->payload.resize(kFreeBoxSize - 8, 0);
+    free->fix_size_recursive();
+    free->write(out);
+    moov.write(out);
+}
+
+static void log_write_stats(const FileWriter::Stats &io) {
+    CH_LOG("debug", "output syscalls=" << io.syscalls << " writes=" << io.writes
+                                       << " vectored=" << io.vectored_writes
+                                       << " copies=" << io.kernel_copies
+                                       << " bytes=" << io.bytes_written);
+}
+
+// Every byte position is fixed by the layout, so the boxes around the mdat payload go out first
+// and the payload regions (audio chunk ranges, text tracks, images) then fill in concurrently.
+static bool write_regions(const std::string &output_path, const AacExtractResult &aac,
+                          const Mp4Build &build, bool fast_start, unsigned threads) {
+    auto writer = FileWriter::create(output_path);
+    if (!writer) {
+        CH_LOG("error", "Failed to open output for write: " << output_path);
+        return false;
+    }
+    if (!aac.frames.is_view()) {
+        writer->reserve(build.layout.file_size);
+    }
+    const uint64_t header_size = build.offsets.payload_start - build.layout.mdat_offset;
+    std::ostream out(writer.get());
+    out.write(reinterpret_cast<const char *>(kFtypBox), sizeof(kFtypBox));
     if (fast_start) {
-        // Moov before mdat: compute offsets assuming mdat follows immediately after moov.
-        // This fast-start layout mirrors the golden file and keeps Apple players happy;
-        // other valid layouts have shown sporadic playback regressions despite being
-        // spec-compliant.
-        uint64_t payload_start =
-            static_cast<uint64_t>(ftyp_size) + moov->size() + 8;  // +8 for mdat header
-        MdatOffsets mdat_offs =
-            compute_mdat_offsets(payload_start, audio_samples, all_text_samples, image_samples,
-                                 chunk_plans.audio, all_text_chunk_plans, chunk_plans.image);
-        patch_all_stco(moov.get(), mdat_offs, true);
-        t_layout_end = now();
-
-        // write moov, then mdat.
-        moov->write(out);
-        write_mdat(out, audio_samples, all_text_samples, image_samples, chunk_plans.audio,
-                   all_text_chunk_plans, chunk_plans.image);
-        t_write_end = now();
-    } else {
-        // Write mdat first and capture offsets.
-        MdatOffsets mdat_offs = write_mdat(out, audio_samples, all_text_samples, image_samples,
-                                           chunk_plans.audio, all_text_chunk_plans,
-                                           chunk_plans.image);
-
-        // Patch STCO in moov using the actual offsets from written mdat.
-        // If we reused the source audio stco, skip patching it.
-        patch_all_stco(moov.get(), mdat_offs, true);
-        t_layout_end = now();
-
-        // Optional leading free box before moov (padding). Size/placement mirrors the golden sample
-        // to avoid surprising atom ordering sensitivities.
-        {
-            auto free = Atom::create("free");
-            free->payload.resize(1024, 0);
-            free->fix_size_recursive();
-            free->write(out);
+        build.moov->write(out);
+    }
+    write_mdat_header(out, build.layout.mdat_size - header_size);
+    if (!fast_start) {
+        out.seekp(static_cast<std::streamoff>(build.layout.moov_offset - kFreeBoxSize));
+        write_trailing_moov(out, *build.moov);
+    }
+    if (!out || !writer->close()) {
+        CH_LOG("error", "Failed to write output: " << output_path);
+        return false;
+    }
+    FileWriter::Stats stats = writer->stats();
+    writer.reset();
+    if (!write_mdat_payload_parallel(output_path, threads, build.offsets, aac.frames,
+                                     build.text_samples, build.image_samples,
+                                     build.chunk_plans.audio, build.chunk_plans.text,
+                                     build.chunk_plans.image, &stats)) {
+        CH_LOG("error", "Failed to write output: " << output_path);
+        return false;
+    }
+    log_write_stats(stats);
+    return true;
+}
+
+bool write_mp4(const std::string &output_path, const AacExtractResult &aac,
+               const std::vector<ChapterTextSample> &text_chapters,
+               const std::vector<ChapterImageSample> &image_chapters, Mp4aConfig audio_cfg,
+               const MetadataSet &metadata, bool fast_start,
+               const std::vector<std::pair<std::string, std::vector<ChapterTextSample>>>
+                   &extra_text_tracks,
+               const std::vector<uint8_t> *ilst_payload,
+               const std::vector<uint8_t> *meta_payload, unsigned write_threads) {
+    CH_LOG("debug", "write_mp4 begin output=" << output_path);
+    auto build = build_mp4(aac, text_chapters, image_chapters, audio_cfg, metadata, fast_start,
+                           extra_text_tracks, ilst_payload, meta_payload);
+    if (!build) {
+        return false;
+    }
+    const auto t_write_start = std::chrono::steady_clock::now();
+    auto log_write_time = [&] {
+        CH_LOG("debug", "write_mp4 write ms="
+                            << std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   std::chrono::steady_clock::now() - t_write_start)
+                                   .count()
+                            << " file_size=" << build->layout.file_size
+                            << " threads=" << std::max(1u, write_threads));
+        CH_LOG("debug", "ChapterForge version " << CHAPTERFORGE_VERSION_DISPLAY);
+    };
+    if (write_threads > 1) {
+        if (!write_regions(output_path, aac, *build, fast_start, write_threads)) {
+            return false;
         }
+        log_write_time();
+        return true;
+    }
 
-        // Write moov at end of file.
-        moov->fix_size_recursive();
-        moov->write(out);
-        t_write_end = now();
+    auto writer = FileWriter::create(output_path);
+    if (!writer) {
+        CH_LOG("error", "Failed to open output for write: " << output_path);
+        return false;
+    }
+    // The final size is known from the layout, so reserve it for a contiguous allocation. Mapped
+    // audio is skipped: it may be kernel-copied, and that path keeps holes of sparse inputs.
+    if (!aac.frames.is_view()) {
+        writer->reserve(build->layout.file_size);
+    }
+    std::ostream out(writer.get());
+    out.write(reinterpret_cast<const char *>(kFtypBox), sizeof(kFtypBox));
+    if (fast_start) {
+        build->moov->write(out);
     }
+    const MdatOffsets written =
+        write_mdat(out, aac.frames, build->text_samples, build->image_samples,
+                   build->chunk_plans.audio, build->chunk_plans.text, build->chunk_plans.image);
+    if (written.payload_start != build->offsets.payload_start ||
+        written.audio_offsets != build->offsets.audio_offsets ||
+        written.text_offsets != build->offsets.text_offsets ||
+        written.image_offsets != build->offsets.image_offsets) {
+        CH_LOG("error", "written mdat layout differs from plan (payload_start="
+                            << written.payload_start << " planned="
+                            << build->offsets.payload_start << ")");
+        return false;
+    }
+    if (!fast_start) {
+        write_trailing_moov(out, *build->moov);
+    }
+    if (!out || !writer->close()) {
+        CH_LOG("error", "Failed to write output: " << output_path);
+        return false;
+    }
+    CH_LOG("debug", "audio bytes copied by kernel=" << writer->kernel_copied_bytes());
+    log_write_stats(writer->stats());
+    log_write_time();
+    return true;
+}
 
-    auto ms = [](auto a, auto b) {
-        return std::chrono::duration_cast<std::chrono::milliseconds>(b - a).count();
+bool plan_mp4(const AacExtractResult &aac, const std::vector<ChapterTextSample> &text_chapters,
+              const std::vector<ChapterImageSample> &image_chapters, Mp4aConfig audio_cfg,
+              const MetadataSet &metadata, bool fast_start,
+              const std::vector<std::pair<std::string, std::vector<ChapterTextSample>>>
+                  &extra_text_tracks,
+              const std::vector<uint8_t> *ilst_payload, const std::vector<uint8_t> *meta_payload,
+              Mp4Layout &layout) {
+    auto build = build_mp4(aac, text_chapters, image_chapters, audio_cfg, metadata, fast_start,
+                           extra_text_tracks, ilst_payload, meta_payload);
+    if (!build) {
+        return false;
+    }
+    layout = std::move(build->layout);
+    return true;
+}
+
+
+// Where an in-place update puts the new moov and the mdat holding the new chapter samples.
+struct InPlaceLayout {
+    bool moov_in_slot = false;
+    uint64_t moov_offset = 0;
+    uint64_t mdat_offset = 0;
+    uint64_t mdat_room = 0;  // free bytes the mdat goes into; 0 when it is appended
+    uint64_t file_end = 0;
+};
+
+// The moov stays in its slot (the old moov plus adjacent free boxes) when it fills it or leaves
+// room for a free box behind it. The mdat goes into the tail of the slot behind such a moov, else
+// into the first other free box it fills or leaves room in, else to the end of the file. A moov
+// that does not fit is appended last, behind a padding free box.
+static InPlaceLayout place_in_place(const in_place::BoxMap &map, size_t slot_first,
+                                    size_t slot_last, uint64_t moov_size, uint64_t mdat_size) {
+    auto fits = [](uint64_t room, uint64_t size) { return room == size || room >= size + 8; };
+    const auto &boxes = map.boxes;
+    const uint64_t slot_offset = boxes[slot_first].offset;
+    const uint64_t slot_end = boxes[slot_last].end();
+    InPlaceLayout layout;
+    layout.file_end = map.end;
+    layout.moov_in_slot = fits(slot_end - slot_offset, moov_size);
+    if (mdat_size > 0) {
+        if (layout.moov_in_slot && fits(slot_end - slot_offset - moov_size, mdat_size)) {
+            layout.mdat_offset = slot_end - mdat_size;
+            layout.mdat_room = mdat_size;
+        }
+        for (size_t i = 0; i < boxes.size() && layout.mdat_room == 0; ++i) {
+            const bool in_slot = i >= slot_first && i <= slot_last;
+            if (in_place::is_free(boxes[i]) && !(in_slot && layout.moov_in_slot) &&
+                fits(boxes[i].size, mdat_size)) {
+                layout.mdat_offset = boxes[i].offset;
+                layout.mdat_room = boxes[i].size;
+            }
+        }
+        if (layout.mdat_room == 0) {
+            layout.mdat_offset = layout.file_end;
+            layout.file_end += mdat_size;
+        }
+    }
+    layout.moov_offset = slot_offset;
+    if (!layout.moov_in_slot) {
+        layout.moov_offset = layout.file_end + kFreeBoxSize;
+        layout.file_end = layout.moov_offset + moov_size;
+    }
+    return layout;
+}
+
+bool update_mp4_in_place(const std::string &path, const AacExtractResult &aac,
+                         const std::vector<ChapterTextSample> &text_chapters,
+                         const std::vector<ChapterImageSample> &image_chapters,
+                         Mp4aConfig audio_cfg, const MetadataSet &metadata,
+                         const std::vector<std::pair<std::string, std::vector<ChapterTextSample>>>
+                             &extra_text_tracks,
+                         const std::vector<uint8_t> *ilst_payload,
+                         const std::vector<uint8_t> *meta_payload) {
+    CH_LOG("debug", "update_mp4_in_place begin path=" << path);
+    if (aac.chunk_offsets.empty() || aac.stsd_payload.empty() || aac.stts_payload.empty() ||
+        aac.stsc_payload.empty() || aac.stsz_payload.empty() || aac.stco_payload.empty()) {
+        CH_LOG("error", "in-place update needs the audio sample tables of an MP4: " << path);
+        return false;
+    }
+    auto built = build_tracks(aac, text_chapters, image_chapters, audio_cfg, metadata,
+                              extra_text_tracks, ilst_payload, meta_payload);
+    if (!built) {
+        return false;
+    }
+    Mp4Build &build = *built;
+    if (build.chunk_plans.audio.size() != aac.chunk_offsets.size()) {
+        CH_LOG("error", "audio chunk plan (" << build.chunk_plans.audio.size()
+                                             << ") does not match the source chunk offsets ("
+                                             << aac.chunk_offsets.size() << ")");
+        return false;
+    }
+
+    auto file = RandomAccessFile::open(path);
+    if (!file) {
+        CH_LOG("error", "Failed to open " << path);
+        return false;
+    }
+    const uint64_t file_size = file->size();
+    const auto map = in_place::scan_boxes(*file);
+    file.reset();
+    if (!map) {
+        CH_LOG("error", "top-level boxes of " << path << " cannot be walked; not updating it");
+        return false;
+    }
+    const auto &boxes = map->boxes;
+    const auto moov_it = std::find_if(boxes.begin(), boxes.end(), [](const in_place::Box &b) {
+        return b.type == fourcc("moov");
+    });
+    if (moov_it == boxes.end()) {
+        CH_LOG("error", "no moov in " << path);
+        return false;
+    }
+    const in_place::Box old_moov = *moov_it;
+    size_t first = static_cast<size_t>(moov_it - boxes.begin());
+    size_t last = first;
+    while (first > 0 && in_place::is_free(boxes[first - 1])) {
+        --first;
+    }
+    while (last + 1 < boxes.size() && in_place::is_free(boxes[last + 1])) {
+        ++last;
+    }
+
+    // The chapter samples form one new mdat. Audio keeps its absolute offsets; the chapter tracks
+    // point into the new mdat. The moov size only depends on stco vs co64, so place with 32-bit
+    // tables first and once more with co64 if any offset needs it.
+    LayoutPlanner planner;
+    for (size_t i = 0; i < build.text_samples.size(); ++i) {
+        planner.add_text(sample_sizes(build.text_samples[i]), build.chunk_plans.text[i]);
+    }
+    planner.set_image(sample_sizes(build.image_samples), build.chunk_plans.image);
+    const uint64_t payload_size = planner.payload_size();
+    const uint64_t header_size = LayoutPlanner::mdat_header_size(payload_size);
+    const uint64_t mdat_size = payload_size > 0 ? header_size + payload_size : 0;
+    MdatOffsets &offsets = build.offsets;
+    InPlaceLayout layout;
+    auto place = [&] {
+        layout = place_in_place(*map, first, last, build.moov->size(), mdat_size);
+        offsets = planner.offsets(layout.mdat_offset + header_size);
+        auto to_absolute = [&offsets](std::vector<uint64_t> &chunks) {
+            for (auto &chunk : chunks) {
+                chunk += offsets.payload_start;
+            }
+        };
+        for (auto &track : offsets.text_offsets) {
+            to_absolute(track);
+        }
+        to_absolute(offsets.image_offsets);
+        offsets.payload_start = 0;
+        offsets.audio_offsets = aac.chunk_offsets;
+    };
+    place();
+    // Source chunks need not be in file order, so the audio is checked whole.
+    const bool audio_wide = *std::max_element(aac.chunk_offsets.begin(),
+                                              aac.chunk_offsets.end()) > 0xFFFFFFFFULL;
+    if (audio_wide || offsets.needs_co64()) {
+        promote_stco_to_co64(build.moov.get());
+        place();
+    }
+    if (!patch_all_stco(build.moov.get(), offsets, true)) {
+        return false;
+    }
+    std::vector<uint8_t> moov = build.moov->serialize();
+
+    // Everything new is staged first. Bytes landing on a box header or on the old moov switch the
+    // file over and go into the commit journal; all others land where nothing refers to them yet
+    // (free box payloads, appended boxes) and are written up front.
+    std::vector<std::pair<uint64_t, uint64_t>> live;
+    for (const auto &b : boxes) {
+        const uint64_t header_end = b.offset + std::min<uint64_t>(16, b.size);
+        live.emplace_back(b.offset, b.type == fourcc("moov") ? b.end() : header_end);
+    }
+    std::vector<in_place::Edit> writes;
+    std::vector<in_place::Edit> edits;
+    auto stage = [&](uint64_t offset, const std::vector<uint8_t> &bytes) {
+        const uint64_t end = offset + bytes.size();
+        auto slice = [&](std::vector<in_place::Edit> &to, uint64_t from, uint64_t until) {
+            to.push_back({from, std::vector<uint8_t>(bytes.begin() + (from - offset),
+                                                     bytes.begin() + (until - offset))});
+        };
+        uint64_t pos = offset;
+        for (const auto &[lo, hi] : live) {
+            if (lo >= end) {
+                break;
+            }
+            if (hi <= pos) {
+                continue;
+            }
+            if (lo > pos) {
+                slice(writes, pos, lo);
+            }
+            const uint64_t from = std::max(lo, pos);
+            pos = std::min(hi, end);
+            slice(edits, from, pos);
+        }
+        if (pos < end) {
+            slice(writes, pos, end);
+        }
+    };
+    auto type_edit = [](uint64_t box_offset, const char type[4]) {
+        return in_place::Edit{box_offset + 4, std::vector<uint8_t>(type, type + 4)};
     };
-    CH_LOG("debug",
-           "write_mp4 timings ms: prep=" << ms(t_start, t_prep_end)
-                                         << " stbl=" << ms(t_prep_end, t_stbl_end)
-                                         << " trak=" << ms(t_stbl_end, t_tracks_end)
-                                         << " moov=" << ms(t_tracks_end, t_moov_end)
-                                         << " layout=" << ms(t_moov_end, t_layout_end)
-                                         << " write=" << ms(t_layout_end, t_write_end)
-                                         << " total=" << ms(t_start, t_write_end));
-    CH_LOG("debug", "ChapterForge version " << CHAPTERFORGE_VERSION_DISPLAY);
-
-	return true;
+    const uint64_t slot_offset = boxes[first].offset;
+    const uint64_t slot_end = boxes[last].end();
+    if (layout.moov_in_slot && old_moov.offset != slot_offset) {
+        // The old header would otherwise survive in the padding behind the new moov.
+        edits.push_back({old_moov.offset, std::vector<uint8_t>(8, 0)});
+    }
+    if (mdat_size > 0) {
+        const bool appended = layout.mdat_room == 0;
+        std::vector<uint8_t> mdat = in_place::box_header(
+            fourcc(appended ? "free" : "mdat"), mdat_size, static_cast<size_t>(header_size));
+        mdat.reserve(static_cast<size_t>(mdat_size));
+        for (const auto &track : build.text_samples) {
+            for (const auto &sample : track) {
+                mdat.insert(mdat.end(), sample.begin(), sample.end());
+            }
+        }
+        for (const auto &sample : build.image_samples) {
+            mdat.insert(mdat.end(), sample.begin(), sample.end());
+        }
+        stage(layout.mdat_offset, mdat);
+        if (layout.mdat_room > mdat_size) {
+            stage(layout.mdat_offset + mdat_size,
+                  in_place::box_header(fourcc("free"), layout.mdat_room - mdat_size));
+        }
+        if (appended) {
+            edits.push_back(type_edit(layout.mdat_offset, "mdat"));
+        }
+    }
+    if (layout.moov_in_slot) {
+        stage(slot_offset, moov);
+        // Whatever the moov leaves of the slot ahead of the samples becomes one free box.
+        const bool mdat_in_slot =
+            mdat_size > 0 && layout.mdat_offset > slot_offset && layout.mdat_offset < slot_end;
+        const uint64_t gap_end = mdat_in_slot ? layout.mdat_offset : slot_end;
+        const uint64_t gap_offset = slot_offset + moov.size();
+        if (gap_end > gap_offset) {
+            edits.push_back(
+                {gap_offset, in_place::box_header(fourcc("free"), gap_end - gap_offset)});
+        }
+    } else {
+        // Appended behind a padding free box the next update can grow into.
+        auto padding = in_place::box_header(fourcc("free"), kFreeBoxSize);
+        padding.resize(kFreeBoxSize, 0);
+        stage(layout.moov_offset - kFreeBoxSize, padding);
+        std::memcpy(moov.data() + 4, "free", 4);
+        stage(layout.moov_offset, moov);
+        edits.push_back(type_edit(layout.moov_offset, "moov"));
+        edits.push_back(type_edit(old_moov.offset, "free"));
+    }
+    // Mdats holding no audio chunk (earlier chapter samples) are reclaimed as free space.
+    std::vector<uint64_t> audio_chunks = aac.chunk_offsets;
+    std::sort(audio_chunks.begin(), audio_chunks.end());
+    for (const auto &b : boxes) {
+        auto it = std::lower_bound(audio_chunks.begin(), audio_chunks.end(), b.offset);
+        if (b.type == fourcc("mdat") && (it == audio_chunks.end() || *it >= b.end())) {
+            CH_LOG("debug", "in-place: mdat@" << b.offset << "+" << b.size << " becomes free");
+            edits.push_back(type_edit(b.offset, "free"));
+        }
+    }
+
+    // Bytes of a free box cut short by an interrupted update are dropped first.
+    if (file_size > map->end) {
+        std::error_code ec;
+        std::filesystem::resize_file(path, map->end, ec);
+        if (ec) {
+            CH_LOG("error", "failed to drop the torn tail of " << path << ": " << ec.message());
+            return false;
+        }
+    }
+    auto writer = FileWriter::open_in_place(path);
+    if (!writer) {
+        return false;
+    }
+    std::ostream out(writer.get());
+    for (const auto &write : writes) {
+        out.seekp(static_cast<std::streamoff>(write.offset));
+        out.write(reinterpret_cast<const char *>(write.bytes.data()),
+                  static_cast<std::streamsize>(write.bytes.size()));
+    }
+    if (!out || !writer->persist() || !writer->close()) {
+        CH_LOG("error", "Failed to write chapter update to " << path);
+        return false;
+    }
+    writer.reset();
+
+    if (!in_place::write_journal(path, layout.file_end, edits)) {
+        return false;
+    }
+    if (in_place::replay_journal(path) != in_place::Replay::Applied) {
+        return false;
+    }
+    CH_LOG("debug", "update_mp4_in_place done: samples@"
+                        << layout.mdat_offset << "+" << mdat_size << " moov@"
+                        << layout.moov_offset << "+" << moov.size()
+                        << (layout.moov_in_slot ? " (in slot)" : " (appended)")
+                        << " journal edits=" << edits.size() << " file_size=" << layout.file_end);
+    return true;
 }
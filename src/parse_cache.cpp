@@ -0,0 +1,204 @@
+//
+//  parse_cache.cpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#include "parse_cache.hpp"
+
+#include "input_file.hpp"
+#include "logging.hpp"
+#include "sidecar_index.hpp"
+
+namespace {
+
+uint64_t table_bytes(const SampleTable &table) {
+    return table.sizes().size_bytes() + table.offsets().size_bytes() +
+           table.samples_per_chunk().size_bytes() + table.chunk_offsets().size_bytes() +
+           table.decode_times().size_bytes();
+}
+
+}  // namespace
+
+ParsedInput::ParsedInput(ParsedMp4 parsed, std::optional<SampleTable> audio_chunks)
+    : parsed_(std::move(parsed)), tracks_(new LazyTable[parsed_.tracks.size()]) {
+    uint64_t bytes = sizeof(ParsedInput) + parsed_.tracks.size() *
+                                              (sizeof(parser_detail::TrackParseResult) +
+                                               sizeof(LazyTable));
+    if (parsed_.moov) {
+        bytes += parsed_.moov->size();
+    }
+    if (parsed_.contents) {
+        bytes += parsed_.contents->size();
+    }
+    if (parsed_.sidecar) {
+        bytes += parsed_.sidecar->size();
+    }
+    bytes_ = bytes;
+    if (audio_chunks) {
+        std::call_once(audio_.once, [&] { finish(audio_, std::move(audio_chunks)); });
+    }
+}
+
+const SampleTable *ParsedInput::finish(LazyTable &lazy, std::optional<SampleTable> table) const {
+    if (table) {
+        bytes_.fetch_add(table_bytes(*table), std::memory_order_relaxed);
+    }
+    lazy.table = std::move(table);
+    return lazy.table ? &*lazy.table : nullptr;
+}
+
+const SampleTable *ParsedInput::track_table(size_t index) const {
+    if (index >= parsed_.tracks.size()) {
+        return nullptr;
+    }
+    LazyTable &lazy = tracks_[index];
+    std::call_once(lazy.once, [&] {
+        const auto &trk = parsed_.tracks[index];
+        finish(lazy, trk.timescale == 0 ? std::nullopt
+                                        : SampleTable::build(trk.stsz, trk.stsc, trk.stco,
+                                                             trk.stts, trk.co64));
+    });
+    return lazy.table ? &*lazy.table : nullptr;
+}
+
+const SampleTable *ParsedInput::audio_chunks() const {
+    std::call_once(audio_.once, [&] {
+        finish(audio_,
+               SampleTable::build_chunks(parsed_.stsz, parsed_.stsc, parsed_.stco, parsed_.co64));
+    });
+    return audio_.table ? &*audio_.table : nullptr;
+}
+
+size_t ParseCache::IdentityHash::operator()(const FileIdentity &id) const {
+    uint64_t h = id.inode;
+    for (uint64_t v : {id.device, id.size, static_cast<uint64_t>(id.mtime_ns)}) {
+        h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    }
+    return static_cast<size_t>(h);
+}
+
+ParseCache &ParseCache::instance() {
+    static ParseCache cache;
+    return cache;
+}
+
+void ParseCache::set_capacity(uint64_t max_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_bytes_ = max_bytes;
+    trim();
+}
+
+std::shared_ptr<const ParsedInput> ParseCache::find(const FileIdentity &id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(id);
+    if (it == index_.end()) {
+        ++misses_;
+        return nullptr;
+    }
+    ++hits_;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->entry;
+}
+
+void ParseCache::insert(const FileIdentity &id, const std::string &path,
+                        std::shared_ptr<const ParsedInput> entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t max_bytes = max_bytes_.load(std::memory_order_relaxed);
+    if (max_bytes == 0 || entry->bytes() > max_bytes) {
+        return;
+    }
+    auto it = index_.find(id);
+    if (it != index_.end()) {
+        // Another caller parsed the same file concurrently; keep the newer entry.
+        lru_.erase(it->second);
+        index_.erase(it);
+    }
+    lru_.push_front(Node{id, path, std::move(entry)});
+    index_.emplace(id, lru_.begin());
+    trim();
+}
+
+size_t ParseCache::invalidate(const std::string &path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t dropped = 0;
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        if (it->path == path) {
+            index_.erase(it->id);
+            it = lru_.erase(it);
+            ++dropped;
+        } else {
+            ++it;
+        }
+    }
+    return dropped;
+}
+
+void ParseCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+}
+
+void ParseCache::trim() {
+    // Entries grow as their sample tables are built, so the total is recomputed.
+    uint64_t held = 0;
+    for (const Node &node : lru_) {
+        held += node.entry->bytes();
+    }
+    const uint64_t max_bytes = max_bytes_.load(std::memory_order_relaxed);
+    while (!lru_.empty() && held > max_bytes) {
+        held -= lru_.back().entry->bytes();
+        index_.erase(lru_.back().id);
+        lru_.pop_back();
+        ++evictions_;
+    }
+}
+
+ParseCache::Stats ParseCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats s;
+    s.hits = hits_;
+    s.misses = misses_;
+    s.evictions = evictions_;
+    s.entries = lru_.size();
+    for (const Node &node : lru_) {
+        s.bytes += node.entry->bytes();
+    }
+    s.max_bytes = max_bytes_.load(std::memory_order_relaxed);
+    return s;
+}
+
+std::shared_ptr<const ParsedInput> parse_input(InputFile &input) {
+    ParseCache &cache = ParseCache::instance();
+    const FileIdentity *id = cache.enabled() ? input.identity() : nullptr;
+    if (id != nullptr) {
+        if (auto hit = cache.find(*id)) {
+            CH_LOG("debug", "parse cache hit for " << input.name());
+            return hit;
+        }
+    }
+    // A valid sidecar index stands in for parsing; the file identity is checked against it even
+    // when the cache is off.
+    if (const FileIdentity *file_id = input.identity()) {
+        if (auto indexed = sidecar_index::load(sidecar_index::path_for(input.name()), *file_id)) {
+            CH_LOG("debug", "using sidecar index for " << input.name());
+            if (id != nullptr) {
+                cache.insert(*id, input.name(), indexed);
+            }
+            return indexed;
+        }
+    }
+    auto parsed = parse_mp4(input);
+    if (!parsed) {
+        return nullptr;
+    }
+    const bool cacheable = !parsed->used_fallback_stbl;
+    auto entry = std::make_shared<const ParsedInput>(std::move(*parsed));
+    if (id != nullptr && cacheable) {
+        cache.insert(*id, input.name(), entry);
+    }
+    return entry;
+}
@@ -8,13 +8,18 @@
 
 #include "parser.hpp"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iterator>
 #include <cstring>
-#include <fstream>
 #include <iostream>
-#include <stdexcept>
-#include <sstream>
-#include <chrono>
+#include <limits>
+#include <optional>
+#include <utility>
 
+#include "atom_scanner.hpp"
+#include "input_file.hpp"
 #include "logging.hpp"
 #include "mp4_atoms.hpp"
 
@@ -23,14 +28,26 @@ namespace {
 using parser_detail::TrackParseResult;
 
 constexpr uint64_t kAtomHeaderSize = 8;
-constexpr uint64_t kFullBoxBaseHeader = 12;  // size+type+version/flags
+constexpr uint64_t kExtendedHeaderSize = 16;
 constexpr uint64_t kMetaReservedBytes = 4;
 constexpr uint64_t kHdlrMinPayload = 20;
-constexpr uint64_t kMaxAtomPayload = 512 * 1024 * 1024;  // 512 MB safety bound
+constexpr uint64_t kMaxAtomPayload = 512 * 1024 * 1024;  // 512 MB bound for unknown atoms
+constexpr uint64_t kMaxContainerPayload = 256 * 1024 * 1024;  // moov and everything inside it
+constexpr uint64_t kMaxStsdPayload = 1024 * 1024;
+constexpr uint64_t kMaxHeaderBoxPayload = 64 * 1024;  // mvhd/tkhd/mdhd/hdlr and friends
+constexpr uint64_t kUnboundedPayload = std::numeric_limits<uint64_t>::max();
+constexpr uint64_t kMaxSalvageScan = 256 * 1024;         // cap for nested-minf salvage scans
+
+inline uint32_t be32(const uint8_t *p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) |
+           uint32_t(p[3]);
+}
 
-}  // namespace
+inline uint64_t be64(const uint8_t *p) {
+    return (uint64_t(be32(p)) << 32) | uint64_t(be32(p + 4));
+}
 
-static void skip(std::istream &in, uint64_t n) { in.seekg(n, std::ios::cur); }
+}  // namespace
 
 uint32_t read_u32(std::istream &in) {
     uint8_t b[4];
@@ -47,168 +64,149 @@ uint64_t read_u64(std::istream &in) {
            (uint64_t(b[6]) << 8) | (uint64_t(b[7]));
 }
 
-// Read atom header: size + type.
-static Mp4AtomInfo read_atom_header(std::istream &in) {
-    Mp4AtomInfo info;
-    info.offset = in.tellg();
-    info.size = read_u32(in);
-    info.type = read_u32(in);
+// Per-type payload safety bound. Media payloads (mdat) and padding (free/skip/wide) are never
+// read, only skipped by offset, so they are bounded solely by the enclosing file. Everything that
+// gets parsed is held to a limit well above what real files carry.
+static uint64_t max_payload_for(uint32_t type) {
+    switch (type) {
+        case fourcc("mdat"):
+        case fourcc("free"):
+        case fourcc("skip"):
+        case fourcc("wide"):
+            return kUnboundedPayload;
+        case fourcc("moov"):
+        case fourcc("trak"):
+        case fourcc("mdia"):
+        case fourcc("minf"):
+        case fourcc("stbl"):
+        case fourcc("udta"):
+        case fourcc("meta"):
+        case fourcc("ilst"):
+        case fourcc("stts"):
+        case fourcc("stsc"):
+        case fourcc("stsz"):
+        case fourcc("stco"):
+        case fourcc("co64"):
+            return kMaxContainerPayload;
+        case fourcc("stsd"):
+            return kMaxStsdPayload;
+        case fourcc("mvhd"):
+        case fourcc("tkhd"):
+        case fourcc("mdhd"):
+        case fourcc("hdlr"):
+        case fourcc("smhd"):
+        case fourcc("vmhd"):
+        case fourcc("nmhd"):
+        case fourcc("dinf"):
+            return kMaxHeaderBoxPayload;
+        default:
+            return kMaxAtomPayload;
+    }
+}
+
+// Read atom header (size + type) at `pos` within `buf`; `base` is the file offset of buf[0].
+// A size of zero signals a truncated header or a payload beyond the safety bound.
+static Mp4AtomInfo read_atom_header(ByteView buf, uint64_t pos, uint64_t base) {
+    Mp4AtomInfo info{};
+    info.offset = base + pos;
+    if (pos > buf.size() || buf.size() - pos < kAtomHeaderSize) {
+        info.size = 0;
+        return info;
+    }
+    const uint8_t *p = buf.data() + pos;
+    info.size = be32(p);
+    info.type = be32(p + 4);
+    info.header_size = kAtomHeaderSize;
 
     if (info.size == 1) {
         // 64-bit extended size.
-        info.size = read_u64(in);
+        if (buf.size() - pos < kExtendedHeaderSize) {
+            info.size = 0;
+            return info;
+        }
+        info.size = be64(p + 8);
+        info.header_size = kExtendedHeaderSize;
     }
     // Hard sanity: reject absurd payloads early (protect against corrupted headers).
-    if (info.size >= kAtomHeaderSize &&
-        (info.size - kAtomHeaderSize) > kMaxAtomPayload) {
+    if (info.size >= info.header_size &&
+        (info.size - info.header_size) > max_payload_for(info.type)) {
         CH_LOG("warn", "atom " << fourcc_to_string(info.type)
-                               << " claims payload " << (info.size - kAtomHeaderSize)
+                               << " claims payload " << (info.size - info.header_size)
                                << " bytes; exceeds safety bound, skipping");
         info.size = 0;
     }
     return info;
 }
 
-// Utility: read an atom payload into a byte buffer.
-static std::vector<uint8_t> read_bytes(std::istream &in, uint64_t size) {
-    std::vector<uint8_t> buf(size);
-    in.read(reinterpret_cast<char *>(buf.data()), size);
-    return buf;
-}
-
-
-static bool grab_atom_from_buffer(const std::vector<uint8_t> &buf, const char *fourcc,
-                                  std::vector<uint8_t> &dst) {
-    if (!dst.empty()) {
-        return false;
-    }
-    for (size_t i = 0; i + 8 <= buf.size(); ++i) {
-        if (buf[i + 4] == static_cast<uint8_t>(fourcc[0]) &&
-            buf[i + 5] == static_cast<uint8_t>(fourcc[1]) &&
-            buf[i + 6] == static_cast<uint8_t>(fourcc[2]) &&
-            buf[i + 7] == static_cast<uint8_t>(fourcc[3])) {
-            uint32_t sz = (buf[i] << 24) | (buf[i + 1] << 16) | (buf[i + 2] << 8) | buf[i + 3];
-            uint64_t end = static_cast<uint64_t>(i) + static_cast<uint64_t>(sz);
-            if (sz >= 8 && end <= buf.size() && end >= i + 8) {
-                dst.assign(buf.begin() + i + 8, buf.begin() + end);
-                CH_LOG("debug", "grabbed " << fourcc << " via raw scan, bytes=" << dst.size());
-                return true;
-            }
-        }
-    }
-    return false;
+// Payload view of an atom whose header was read at `pos`; caller guarantees it fits in `buf`.
+static ByteView atom_payload(ByteView buf, uint64_t pos, const Mp4AtomInfo &info) {
+    return buf.subspan(static_cast<size_t>(pos + info.header_size),
+                       static_cast<size_t>(info.size - info.header_size));
 }
 
-// Naive scan for ilst payload (fallback when structured parse misses it).
-static std::vector<uint8_t> scan_ilst_payload(const std::string &path) {
-    std::ifstream f(path, std::ios::binary);
-    if (!f.is_open()) {
-        return {};
-    }
-    f.seekg(0, std::ios::end);
-    std::streamoff len = f.tellg();
-    if (len <= 0) {
-        return {};
-    }
-    size_t sz = static_cast<size_t>(len);
-    f.seekg(0, std::ios::beg);
-    std::vector<uint8_t> data(sz);
-    f.read(reinterpret_cast<char *>(data.data()), sz);
-    for (size_t i = 0; i + 4 <= data.size(); ++i) {
-        if (data[i] == 'i' && data[i + 1] == 'l' && data[i + 2] == 's' && data[i + 3] == 't') {
-            if (i < 4) {
-                continue;
-            }
-            uint32_t size =
-                (data[i - 4] << 24) | (data[i - 3] << 16) | (data[i - 2] << 8) | (data[i - 1]);
-            if (size < 8) {
-                continue;
-            }
-            size_t payload_size = size - 8;
-            if (i + 4 + payload_size <= data.size()) {
-                return std::vector<uint8_t>(data.begin() + i + 4,
-                                            data.begin() + i + 4 + payload_size);
-            }
-        }
-    }
-    return {};
+// Signature scan for ilst payload (fallback when structured parse misses it).
+static ByteView scan_ilst_payload(ByteView data) {
+    auto ilst = AtomScanTarget::of(fourcc("ilst"));
+    scan_atoms(data, std::span<AtomScanTarget>(&ilst, 1));
+    return ilst.payload;
 }
 
 // Parse mdhd to get timescale + duration.
-static void parse_mdhd(std::istream &in, uint64_t size, uint32_t &timescale, uint64_t &duration) {
-    uint8_t version = in.get();
-    uint8_t flags[3];
-    in.read((char *)flags, 3);
-
+static void parse_mdhd(ByteView p, uint32_t &timescale, uint64_t &duration) {
+    if (p.empty()) {
+        return;
+    }
+    const uint8_t version = p[0];
     if (version == 1) {
-        read_u64(in);  // creation_time
-        read_u64(in);  // modification_time
-        timescale = read_u32(in);
-        duration = read_u64(in);
+        // version/flags, creation_time, modification_time, timescale, duration.
+        if (p.size() < 4 + 8 + 8 + 4 + 8) {
+            return;
+        }
+        timescale = be32(p.data() + 20);
+        duration = be64(p.data() + 24);
     } else {
-        read_u32(in);  // creation_time
-        read_u32(in);  // modification_time
-        timescale = read_u32(in);
-        duration = read_u32(in);
-    }
-    // skip the rest of mdhd.
-    uint64_t consumed = (version == 1 ? 1 + 3 + 8 + 8 + 4 + 8 : 1 + 3 + 4 + 4 + 4 + 4);
-    if (size > consumed) {
-        skip(in, size - consumed);
+        if (p.size() < 4 + 4 + 4 + 4 + 4) {
+            return;
+        }
+        timescale = be32(p.data() + 12);
+        duration = be32(p.data() + 16);
     }
 }
 
 // Extract ilst from meta payload (payload only, after size/type).
-static void parse_meta_payload(std::istream &in, uint64_t size, ParsedMp4 &out) {
-    const uint64_t start = (uint64_t)in.tellg();
-
-    // meta full box header.
-    uint8_t version = in.get();
-    uint8_t flags[3];
-    in.read((char *)flags, 3);
-    (void)version;
-    (void)flags;
+static void parse_meta_payload(ByteView p, ParsedMp4 &out) {
+    // meta full box header (version + flags).
+    if (p.size() < 4) {
+        return;
+    }
 
     // Peek ahead to guess whether the next word is a valid atom size/type (ISO).
-    const uint64_t payload_remain = size - 4;
+    const uint64_t payload_remain = p.size() - 4;
     bool iso_style_first = true;
     if (payload_remain >= kAtomHeaderSize) {
-        std::streampos after_flags = in.tellg();
-        uint32_t next_size = read_u32(in);
-        uint32_t next_type = read_u32(in);
-        bool looks_like_atom = next_size >= kAtomHeaderSize && next_size <= payload_remain &&
-                               is_printable_fourcc(next_type);
-        iso_style_first = looks_like_atom;
-        in.clear();
-        in.seekg(after_flags);
+        uint32_t next_size = be32(p.data() + 4);
+        uint32_t next_type = be32(p.data() + 8);
+        iso_style_first = next_size >= kAtomHeaderSize && next_size <= payload_remain &&
+                          is_printable_fourcc(next_type);
     }
 
     auto parse_children = [&](bool consume_reserved) {
-        in.clear();
-        in.seekg(start + 4);  // after version+flags
-        uint64_t remain = payload_remain;
-        if (consume_reserved && remain >= kMetaReservedBytes) {
-            read_u32(in);
-            remain -= kMetaReservedBytes;
-        }
-        while (remain > kAtomHeaderSize) {
-            auto child = read_atom_header(in);
-            if (!in || child.size == 0 || child.size < kAtomHeaderSize || child.size > remain) {
+        uint64_t pos = 4;  // after version+flags
+        if (consume_reserved && payload_remain >= kMetaReservedBytes) {
+            pos += kMetaReservedBytes;
+        }
+        while (p.size() - pos > kAtomHeaderSize) {
+            auto child = read_atom_header(p, pos, 0);
+            const uint64_t remain = p.size() - pos;
+            if (child.size == 0 || child.size < child.header_size || child.size > remain) {
                 CH_LOG("debug", "meta child invalid size=" << child.size << " remain=" << remain);
                 break;
             }
-            uint64_t payload_size = child.size - kAtomHeaderSize;
-            if (payload_size > remain - kAtomHeaderSize) {
-                CH_LOG("debug", "meta child payload exceeds remain; breaking");
-                break;
-            }
             if (child.type == fourcc("ilst")) {
-                out.ilst_payload = read_bytes(in, payload_size);
+                out.ilst_payload = atom_payload(p, pos, child);
                 CH_LOG("debug", "captured ilst payload, bytes=" << out.ilst_payload.size());
-            } else {
-                skip(in, payload_size);
             }
-            remain -= child.size;
+            pos += child.size;
         }
     };
 
@@ -224,36 +222,22 @@ static void parse_meta_payload(std::istream &in, uint64_t size, ParsedMp4 &out)
             parse_children(false);
         }
     }
-
-    // Seek to end of meta box.
-    uint64_t end = start + size;
-    in.seekg(end);
 }
 
-// Parse hdlr to retrieve handler type and name. Expects payload size (box size minus 8).
-static void parse_hdlr(std::istream &in, uint64_t payload_size, TrackParseResult &track) {
-    if (payload_size < kHdlrMinPayload) {  // too small to contain required fields
-        skip(in, payload_size);
+// Parse hdlr to retrieve handler type and name. Expects the payload (box minus header).
+static void parse_hdlr(ByteView p, TrackParseResult &track) {
+    if (p.size() < kHdlrMinPayload) {  // too small to contain required fields
         return;
     }
 
-    uint8_t version = in.get();
-    uint8_t flags[3];
-    in.read((char *)flags, 3);
-    (void)version;
-    (void)flags;
-
-    // pre_defined + handler_type.
-    skip(in, 4);
-    track.handler_type = read_u32(in);
+    // version/flags + pre_defined, then handler_type.
+    track.handler_type = be32(p.data() + 8);
 
     // reserved (12 bytes), then a Pascal-style or null-terminated UTF-8 name.
-    uint64_t consumed = 1 + 3 + 4 + 4 + 12;
+    const uint64_t consumed = 1 + 3 + 4 + 4 + 12;
     std::string name;
-    if (payload_size > consumed) {
-        uint64_t name_len = payload_size - consumed;
-        name.resize(static_cast<size_t>(name_len));
-        in.read(name.data(), (std::streamsize)name_len);
+    if (p.size() > consumed) {
+        name.assign(reinterpret_cast<const char *>(p.data() + consumed), p.size() - consumed);
         // Trim any trailing nulls.
         while (!name.empty() && name.back() == '\0') {
             name.pop_back();
@@ -263,333 +247,250 @@ static void parse_hdlr(std::istream &in, uint64_t payload_size, TrackParseResult
 }
 
 // Parse tkhd to retrieve track id and flags.
-static void parse_tkhd(std::istream &in, uint64_t payload_size, TrackParseResult &track) {
-    if (payload_size < 20) {
-        skip(in, payload_size);
+static void parse_tkhd(ByteView p, TrackParseResult &track) {
+    if (p.size() < 20) {
         return;
     }
-    uint8_t version = in.get();
-    uint8_t flags_bytes[3];
-    in.read((char *)flags_bytes, 3);
-    track.tkhd_flags = (flags_bytes[0] << 16) | (flags_bytes[1] << 8) | flags_bytes[2];
-    // creation + modification time (version dependent); skip 8 or 16 bytes.
-    uint64_t consumed = 1 + 3;
-    if (version == 1) {
-        skip(in, 16);
-        consumed += 16;
-    } else {
-        skip(in, 8);
-        consumed += 8;
-    }
-    track.track_id = read_u32(in);
-    skip(in, 4);  // reserved
-    consumed += 8;  // track_id + reserved
-    // remainder not needed here.
-    if (payload_size > consumed) {
-        skip(in, payload_size - consumed);
+    const uint8_t version = p[0];
+    track.tkhd_flags = (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+    // creation + modification time are version dependent (8 or 16 bytes).
+    const size_t id_offset = 4 + (version == 1 ? 16 : 8);
+    if (p.size() >= id_offset + 4) {
+        track.track_id = be32(p.data() + id_offset);
     }
 }
 
-// Parse stbl children (stsd, stts, stsc, stsz, stco)
-static void parse_stbl(std::istream &in, uint64_t size, TrackParseResult &track) {
-    CH_LOG("debug", "parse_stbl size=" << size);
-    uint64_t start = (uint64_t)in.tellg();
-    uint64_t remain = size;
-
-    while (remain >= 8) {
-        auto info = read_atom_header(in);
-        if (!in || info.size == 0 || info.size < 8) {
+// Parse stbl children (stsd, stts, stsc, stsz, stco/co64); the first instance of each wins.
+static void parse_stbl(ByteView p, uint64_t base, TrackParseResult &track) {
+    CH_LOG("debug", "parse_stbl size=" << p.size());
+    uint64_t pos = 0;
+    while (p.size() - pos >= kAtomHeaderSize) {
+        auto info = read_atom_header(p, pos, base);
+        if (info.size == 0 || info.size < info.header_size || info.size > p.size() - pos) {
             break;
         }
-        uint64_t payload_size = info.size - 8;
+        ByteView payload = atom_payload(p, pos, info);
 
+        ByteView *slot = nullptr;
         switch (info.type) {
-            case ('s' << 24 | 't' << 16 | 's' << 8 | 'd'):  // stsd
-                if (track.stsd.empty()) {
-                    track.stsd = read_bytes(in, payload_size);
-                } else {
-                    skip(in, payload_size);
-                }
+            case fourcc("stsd"):
+                slot = &track.stsd;
                 break;
-            case ('s' << 24 | 't' << 16 | 't' << 8 | 's'):  // stts
-                if (track.stts.empty()) {
-                    track.stts = read_bytes(in, payload_size);
-                } else {
-                    skip(in, payload_size);
-                }
+            case fourcc("stts"):
+                slot = &track.stts;
                 break;
-            case ('s' << 24 | 't' << 16 | 's' << 8 | 'c'):  // stsc
-                if (track.stsc.empty()) {
-                    track.stsc = read_bytes(in, payload_size);
-                } else {
-                    skip(in, payload_size);
-                }
+            case fourcc("stsc"):
+                slot = &track.stsc;
                 break;
-            case ('s' << 24 | 't' << 16 | 's' << 8 | 'z'):  // stsz
-                if (track.stsz.empty()) {
-                    track.stsz = read_bytes(in, payload_size);
-                } else {
-                    skip(in, payload_size);
-                }
+            case fourcc("stsz"):
+                slot = &track.stsz;
                 break;
-            case ('s' << 24 | 't' << 16 | 'c' << 8 | 'o'):  // stco
-                if (track.stco.empty()) {
-                    track.stco = read_bytes(in, payload_size);
-                } else {
-                    skip(in, payload_size);
-                }
+            case fourcc("stco"):
+            case fourcc("co64"):
+                slot = &track.stco;
                 break;
             default:
-                skip(in, payload_size);
+                break;
         }
-
-        remain -= info.size;
+        if (slot != nullptr && slot->empty()) {
+            *slot = payload;
+            if (slot == &track.stco) {
+                track.co64 = info.type == fourcc("co64");
+            }
+        }
+        pos += info.size;
     }
 
-    uint64_t end = start + size;
-    in.seekg(end);
     CH_LOG("debug", "stbl parsed sizes stsd=" << track.stsd.size()
                                                << " stts=" << track.stts.size()
                                                << " stsc=" << track.stsc.size()
                                                << " stsz=" << track.stsz.size()
-                                               << " stco=" << track.stco.size());
+                                               << (track.co64 ? " co64=" : " stco=")
+                                               << track.stco.size());
+}
+
+// Parse minf children to locate stbl.
+static void parse_minf(ByteView p, uint64_t base, TrackParseResult &track) {
+    uint64_t pos = 0;
+    while (p.size() - pos >= kAtomHeaderSize) {
+        auto mi = read_atom_header(p, pos, base);
+        if (mi.size < mi.header_size || mi.size > p.size() - pos) {
+            CH_LOG("debug", "  minf break: size<8 or overflow");
+            break;
+        }
+        CH_LOG("debug", "  minf child=" << fourcc_to_string(mi.type) << " size=" << mi.size);
+        if (mi.type == fourcc("stbl")) {
+            parse_stbl(atom_payload(p, pos, mi), base + pos + mi.header_size, track);
+        }
+        pos += mi.size;
+    }
 }
 
 // Parse mdia box of a track.
-static bool parse_mdia(std::istream &in, uint64_t mpay, uint64_t mdia_end,
-                       TrackParseResult &track, bool &force_fallback) {
-    uint64_t mdia_remain = mpay;
-    bool mdia_overflow = false;
-
-    while (mdia_remain >= 8) {
-        CH_LOG("debug", " mdia pos=" << (uint64_t)in.tellg() << " remain=" << mdia_remain);
-        auto m = read_atom_header(in);
-        if (!in || m.size == 0 || m.size < 8) {
-            CH_LOG("debug", "mdia break: stream bad or size<8");
+static bool parse_mdia(ByteView p, uint64_t base, TrackParseResult &track, bool &force_fallback) {
+    uint64_t pos = 0;
+    while (p.size() - pos >= kAtomHeaderSize) {
+        CH_LOG("debug", " mdia pos=" << (base + pos) << " remain=" << (p.size() - pos));
+        auto m = read_atom_header(p, pos, base);
+        if (m.size == 0 || m.size < m.header_size) {
+            CH_LOG("debug", "mdia break: size<8");
             break;
         }
-        uint64_t mpay_child = m.size - 8;
-        if (m.size > mdia_remain) {
+        if (m.size > p.size() - pos) {
             CH_LOG("debug", " mdia child type=" << fourcc_to_string(m.type) << " claims size="
-                                                << m.size << " but remain=" << mdia_remain
-                                                << " — clamping and bailing from mdia");
-            mdia_overflow = true;
-            in.seekg(mdia_end);
-            mdia_remain = 0;
-            break;
+                                                << m.size << " but remain=" << (p.size() - pos)
+                                                << " — bailing from mdia");
+            force_fallback = true;
+            return false;
         }
         CH_LOG("debug", " mdia child type=" << fourcc_to_string(m.type) << " size=" << m.size
                                             << " offset=" << m.offset);
+        ByteView body = atom_payload(p, pos, m);
+        const uint64_t body_base = m.offset + m.header_size;
 
-        // If a bogus child claims to run past mdia, clamp it but keep parsing so we can avoid a
-        // full fallback where possible.
-        if (m.offset + m.size > mdia_end) {
-            uint64_t allowed = mdia_end - m.offset;
-            if (allowed < 8) {
-                CH_LOG("debug", " mdia child overflow too large; bail");
-                mdia_overflow = true;
-                in.seekg(mdia_end);
-                mdia_remain = 0;
-                break;
-            }
-            CH_LOG("debug", " mdia child overflow; clamping size " << m.size << " -> " << allowed);
-            m.size = allowed;
-            mpay_child = m.size - 8;
-        }
-
-        if (m.type == ('m' << 24 | 'd' << 16 | 'h' << 8 | 'd')) {
-            parse_mdhd(in, mpay_child, track.timescale, track.duration);
+        if (m.type == fourcc("mdhd")) {
+            parse_mdhd(body, track.timescale, track.duration);
             CH_LOG("debug", "  mdhd timescale=" << track.timescale
                                                 << " duration=" << track.duration);
-        } else if (m.type == ('h' << 24 | 'd' << 16 | 'l' << 8 | 'r')) {
-            // Pass the payload size (box size minus header) so the handler name length is read
-            // correctly.
-            parse_hdlr(in, mpay_child, track);
+        } else if (m.type == fourcc("hdlr")) {
+            parse_hdlr(body, track);
             CH_LOG("debug", "  hdlr=" << std::hex << track.handler_type << std::dec
                                       << " name=" << track.handler_name);
-        } else if (m.type == ('m' << 24 | 'i' << 16 | 'n' << 8 | 'f')) {
-            // find stbl.
-            uint64_t minf_end = (uint64_t)in.tellg() + mpay_child;
-            uint64_t minf_rem = mpay_child;
-            CH_LOG("debug", "  enter minf end=" << minf_end);
-
-            while (minf_rem >= 8) {
-                auto mi = read_atom_header(in);
-                if (!in || mi.size < 8) {
-                    CH_LOG("debug", "  minf break: stream bad or size<8");
-                    break;
-                }
-                uint64_t mi_pay = mi.size - 8;
-                CH_LOG("debug", "  minf child=" << std::hex << mi.type << std::dec
-                                                 << " size=" << mi.size);
-
-                if (mi.type == ('s' << 24 | 't' << 16 | 'b' << 8 | 'l')) {
-                    parse_stbl(in, mi_pay, track);
-                } else {
-                    skip(in, mi_pay);
-                }
-                minf_rem -= mi.size;
-            }
-            in.seekg(minf_end);
-        } else {
+        } else if (m.type == fourcc("minf")) {
+            parse_minf(body, body_base, track);
+        } else if (!body.empty() && body.size() < kMaxSalvageScan) {
             // Try to salvage by scanning this mdia child payload for an embedded 'minf' (some
-            // malformed files nest it oddly).
-            if (mpay_child > 0 && mpay_child < 256 * 1024) {  // cap read size
-                auto buf = read_bytes(in, mpay_child);
-                const uint32_t minf_tag = ('m' << 24 | 'i' << 16 | 'n' << 8 | 'f');
-                for (size_t off = 0; off + 4 <= buf.size(); ++off) {
-                    uint32_t maybe =
-                        (buf[off] << 24) | (buf[off + 1] << 16) | (buf[off + 2] << 8) |
-                        buf[off + 3];
-                    if (maybe == minf_tag) {
-                        uint64_t abs_pos = m.offset + 8 + off;
-                        CH_LOG("debug", "  found nested minf @" << abs_pos << " inside "
-                                                                << fourcc_to_string(m.type));
-                        in.seekg((std::streamoff)abs_pos);
-                        uint64_t minf_remaining = mdia_end - abs_pos;
-                        parse_stbl(in, minf_remaining, track);
-                        in.seekg(mdia_end);
-                        mdia_remain = 0;
-                        goto mdia_done;
-                    }
+            // malformed files nest it oddly). Everything after the tag up to the end of mdia is
+            // treated as minf content.
+            static constexpr uint8_t kMinfTag[4] = {'m', 'i', 'n', 'f'};
+            for (size_t off = 0; off + 4 <= body.size(); ++off) {
+                if (std::memcmp(body.data() + off, kMinfTag, 4) == 0) {
+                    const uint64_t rel = pos + m.header_size + off + 4;
+                    CH_LOG("debug", "  found nested minf @" << (base + rel - 4) << " inside "
+                                                            << fourcc_to_string(m.type));
+                    parse_minf(p.subspan(static_cast<size_t>(rel)), base + rel, track);
+                    return true;
                 }
-            } else {
-                skip(in, mpay_child);
             }
         }
-        if (m.size > mdia_remain) {
-            break;
-        }
-        // Ensure we land exactly at the end of this child before reading the next atom, even if the
-        // parser above consumed slightly less than declared.
-        in.seekg((std::streamoff)(m.offset + m.size));
-        mdia_remain -= m.size;
-    }
-mdia_done:
-    in.seekg(mdia_end);
-    if (mdia_overflow) {
-        force_fallback = true;
-        return false;
+        pos += m.size;
     }
     return true;
 }
 
-// Parse trak box and return a TrackParseResult (audio/video/text).
-static std::optional<TrackParseResult> parse_trak(std::istream &in, uint64_t c_payload,
-                                                  uint64_t file_size, bool &force_fallback) {
-    (void)file_size;
-    uint64_t trak_end = (uint64_t)in.tellg() + c_payload;
-    uint64_t trak_remain = c_payload;
+// Parse trak box payload and return a TrackParseResult (audio/video/text).
+static std::optional<TrackParseResult> parse_trak(ByteView p, uint64_t base,
+                                                  bool &force_fallback) {
     TrackParseResult track;
-    CH_LOG("debug", "trak start end=" << trak_end);
+    CH_LOG("debug", "trak start end=" << (base + p.size()));
 
-    while (trak_remain >= 8) {
-        auto tchild = read_atom_header(in);
-        if (!in || tchild.size == 0 || tchild.size < 8) {
+    bool any_child = false;
+    uint64_t pos = 0;
+    while (p.size() - pos >= kAtomHeaderSize) {
+        auto tchild = read_atom_header(p, pos, base);
+        if (tchild.size == 0 || tchild.size < tchild.header_size) {
             break;
         }
-        uint64_t tpay = tchild.size - 8;
+        if (tchild.size > p.size() - pos) {
+            CH_LOG("debug", " trak child overflow; clamping size " << tchild.size << " -> "
+                                                                  << (p.size() - pos));
+            tchild.size = p.size() - pos;
+            if (tchild.size < tchild.header_size) {
+                break;
+            }
+        }
+        any_child = true;
         CH_LOG("debug", " trak child=" << fourcc_to_string(tchild.type) << " size=" << tchild.size);
 
-        if (tchild.type == ('t' << 24 | 'k' << 16 | 'h' << 8 | 'd')) {
-            parse_tkhd(in, tpay, track);
-        } else if (tchild.type == ('m' << 24 | 'd' << 16 | 'i' << 8 | 'a')) {
+        ByteView body = atom_payload(p, pos, tchild);
+        if (tchild.type == fourcc("tkhd")) {
+            parse_tkhd(body, track);
+        } else if (tchild.type == fourcc("mdia")) {
             CH_LOG("debug", "trak: entering mdia");
-            uint64_t mdia_end = (uint64_t)in.tellg() + tpay;
-            parse_mdia(in, tpay, mdia_end, track, force_fallback);
+            parse_mdia(body, tchild.offset + tchild.header_size, track, force_fallback);
             if (force_fallback) {
-                break;
+                return std::nullopt;
             }
-        } else {
-            skip(in, tpay);
-        }
-        trak_remain -= tchild.size;
-        if (force_fallback) {
-            break;
         }
+        pos += tchild.size;
     }
 
-    if (force_fallback) {
+    if (!any_child) {
+        CH_LOG("debug", "trak without parsable children; ignoring");
         return std::nullopt;
     }
 
     if (track.stsz.size() >= 12) {
-        track.sample_count = (track.stsz[8] << 24) | (track.stsz[9] << 16) |
-                             (track.stsz[10] << 8) | track.stsz[11];
+        track.sample_count = be32(track.stsz.data() + 8);
     }
 
     return track;
 }
 
-// Parse moov atom.
-static void parse_moov(std::istream &in, const Mp4AtomInfo &atom, uint64_t file_size,
-                       ParsedMp4 &out, uint32_t &best_audio_samples, bool &force_fallback) {
-    uint64_t end = atom.offset + atom.size;
-    if (end > file_size) {
-        CH_LOG("error", "parse_mp4: moov exceeds file size end=" << end << " file=" << file_size);
-        in.seekg(atom.offset + atom.size, std::ios::beg);
+// Parse meta (under moov or udta): keep the first raw payload and look for ilst inside.
+static void handle_meta(ByteView body, ParsedMp4 &out) {
+    if (out.meta_payload.empty()) {
+        out.meta_payload = body;
+    }
+    parse_meta_payload(body, out);
+}
+
+// Parse moov atom located at atom.offset inside `file`.
+static void parse_moov(ByteView file, const Mp4AtomInfo &atom, ParsedMp4 &out,
+                       uint32_t &best_audio_samples, bool &force_fallback) {
+    const uint64_t end = atom.offset + atom.size;
+    if (end > file.size()) {
+        CH_LOG("error", "parse_mp4: moov exceeds file size end=" << end
+                                                                 << " file=" << file.size());
         return;
     }
 
     CH_LOG("debug", "enter moov @0x" << std::hex << atom.offset << std::dec << " end=" << end);
-    while (((uint64_t)in.tellg()) + 8 <= end) {
-        auto child = read_atom_header(in);
-        if (!in || child.size == 0 || child.size < 8) {
+    ByteView moov = file.subspan(static_cast<size_t>(atom.offset), static_cast<size_t>(atom.size));
+    uint64_t pos = atom.header_size;
+    while (pos + kAtomHeaderSize <= moov.size()) {
+        auto child = read_atom_header(moov, pos, atom.offset);
+        if (child.size == 0 || child.size < child.header_size) {
             break;
         }
 
-        if (child.offset + child.size > end) {
-                CH_LOG("error", "parse_mp4: child overflow type=" << fourcc_to_string(child.type)
-                                                                 << " size=" << child.size
-                                                                 << " end=" << end);
-            child.size = end - child.offset;
-            if (child.size < 8) {
+        if (child.size > moov.size() - pos) {
+            CH_LOG("error", "parse_mp4: child overflow type=" << fourcc_to_string(child.type)
+                                                             << " size=" << child.size
+                                                             << " end=" << end);
+            child.size = moov.size() - pos;
+            if (child.size < child.header_size) {
                 break;
             }
         }
 
-        uint64_t c_payload = child.size - 8;
         CH_LOG("debug", "moov child=" << fourcc_to_string(child.type) << " size=" << child.size
                                       << " offset=0x" << std::hex << child.offset << std::dec);
+        ByteView body = atom_payload(moov, pos, child);
+        const uint64_t body_base = child.offset + child.header_size;
 
         switch (child.type) {
-            case ('u' << 24 | 'd' << 16 | 't' << 8 | 'a'): {
-                uint64_t udta_end = (uint64_t)in.tellg() + c_payload;
-                while (((uint64_t)in.tellg()) + 8 <= udta_end) {
-                    auto u = read_atom_header(in);
-                    if (!in || u.size < 8) {
+            case fourcc("udta"): {
+                uint64_t upos = 0;
+                while (upos + kAtomHeaderSize <= body.size()) {
+                    auto u = read_atom_header(body, upos, body_base);
+                    if (u.size < u.header_size || u.size > body.size() - upos) {
                         break;
                     }
-                    uint64_t upay = u.size - 8;
-
-                    if (u.type == ('m' << 24 | 'e' << 16 | 't' << 8 | 'a')) {
+                    if (u.type == fourcc("meta")) {
                         CH_LOG("debug", "found meta inside udta");
-                        auto meta_buf = read_bytes(in, upay);
-                        if (out.meta_payload.empty()) {
-                            out.meta_payload = meta_buf;
-                        }
-                        std::string meta_str(meta_buf.begin(), meta_buf.end());
-                        std::istringstream meta_stream(meta_str);
-                        parse_meta_payload(meta_stream, upay, out);
-                    } else {
-                        skip(in, upay);
+                        handle_meta(atom_payload(body, upos, u), out);
                     }
+                    upos += u.size;
                 }
                 break;
             }
-            case ('m' << 24 | 'e' << 16 | 't' << 8 | 'a'): {
+            case fourcc("meta"):
                 CH_LOG("debug", "found meta under moov");
-                auto meta_buf = read_bytes(in, c_payload);
-                if (out.meta_payload.empty()) {
-                    out.meta_payload = meta_buf;
-                }
-                std::string meta_str(meta_buf.begin(), meta_buf.end());
-                std::istringstream meta_stream(meta_str);
-                parse_meta_payload(meta_stream, c_payload, out);
+                handle_meta(body, out);
                 break;
-            }
-            case ('t' << 24 | 'r' << 16 | 'a' << 8 | 'k'): {
-                auto track_opt = parse_trak(in, c_payload, file_size, force_fallback);
+            case fourcc("trak"): {
+                auto track_opt = parse_trak(body, body_base, force_fallback);
                 if (!track_opt) {
                     break;
                 }
@@ -605,17 +506,140 @@ static void parse_moov(std::istream &in, const Mp4AtomInfo &atom, uint64_t file_
                         out.stsc = track.stsc;
                         out.stsz = track.stsz;
                         out.stco = track.stco;
+                        out.co64 = track.co64;
                     }
                 }
-                out.tracks.push_back(track);
+                out.tracks.push_back(std::move(track));
                 break;
             }
             default:
-                skip(in, c_payload);
                 break;
         }
+        pos += child.size;
     }
-    in.seekg(end);
+}
+
+// Every sample-table atom (and ilst) the structured parse did not capture; the order matches the
+// slots filled by apply_recovered().
+using RecoveryTargets = std::array<AtomScanTarget, 7>;
+
+static RecoveryTargets recovery_targets(const ParsedMp4 &out) {
+    return {
+        AtomScanTarget::of(fourcc("stsd"), !out.stsd.empty()),
+        AtomScanTarget::of(fourcc("stts"), !out.stts.empty()),
+        AtomScanTarget::of(fourcc("stsc"), !out.stsc.empty()),
+        AtomScanTarget::of(fourcc("stsz"), !out.stsz.empty()),
+        AtomScanTarget::of(fourcc("stco"), !out.stco.empty()),
+        AtomScanTarget::of(fourcc("ilst"), !out.ilst_payload.empty()),
+        AtomScanTarget::of(fourcc("co64"), !out.stco.empty()),
+    };
+}
+
+// Fill the tables still missing from `out` with the payloads found; they must outlive `out`.
+static void apply_recovered(const RecoveryTargets &targets, ParsedMp4 &out) {
+    ByteView *slots[] = {&out.stsd, &out.stts, &out.stsc,
+                         &out.stsz, &out.stco, &out.ilst_payload};
+    for (size_t i = 0; i < std::size(slots); ++i) {
+        if (slots[i]->empty() && targets[i].found) {
+            *slots[i] = targets[i].payload;
+        }
+    }
+    // co64 stands in for a missing stco (files past 4 GB).
+    if (out.stco.empty() && targets[std::size(slots)].found) {
+        out.stco = targets[std::size(slots)].payload;
+        out.co64 = true;
+    }
+}
+
+// Recovery for damaged files: one flat pass over the whole mapping for every sample-table atom
+// (and ilst) the structured parse did not capture. Tables already captured are kept; scanned pages
+// are dropped as the window moves on.
+static void recover_sample_tables(ByteView file, const MappedFile *mapping, ParsedMp4 &out) {
+    RecoveryTargets targets = recovery_targets(out);
+    AtomScanOptions scan_opts;
+    if (mapping != nullptr) {
+        scan_opts.on_window_done = [&](size_t begin, size_t end) {
+            mapping->release(begin, end - begin);
+        };
+        mapping->advise_sequential();
+    }
+    const uint64_t scanned = scan_atoms(file, targets, scan_opts);
+    apply_recovered(targets, out);
+    CH_LOG("debug", "recovery scan examined " << scanned << " of " << file.size() << " bytes");
+}
+
+// Window read from a source that cannot be mapped, and the largest a window grows to hold one
+// candidate box whole; a candidate claiming more is skipped.
+constexpr size_t kRecoveryWindow = 8 * 1024 * 1024;
+constexpr uint64_t kMaxRecoveredBox = 64ull * 1024 * 1024;
+
+// The same recovery over an input that cannot be mapped: fixed-size windows are read with
+// positional reads and scanned in turn, so only one window is held at a time. Consecutive windows
+// overlap by a box header; a window restarts at a candidate box cut off by its end, grown to hold
+// it. The payloads found are copied into `out.contents`. False once a read fails.
+static bool recover_sample_tables(InputFile &input, ParsedMp4 &out) {
+    RecoveryTargets targets = recovery_targets(out);
+    std::vector<std::vector<uint8_t>> found(targets.size());
+    std::vector<uint8_t> window;
+    const uint64_t total = input.size();
+    uint64_t begin = 0;
+    uint64_t want = kRecoveryWindow;
+    uint64_t windows = 0;
+    while (begin < total) {
+        window.resize(static_cast<size_t>(std::min(want, total - begin)));
+        if (!input.read_at(begin, window.data(), window.size())) {
+            return false;
+        }
+        ++windows;
+        std::optional<std::pair<uint64_t, uint64_t>> cut;  // first cut-off box: start, size
+        AtomScanOptions scan_opts;
+        scan_opts.window_bytes = window.size();
+        scan_opts.on_cut_box = [&](uint64_t box, uint64_t size) {
+            if (!cut) {
+                cut.emplace(box, size);
+            }
+        };
+        scan_atoms(window, targets, scan_opts);
+        bool remaining = false;
+        for (size_t i = 0; i < targets.size(); ++i) {
+            auto &t = targets[i];
+            if (t.found && found[i].empty() && !t.payload.empty() &&
+                t.payload.data() >= window.data() &&
+                t.payload.data() < window.data() + window.size()) {
+                found[i].assign(t.payload.begin(), t.payload.end());
+            }
+            remaining |= !t.found;
+        }
+        if (!remaining || begin + window.size() >= total) {
+            break;
+        }
+        // The last 8 bytes may hold the size and type of a box not examined yet.
+        uint64_t next = begin + window.size() - 8;
+        want = kRecoveryWindow;
+        if (cut && cut->second <= kMaxRecoveredBox &&
+            (cut->first > 0 || cut->second > window.size())) {
+            next = begin + cut->first;
+            want = std::max<uint64_t>(kRecoveryWindow, cut->second);
+        }
+        begin = next;
+    }
+    // One buffer for the payloads found, so the views stay valid as long as `out`.
+    size_t bytes = 0;
+    for (const auto &f : found) {
+        bytes += f.size();
+    }
+    auto contents = std::make_shared<std::vector<uint8_t>>();
+    contents->reserve(bytes);
+    for (size_t i = 0; i < targets.size(); ++i) {
+        const size_t at = contents->size();
+        contents->insert(contents->end(), found[i].begin(), found[i].end());
+        targets[i].payload = ByteView(contents->data() + at, found[i].size());
+    }
+    out.contents = std::move(contents);
+    apply_recovered(targets, out);
+    CH_LOG("debug", "recovery scan of " << input.name() << " read " << windows << " windows, kept "
+                                        << bytes << " bytes");
+    return true;
 }
 
 //
@@ -628,47 +652,45 @@ std::optional<ParsedMp4> parse_mp4(const std::string &path) {
     bool force_fallback = false;
 
     CH_LOG("debug", "parse_mp4 enter path=" << path);
-    std::ifstream in(path, std::ios::binary);
-    if (!in) {
-        CH_LOG("error", "parse_mp4: cannot open " << path << " errno=" << errno);
+    out.source = MappedFile::open(path);
+    if (!out.source) {
+        CH_LOG("error", "parse_mp4: cannot open " << path);
         return std::nullopt;
     }
-
-    in.seekg(0, std::ios::end);
-    const uint64_t file_size = static_cast<uint64_t>(in.tellg());
-    in.seekg(0, std::ios::beg);
+    const ByteView file = out.source->bytes();
+    const uint64_t file_size = file.size();
     CH_LOG("debug", "parse_mp4: size=" << file_size << " path=" << path);
 
-    while (in.peek() != EOF) {
+    ByteView moov_view;  // first moov seen; bounds the ilst salvage scan below
+    uint64_t pos = 0;
+    while (pos < file_size) {
         if (force_fallback) {
             break;
         }
-        Mp4AtomInfo atom = read_atom_header(in);
+        Mp4AtomInfo atom = read_atom_header(file, pos, 0);
         if (atom.size == 0) {
             CH_LOG("warn", "parse_mp4: atom with zero/invalid size encountered, bailing");
             break;
         }
-        if (atom.size < 8 || atom.offset + atom.size > file_size) {
+        if (atom.size < atom.header_size || atom.size > file_size - atom.offset) {
             CH_LOG("error", "parse_mp4: bad atom header size=" << atom.size
                                                                << " offset=" << atom.offset
                                                                << " file=" << file_size);
             break;
         }
-        uint64_t payload_size = atom.size - 8;
-
-        switch (atom.type) {
-            case ('m' << 24 | 'd' << 16 | 'a' << 8 | 't'): {  // mdat
-                // Skip mdat payload; we only need sample tables for reuse.
-                skip(in, payload_size);
-                break;
-            }
-            case ('m' << 24 | 'o' << 16 | 'o' << 8 | 'v'): {  // moov
-                parse_moov(in, atom, file_size, out, best_audio_samples, force_fallback);
-                break;
+        // mdat and any other top-level payloads are skipped without being touched; only moov is
+        // needed for sample-table reuse.
+        if (atom.type == fourcc("moov")) {
+            if (moov_view.empty()) {
+                moov_view = file.subspan(static_cast<size_t>(atom.offset),
+                                         static_cast<size_t>(atom.size));
             }
-            default:
-                skip(in, payload_size);
+            parse_moov(file, atom, out, best_audio_samples, force_fallback);
+        }
+        if (atom.offset + atom.size <= pos) {
+            break;  // no progress; never expected once the size is bounded by the file
         }
+        pos = atom.offset + atom.size;
     }
 
     const auto t_struct_done = std::chrono::steady_clock::now();
@@ -677,32 +699,18 @@ std::optional<ParsedMp4> parse_mp4(const std::string &path) {
     if (out.stsz.empty() || out.stco.empty() || out.stsc.empty() || out.stsd.empty()) {
         CH_LOG("debug", "fallback flat scan for stbl atoms");
         out.used_fallback_stbl = true;
-        // load whole file into memory and search for atoms by signature.
-        in.clear();
-        in.seekg(0, std::ios::end);
-        std::streamoff len = in.tellg();
-        if (len <= 0) {
+        if (file.empty()) {
             return out;
         }
-        in.seekg(0, std::ios::beg);
-        std::vector<uint8_t> buf(static_cast<size_t>(len));
-        in.read(reinterpret_cast<char *>(buf.data()), len);
-
-        grab_atom_from_buffer(buf, "stsd", out.stsd);
-        grab_atom_from_buffer(buf, "stts", out.stts);
-        grab_atom_from_buffer(buf, "stsc", out.stsc);
-        grab_atom_from_buffer(buf, "stsz", out.stsz);
-        grab_atom_from_buffer(buf, "stco", out.stco);
-        if (out.ilst_payload.empty()) {
-            grab_atom_from_buffer(buf, "ilst", out.ilst_payload);
-        }
+        recover_sample_tables(out.source->bytes(), out.source.get(), out);
     }
 
-    // Fallback scan for ilst if still missing.
+    // Fallback scan for ilst if still missing. Metadata lives in moov, so when moov was found and
+    // the sample tables came from it, only moov is scanned; media payloads are never touched.
     if (out.ilst_payload.empty()) {
-        auto ilst = scan_ilst_payload(path);
-        if (!ilst.empty()) {
-            out.ilst_payload = std::move(ilst);
+        const bool moov_only = !moov_view.empty() && !out.used_fallback_stbl;
+        out.ilst_payload = scan_ilst_payload(moov_only ? moov_view : file);
+        if (!out.ilst_payload.empty()) {
             CH_LOG("debug", "ilst found via naive scan, bytes=" << out.ilst_payload.size());
         }
     }
@@ -720,7 +728,8 @@ std::optional<ParsedMp4> parse_mp4(const std::string &path) {
     const auto ms_total =
         std::chrono::duration_cast<std::chrono::milliseconds>(t_done - t_start).count();
 
-    CH_LOG("debug", "parse_mp4 done stco=" << out.stco.size() << " stsc=" << out.stsc.size()
+    CH_LOG("debug", "parse_mp4 done " << (out.co64 ? "co64=" : "stco=") << out.stco.size()
+                                           << " stsc=" << out.stsc.size()
                                            << " stsz=" << out.stsz.size()
                                            << " stsd=" << out.stsd.size()
                                            << " ilst=" << out.ilst_payload.size()
@@ -733,14 +742,106 @@ std::optional<ParsedMp4> parse_mp4(const std::string &path) {
     return out;
 }
 
+std::optional<ParsedMp4> parse_mp4(InputFile &input) {
+    ParsedMp4 out;
+    uint32_t best_audio_samples = 0;
+    bool force_fallback = false;
+    const uint64_t file_size = input.size();
+    CH_LOG("debug", "parse_mp4 enter input=" << input.name() << " size=" << file_size);
+
+    // Top-level walk: one header read per atom; only the first moov is fetched.
+    auto moov = std::make_shared<std::vector<uint8_t>>();
+    uint64_t pos = 0;
+    while (pos < file_size && !force_fallback) {
+        uint8_t header[kExtendedHeaderSize];
+        const size_t want = static_cast<size_t>(std::min<uint64_t>(sizeof(header), file_size - pos));
+        if (!input.read_at(pos, header, want)) {
+            break;
+        }
+        const Mp4AtomInfo atom = read_atom_header(ByteView(header, want), 0, pos);
+        if (atom.size == 0) {
+            CH_LOG("warn", "parse_mp4: atom with zero/invalid size encountered, bailing");
+            break;
+        }
+        if (atom.size < atom.header_size || atom.size > file_size - atom.offset) {
+            CH_LOG("error", "parse_mp4: bad atom header size=" << atom.size
+                                                               << " offset=" << atom.offset
+                                                               << " file=" << file_size);
+            break;
+        }
+        if (atom.type == fourcc("moov") && moov->empty()) {
+            moov->resize(static_cast<size_t>(atom.size));
+            if (!input.read_at(atom.offset, moov->data(), moov->size())) {
+                moov->clear();
+                break;
+            }
+            Mp4AtomInfo local = atom;
+            local.offset = 0;
+            parse_moov(*moov, local, out, best_audio_samples, force_fallback);
+        }
+        if (atom.offset + atom.size <= pos) {
+            break;  // no progress; never expected once the size is bounded by the file
+        }
+        pos = atom.offset + atom.size;
+    }
+    if (!moov->empty()) {
+        out.moov = moov;
+    }
+    ByteView whole;  // mapped input, only on the fallback path
+
+    if (out.stsz.empty() || out.stco.empty() || out.stsc.empty() || out.stsd.empty()) {
+        CH_LOG("debug", "fallback flat scan for stbl atoms");
+        out.used_fallback_stbl = true;
+        if (input.is_file()) {
+            out.source = input.map();
+            if (!out.source) {
+                return input.budget_exceeded() ? std::nullopt : std::optional<ParsedMp4>(out);
+            }
+            whole = out.source->bytes();
+            if (whole.empty()) {
+                return out;
+            }
+            recover_sample_tables(whole, out.source.get(), out);
+        } else if (!recover_sample_tables(input, out)) {
+            return input.budget_exceeded() ? std::nullopt : std::optional<ParsedMp4>(out);
+        }
+    }
+    // Metadata lives in moov; the whole input is only scanned when it is mapped anyway.
+    if (out.ilst_payload.empty()) {
+        out.ilst_payload = scan_ilst_payload(whole.empty() ? ByteView(*moov) : whole);
+    }
+    if (out.stco.empty() || out.stsc.empty() || out.stsz.empty() || out.stsd.empty()) {
+        CH_LOG("error", "parse_mp4: missing stbl atoms stco/stsc/stsz/stsd");
+    }
+    CH_LOG("debug", "parse_mp4 done moov=" << moov->size() << " tracks=" << out.tracks.size()
+                                           << " fallback_stbl=" << out.used_fallback_stbl
+                                           << " bytes_read=" << input.stats().bytes);
+    return out;
+}
+
+std::optional<ParsedMp4> parse_moov_atom(ByteView moov) {
+    const Mp4AtomInfo atom = read_atom_header(moov, 0, 0);
+    if (atom.size == 0 || atom.type != fourcc("moov") || atom.size > moov.size()) {
+        CH_LOG("error", "parse_moov_atom: buffer does not hold a complete moov");
+        return std::nullopt;
+    }
+    ParsedMp4 out;
+    uint32_t best_audio_samples = 0;
+    bool force_fallback = false;
+    parse_moov(moov, atom, out, best_audio_samples, force_fallback);
+    if (force_fallback) {
+        return std::nullopt;
+    }
+    return out;
+}
+
 #ifdef CHAPTERFORGE_TESTING
-std::optional<TrackParseResult> parse_trak_for_test(std::istream &in, uint64_t payload_size,
-                                                    uint64_t file_size, bool &force_fallback) {
-    return parse_trak(in, payload_size, file_size, force_fallback);
+std::optional<TrackParseResult> parse_trak_for_test(ByteView trak_payload, bool &force_fallback) {
+    return parse_trak(trak_payload, 0, force_fallback);
 }
 
-void parse_moov_for_test(std::istream &in, const Mp4AtomInfo &atom, uint64_t file_size,
-                         ParsedMp4 &out, uint32_t &best_audio_samples, bool &force_fallback) {
-    parse_moov(in, atom, file_size, out, best_audio_samples, force_fallback);
+void parse_moov_for_test(ByteView file, const Mp4AtomInfo &atom, ParsedMp4 &out,
+                         uint32_t &best_audio_samples, bool &force_fallback) {
+    parse_moov(file, atom, out, best_audio_samples, force_fallback);
 }
 #endif
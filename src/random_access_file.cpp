@@ -0,0 +1,131 @@
+//
+//  random_access_file.cpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#include "random_access_file.hpp"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+
+#include "logging.hpp"
+
+std::unique_ptr<RandomAccessFile> RandomAccessFile::open(const std::string &path) {
+    std::unique_ptr<RandomAccessFile> f(new RandomAccessFile());
+#if defined(_WIN32)
+    HANDLE h = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (h == INVALID_HANDLE_VALUE) {
+        CH_LOG("error", "open failed for " << path << " err=" << GetLastError());
+        return nullptr;
+    }
+    f->handle_ = h;
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(h, &size)) {
+        CH_LOG("error", "stat failed for " << path << " err=" << GetLastError());
+        return nullptr;
+    }
+    f->size_ = static_cast<uint64_t>(size.QuadPart);
+    BY_HANDLE_FILE_INFORMATION info{};
+    if (GetFileInformationByHandle(h, &info)) {
+        f->identity_.device = info.dwVolumeSerialNumber;
+        f->identity_.inode =
+            (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+        const uint64_t ticks =
+            (static_cast<uint64_t>(info.ftLastWriteTime.dwHighDateTime) << 32) |
+            info.ftLastWriteTime.dwLowDateTime;
+        f->identity_.mtime_ns = static_cast<int64_t>(ticks) * 100;  // 100 ns units
+    }
+#else
+    f->fd_ = ::open(path.c_str(), O_RDONLY);
+    if (f->fd_ < 0) {
+        CH_LOG("error", "open failed for " << path << " errno=" << errno);
+        return nullptr;
+    }
+    struct stat st {};
+    if (fstat(f->fd_, &st) != 0 || !S_ISREG(st.st_mode)) {
+        CH_LOG("error", "not a regular file " << path << " errno=" << errno);
+        return nullptr;
+    }
+    f->size_ = static_cast<uint64_t>(st.st_size);
+    f->identity_.device = static_cast<uint64_t>(st.st_dev);
+    f->identity_.inode = static_cast<uint64_t>(st.st_ino);
+#if defined(__APPLE__)
+    const struct timespec mtime = st.st_mtimespec;
+#else
+    const struct timespec mtime = st.st_mtim;
+#endif
+    f->identity_.mtime_ns = static_cast<int64_t>(mtime.tv_sec) * 1000000000 + mtime.tv_nsec;
+#endif
+    f->identity_.size = f->size_;
+    return f;
+}
+
+RandomAccessFile::~RandomAccessFile() {
+#if defined(_WIN32)
+    if (handle_ != nullptr) {
+        CloseHandle(static_cast<HANDLE>(handle_));
+    }
+#else
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+}
+
+bool RandomAccessFile::read_at(uint64_t offset, void *dst, size_t length) {
+    if (offset > size_ || length > size_ - offset) {
+        return false;
+    }
+    auto *out = static_cast<uint8_t *>(dst);
+    size_t done = 0;
+    while (done < length) {
+        read_calls_.fetch_add(1, std::memory_order_relaxed);
+#if defined(_WIN32)
+        OVERLAPPED ov{};
+        const uint64_t pos = offset + done;
+        ov.Offset = static_cast<DWORD>(pos & 0xFFFFFFFFu);
+        ov.OffsetHigh = static_cast<DWORD>(pos >> 32);
+        const DWORD want = static_cast<DWORD>(std::min<size_t>(length - done, 1u << 30));
+        DWORD got = 0;
+        if (!ReadFile(static_cast<HANDLE>(handle_), out + done, want, &got, &ov) || got == 0) {
+            return false;
+        }
+#else
+        const ssize_t got = ::pread(fd_, out + done, length - done,
+                                    static_cast<off_t>(offset + done));
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return false;
+        }
+#endif
+        done += static_cast<size_t>(got);
+        bytes_read_.fetch_add(static_cast<uint64_t>(got), std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool RandomAccessFile::read_at(uint64_t offset, size_t length, std::vector<uint8_t> &out) {
+    out.resize(length);
+    if (!read_at(offset, out.data(), length)) {
+        out.clear();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,239 @@
+//
+//  sample_table.cpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#include "sample_table.hpp"
+
+#include <algorithm>
+
+#include "byte_order.hpp"
+#include "logging.hpp"
+
+namespace {
+
+constexpr size_t kFullBoxHeader = 8;  // version/flags + entry_count
+constexpr size_t kStszHeader = 12;    // version/flags + sample_size + sample_count
+constexpr size_t kStscEntrySize = 12;
+constexpr size_t kSttsEntrySize = 8;
+
+inline uint32_t be32(const uint8_t *p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) |
+           uint32_t(p[3]);
+}
+
+struct StscEntry {
+    uint32_t first_chunk;
+    uint32_t samples_per_chunk;
+};
+
+// Reads the stsc entries; stops at the first entry whose first_chunk does not increase, so every
+// returned entry covers at least one chunk.
+std::optional<std::vector<StscEntry>> read_stsc(std::span<const uint8_t> stsc) {
+    if (stsc.size() < kFullBoxHeader) {
+        return std::nullopt;
+    }
+    const uint64_t count = be32(stsc.data() + 4);
+    if (stsc.size() < kFullBoxHeader + count * kStscEntrySize) {
+        return std::nullopt;
+    }
+    // first_chunk, samples_per_chunk, sample_description_index per entry.
+    std::vector<uint32_t> fields(static_cast<size_t>(count) * 3);
+    load_be32(stsc.data() + kFullBoxHeader, fields);
+    std::vector<StscEntry> entries;
+    entries.reserve(static_cast<size_t>(count));
+    for (size_t i = 0; i < fields.size(); i += 3) {
+        const StscEntry e{fields[i], fields[i + 1]};
+        if (e.first_chunk == 0 || (!entries.empty() && e.first_chunk <= entries.back().first_chunk)) {
+            break;
+        }
+        entries.push_back(e);
+    }
+    return entries;
+}
+
+}  // namespace
+
+std::vector<uint32_t> SampleTable::derive_chunk_plan(std::span<const uint8_t> stsc,
+                                                     uint32_t sample_count) {
+    std::vector<uint32_t> plan;
+    auto entries = read_stsc(stsc);
+    if (!entries || entries->empty()) {
+        return plan;
+    }
+    uint32_t remaining = sample_count;
+    for (size_t e = 0; e < entries->size() && remaining > 0; ++e) {
+        const uint32_t per_chunk = (*entries)[e].samples_per_chunk;
+        if (per_chunk == 0) {
+            break;
+        }
+        const bool last = e + 1 == entries->size();
+        uint64_t chunks = last ? UINT64_MAX
+                               : (*entries)[e + 1].first_chunk - (*entries)[e].first_chunk;
+        for (; chunks > 0 && remaining > 0; --chunks) {
+            const uint32_t n = std::min(per_chunk, remaining);
+            plan.push_back(n);
+            remaining -= n;
+        }
+    }
+    return plan;
+}
+
+std::optional<SampleTable> SampleTable::build(std::span<const uint8_t> stsz,
+                                              std::span<const uint8_t> stsc,
+                                              std::span<const uint8_t> stco,
+                                              std::span<const uint8_t> stts, bool co64) {
+    return build_index(stsz, stsc, stco, stts, co64, true);
+}
+
+std::optional<SampleTable> SampleTable::build_chunks(std::span<const uint8_t> stsz,
+                                                     std::span<const uint8_t> stsc,
+                                                     std::span<const uint8_t> stco,
+                                                     bool co64) {
+    return build_index(stsz, stsc, stco, {}, co64, false);
+}
+
+std::optional<SampleTable> SampleTable::from_chunk_plan(
+    std::span<const uint8_t> stsz, std::span<const uint32_t> samples_per_chunk,
+    std::span<const uint64_t> chunk_offsets) {
+    if (stsz.size() < kStszHeader || samples_per_chunk.size() != chunk_offsets.size()) {
+        return std::nullopt;
+    }
+    const uint32_t constant_size = be32(stsz.data() + 4);
+    const uint64_t sample_count = be32(stsz.data() + 8);
+    if (constant_size == 0 && stsz.size() < kStszHeader + sample_count * 4) {
+        return std::nullopt;
+    }
+    uint64_t planned = 0;
+    for (uint32_t n : samples_per_chunk) {
+        planned += n;
+    }
+    if (planned != sample_count) {
+        return std::nullopt;
+    }
+    SampleTable table;
+    if (constant_size != 0) {
+        table.sizes_.assign(static_cast<size_t>(sample_count), constant_size);
+    } else {
+        table.sizes_.resize(static_cast<size_t>(sample_count));
+        load_be32(stsz.data() + kStszHeader, table.sizes_);
+    }
+    table.samples_per_chunk_.assign(samples_per_chunk.begin(), samples_per_chunk.end());
+    table.chunk_offsets_.assign(chunk_offsets.begin(), chunk_offsets.end());
+    return table;
+}
+
+std::optional<SampleTable> SampleTable::build_index(std::span<const uint8_t> stsz,
+                                                    std::span<const uint8_t> stsc,
+                                                    std::span<const uint8_t> stco,
+                                                    std::span<const uint8_t> stts, bool co64,
+                                                    bool per_sample) {
+    if (stsz.size() < kStszHeader || stco.size() < kFullBoxHeader) {
+        return std::nullopt;
+    }
+    const uint32_t constant_size = be32(stsz.data() + 4);
+    const uint64_t sample_count = be32(stsz.data() + 8);
+    if (constant_size == 0 && stsz.size() < kStszHeader + sample_count * 4) {
+        return std::nullopt;
+    }
+    const size_t offset_size = co64 ? 8 : 4;
+    const uint64_t chunk_count = be32(stco.data() + 4);
+    if (stco.size() < kFullBoxHeader + chunk_count * offset_size) {
+        return std::nullopt;
+    }
+    auto entries = read_stsc(stsc);
+    if (!entries || (sample_count > 0 && (entries->empty() || entries->front().first_chunk != 1))) {
+        return std::nullopt;
+    }
+
+    // Reject tables whose chunks cannot hold every sample before allocating per-sample arrays.
+    uint64_t capacity = 0;
+    for (size_t e = 0; e < entries->size() && (*entries)[e].first_chunk <= chunk_count; ++e) {
+        const uint64_t end = e + 1 < entries->size()
+                                 ? std::min<uint64_t>((*entries)[e + 1].first_chunk - 1, chunk_count)
+                                 : chunk_count;
+        capacity += (end - (*entries)[e].first_chunk + 1) * (*entries)[e].samples_per_chunk;
+    }
+    if (capacity < sample_count) {
+        CH_LOG("debug", "sample table: chunks hold " << capacity << " of " << sample_count
+                                                     << " samples");
+        return std::nullopt;
+    }
+
+    SampleTable table;
+    if (constant_size != 0) {
+        table.sizes_.assign(static_cast<size_t>(sample_count), constant_size);
+    } else {
+        table.sizes_.resize(static_cast<size_t>(sample_count));
+        load_be32(stsz.data() + kStszHeader, table.sizes_);
+    }
+
+    // Decode the whole chunk offset table up front; the walk below only indexes it.
+    std::vector<uint64_t> chunk_offsets(static_cast<size_t>(chunk_count));
+    if (co64) {
+        load_be64(stco.data() + kFullBoxHeader, chunk_offsets);
+    } else {
+        std::vector<uint32_t> narrow(chunk_offsets.size());
+        load_be32(stco.data() + kFullBoxHeader, narrow);
+        std::copy(narrow.begin(), narrow.end(), chunk_offsets.begin());
+    }
+
+    if (per_sample) {
+        table.offsets_.resize(table.sizes_.size());
+    }
+    size_t sample = 0;
+    for (size_t e = 0; e < entries->size() && sample < table.sizes_.size(); ++e) {
+        const uint64_t first = (*entries)[e].first_chunk;
+        const uint64_t end = e + 1 < entries->size()
+                                 ? std::min<uint64_t>((*entries)[e + 1].first_chunk - 1, chunk_count)
+                                 : chunk_count;
+        const uint32_t per_chunk = (*entries)[e].samples_per_chunk;
+        for (uint64_t chunk = first; chunk <= end && sample < table.sizes_.size(); ++chunk) {
+            uint64_t cursor = chunk_offsets[chunk - 1];
+            const size_t n = std::min<size_t>(per_chunk, table.sizes_.size() - sample);
+            table.chunk_offsets_.push_back(cursor);
+            table.samples_per_chunk_.push_back(static_cast<uint32_t>(n));
+            if (!per_sample) {
+                sample += n;
+                continue;
+            }
+            for (size_t s = 0; s < n; ++s, ++sample) {
+                table.offsets_[sample] = cursor;
+                cursor += table.sizes_[sample];
+            }
+        }
+    }
+
+    if (stts.size() >= kFullBoxHeader) {
+        const uint64_t count = be32(stts.data() + 4);
+        if (stts.size() >= kFullBoxHeader + count * kSttsEntrySize) {
+            // sample_count, sample_delta per entry.
+            std::vector<uint32_t> fields(static_cast<size_t>(count) * 2);
+            load_be32(stts.data() + kFullBoxHeader, fields);
+            table.decode_times_.reserve(table.sizes_.size());
+            uint64_t time = 0;
+            for (size_t i = 0;
+                 i < fields.size() && table.decode_times_.size() < table.sizes_.size(); i += 2) {
+                const uint64_t n = std::min<uint64_t>(
+                    fields[i], table.sizes_.size() - table.decode_times_.size());
+                const uint32_t delta = fields[i + 1];
+                for (uint64_t j = 0; j < n; ++j) {
+                    table.decode_times_.push_back(time);
+                    time += delta;
+                }
+            }
+        }
+    }
+    return table;
+}
+
+std::optional<size_t> SampleTable::sample_at_time(uint64_t time) const {
+    auto it = std::upper_bound(decode_times_.begin(), decode_times_.end(), time);
+    if (it == decode_times_.begin()) {
+        return std::nullopt;
+    }
+    return static_cast<size_t>(it - decode_times_.begin()) - 1;
+}
@@ -0,0 +1,343 @@
+//
+//  sidecar_index.cpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#include "sidecar_index.hpp"
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "file_writer.hpp"
+#include "logging.hpp"
+#include "mapped_file.hpp"
+#include "parse_cache.hpp"
+#include "parser.hpp"
+#include "sample_table.hpp"
+
+namespace {
+
+constexpr char kMagic[8] = {'C', 'F', 'I', 'D', 'X', '\r', '\n', '\x1a'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = 64;
+constexpr size_t kHashedHeaderSize = 56;  // everything before the header hash
+constexpr size_t kRefSize = 16;           // u64 offset + u64 size
+// timescale, flags, duration; stsd, stts, stsc, stsz, stco, ilst, meta, chunk plan, chunk offsets
+constexpr size_t kAudioRefs = 9;
+constexpr size_t kAudioRecordSize = 16 + kAudioRefs * kRefSize;
+// track_id, tkhd_flags, handler_type, timescale, duration, sample_count, flags; name, stsd, stts,
+// stsc, stsz, stco
+constexpr size_t kTrackRefs = 6;
+constexpr size_t kTrackRecordSize = 32 + kTrackRefs * kRefSize;
+constexpr uint32_t kFlagCo64 = 1;
+
+// The chunk plan and offsets are used in place as native arrays.
+constexpr bool kNativeLittleEndian = std::endian::native == std::endian::little;
+
+void put_u32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+}
+
+void put_u64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) {
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+}
+
+uint32_t get_u32(const uint8_t *p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; --i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+uint64_t get_u64(const uint8_t *p) {
+    return static_cast<uint64_t>(get_u32(p)) | (static_cast<uint64_t>(get_u32(p + 4)) << 32);
+}
+
+long current_pid() {
+#if defined(_WIN32)
+    return static_cast<long>(_getpid());
+#else
+    return static_cast<long>(::getpid());
+#endif
+}
+
+// FNV-1a over 64-bit words (bytes for the tail), with a shift to spread high bits.
+uint64_t hash_bytes(ByteView bytes) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    size_t i = 0;
+    for (; i + 8 <= bytes.size(); i += 8) {
+        uint64_t w;
+        std::memcpy(&w, bytes.data() + i, 8);
+        h = (h ^ w) * 0x100000001b3ULL;
+        h ^= h >> 29;
+    }
+    for (; i < bytes.size(); ++i) {
+        h = (h ^ bytes[i]) * 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// Serialises records and 8-byte aligned payload blobs; a view written before (the audio track's
+// tables appear both as ParsedMp4 fields and in its track record) is stored once.
+class Builder {
+  public:
+    explicit Builder(size_t records_size) : out_(records_size, 0) {}
+
+    void ref(size_t at, ByteView bytes) {
+        uint64_t offset = 0;
+        if (!bytes.empty()) {
+            const auto key = std::make_pair(bytes.data(), bytes.size());
+            auto it = written_.find(key);
+            if (it == written_.end()) {
+                out_.resize((out_.size() + 7) & ~size_t{7}, 0);
+                it = written_.emplace(key, out_.size()).first;
+                out_.insert(out_.end(), bytes.begin(), bytes.end());
+            }
+            offset = it->second;
+        }
+        put_u64(out_.data() + at, offset);
+        put_u64(out_.data() + at + 8, bytes.size());
+    }
+
+    uint8_t *at(size_t offset) { return out_.data() + offset; }
+    std::vector<uint8_t> &bytes() { return out_; }
+
+  private:
+    std::vector<uint8_t> out_;
+    std::map<std::pair<const uint8_t *, size_t>, uint64_t> written_;
+};
+
+template <typename T>
+ByteView as_bytes(std::span<const T> values) {
+    return {reinterpret_cast<const uint8_t *>(values.data()), values.size_bytes()};
+}
+
+// Resolves refs against the mapped index; any ref outside it fails the whole load.
+class Reader {
+  public:
+    explicit Reader(ByteView file) : file_(file) {}
+
+    ByteView ref(size_t at) {
+        const uint64_t offset = get_u64(file_.data() + at);
+        const uint64_t size = get_u64(file_.data() + at + 8);
+        if (size == 0) {
+            return {};
+        }
+        if (offset < kHeaderSize || offset > file_.size() || size > file_.size() - offset) {
+            ok_ = false;
+            return {};
+        }
+        return file_.subspan(static_cast<size_t>(offset), static_cast<size_t>(size));
+    }
+
+    // Native array view of a ref; needs the 8-byte alignment every blob is written with.
+    template <typename T>
+    std::span<const T> array(size_t at) {
+        const ByteView bytes = ref(at);
+        if (reinterpret_cast<uintptr_t>(bytes.data()) % alignof(T) != 0 ||
+            bytes.size() % sizeof(T) != 0) {
+            ok_ = false;
+            return {};
+        }
+        return {reinterpret_cast<const T *>(bytes.data()), bytes.size() / sizeof(T)};
+    }
+
+    bool ok() const { return ok_; }
+
+  private:
+    ByteView file_;
+    bool ok_ = true;
+};
+
+}  // namespace
+
+namespace sidecar_index {
+
+std::string path_for(const std::string &media_path) { return media_path + ".cfidx"; }
+
+bool write(const ParsedInput &input, const FileIdentity &source, const std::string &path) {
+    if (!kNativeLittleEndian) {
+        CH_LOG("warn", "sidecar index not supported on big-endian hosts");
+        return false;
+    }
+    const ParsedMp4 &parsed = input.parsed();
+    const SampleTable *audio = input.audio_chunks();
+    if (audio == nullptr || parsed.used_fallback_stbl) {
+        CH_LOG("error", "no consistent audio sample table to index for " << path);
+        return false;
+    }
+    const size_t records = kHeaderSize + kAudioRecordSize + parsed.tracks.size() * kTrackRecordSize;
+    Builder b(records);
+
+    size_t at = kHeaderSize;
+    put_u32(b.at(at), parsed.audio_timescale);
+    put_u32(b.at(at + 4), parsed.co64 ? kFlagCo64 : 0);
+    put_u64(b.at(at + 8), parsed.audio_duration);
+    const ByteView audio_refs[kAudioRefs] = {
+        parsed.stsd, parsed.stts, parsed.stsc, parsed.stsz, parsed.stco,
+        parsed.ilst_payload, parsed.meta_payload, as_bytes(audio->samples_per_chunk()),
+        as_bytes(audio->chunk_offsets())};
+    for (size_t i = 0; i < kAudioRefs; ++i) {
+        b.ref(at + 16 + i * kRefSize, audio_refs[i]);
+    }
+    at += kAudioRecordSize;
+
+    for (const auto &trk : parsed.tracks) {
+        put_u32(b.at(at), trk.track_id);
+        put_u32(b.at(at + 4), trk.tkhd_flags);
+        put_u32(b.at(at + 8), trk.handler_type);
+        put_u32(b.at(at + 12), trk.timescale);
+        put_u64(b.at(at + 16), trk.duration);
+        put_u32(b.at(at + 24), trk.sample_count);
+        put_u32(b.at(at + 28), trk.co64 ? kFlagCo64 : 0);
+        const ByteView name(reinterpret_cast<const uint8_t *>(trk.handler_name.data()),
+                            trk.handler_name.size());
+        const ByteView track_refs[kTrackRefs] = {name, trk.stsd, trk.stts,
+                                                 trk.stsc, trk.stsz, trk.stco};
+        for (size_t i = 0; i < kTrackRefs; ++i) {
+            b.ref(at + 32 + i * kRefSize, track_refs[i]);
+        }
+        at += kTrackRecordSize;
+    }
+
+    auto &out = b.bytes();
+    std::memcpy(out.data(), kMagic, sizeof(kMagic));
+    put_u32(out.data() + 8, kVersion);
+    put_u32(out.data() + 12, static_cast<uint32_t>(parsed.tracks.size()));
+    put_u64(out.data() + 16, source.size);
+    put_u64(out.data() + 24, static_cast<uint64_t>(source.mtime_ns));
+    put_u64(out.data() + 32, out.size() - kHeaderSize);
+    put_u64(out.data() + 40, hash_bytes(ByteView(out).subspan(kHeaderSize)));
+    put_u64(out.data() + 56, hash_bytes(ByteView(out.data(), kHashedHeaderSize)));
+
+    // Write beside the target, make it durable and rename, so readers never map a partial index
+    // and a crash cannot leave the new name pointing at unwritten data. The temp name is unique
+    // per process and call, so concurrent writers of the same index do not share a file.
+    static std::atomic<uint64_t> temp_counter{0};
+    const std::string tmp = path + "." + std::to_string(current_pid()) + "." +
+                            std::to_string(temp_counter.fetch_add(1)) + ".tmp";
+    std::error_code ec;
+    {
+        auto writer = FileWriter::create(tmp);
+        if (!writer) {
+            CH_LOG("error", "failed to create sidecar index " << tmp);
+            return false;
+        }
+        std::ostream f(writer.get());
+        f.write(reinterpret_cast<const char *>(out.data()),
+                static_cast<std::streamsize>(out.size()));
+        if (!f || !writer->persist() || !writer->close()) {
+            CH_LOG("error", "failed to write sidecar index " << tmp);
+            writer.reset();
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        CH_LOG("error", "failed to rename " << tmp << " to " << path << ": " << ec.message());
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    CH_LOG("debug", "wrote sidecar index " << path << " bytes=" << out.size()
+                                           << " tracks=" << parsed.tracks.size());
+    return true;
+}
+
+std::shared_ptr<const ParsedInput> load(const std::string &path, const FileIdentity &source) {
+    std::error_code ec;
+    if (!kNativeLittleEndian || !std::filesystem::is_regular_file(path, ec)) {
+        return nullptr;
+    }
+    auto map = MappedFile::open(path);
+    if (!map || map->size() < kHeaderSize + kAudioRecordSize) {
+        CH_LOG("debug", "sidecar index " << path << " unreadable or truncated");
+        return nullptr;
+    }
+    const ByteView file = map->bytes();
+    const uint8_t *h = file.data();
+    const uint32_t track_count = get_u32(h + 12);
+    if (std::memcmp(h, kMagic, sizeof(kMagic)) != 0 || get_u32(h + 8) != kVersion ||
+        get_u64(h + 56) != hash_bytes(file.first(kHashedHeaderSize))) {
+        CH_LOG("debug", "sidecar index " << path << " has a bad header");
+        return nullptr;
+    }
+    if (get_u64(h + 16) != source.size ||
+        static_cast<int64_t>(get_u64(h + 24)) != source.mtime_ns) {
+        CH_LOG("debug", "sidecar index " << path << " is stale");
+        return nullptr;
+    }
+    if (get_u64(h + 32) != file.size() - kHeaderSize ||
+        kHeaderSize + kAudioRecordSize + uint64_t{track_count} * kTrackRecordSize > file.size() ||
+        get_u64(h + 40) != hash_bytes(file.subspan(kHeaderSize))) {
+        CH_LOG("debug", "sidecar index " << path << " is damaged");
+        return nullptr;
+    }
+
+    Reader r(file);
+    ParsedMp4 parsed;
+    size_t at = kHeaderSize;
+    parsed.audio_timescale = get_u32(h + at);
+    parsed.co64 = (get_u32(h + at + 4) & kFlagCo64) != 0;
+    parsed.audio_duration = get_u64(h + at + 8);
+    ByteView *audio_refs[] = {&parsed.stsd, &parsed.stts, &parsed.stsc, &parsed.stsz,
+                              &parsed.stco, &parsed.ilst_payload, &parsed.meta_payload};
+    for (size_t i = 0; i < std::size(audio_refs); ++i) {
+        *audio_refs[i] = r.ref(at + 16 + i * kRefSize);
+    }
+    const auto chunk_plan = r.array<uint32_t>(at + 16 + 7 * kRefSize);
+    const auto chunk_offsets = r.array<uint64_t>(at + 16 + 8 * kRefSize);
+    at += kAudioRecordSize;
+
+    parsed.tracks.resize(track_count);
+    for (auto &trk : parsed.tracks) {
+        trk.track_id = get_u32(h + at);
+        trk.tkhd_flags = get_u32(h + at + 4);
+        trk.handler_type = get_u32(h + at + 8);
+        trk.timescale = get_u32(h + at + 12);
+        trk.duration = get_u64(h + at + 16);
+        trk.sample_count = get_u32(h + at + 24);
+        trk.co64 = (get_u32(h + at + 28) & kFlagCo64) != 0;
+        const ByteView name = r.ref(at + 32);
+        trk.handler_name.assign(reinterpret_cast<const char *>(name.data()), name.size());
+        ByteView *track_refs[] = {&trk.stsd, &trk.stts, &trk.stsc, &trk.stsz, &trk.stco};
+        for (size_t i = 0; i < std::size(track_refs); ++i) {
+            *track_refs[i] = r.ref(at + 32 + (i + 1) * kRefSize);
+        }
+        at += kTrackRecordSize;
+    }
+    if (!r.ok()) {
+        CH_LOG("debug", "sidecar index " << path << " has refs outside the file");
+        return nullptr;
+    }
+    auto audio = SampleTable::from_chunk_plan(parsed.stsz, chunk_plan, chunk_offsets);
+    if (!audio) {
+        CH_LOG("debug", "sidecar index " << path << " has an inconsistent chunk plan");
+        return nullptr;
+    }
+    parsed.sidecar = std::move(map);
+    CH_LOG("debug", "loaded sidecar index " << path << " tracks=" << track_count);
+    return std::make_shared<const ParsedInput>(std::move(parsed), std::move(audio));
+}
+
+}  // namespace sidecar_index
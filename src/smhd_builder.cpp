@@ -8,21 +8,11 @@
 
 #include "smhd_builder.hpp"
 
+#include "fixed_boxes.hpp"
+
 std::unique_ptr<Atom> build_smhd() {
+    // version/flags 0, balance 0, reserved.
     auto smhd = Atom::create("smhd");
-    auto &p = smhd->payload;
-
-    // version.
-    write_u8(p, 0);
-
-    // flags.
-    write_u24(p, 0);
-
-    // balance = 0.
-    write_u16(p, 0);
-
-    // reserved.
-    write_u16(p, 0);
-
+    smhd->payload = fixed_boxes::Smhd::kTemplate.to_vector();
     return smhd;
 }
@@ -62,19 +62,20 @@ static std::unique_ptr<Atom> build_stsc(const std::vector<uint32_t> &chunk_sizes
     return stsc;
 }
 
+// version/flags + sample_size + sample_count
+constexpr size_t kStszHeaderSize = 12;
+
 // Build stsz (sizes of all AAC frames)
-static std::unique_ptr<Atom> build_stsz(const std::vector<uint32_t> &sizes) {
+static std::unique_ptr<Atom> build_stsz(std::span<const uint32_t> sizes) {
     auto stsz = Atom::create("stsz");
     auto &p = stsz->payload;
+    p.reserve(12 + sizes.size() * 4);
 
     write_u8(p, 0);
     write_u24(p, 0);
     write_u32(p, 0);  // sample_size = 0 (variable)
     write_u32(p, sizes.size());
-
-    for (uint32_t s : sizes) {
-        write_u32(p, s);
-    }
+    write_u32_array(p, sizes);
 
     return stsz;
 }
@@ -88,16 +89,14 @@ static std::unique_ptr<Atom> build_stco(uint32_t chunk_count) {
     write_u24(p, 0);
 
     write_u32(p, chunk_count);
-    for (uint32_t i = 0; i < chunk_count; ++i) {
-        write_u32(p, 0);  // filled later in patch_stco()
-    }
+    p.resize(p.size() + size_t(chunk_count) * 4, 0);  // filled later in patch_stco()
 
     return stco;
 }
 
 // Build audio stbl from parsed AAC config and sample layout.
 std::unique_ptr<Atom> build_audio_stbl(const Mp4aConfig &cfg,
-                                       const std::vector<uint32_t> &sample_sizes,
+                                       std::span<const uint32_t> sample_sizes,
                                        const std::vector<uint32_t> &chunk_sizes,
                                        uint32_t num_samples, const std::vector<uint8_t> *raw_stsd) {
     auto stbl = Atom::create("stbl");
@@ -123,7 +122,8 @@ std::unique_ptr<Atom> build_audio_stbl_raw(const std::vector<uint8_t> &stsd_payl
                                            const std::vector<uint8_t> &stts_payload,
                                            const std::vector<uint8_t> &stsc_payload,
                                            const std::vector<uint8_t> &stsz_payload,
-                                           const std::vector<uint8_t> &stco_payload) {
+                                           const std::vector<uint8_t> &stco_payload,
+                                           std::span<const uint32_t> sample_sizes) {
     auto stbl = Atom::create("stbl");
 
     auto stsd = Atom::create("stsd");
@@ -140,6 +140,12 @@ std::unique_ptr<Atom> build_audio_stbl_raw(const std::vector<uint8_t> &stsd_payl
 
     auto stsz = Atom::create("stsz");
     stsz->payload = stsz_payload;
+    const bool header_only = stsz_payload.size() == kStszHeaderSize && stsz_payload[4] == 0 &&
+                             stsz_payload[5] == 0 && stsz_payload[6] == 0 && stsz_payload[7] == 0;
+    if (header_only) {
+        // Variable sample sizes: the entries come from the frame index.
+        write_u32_array(stsz->payload, sample_sizes);
+    }
     stbl->add(std::move(stsz));
 
     auto stco = Atom::create("stco");
@@ -97,9 +97,12 @@ static std::unique_ptr<Atom> build_stsz_img(const std::vector<ChapterImageSample
     write_u32(p, 0);  // variable size
     write_u32(p, samples.size());
 
+    std::vector<uint32_t> sizes;
+    sizes.reserve(samples.size());
     for (auto &s : samples) {
-        write_u32(p, s.data.size());
+        sizes.push_back(static_cast<uint32_t>(s.data.size()));
     }
+    write_u32_array(p, sizes);
 
     return stsz;
 }
@@ -113,9 +116,7 @@ static std::unique_ptr<Atom> build_stco_img(uint32_t count) {
     write_u24(p, 0);
     write_u32(p, count);
 
-    for (uint32_t i = 0; i < count; ++i) {
-        write_u32(p, 0);
-    }
+    p.resize(p.size() + size_t(count) * 4, 0);
 
     return stco;
 }
@@ -55,9 +55,12 @@ static std::unique_ptr<Atom> build_stsz_meta(const std::vector<ChapterMetadataSa
     write_u32(p, 0);  // version/flags
     write_u32(p, 0);  // sample_size (0 = sizes follow)
     write_u32(p, static_cast<uint32_t>(samples.size()));
+    std::vector<uint32_t> sizes;
+    sizes.reserve(samples.size());
     for (const auto &s : samples) {
-        write_u32(p, static_cast<uint32_t>(s.payload.size()));
+        sizes.push_back(static_cast<uint32_t>(s.payload.size()));
     }
+    write_u32_array(p, sizes);
     stsz->fix_size_recursive();
     return stsz;
 }
@@ -69,9 +72,7 @@ static std::unique_ptr<Atom> build_stco_meta(const std::vector<ChapterMetadataSa
     write_u32(p, 0);  // version/flags
     write_u32(p, static_cast<uint32_t>(samples.size()));
     // placeholder zeros; patched later.
-    for (size_t i = 0; i < samples.size(); ++i) {
-        write_u32(p, 0);
-    }
+    p.resize(p.size() + samples.size() * 4, 0);
     stco->fix_size_recursive();
     return stco;
 }
@@ -123,9 +123,12 @@ static std::unique_ptr<Atom> build_stsz_text(const std::vector<ChapterTextSample
     write_u32(p, 0);  // variable sizes
     write_u32(p, samples.size());
 
+    std::vector<uint32_t> sizes;
+    sizes.reserve(samples.size());
     for (auto &s : samples) {
-        write_u32(p, encoded_tx3g_size(s));
+        sizes.push_back(encoded_tx3g_size(s));
     }
+    write_u32_array(p, sizes);
 
     return stsz;
 }
@@ -139,9 +142,7 @@ static std::unique_ptr<Atom> build_stco_text(uint32_t count) {
     write_u24(p, 0);
     write_u32(p, count);
 
-    for (uint32_t i = 0; i < count; ++i) {
-        write_u32(p, 0);
-    }
+    p.resize(p.size() + size_t(count) * 4, 0);
 
     return stco;
 }
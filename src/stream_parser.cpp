@@ -0,0 +1,376 @@
+//
+//  stream_parser.cpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#include "stream_parser.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+#include "coalesced_reads.hpp"
+#include "fourcc_utils.hpp"
+#include "logging.hpp"
+#include "parse_cache.hpp"
+
+namespace {
+
+// Same bound the file read path puts on moov.
+constexpr uint64_t kMaxMoov = 256ull * 1024 * 1024;
+
+inline uint32_t be32(const uint8_t *p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+bool seek(std::FILE *file, uint64_t offset) {
+#if defined(_WIN32)
+    return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+// The retained pieces of a stream; reads must fall inside one piece.
+class PieceSource : public chapterforge::RandomAccessSource {
+  public:
+    PieceSource(uint64_t size, std::vector<StreamParser::Piece> pieces)
+        : size_(size), pieces_(std::move(pieces)) {}
+
+    uint64_t size() const override { return size_; }
+    bool read_at(uint64_t offset, void *dst, size_t length) override {
+        auto it = std::upper_bound(
+            pieces_.begin(), pieces_.end(), offset,
+            [](uint64_t value, const StreamParser::Piece &p) { return value < p.offset; });
+        if (it == pieces_.begin()) {
+            return false;
+        }
+        --it;
+        const uint64_t at = offset - it->offset;
+        if (at > it->bytes.size() || length > it->bytes.size() - at) {
+            return false;
+        }
+        std::memcpy(dst, it->bytes.data() + at, length);
+        return true;
+    }
+
+  private:
+    uint64_t size_;
+    std::vector<StreamParser::Piece> pieces_;
+};
+
+// A whole stream kept in memory or in the spill file, which it closes (and so deletes).
+class SpoolSource : public chapterforge::RandomAccessSource {
+  public:
+    SpoolSource(std::vector<uint8_t> memory, std::FILE *file, uint64_t size)
+        : memory_(std::move(memory)), file_(file), size_(size) {}
+    ~SpoolSource() override {
+        if (file_) {
+            std::fclose(file_);
+        }
+    }
+
+    uint64_t size() const override { return size_; }
+    bool read_at(uint64_t offset, void *dst, size_t length) override {
+        if (offset > size_ || length > size_ - offset) {
+            return false;
+        }
+        if (!file_) {
+            std::memcpy(dst, memory_.data() + offset, length);
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        return seek(file_, offset) && std::fread(dst, 1, length, file_) == length;
+    }
+
+  private:
+    std::vector<uint8_t> memory_;
+    std::FILE *file_;
+    uint64_t size_;
+    std::mutex mutex_;
+};
+
+}  // namespace
+
+StreamParser::StreamParser(uint64_t spill_threshold, Events events, uint64_t max_bytes)
+    : spill_threshold_(spill_threshold), events_(std::move(events)), max_bytes_(max_bytes) {}
+
+StreamParser::~StreamParser() {
+    if (spool_file_) {
+        std::fclose(spool_file_);
+    }
+}
+
+bool StreamParser::fail(std::string message) {
+    CH_LOG("error", message);
+    error_ = std::move(message);
+    return false;
+}
+
+bool StreamParser::feed(ByteView bytes) {
+    if (!error_.empty()) {
+        return false;
+    }
+    while (!bytes.empty()) {
+        const size_t header_need = header_have_ >= 8 && be32(header_) == 1 ? 16 : 8;
+        size_t take = bytes.size();
+        if (!opaque_ && !to_end_) {
+            take = atom_left_ > 0 ? static_cast<size_t>(std::min<uint64_t>(take, atom_left_))
+                                  : std::min(take, header_need - header_have_);
+        }
+        const ByteView chunk = bytes.first(take);
+        if (!keep(pos_, chunk)) {
+            return false;
+        }
+        if (in_moov_) {
+            moov_->insert(moov_->end(), chunk.begin(), chunk.end());
+        }
+        pos_ += take;
+        bytes = bytes.subspan(take);
+        if (opaque_ || to_end_) {
+            continue;
+        }
+        if (atom_left_ > 0) {
+            atom_left_ -= take;
+            if (atom_left_ == 0 && in_moov_ && !moov_complete()) {
+                return false;
+            }
+            continue;
+        }
+        std::memcpy(header_ + header_have_, chunk.data(), take);
+        header_have_ += take;
+        if (header_have_ == header_need && !atom_header()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool StreamParser::atom_header() {
+    const uint64_t offset = pos_ - header_have_;
+    const uint32_t header_size = static_cast<uint32_t>(header_have_);
+    const uint32_t type = be32(header_ + 4);
+    uint64_t size = be32(header_);
+    if (size == 1) {
+        size = (uint64_t(be32(header_ + 8)) << 32) | be32(header_ + 12);
+    }
+    header_have_ = 0;
+    const bool is_moov = type == fourcc("moov") && !moov_seen_;
+    if (!is_printable_fourcc(type) || (size != 0 && size < header_size) ||
+        (is_moov && (size == 0 || size > kMaxMoov))) {
+        // Without a trustworthy walk the stream can only be handed on whole.
+        CH_LOG("warn", "stream: unusable atom header at " << offset << " size=" << size
+                                                          << "; keeping the rest as is");
+        opaque_ = true;
+        return true;
+    }
+    if (events_.atom) {
+        events_.atom(Mp4AtomInfo{type, size, offset, header_size});
+    }
+    to_end_ = size == 0;
+    atom_left_ = to_end_ ? 0 : size - header_size;
+    if (is_moov) {
+        in_moov_ = true;
+        moov_ = std::make_shared<std::vector<uint8_t>>();
+        moov_->reserve(static_cast<size_t>(size));
+        moov_->insert(moov_->end(), header_, header_ + header_size);
+        if (atom_left_ == 0) {
+            return moov_complete();
+        }
+    }
+    return true;
+}
+
+bool StreamParser::keep(uint64_t offset, ByteView bytes) {
+    if (spooling_) {
+        return spool(bytes);
+    }
+    // Pieces grow as their bytes arrive, so memory follows what the stream actually delivers
+    // rather than what the sample tables claim.
+    const uint64_t end = offset + bytes.size();
+    for (size_t i = next_piece_; i < pieces_.size() && pieces_[i].offset < end; ++i) {
+        Piece &piece = pieces_[i];
+        const uint64_t from = std::max(piece.offset, offset);
+        const uint64_t to = std::min(piece.offset + piece.size, end);
+        if (from < to) {
+            const uint8_t *data = bytes.data() + (from - offset);
+            piece.bytes.insert(piece.bytes.end(), data, data + (to - from));
+        }
+    }
+    while (next_piece_ < pieces_.size() &&
+           pieces_[next_piece_].offset + pieces_[next_piece_].size <= end) {
+        ++next_piece_;
+    }
+    return true;
+}
+
+bool StreamParser::spool(ByteView bytes) {
+    if (!spool_file_ && spool_memory_.size() + bytes.size() <= spill_threshold_) {
+        spool_memory_.insert(spool_memory_.end(), bytes.begin(), bytes.end());
+        spool_size_ += bytes.size();
+        return true;
+    }
+    if (!spool_file_) {
+        spool_file_ = std::tmpfile();
+        if (!spool_file_) {
+            return fail("Failed to create a temporary file to spill the stream to");
+        }
+        if (std::fwrite(spool_memory_.data(), 1, spool_memory_.size(), spool_file_) !=
+            spool_memory_.size()) {
+            return fail("Failed to spill the stream to a temporary file");
+        }
+        CH_LOG("debug", "stream: spilled to a temporary file at " << spool_size_ << " bytes");
+        std::vector<uint8_t>().swap(spool_memory_);
+    }
+    if (std::fwrite(bytes.data(), 1, bytes.size(), spool_file_) != bytes.size()) {
+        return fail("Failed to spill the stream to a temporary file");
+    }
+    spool_size_ += bytes.size();
+    return true;
+}
+
+bool StreamParser::read_spool(uint64_t offset, uint8_t *dst, size_t length) {
+    if (!spool_file_) {
+        std::memcpy(dst, spool_memory_.data() + offset, length);
+        return true;
+    }
+    return seek(spool_file_, offset) && std::fread(dst, 1, length, spool_file_) == length;
+}
+
+bool StreamParser::moov_complete() {
+    in_moov_ = false;
+    moov_seen_ = true;
+    auto parsed = parse_moov_atom(*moov_);
+    if (!parsed || parsed->stsz.empty() || parsed->stco.empty() || parsed->stsc.empty() ||
+        parsed->stsd.empty()) {
+        CH_LOG("warn", "stream: moov lacks usable sample tables; keeping the whole stream");
+        moov_.reset();
+        return true;
+    }
+    parsed->moov = moov_;
+    parsed_ = std::make_shared<const ParsedInput>(std::move(*parsed));
+
+    // The ranges read_m4a may fetch: every sample of every text track and of the first video
+    // track, merged the way CoalescedReads merges them.
+    std::vector<CoalescedReads::Range> ranges;
+    bool video = false;
+    const auto &tracks = parsed_->parsed().tracks;
+    for (size_t t = 0; t < tracks.size(); ++t) {
+        const bool is_text = tracks[t].handler_type == fourcc("text");
+        const bool is_video = tracks[t].handler_type == fourcc("vide") && !video;
+        const SampleTable *table = is_text || is_video ? parsed_->track_table(t) : nullptr;
+        if (table == nullptr) {
+            continue;
+        }
+        video = video || is_video;
+        for (size_t i = 0; i < table->sample_count(); ++i) {
+            // A range ending past 2^64 lies beyond any stream; read_m4a rejects it on its own.
+            if (table->size(i) != 0 && table->offset(i) <= UINT64_MAX - table->size(i)) {
+                ranges.push_back({table->offset(i), table->size(i)});
+            }
+        }
+    }
+    std::sort(ranges.begin(), ranges.end(),
+              [](const auto &a, const auto &b) { return a.offset < b.offset; });
+    std::vector<std::pair<uint64_t, uint64_t>> spans;  // [begin, end)
+    for (const auto &r : ranges) {
+        if (!spans.empty() && r.offset <= spans.back().second + CoalescedReads::kDefaultMaxGap) {
+            spans.back().second = std::max(spans.back().second, r.offset + r.size);
+        } else {
+            spans.emplace_back(r.offset, r.offset + r.size);
+        }
+    }
+
+    // The tables are untrusted: charge what they ask to retain before holding any of it.
+    // Summing stops past kMaxRetained, so claimed sizes cannot overflow the total.
+    uint64_t retained = 0;
+    for (const auto &[begin, end] : spans) {
+        retained += std::min(end - begin, kMaxRetained + 1);
+        if (retained > kMaxRetained) {
+            break;
+        }
+    }
+    if (max_bytes_ != 0 && retained > max_bytes_) {
+        return fail("Read budget of " + std::to_string(max_bytes_) +
+                    " bytes exceeded for stream: chapter samples need at least " +
+                    std::to_string(retained));
+    }
+    if (retained > kMaxRetained) {
+        return fail("Chapter samples of the stream need more than the " +
+                    std::to_string(kMaxRetained) + " bytes kept at most");
+    }
+
+    // Whatever the stream already passed comes out of the spool, which is then dropped.
+    pieces_.reserve(spans.size());
+    for (const auto &[begin, end] : spans) {
+        Piece piece;
+        piece.offset = begin;
+        piece.size = end - begin;
+        if (begin < spool_size_) {
+            piece.bytes.resize(static_cast<size_t>(std::min(end, spool_size_) - begin));
+            if (!read_spool(begin, piece.bytes.data(), piece.bytes.size())) {
+                return fail("Failed to read back the spilled stream");
+            }
+        }
+        pieces_.push_back(std::move(piece));
+    }
+    CH_LOG("debug", "stream: moov parsed at " << pos_ << " tracks=" << tracks.size()
+                                               << " spans=" << spans.size()
+                                               << " retained=" << retained
+                                               << " spooled=" << spool_size_);
+    std::vector<uint8_t>().swap(spool_memory_);
+    if (spool_file_) {
+        std::fclose(spool_file_);
+        spool_file_ = nullptr;
+    }
+    spool_size_ = 0;
+    spooling_ = false;
+    while (next_piece_ < pieces_.size() &&
+           pieces_[next_piece_].offset + pieces_[next_piece_].size <= pos_) {
+        ++next_piece_;
+    }
+    if (events_.tables) {
+        events_.tables(*parsed_);
+    }
+    return true;
+}
+
+bool StreamParser::done() const { return !spooling_ && next_piece_ == pieces_.size(); }
+
+uint64_t StreamParser::buffered() const {
+    if (spooling_) {
+        return spool_size_;
+    }
+    uint64_t bytes = moov_ ? moov_->size() : 0;
+    for (const Piece &piece : pieces_) {
+        bytes += piece.bytes.size();
+    }
+    return bytes;
+}
+
+StreamParser::Result StreamParser::finish() {
+    if (!error_.empty()) {
+        return {};
+    }
+    if (!spooling_) {
+        if (!done()) {
+            fail("Stream ended at " + std::to_string(pos_) + " bytes, before the chapter sample at " +
+                 std::to_string(pieces_[next_piece_].offset));
+            return {};
+        }
+        return {parsed_, std::make_shared<PieceSource>(pos_, std::move(pieces_))};
+    }
+    if (spool_size_ == 0) {
+        fail("Stream is empty");
+        return {};
+    }
+    CH_LOG("debug", "stream: handing on the whole stream, " << spool_size_ << " bytes"
+                                                            << (spool_file_ ? " spilled" : ""));
+    auto source = std::make_shared<SpoolSource>(std::move(spool_memory_), spool_file_, spool_size_);
+    spool_file_ = nullptr;
+    spool_size_ = 0;
+    return {nullptr, std::move(source)};
+}
@@ -23,9 +23,7 @@ std::unique_ptr<Atom> build_stsz(const std::vector<uint32_t> &sample_sizes) {
     write_u32(p, (uint32_t)sample_sizes.size());
 
     // sizes.
-    for (uint32_t sz : sample_sizes) {
-        write_u32(p, sz);
-    }
+    write_u32_array(p, sample_sizes);
 
     return stsz;
 }
@@ -8,49 +8,25 @@
 
 #include "tkhd_builder.hpp"
 
+#include "fixed_boxes.hpp"
+
 static std::unique_ptr<Atom> build_tkhd_common(uint32_t track_id, uint64_t duration, uint8_t flags3,
                                                uint16_t volume, uint16_t layer, uint16_t alt_group,
                                                float width, float height) {
-    auto tkhd = Atom::create("tkhd");
-    std::vector<uint8_t> &p = tkhd->payload;
-
-    // Apple uses 84 bytes.
-    p.reserve(84);
-
-    write_u8(p, 0);        // version
-    write_u24(p, flags3);  // flags
-
-    write_u32(p, 0);  // creation_time
-    write_u32(p, 0);  // modification_time
-
-    write_u32(p, track_id);  // track_ID
-    write_u32(p, 0);         // reserved
-
-    write_u32(p, (uint32_t)duration);
-
-    write_u64(p, 0);  // reserved[8]
-
-    write_u16(p, layer);      // layer
-    write_u16(p, alt_group);  // alternate_group
-
-    write_u16(p, volume);  // 0x0100 for audio, 0 for others
-    write_u16(p, 0);       // reserved
-
-    // unity matrix (same as QuickTime defaults)
-    write_u32(p, 0x00010000);  // a
-    write_u32(p, 0x00000000);  // b
-    write_u32(p, 0x00000000);  // u
-    write_u32(p, 0x00000000);  // c
-    write_u32(p, 0x00010000);  // d
-    write_u32(p, 0x00000000);  // v
-    write_u32(p, 0x00000000);  // x
-    write_u32(p, 0x00000000);  // y
-    write_u32(p, 0x40000000);  // w (scale)
-
+    using fixed_boxes::Tkhd;
+    auto p = Tkhd::kTemplate;  // Apple uses 84 bytes, unity matrix.
+    p.put_u24(Tkhd::kFlags, flags3);
+    p.put_u32(Tkhd::kTrackId, track_id);
+    p.put_u32(Tkhd::kDuration, (uint32_t)duration);
+    p.put_u16(Tkhd::kLayer, layer);
+    p.put_u16(Tkhd::kAlternateGroup, alt_group);
+    p.put_u16(Tkhd::kVolume, volume);  // 0x0100 for audio, 0 for others
     // width, height (16.16 fixed)
-    write_fixed16_16(p, width);
-    write_fixed16_16(p, height);
+    p.put_u32(Tkhd::kWidth, static_cast<uint32_t>(width * 65536.0f));
+    p.put_u32(Tkhd::kHeight, static_cast<uint32_t>(height * 65536.0f));
 
+    auto tkhd = Atom::create("tkhd");
+    tkhd->payload = p.to_vector();
     return tkhd;
 }
 
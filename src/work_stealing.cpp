@@ -0,0 +1,105 @@
+//
+//  work_stealing.cpp
+//  ChapterForge
+//
+//  Created by Till Toenshoff on 12/9/25.
+//  Copyright © 2025 Till Toenshoff. All rights reserved.
+//
+
+#include "work_stealing.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Indices [begin, end) a worker has yet to run.
+struct Share {
+    std::mutex mutex;
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+}  // namespace
+
+void run_work_stealing(size_t count, unsigned threads, const std::function<void(size_t)> &task) {
+    const size_t workers = std::max<size_t>(1, std::min<size_t>(threads, count));
+    if (count == 0) {
+        return;
+    }
+    std::unique_ptr<Share[]> shares(new Share[workers]);
+    for (size_t w = 0; w < workers; ++w) {
+        shares[w].begin = count * w / workers;
+        shares[w].end = count * (w + 1) / workers;
+    }
+
+    // Move the back half of the largest other share into `self`; false once no work is left.
+    // Shares only ever shrink, so a scan that finds them all empty means every task is taken.
+    auto steal = [&](size_t self) {
+        for (;;) {
+            size_t victim = workers;
+            size_t largest = 0;
+            for (size_t w = 0; w < workers; ++w) {
+                if (w == self) {
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(shares[w].mutex);
+                if (shares[w].end - shares[w].begin > largest) {
+                    largest = shares[w].end - shares[w].begin;
+                    victim = w;
+                }
+            }
+            if (victim == workers) {
+                return false;
+            }
+            size_t begin = 0;
+            size_t end = 0;
+            {
+                std::lock_guard<std::mutex> lock(shares[victim].mutex);
+                Share &v = shares[victim];
+                if (v.begin == v.end) {
+                    continue;  // emptied meanwhile; look again
+                }
+                end = v.end;
+                begin = v.begin + (v.end - v.begin) / 2;
+                v.end = begin;
+            }
+            std::lock_guard<std::mutex> lock(shares[self].mutex);
+            shares[self].begin = begin;
+            shares[self].end = end;
+            return true;
+        }
+    };
+
+    auto worker = [&](size_t self) {
+        for (;;) {
+            size_t index = 0;
+            bool have = false;
+            {
+                std::lock_guard<std::mutex> lock(shares[self].mutex);
+                if (shares[self].begin < shares[self].end) {
+                    index = shares[self].begin++;
+                    have = true;
+                }
+            }
+            if (have) {
+                task(index);
+            } else if (!steal(self)) {
+                return;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (size_t w = 1; w < workers; ++w) {
+        pool.emplace_back(worker, w);
+    }
+    worker(0);
+    for (auto &t : pool) {
+        t.join();
+    }
+}
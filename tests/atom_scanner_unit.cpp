@@ -0,0 +1,136 @@
+// Unit coverage for the recovery scanner: decoys are rejected, every candidate finder agrees, and
+// boxes straddling window boundaries are still found.
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "atom_scanner.hpp"
+#include "fourcc_utils.hpp"
+#include "parser_test_utils.hpp"
+
+using namespace parser_test_utils;
+
+namespace {
+
+bool check(bool cond, const std::string &msg) {
+    if (!cond) {
+        std::cerr << "[atom_scanner_unit] FAIL: " << msg << "\n";
+    }
+    return cond;
+}
+
+struct Fixture {
+    std::vector<uint8_t> data;
+    uint64_t stsz_offset = 0;
+    uint64_t stco_offset = 0;
+    uint64_t ilst_offset = 0;
+};
+
+Fixture make_fixture() {
+    Fixture fx;
+    auto &d = fx.data;
+    // Noise full of first-byte candidates ('s' and 'i').
+    for (int i = 0; i < 5000; ++i) {
+        d.push_back(static_cast<uint8_t>("si\x00\x7fz"[i % 5]));
+    }
+    // Decoy: 'stsz' text whose size field overruns the buffer.
+    write_u32_be(d, 0x7FFFFFF0);
+    write_u32_be(d, fourcc("stsz"));
+    // Decoy: plausible size but entry count larger than the payload.
+    write_u32_be(d, 20);
+    write_u32_be(d, fourcc("stco"));
+    write_u32_be(d, 0);    // version/flags
+    write_u32_be(d, 100);  // entry_count (does not fit)
+    write_u32_be(d, 0);
+    d.resize(d.size() + 3, 's');  // misalign what follows
+
+    fx.stsz_offset = d.size();
+    append_atom(d, fourcc("stsz"), make_stsz(3, 0));
+    fx.stco_offset = d.size();
+    std::vector<uint8_t> stco{0, 0, 0, 0};
+    write_u32_be(stco, 2);
+    write_u32_be(stco, 100);
+    write_u32_be(stco, 200);
+    append_atom(d, fourcc("stco"), stco);
+    d.resize(d.size() + 777, 'i');
+    fx.ilst_offset = d.size();
+    std::vector<uint8_t> item;
+    append_atom(item, fourcc("data"), std::vector<uint8_t>(12, 0));
+    std::vector<uint8_t> ilst;
+    append_atom(ilst, fourcc("\xa9nam"), item);
+    append_atom(d, fourcc("ilst"), ilst);
+    d.resize(d.size() + 64, 0);
+    return fx;
+}
+
+bool run(const Fixture &fx, ScanIsa isa, size_t window, const char *label) {
+    AtomScanTarget targets[] = {
+        AtomScanTarget::of(fourcc("stsz")), AtomScanTarget::of(fourcc("stco")),
+        AtomScanTarget::of(fourcc("ilst")),
+        AtomScanTarget::of(fourcc("stts")),  // absent
+    };
+    AtomScanOptions opts;
+    opts.isa = isa;
+    opts.window_bytes = window;
+    size_t windows = 0;
+    size_t covered = 0;
+    opts.on_window_done = [&](size_t, size_t end) {
+        ++windows;
+        covered = end;
+    };
+    const uint64_t scanned = scan_atoms(fx.data, targets, opts);
+    const std::string ctx = std::string(label) + " window=" + std::to_string(window);
+    bool ok = true;
+    ok &= check(targets[0].found && targets[0].offset == fx.stsz_offset, "stsz " + ctx);
+    ok &= check(targets[0].payload.size() == 12 + 3 * 4, "stsz payload " + ctx);
+    ok &= check(targets[1].found && targets[1].offset == fx.stco_offset, "stco " + ctx);
+    ok &= check(targets[2].found && targets[2].offset == fx.ilst_offset, "ilst " + ctx);
+    ok &= check(!targets[3].found, "stts must stay missing " + ctx);
+    ok &= check(scanned == fx.data.size() && covered == fx.data.size(), "full pass " + ctx);
+    ok &= check(windows == (fx.data.size() + window - 1) / window, "window count " + ctx);
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    const auto fx = make_fixture();
+    bool ok = true;
+    std::vector<std::pair<ScanIsa, const char *>> isas = {{ScanIsa::Scalar, "scalar"}};
+    if (best_scan_isa() != ScanIsa::Scalar) {
+        isas.push_back({ScanIsa::Sse2, "sse2"});
+    }
+    if (best_scan_isa() == ScanIsa::Avx2) {
+        isas.push_back({ScanIsa::Avx2, "avx2"});
+    }
+    for (const auto &[isa, label] : isas) {
+        for (size_t window : {64u, 4097u, 1u << 20}) {
+            ok &= run(fx, isa, window, label);
+        }
+    }
+
+    // Early exit: once every target is found the scan stops short of the buffer end.
+    {
+        auto stsz = AtomScanTarget::of(fourcc("stsz"));
+        const uint64_t scanned = scan_atoms(fx.data, std::span<AtomScanTarget>(&stsz, 1));
+        ok &= check(stsz.found && scanned < fx.data.size(), "early exit after last target");
+    }
+
+    // Candidates running past the buffer end are reported in order: the oversized stsz decoy,
+    // then the stco cut short by the end of the buffer.
+    {
+        AtomScanTarget targets[] = {AtomScanTarget::of(fourcc("stsz")),
+                                    AtomScanTarget::of(fourcc("stco"))};
+        std::vector<std::pair<uint64_t, uint64_t>> cuts;
+        AtomScanOptions opts;
+        opts.on_cut_box = [&](uint64_t box, uint64_t size) { cuts.emplace_back(box, size); };
+        const std::span<const uint8_t> head(fx.data.data(), fx.stco_offset + 12);
+        scan_atoms(head, targets, opts);
+        const std::vector<std::pair<uint64_t, uint64_t>> expected = {
+            {5000, 0x7FFFFFF0}, {fx.stco_offset, 24}};
+        ok &= check(targets[0].found && !targets[1].found && cuts == expected,
+                    "cut-off candidates reported");
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+// Unit test for read_m4a_batch and the work-stealing pool behind it: every index runs exactly
+// once under uneven task costs, each file's result matches a single read_m4a and is delivered
+// once without overlapping callbacks, a missing file fails only its own entry, and a single
+// worker delivers in order.
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "chapterforge.hpp"
+#include "work_stealing.hpp"
+
+#define CHAPTERFORGE_TEST_NAME "batch_read_unit"
+#include "fixture_utils.hpp"
+
+using namespace fixture_utils;
+
+namespace {
+
+bool test_pool() {
+    bool ok = true;
+    for (unsigned threads : {1u, 3u, 8u}) {
+        constexpr size_t kCount = 200;
+        std::vector<std::atomic<int>> runs(kCount);
+        // The first tasks are slow, so the workers that own them must be relieved by stealing.
+        run_work_stealing(kCount, threads, [&](size_t i) {
+            if (i < 4) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+            runs[i].fetch_add(1);
+        });
+        bool once = true;
+        for (const auto &r : runs) {
+            once &= r.load() == 1;
+        }
+        ok &= check(once, "every index runs once, threads=" + std::to_string(threads));
+    }
+    int calls = 0;
+    run_work_stealing(0, 4, [&](size_t) { ++calls; });
+    ok &= check(calls == 0, "empty range runs nothing");
+    return ok;
+}
+
+bool test_batch(const std::vector<std::string> &paths) {
+    std::vector<chapterforge::ReadResult> expected;
+    for (const auto &p : paths) {
+        expected.push_back(chapterforge::read_m4a(p));
+    }
+    chapterforge::BatchOptions options;
+    options.threads = 3;
+    std::vector<int> delivered(paths.size(), 0);
+    std::atomic<int> inside{0};
+    bool overlapped = false;
+    bool matches = true;
+    const size_t failed =
+        chapterforge::read_m4a_batch(paths, options, [&](size_t i, chapterforge::ReadResult res) {
+            if (inside.fetch_add(1) != 0) {
+                overlapped = true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            ++delivered[i];
+            matches &= expected[i].status.ok ? same_result(expected[i], res) : !res.status.ok;
+            inside.fetch_sub(1);
+        });
+    bool ok = check(failed == 1, "only the missing file fails");
+    bool once = true;
+    for (int d : delivered) {
+        once &= d == 1;
+    }
+    ok &= check(once, "every result delivered once");
+    ok &= check(!overlapped, "callbacks never overlap");
+    ok &= check(matches, "batch results match single reads");
+
+    options.threads = 1;
+    std::vector<size_t> order;
+    chapterforge::read_m4a_batch(paths, options,
+                                 [&](size_t i, chapterforge::ReadResult) { order.push_back(i); });
+    bool in_order = order.size() == paths.size();
+    for (size_t i = 0; in_order && i < order.size(); ++i) {
+        in_order = order[i] == i;
+    }
+    ok &= check(in_order, "single worker delivers in order");
+    ok &= check(chapterforge::read_m4a_batch({}, options, nullptr) == 0, "empty batch");
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path() / "chapterforge_batch_unit";
+    std::filesystem::create_directories(dir);
+    std::vector<std::string> paths;
+    bool ok = test_pool();
+    for (uint32_t i = 0; i < 6 && ok; ++i) {
+        paths.push_back((dir / ("book" + std::to_string(i) + ".m4a")).string());
+        ok &= mux_fixture(paths.back(), 2 + i, "Book " + std::to_string(i));
+    }
+    paths.insert(paths.begin() + 2, (dir / "missing.m4a").string());
+    if (ok) {
+        ok &= test_batch(paths);
+    }
+    std::filesystem::remove_all(dir);
+    return ok ? 0 : 1;
+}
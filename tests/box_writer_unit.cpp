@@ -0,0 +1,170 @@
+// Unit test for BoxWriter and the fixed-layout box templates: nested boxes get their sizes
+// back-patched on close, serialized Atom trees match the box layout byte for byte without
+// fix_size_recursive(), and the template-based tkhd/mvhd/mdhd/hdlr/smhd/vmhd builders produce
+// exactly the fields a field-by-field encoding does.
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "box_writer.hpp"
+#include "hdlr_builder.hpp"
+#include "mdhd_builder.hpp"
+#include "mp4_atoms.hpp"
+#include "mvhd_builder.hpp"
+#include "smhd_builder.hpp"
+#include "tkhd_builder.hpp"
+#include "vmhd_builder.hpp"
+
+namespace {
+
+bool check(bool cond, const std::string &msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[box_writer_unit] FAIL: %s\n", msg.c_str());
+    }
+    return cond;
+}
+
+void box(std::vector<uint8_t> &out, const char type[4], const std::vector<uint8_t> &payload) {
+    write_u32(out, static_cast<uint32_t>(8 + payload.size()));
+    write_u32(out, fourcc(type));
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+bool test_scopes() {
+    BoxWriter w;
+    {
+        auto outer = w.open(fourcc("moov"));
+        {
+            auto inner = w.open(fourcc("mvhd"));
+            const uint8_t fields[] = {1, 2, 3, 4};
+            w.bytes(fields);
+        }
+        auto table = w.open(fourcc("stsz"));
+        const uint8_t entries[] = {0xA0, 0xB0, 0xC0, 0xD0};
+        w.bytes(entries);
+        table.close();
+        table.close();  // closing twice is harmless
+    }
+    std::vector<uint8_t> mvhd{1, 2, 3, 4};
+    std::vector<uint8_t> stsz{0xA0, 0xB0, 0xC0, 0xD0};
+    std::vector<uint8_t> children;
+    box(children, "mvhd", mvhd);
+    box(children, "stsz", stsz);
+    std::vector<uint8_t> expected;
+    box(expected, "moov", children);
+    return check(w.buffer() == expected, "nested boxes back-patched");
+}
+
+bool test_atom_serialize() {
+    auto moov = Atom::create("moov");
+    auto trak = Atom::create("trak");
+    auto tkhd = Atom::create("tkhd");
+    tkhd->payload = {9, 8, 7};
+    trak->add(std::move(tkhd));
+    trak->add(Atom::create("edts"));
+    moov->payload = {0xAA};
+    moov->add(std::move(trak));
+
+    std::vector<uint8_t> trak_children;
+    box(trak_children, "tkhd", {9, 8, 7});
+    box(trak_children, "edts", {});
+    std::vector<uint8_t> moov_payload{0xAA};
+    box(moov_payload, "trak", trak_children);
+    std::vector<uint8_t> expected;
+    box(expected, "moov", moov_payload);
+
+    // Sizes come from the bytes written, not from a stale fix_size_recursive().
+    bool ok = check(moov->serialize() == expected, "tree serialized without sizing");
+    moov->fix_size_recursive();
+    ok &= check(moov->size() == expected.size(), "fix_size_recursive agrees");
+    std::ostringstream out;
+    moov->write(out);
+    const std::string written = out.str();
+    ok &= check(std::vector<uint8_t>(written.begin(), written.end()) == expected,
+                "write() emits the serialized box");
+    ok &= check(moov->find("tkhd").size() == 1 && moov->find("trak").size() == 1 &&
+                    moov->find("moov").front() == moov.get(),
+                "find");
+    return ok;
+}
+
+// Field-by-field encodings the fixed templates replace.
+std::vector<uint8_t> reference_tkhd(uint8_t flags, uint32_t id, uint32_t duration,
+                                    uint16_t layer, uint16_t group, uint16_t volume,
+                                    float width, float height) {
+    std::vector<uint8_t> p;
+    write_u8(p, 0);
+    write_u24(p, flags);
+    write_u32(p, 0);
+    write_u32(p, 0);
+    write_u32(p, id);
+    write_u32(p, 0);
+    write_u32(p, duration);
+    write_u64(p, 0);
+    write_u16(p, layer);
+    write_u16(p, group);
+    write_u16(p, volume);
+    write_u16(p, 0);
+    for (uint32_t m : {0x00010000u, 0u, 0u, 0u, 0x00010000u, 0u, 0u, 0u, 0x40000000u}) {
+        write_u32(p, m);
+    }
+    write_fixed16_16(p, width);
+    write_fixed16_16(p, height);
+    return p;
+}
+
+bool test_fixed_boxes() {
+    bool ok = check(build_tkhd_audio(1, 123456)->payload ==
+                        reference_tkhd(7, 1, 123456, 0, 0, 0x0100, 0, 0),
+                    "tkhd audio");
+    ok &= check(build_tkhd_text(2, 99, false)->payload ==
+                    reference_tkhd(0, 2, 99, 0, 1, 0, 0, 0),
+                "tkhd text");
+    ok &= check(build_tkhd_image(3, 77, 640, 480)->payload ==
+                    reference_tkhd(7, 3, 77, 1, 0, 0, 640, 480),
+                "tkhd image");
+
+    std::vector<uint8_t> mvhd{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    write_u32(mvhd, 44100);
+    write_u32(mvhd, 5000);
+    write_u32(mvhd, 0x00010000);
+    write_u16(mvhd, 0x0100);
+    mvhd.resize(36, 0);
+    write_u32(mvhd, 0x00010000);
+    mvhd.resize(48, 0);
+    write_u32(mvhd, 0x00010000);
+    mvhd.resize(96, 0);
+    write_u32(mvhd, 5);
+    ok &= check(build_mvhd(44100, 5000)->payload == mvhd, "mvhd");
+
+    std::vector<uint8_t> mdhd(12, 0);
+    write_u32(mdhd, 1000);
+    write_u32(mdhd, 4242);
+    write_u16(mdhd, 0x55C4);
+    write_u16(mdhd, 0);
+    ok &= check(build_mdhd(1000, 4242, 0x55C4)->payload == mdhd, "mdhd");
+
+    std::vector<uint8_t> hdlr(8, 0);
+    write_u32(hdlr, fourcc("soun"));
+    hdlr.resize(24, 0);
+    const std::string name = "sound handler";
+    hdlr.insert(hdlr.end(), name.begin(), name.end());
+    hdlr.push_back(0);
+    ok &= check(build_hdlr_sound()->payload == hdlr, "hdlr");
+
+    ok &= check(build_smhd()->payload == std::vector<uint8_t>(8, 0), "smhd");
+    std::vector<uint8_t> vmhd{0, 0, 0, 1};
+    vmhd.resize(12, 0);
+    ok &= check(build_vmhd()->payload == vmhd, "vmhd");
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    bool ok = test_scopes();
+    ok &= test_atom_serialize();
+    ok &= test_fixed_boxes();
+    return ok ? 0 : 1;
+}
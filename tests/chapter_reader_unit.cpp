@@ -0,0 +1,97 @@
+// Unit test for ChapterReader: titles, URLs, start times and images fetched one chapter at a
+// time match read_m4a for faststart and trailing-moov layouts, fetching a single image reads
+// only moov plus that image, and out-of-range or undersized requests fail cleanly.
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "chapterforge.hpp"
+
+#define CHAPTERFORGE_TEST_NAME "chapter_reader_unit"
+#include "fixture_utils.hpp"
+
+using namespace fixture_utils;
+
+namespace {
+
+// Header walk: up to 16 bytes per top-level atom (ftyp, mdat, free, ...).
+constexpr uint64_t kHeaderSlack = 4096;
+
+// Five chapters; chapter 2 has no URL so alignment by start time is exercised.
+bool mux_reader_fixture(const std::string &out_path, bool fast_start) {
+    auto fx = make_fixture(5, "Reader Title", true, 2000);
+    fx.urls[1].href = "";
+    fx.meta.title = "Chapter Reader Unit";
+    return mux_fixture(out_path, fx, fast_start);
+}
+
+bool verify(const std::string &path, const std::string &label) {
+    const auto expected = chapterforge::read_m4a(path);
+    const auto probe = chapterforge::probe_m4a(path);
+    chapterforge::Status status{};
+    auto reader = chapterforge::ChapterReader::open(path, &status);
+    bool ok = check(expected.status.ok && probe.status.ok, label + " read_m4a/probe_m4a ok");
+    ok &= check(reader != nullptr && status.ok, label + " open: " + status.message);
+    if (!ok) {
+        return false;
+    }
+    ok &= check(reader->count() == 5 && reader->count() == expected.titles.size(),
+                label + " count");
+    ok &= check(reader->bytes_read() <= probe.moov_size + kHeaderSlack,
+                label + " open reads only moov");
+
+    // One image: moov plus exactly the image bytes.
+    const uint64_t before = reader->bytes_read();
+    std::vector<uint8_t> image(reader->image_size(3));
+    ok &= check(reader->read_image(3, image), label + " read image 3");
+    ok &= check(reader->bytes_read() - before == image.size(), label + " image read cost");
+    ok &= check(image == expected.images[3].data, label + " image 3 bytes");
+
+    for (size_t i = 0; i < reader->count(); ++i) {
+        const std::string at = label + " chapter " + std::to_string(i);
+        ok &= check(reader->start_ms(i) == expected.titles[i].start_ms, at + " start");
+        ok &= check(reader->title(i) == expected.titles[i].text, at + " title");
+        const std::string url =
+            i < expected.urls.size() ? expected.urls[i].href : std::string{};
+        ok &= check(reader->url(i) == url, at + " url");
+        ok &= check(reader->image_size(i) == expected.images[i].data.size(), at + " image size");
+        std::vector<uint8_t> buf(reader->image_size(i) + 7);
+        ok &= check(reader->read_image(i, buf), at + " read image");
+        buf.resize(reader->image_size(i));
+        ok &= check(buf == expected.images[i].data, at + " image bytes");
+    }
+    ok &= check(reader->url(1).empty(), label + " chapter without url");
+
+    // Failures leave the reader usable.
+    std::vector<uint8_t> small(reader->image_size(0) - 1);
+    ok &= check(!reader->read_image(0, small), label + " undersized span rejected");
+    ok &= check(!reader->read_image(5, image), label + " image out of range");
+    ok &= check(reader->title(5).empty() && reader->url(5).empty() &&
+                    reader->image_size(5) == 0 && reader->start_ms(5) == 0,
+                label + " accessors out of range");
+    ok &= check(reader->title(0) == expected.titles[0].text, label + " usable after failures");
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto fast = (dir / "chapterforge_chapter_reader_fast.m4a").string();
+    const auto tail = (dir / "chapterforge_chapter_reader_tail.m4a").string();
+    bool ok = mux_reader_fixture(fast, true) && mux_reader_fixture(tail, false);
+    if (ok) {
+        ok &= verify(fast, "faststart");
+        ok &= verify(tail, "moov-at-end");
+    }
+
+    chapterforge::Status status{true, ""};
+    ok &= check(chapterforge::ChapterReader::open((dir / "chapterforge_missing.m4a").string(),
+                                                  &status) == nullptr &&
+                    !status.ok,
+                "missing file rejected");
+
+    std::filesystem::remove(fast);
+    std::filesystem::remove(tail);
+    return ok ? 0 : 1;
+}
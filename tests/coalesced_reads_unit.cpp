@@ -0,0 +1,143 @@
+// Unit test for CoalescedReads: unordered, overlapping and repeated ranges come back intact
+// from merged reads, holes above the gap limit split spans, out-of-file ranges are rejected,
+// and read_m4a fetches hundreds of chapter samples with one read per chapter track.
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "chapterforge.hpp"
+#include "coalesced_reads.hpp"
+#include "random_access_file.hpp"
+
+#define CHAPTERFORGE_TEST_NAME "coalesced_reads_unit"
+#include "fixture_utils.hpp"
+
+using namespace fixture_utils;
+
+namespace {
+
+// Top-level walk of a muxed file (ftyp, moov, free, mdat headers) plus the moov read.
+constexpr uint64_t kParseReads = 5;
+
+bool test_ranges(const std::filesystem::path &dir) {
+    const auto path = dir / "chapterforge_coalesced_reads.bin";
+    std::vector<uint8_t> bytes(256 * 1024);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<uint8_t>((i * 2654435761u) >> 13);
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(bytes.data()), std::streamsize(bytes.size()));
+    }
+    auto file = RandomAccessFile::open(path.string());
+    if (!check(file != nullptr, "open")) {
+        return false;
+    }
+
+    // Two clusters 100 KB apart; within a cluster: out of order, adjacent, overlapping, repeated,
+    // a small hole and an empty range.
+    const std::vector<CoalescedReads::Range> ranges = {
+        {1200, 300}, {1000, 200}, {1100, 150}, {1000, 200}, {2000, 50},
+        {150000, 4000}, {154000, 10}, {1500, 0}, {500, 10},
+    };
+    std::vector<std::vector<uint8_t>> slices(ranges.size());
+    std::vector<int> visits(ranges.size(), 0);
+    auto collect = [&](size_t i, std::span<const uint8_t> bytes) {
+        slices[i].assign(bytes.begin(), bytes.end());
+        ++visits[i];
+    };
+    CoalescedReads reads(4096);
+    bool ok = check(reads.read(*file, ranges, collect), "read");
+    ok &= check(reads.span_count() == 2, "two spans");
+    ok &= check(file->read_calls() == 2, "two read calls");
+    ok &= check(file->bytes_read() == (2050 - 500) + 4010, "bytes read cover spans only");
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        const auto begin = bytes.begin() + static_cast<std::ptrdiff_t>(ranges[i].offset);
+        ok &= check(visits[i] == 1 && slices[i].size() == ranges[i].size &&
+                        std::equal(slices[i].begin(), slices[i].end(), begin),
+                    "slice " + std::to_string(i));
+    }
+
+    // Without a gap limit only touching or overlapping ranges merge.
+    CoalescedReads no_gap(0);
+    ok &= check(no_gap.read(*file, ranges, collect), "read without gap");
+    ok &= check(no_gap.span_count() == 4, "spans without gap");
+
+    // The span limit splits a contiguous run; a range larger than the limit stays whole.
+    const std::vector<CoalescedReads::Range> run = {{0, 1000}, {1000, 1000}, {2000, 1000},
+                                                    {3000, 5000}};
+    CoalescedReads small_spans(4096, 2500);
+    ok &= check(small_spans.read(*file, run, collect), "read with span limit");
+    ok &= check(small_spans.span_count() == 3, "spans with span limit");
+    ok &= check(slices[3].size() == 5000 &&
+                    std::equal(slices[3].begin(), slices[3].end(), bytes.begin() + 3000),
+                "oversized range intact");
+
+    const std::vector<CoalescedReads::Range> outside = {{0, 10}, {bytes.size() - 4, 8}};
+    ok &= check(!reads.read(*file, outside, collect), "range past end rejected");
+    ok &= check(reads.read(*file, {}, collect) && reads.span_count() == 0, "empty batch");
+    file.reset();
+    std::filesystem::remove(path);
+    return ok;
+}
+
+bool test_read_m4a(const std::filesystem::path &dir) {
+    const std::filesystem::path testdata(TESTDATA_DIR);
+    const auto path = (dir / "chapterforge_coalesced_reads.m4a").string();
+    constexpr uint32_t kChapters = 300;
+    const auto jpeg = load_bytes(testdata / "images" / "chapter1.jpg");
+    std::vector<ChapterTextSample> titles;
+    std::vector<ChapterTextSample> urls;
+    std::vector<ChapterImageSample> images;
+    for (uint32_t i = 0; i < kChapters; ++i) {
+        ChapterTextSample t{};
+        t.text = "Coalesced " + std::to_string(i + 1);
+        t.start_ms = i * 30;
+        titles.push_back(t);
+        ChapterTextSample u{};
+        u.href = "https://chapterforge.test/" + std::to_string(i + 1);
+        u.start_ms = t.start_ms;
+        urls.push_back(u);
+        if (i % 10 == 0) {
+            ChapterImageSample im{};
+            im.start_ms = t.start_ms;
+            im.data = jpeg;
+            images.push_back(std::move(im));
+        }
+    }
+    auto st = chapterforge::mux_file_to_m4a((testdata / "input.m4a").string(), titles, urls,
+                                            images, MetadataSet{}, path, true);
+    if (!check(st.ok, "mux: " + st.message)) {
+        return false;
+    }
+    const auto res = chapterforge::read_m4a(path);
+    bool ok = check(res.status.ok, "read_m4a: " + res.status.message);
+    ok &= check(res.titles.size() == kChapters, "title count");
+    for (uint32_t i = 0; ok && i < kChapters; ++i) {
+        ok &= check(res.titles[i].text == titles[i].text, "title " + std::to_string(i));
+        ok &= check(res.urls[i].href == urls[i].href, "url " + std::to_string(i));
+        ok &= check(res.images[i].data == (i % 10 == 0 ? jpeg : std::vector<uint8_t>{}),
+                    "image " + std::to_string(i));
+    }
+    // Each chapter track is contiguous in mdat: one read per track instead of one per sample, on
+    // top of the parse (a header read per top-level atom, then moov).
+    std::printf("[coalesced_reads_unit] read_m4a: %u chapters, reads=%llu bytes=%llu\n", kChapters,
+                static_cast<unsigned long long>(res.io.reads),
+                static_cast<unsigned long long>(res.io.bytes));
+    ok &= check(res.io.reads <= kParseReads + 3, "read calls per chapter track");
+    ok &= check(res.io.bytes >= 30 * jpeg.size(), "bytes read include images");
+    std::filesystem::remove(path);
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path();
+    bool ok = true;
+    ok &= test_ranges(dir);
+    ok &= test_read_m4a(dir);
+    return ok ? 0 : 1;
+}
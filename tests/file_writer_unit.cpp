@@ -0,0 +1,146 @@
+// Unit coverage for FileWriter: buffered stream writes with seek-back patching, copy_range from
+// a mapped file (kernel copy where available, mapped writes otherwise) yielding byte-identical
+// output, and gathered writes of many pieces interleaved with stream writes, with preallocation
+// leaving the file size alone and the syscall counters adding up.
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "file_writer.hpp"
+#include "mapped_file.hpp"
+
+#define CHAPTERFORGE_TEST_NAME "file_writer_unit"
+#include "fixture_utils.hpp"
+
+using namespace fixture_utils;
+
+namespace {
+
+bool test_stream_writes_and_patch(const std::filesystem::path &dir) {
+    const auto path = dir / "file_writer_stream.bin";
+    auto writer = FileWriter::create(path.string());
+    if (!check(writer != nullptr, "create")) {
+        return false;
+    }
+    std::ostream out(writer.get());
+    const auto small = pattern(100, 1);
+    const auto large = pattern(3 * 1024 * 1024, 2);  // larger than the write buffer
+    out.write("\0\0\0\0", 4);
+    out.write(reinterpret_cast<const char *>(small.data()), std::streamsize(small.size()));
+    const auto mid = out.tellp();
+    out.write(reinterpret_cast<const char *>(large.data()), std::streamsize(large.size()));
+    out.put('x');
+    const auto end = out.tellp();
+    out.seekp(0);
+    out.write("ABCD", 4);
+    out.seekp(end);
+    out.put('y');
+    bool ok = check(static_cast<uint64_t>(mid) == 104, "tellp after small write");
+    ok &= check(static_cast<uint64_t>(end) == 104 + large.size() + 1, "tellp after large write");
+    ok &= check(static_cast<bool>(out) && writer->close(), "close");
+
+    std::vector<uint8_t> expected{'A', 'B', 'C', 'D'};
+    expected.insert(expected.end(), small.begin(), small.end());
+    expected.insert(expected.end(), large.begin(), large.end());
+    expected.push_back('x');
+    expected.push_back('y');
+    ok &= check(load_bytes(path) == expected, "stream content");
+    std::filesystem::remove(path);
+    return ok;
+}
+
+bool test_copy_range(const std::filesystem::path &dir) {
+    const auto src_path = dir / "file_writer_src.bin";
+    const auto dst_path = dir / "file_writer_dst.bin";
+    const auto source_bytes = pattern(1024 * 1024 + 333, 7);
+    {
+        std::ofstream src(src_path, std::ios::binary | std::ios::trunc);
+        src.write(reinterpret_cast<const char *>(source_bytes.data()),
+                  std::streamsize(source_bytes.size()));
+    }
+    auto source = MappedFile::open(src_path.string());
+    auto writer = FileWriter::create(dst_path.string());
+    if (!check(source && writer, "open source and destination")) {
+        return false;
+    }
+    std::ostream out(writer.get());
+    out.write("head", 4);
+    bool ok = check(writer->copy_range(*source, 4096, 500000), "copy first range");
+    out.write("mid", 3);
+    ok &= check(writer->copy_range(*source, 17, 1000), "copy second range");
+    ok &= check(static_cast<uint64_t>(out.tellp()) == 4 + 500000 + 3 + 1000,
+                "position advances by copied bytes");
+    ok &= check(!writer->copy_range(*source, source_bytes.size() - 10, 11),
+                "range past end rejected");
+    ok &= check(writer->kernel_copied_bytes() <= 501000, "kernel copy accounting");
+    writer->close();
+
+    std::vector<uint8_t> expected{'h', 'e', 'a', 'd'};
+    expected.insert(expected.end(), source_bytes.begin() + 4096, source_bytes.begin() + 504096);
+    expected.insert(expected.end(), {'m', 'i', 'd'});
+    expected.insert(expected.end(), source_bytes.begin() + 17, source_bytes.begin() + 1017);
+    ok &= check(load_bytes(dst_path) == expected, "copied content");
+    source.reset();
+    std::filesystem::remove(src_path);
+    std::filesystem::remove(dst_path);
+    return ok;
+}
+
+bool test_gather(const std::filesystem::path &dir) {
+    const auto path = dir / "file_writer_gather.bin";
+    auto writer = FileWriter::create(path.string());
+    if (!check(writer != nullptr, "create")) {
+        return false;
+    }
+    // More pieces than one vectored write takes, with empty and buffer-sized ones mixed in.
+    std::vector<std::vector<uint8_t>> storage;
+    for (uint32_t i = 0; i < 3000; ++i) {
+        const size_t n = i % 500 == 7 ? 5 * 1024 * 1024 : (i % 11 == 0 ? 0 : 50 + i % 300);
+        storage.push_back(pattern(n, i));
+    }
+    std::vector<std::span<const uint8_t>> pieces(storage.begin(), storage.end());
+    const bool reserved = writer->reserve(64 * 1024 * 1024);
+    std::ostream out(writer.get());
+    out.write("head", 4);
+    bool ok = check(writer->write_gather(pieces), "gather");
+    out.write("tail", 4);
+    ok &= check(writer->write_gather({}), "empty gather");
+    const uint64_t end = static_cast<uint64_t>(out.tellp());
+    ok &= check(static_cast<bool>(out) && writer->close(), "close");
+
+    std::vector<uint8_t> expected{'h', 'e', 'a', 'd'};
+    for (const auto &s : storage) {
+        expected.insert(expected.end(), s.begin(), s.end());
+    }
+    expected.insert(expected.end(), {'t', 'a', 'i', 'l'});
+    ok &= check(end == expected.size(), "position advances by gathered bytes");
+    ok &= check(load_bytes(path) == expected, "gathered content");
+
+    const auto &stats = writer->stats();
+#if !defined(_WIN32)
+    ok &= check(stats.vectored_writes >= 3 && stats.vectored_writes < 40,
+                "pieces batched into few vectored writes: " +
+                    std::to_string(stats.vectored_writes));
+#endif
+    ok &= check(stats.bytes_written == expected.size(), "bytes written accounted");
+    ok &= check(stats.syscalls >= stats.writes + stats.vectored_writes, "syscalls counted");
+    ok &= check(!reserved || stats.preallocated == 64 * 1024 * 1024, "preallocation counted");
+    std::filesystem::remove(path);
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path();
+    bool ok = true;
+    ok &= test_stream_writes_and_patch(dir);
+    ok &= test_copy_range(dir);
+    ok &= test_gather(dir);
+    return ok ? 0 : 1;
+}
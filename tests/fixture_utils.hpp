@@ -0,0 +1,174 @@
+// Shared helpers for the unit tests that mux testdata/input.m4a into a chapter fixture and read
+// it back or write files of their own: failure reporting, file loading, filler bytes, the fixture
+// itself and result comparison.
+//
+// Define CHAPTERFORGE_TEST_NAME (the test's name, used to tag failures) before including.
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "chapterforge.hpp"
+
+#ifndef TESTDATA_DIR
+#error "TESTDATA_DIR must be defined"
+#endif
+#ifndef CHAPTERFORGE_TEST_NAME
+#error "CHAPTERFORGE_TEST_NAME must be defined before including fixture_utils.hpp"
+#endif
+
+namespace fixture_utils {
+
+// Report `msg` as a failure of this test unless `cond` holds; returns `cond`.
+inline bool check(bool cond, const std::string &msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[%s] FAIL: %s\n", CHAPTERFORGE_TEST_NAME, msg.c_str());
+    }
+    return cond;
+}
+
+inline std::vector<uint8_t> load_bytes(const std::filesystem::path &p) {
+    std::ifstream in(p, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(in)),
+                                std::istreambuf_iterator<char>());
+}
+
+// `n` deterministic filler bytes; each `seed` gives a different sequence.
+inline std::vector<uint8_t> pattern(size_t n, uint32_t seed) {
+    std::vector<uint8_t> v(n);
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = static_cast<uint8_t>((i * 2654435761u + seed) >> 13);
+    }
+    return v;
+}
+
+// Chapter data of a fixture: `chapters` titles "<prefix> N" `spacing_ms` apart, each with one of
+// the five test JPEGs (chapter1.jpg .. chapter5.jpg in turn), a URL per title when `with_urls`,
+// and `prefix` as metadata title. Tests needing another shape adjust it before muxing.
+struct Fixture {
+    std::vector<ChapterTextSample> titles;
+    std::vector<ChapterTextSample> urls;
+    std::vector<ChapterImageSample> images;
+    MetadataSet meta;
+};
+
+inline Fixture make_fixture(uint32_t chapters, const std::string &prefix, bool with_urls = false,
+                            uint32_t spacing_ms = 1000) {
+    const std::filesystem::path images(std::filesystem::path(TESTDATA_DIR) / "images");
+    std::vector<std::vector<uint8_t>> jpegs;
+    for (int i = 1; i <= 5; ++i) {
+        jpegs.push_back(load_bytes(images / ("chapter" + std::to_string(i) + ".jpg")));
+    }
+    Fixture fx;
+    for (uint32_t i = 0; i < chapters; ++i) {
+        ChapterTextSample t{};
+        t.text = prefix + " " + std::to_string(i + 1);
+        t.start_ms = i * spacing_ms;
+        fx.titles.push_back(t);
+        if (with_urls) {
+            ChapterTextSample u{};
+            u.href = "https://chapterforge.test/chapter-" + std::to_string(i + 1);
+            u.start_ms = t.start_ms;
+            fx.urls.push_back(u);
+        }
+        ChapterImageSample im{};
+        im.start_ms = t.start_ms;
+        im.data = jpegs[i % jpegs.size()];
+        fx.images.push_back(std::move(im));
+    }
+    fx.meta.title = prefix;
+    return fx;
+}
+
+// Mux testdata/`input` with `fx` into `out_path` using `options`.
+inline bool mux_fixture(const std::string &out_path, const Fixture &fx,
+                        const chapterforge::MuxOptions &options,
+                        const std::string &input = "input.m4a") {
+    const auto input_path = (std::filesystem::path(TESTDATA_DIR) / input).string();
+    const auto st = chapterforge::mux_file_to_m4a(input_path, fx.titles, fx.urls, fx.images,
+                                                  fx.meta, out_path, options);
+    return check(st.ok, "mux " + out_path + ": " + st.message);
+}
+
+// Mux testdata/input.m4a with `fx` into `out_path`.
+inline bool mux_fixture(const std::string &out_path, const Fixture &fx, bool fast_start = true) {
+    chapterforge::MuxOptions options;
+    options.fast_start = fast_start;
+    return mux_fixture(out_path, fx, options);
+}
+
+inline bool mux_fixture(const std::string &out_path, uint32_t chapters, const std::string &prefix,
+                        bool fast_start = true, bool with_urls = false) {
+    return mux_fixture(out_path, make_fixture(chapters, prefix, with_urls), fast_start);
+}
+
+// Copy of the muxed file `bytes` with the stsz entries of samples `first` onwards set to `size`
+// in every text track (titles and URLs) that lists per-sample sizes.
+inline std::vector<uint8_t> with_text_sample_size(std::vector<uint8_t> bytes, uint32_t size,
+                                                  uint32_t first = 0) {
+    auto be32 = [&](size_t at) {
+        return (uint32_t(bytes[at]) << 24) | (uint32_t(bytes[at + 1]) << 16) |
+               (uint32_t(bytes[at + 2]) << 8) | uint32_t(bytes[at + 3]);
+    };
+    auto find = [&](const char *type, size_t from, size_t to) {
+        for (size_t at = from; at + 8 <= to; ++at) {
+            if (std::equal(type, type + 4, bytes.begin() + at + 4)) {
+                return at;
+            }
+        }
+        return to;
+    };
+    const char *text = "text";
+    for (size_t trak = find("trak", 0, bytes.size()); trak < bytes.size();
+         trak = find("trak", trak + 8, bytes.size())) {
+        const size_t end = std::min(bytes.size(), trak + be32(trak));
+        const size_t hdlr = find("hdlr", trak, end);
+        const size_t stsz = find("stsz", trak, end);
+        if (hdlr + 20 > end || stsz + 20 > end ||
+            !std::equal(text, text + 4, bytes.begin() + hdlr + 16) || be32(stsz + 12) != 0) {
+            continue;
+        }
+        const uint32_t count = be32(stsz + 16);
+        for (uint32_t i = first; i < count && stsz + 24 + i * 4 <= end; ++i) {
+            for (int b = 0; b < 4; ++b) {
+                bytes[stsz + 20 + i * 4 + b] = static_cast<uint8_t>(size >> (24 - 8 * b));
+            }
+        }
+    }
+    return bytes;
+}
+
+// Both reads succeeded and returned the same chapters: titles (text, href, start), URLs (href,
+// start), images (bytes, start) and metadata title and cover. I/O statistics are not compared.
+inline bool same_result(const chapterforge::ReadResult &a, const chapterforge::ReadResult &b) {
+    if (!a.status.ok || !b.status.ok || a.titles.size() != b.titles.size() ||
+        a.urls.size() != b.urls.size() || a.images.size() != b.images.size() ||
+        a.metadata.title != b.metadata.title || a.metadata.cover != b.metadata.cover) {
+        return false;
+    }
+    for (size_t i = 0; i < a.titles.size(); ++i) {
+        if (a.titles[i].text != b.titles[i].text || a.titles[i].href != b.titles[i].href ||
+            a.titles[i].start_ms != b.titles[i].start_ms) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < a.urls.size(); ++i) {
+        if (a.urls[i].href != b.urls[i].href || a.urls[i].start_ms != b.urls[i].start_ms) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < a.images.size(); ++i) {
+        if (a.images[i].data != b.images[i].data || a.images[i].start_ms != b.images[i].start_ms) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace fixture_utils
@@ -0,0 +1,167 @@
+// Unit test for update_chapters_in_place: updates that keep the moov in its slot and ones that
+// relocate it both read back the new chapters and metadata while the audio bytes stay untouched,
+// repeated updates reuse freed space instead of growing the file, an existing sidecar index does
+// not go stale, a pending journal is applied by recover_chapter_update while a torn or stale one
+// is discarded, and inputs that cannot be updated in place are rejected unchanged.
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "chapterforge.hpp"
+#include "in_place_update.hpp"
+
+#define CHAPTERFORGE_TEST_NAME "in_place_update_unit"
+#include "fixture_utils.hpp"
+
+using namespace fixture_utils;
+
+namespace {
+
+// Bytes of the audio track, located by planning the original mux.
+struct AudioRange {
+    uint64_t offset = 0;
+    uint64_t bytes = 0;
+};
+
+std::vector<uint8_t> audio_bytes(const std::filesystem::path &p, const AudioRange &audio) {
+    const auto all = load_bytes(p);
+    if (all.size() < audio.offset + audio.bytes) {
+        return {};
+    }
+    return std::vector<uint8_t>(all.begin() + audio.offset,
+                                all.begin() + audio.offset + audio.bytes);
+}
+
+bool reads_back(const std::filesystem::path &p, const std::vector<ChapterTextSample> &expected,
+                const std::string &album, const std::string &label) {
+    const auto read = chapterforge::read_m4a(p.string());
+    if (!check(read.status.ok, label + ": read failed: " + read.status.message)) {
+        return false;
+    }
+    bool ok = check(read.titles.size() == expected.size(), label + ": title count");
+    for (size_t i = 0; ok && i < expected.size(); ++i) {
+        ok &= check(read.titles[i].text == expected[i].text &&
+                        read.titles[i].start_ms == expected[i].start_ms,
+                    label + ": title " + std::to_string(i));
+    }
+    ok &= check(read.metadata.album == album, label + ": album");
+    ok &= check(!std::filesystem::exists(in_place::journal_path(p.string())),
+                label + ": journal left behind");
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    const std::filesystem::path testdata(TESTDATA_DIR);
+    const auto dir = std::filesystem::temp_directory_path() / "chapterforge_in_place_update_unit";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const auto file = dir / "book.m4a";
+    const auto input = (testdata / "input.m4a").string();
+    const auto json = (testdata / "chapters.json").string();
+
+    const auto plan = chapterforge::plan_m4a(input, json);
+    auto st = chapterforge::mux_file_to_m4a(input, json, file.string());
+    if (!check(plan.status.ok && st.ok && !plan.tracks.empty(), "mux failed: " + st.message)) {
+        return 1;
+    }
+    const AudioRange audio{plan.tracks[0].offset, plan.tracks[0].bytes};
+    const auto original_audio = audio_bytes(file, audio);
+    bool ok = check(!original_audio.empty(), "audio range");
+
+    // Fewer, shorter chapters: the moov shrinks and stays where it is. The file keeps its size, so
+    // an index of the old chapters must not survive the update even if the mtime does not move.
+    ok &= check(chapterforge::write_index(file.string()).ok, "index write failed");
+    const auto index = file.string() + ".cfidx";
+    const auto mtime_before = std::filesystem::last_write_time(file);
+    MetadataSet meta;
+    meta.title = "Updated";
+    meta.album = "Small Update";
+    const auto few = make_fixture(2, "Part", false, 100).titles;
+    const auto size_before = std::filesystem::file_size(file);
+    st = chapterforge::update_chapters_in_place(file.string(), few, {}, {}, meta);
+    ok &= check(st.ok, "small update failed: " + st.message);
+    ok &= reads_back(file, few, meta.album, "small update");
+    ok &= check(audio_bytes(file, audio) == original_audio, "small update: audio changed");
+    ok &= check(std::filesystem::file_size(file) == size_before,
+                "small update: chapters should fit the old moov slot");
+    ok &= check(std::filesystem::exists(index), "small update: index not rewritten");
+    std::filesystem::last_write_time(file, mtime_before);
+    ok &= reads_back(file, few, meta.album, "small update with old mtime");
+
+    // Many chapters with images: the moov outgrows its slot and is relocated.
+    const auto large =
+        make_fixture(200, "A rather long chapter title to grow the moov", false, 100);
+    const auto &many = large.titles;
+    std::vector<ChapterImageSample> images;
+    for (size_t i = 0; i < many.size(); i += 20) {
+        images.push_back(large.images[i]);
+    }
+    meta.album = "Large Update";
+    st = chapterforge::update_chapters_in_place(file.string(), many, {}, images, meta);
+    ok &= check(st.ok, "large update failed: " + st.message);
+    ok &= reads_back(file, many, meta.album, "large update");
+    ok &= check(audio_bytes(file, audio) == original_audio, "large update: audio changed");
+    const auto read = chapterforge::read_m4a(file.string());
+    ok &= check(!read.images.empty() && read.images.front().data == images.front().data,
+                "large update: images");
+
+    // Repeating updates settles into the space freed by the previous ones.
+    std::vector<uint64_t> sizes;
+    for (int i = 0; i < 5; ++i) {
+        const bool big = i % 2 == 0;
+        const std::vector<ChapterImageSample> none;
+        st = chapterforge::update_chapters_in_place(file.string(), big ? many : few, {},
+                                                    big ? images : none, meta);
+        ok &= check(st.ok, "repeated update failed: " + st.message);
+        sizes.push_back(std::filesystem::file_size(file));
+    }
+    ok &= check(sizes[4] == sizes[2] && sizes[3] == sizes[1], "repeated updates keep growing");
+    ok &= reads_back(file, many, meta.album, "repeated updates");
+    ok &= check(audio_bytes(file, audio) == original_audio, "repeated updates: audio changed");
+
+    // A complete journal is applied by recovery; a torn one or one for another size is dropped.
+    const uint64_t size = std::filesystem::file_size(file);
+    const std::vector<uint8_t> marker = {'C', 'F', 'T', 'E', 'S', 'T'};
+    const uint64_t marker_offset = size - marker.size();
+    const auto tail = [&] {
+        const auto all = load_bytes(file);
+        return std::vector<uint8_t>(all.end() - marker.size(), all.end());
+    };
+    const auto original_tail = tail();
+    ok &= check(in_place::write_journal(file.string(), size, {{marker_offset, marker}}),
+                "write journal");
+    st = chapterforge::recover_chapter_update(file.string());
+    ok &= check(st.ok && tail() == marker, "recovery did not apply the journal");
+    ok &= check(!std::filesystem::exists(in_place::journal_path(file.string())),
+                "applied journal not removed");
+
+    ok &= check(in_place::write_journal(file.string(), size, {{marker_offset, original_tail}}),
+                "write journal");
+    const auto journal = in_place::journal_path(file.string());
+    std::filesystem::resize_file(journal, std::filesystem::file_size(journal) - 3);
+    st = chapterforge::recover_chapter_update(file.string());
+    ok &= check(st.ok && tail() == marker, "torn journal was applied");
+    ok &= check(!std::filesystem::exists(in_place::journal_path(file.string())),
+                "torn journal not removed");
+
+    ok &= check(in_place::write_journal(file.string(), size + 1, {{marker_offset, original_tail}}),
+                "write journal");
+    ok &= check(in_place::replay_journal(file.string()) == in_place::Replay::Discarded &&
+                    tail() == marker,
+                "journal for another file size was applied");
+
+    // Raw ADTS has no moov to update.
+    const auto adts = dir / "input.aac";
+    std::filesystem::copy_file(testdata / "input.aac", adts);
+    const auto adts_before = load_bytes(adts);
+    st = chapterforge::update_chapters_in_place(adts.string(), few, {}, {}, meta);
+    ok &= check(!st.ok, "ADTS input should be rejected");
+    ok &= check(load_bytes(adts) == adts_before, "rejected input was modified");
+
+    std::filesystem::remove_all(dir);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+// 64-bit output: muxing more than 4 GB of audio switches to a largesize mdat header and co64
+// chunk offsets in both layouts, and every offset lands on the right bytes. The result reads back
+// through the structured (non-fallback) parser and remuxes from its co64 tables. The audio source
+// is a sparse 5 GB file whose holes stay holes in the output (kernel copy), so the test costs
+// almost no disk space.
+#include <sys/stat.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "aac_extractor.hpp"
+#include "fourcc_utils.hpp"
+#include "mapped_file.hpp"
+#include "chapterforge.hpp"
+#include "mp4_muxer.hpp"
+#include "parser.hpp"
+
+namespace {
+
+constexpr uint32_t kFrameSize = 1024 * 1024;
+constexpr uint32_t kFrames = 5 * 1024;  // 5 GB of audio
+constexpr char kMarker[] = "last frame past 4 GB";
+
+bool check(bool cond, const std::string &msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[large_output] FAIL: %s\n", msg.c_str());
+    }
+    return cond;
+}
+
+std::vector<uint8_t> read_at(const std::filesystem::path &p, uint64_t offset, size_t length) {
+    std::ifstream in(p, std::ios::binary);
+    std::vector<uint8_t> buf(length);
+    in.seekg(static_cast<std::streamoff>(offset));
+    in.read(reinterpret_cast<char *>(buf.data()), static_cast<std::streamsize>(length));
+    buf.resize(static_cast<size_t>(in.gcount()));
+    return buf;
+}
+
+uint64_t be(const uint8_t *p, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+// Payloads of all chunk offset boxes (type `want`) below a moov payload, in track order.
+void collect(const uint8_t *data, size_t size, uint32_t want,
+             std::vector<std::vector<uint8_t>> &out) {
+    size_t pos = 0;
+    while (pos + 8 <= size) {
+        const uint64_t box = be(data + pos, 4);
+        const uint32_t type = static_cast<uint32_t>(be(data + pos + 4, 4));
+        if (box < 8 || pos + box > size) {
+            return;
+        }
+        if (type == want) {
+            out.emplace_back(data + pos + 8, data + pos + box);
+        } else if (type == fourcc("trak") || type == fourcc("mdia") || type == fourcc("minf") ||
+                   type == fourcc("stbl")) {
+            collect(data + pos + 8, box - 8, want, out);
+        }
+        pos += box;
+    }
+}
+
+bool mux_large(const AacExtractResult &aac, const std::filesystem::path &out, bool fast_start) {
+    const std::string label = fast_start ? "faststart" : "moov-at-end";
+    std::vector<ChapterTextSample> titles(2);
+    titles[0].text = "Chapter 1";
+    titles[1].text = "Chapter 2";
+    titles[1].start_ms = 60000;
+
+    Mp4Layout layout;
+    bool ok = check(plan_mp4(aac, titles, {}, Mp4aConfig{}, MetadataSet{}, fast_start, {}, nullptr,
+                             nullptr, layout),
+                    label + ": plan");
+    ok &= check(write_mp4(out.string(), aac, titles, {}, Mp4aConfig{}, MetadataSet{}, fast_start),
+                label + ": write");
+    if (!ok) {
+        return false;
+    }
+    ok &= check(std::filesystem::file_size(out) == layout.file_size, label + ": file size");
+    struct stat st {};
+    ok &= check(::stat(out.c_str(), &st) == 0 && uint64_t(st.st_blocks) * 512 < 64 * 1024 * 1024,
+                label + ": output should stay sparse");
+
+    // mdat: size field 1, then the 64-bit largesize.
+    const auto mdat = read_at(out, layout.mdat_offset, 16);
+    ok &= check(mdat.size() == 16 && be(mdat.data(), 4) == 1 &&
+                    be(mdat.data() + 4, 4) == fourcc("mdat") &&
+                    be(mdat.data() + 8, 8) == layout.mdat_size,
+                label + ": largesize mdat header");
+
+    const auto moov = read_at(out, layout.moov_offset, static_cast<size_t>(layout.moov_size));
+    std::vector<std::vector<uint8_t>> co64;
+    std::vector<std::vector<uint8_t>> stco;
+    collect(moov.data() + 8, moov.size() - 8, fourcc("co64"), co64);
+    collect(moov.data() + 8, moov.size() - 8, fourcc("stco"), stco);
+    ok &= check(co64.size() == 2 && stco.empty(), label + ": all tracks use co64");
+    if (!ok) {
+        return false;
+    }
+
+    // Audio chunks are contiguous from the payload start; the last one sits past 4 GB.
+    const auto &audio = co64[0];
+    const uint64_t chunks = be(audio.data() + 4, 4);
+    const uint64_t payload_start = layout.mdat_offset + 16;
+    ok &= check(chunks == layout.tracks[0].chunks && be(audio.data() + 8, 8) == payload_start,
+                label + ": first audio chunk");
+    const uint64_t last_chunk = be(audio.data() + 8 + (chunks - 1) * 8, 8);
+    ok &= check(last_chunk > 0xFFFFFFFFULL, label + ": last audio chunk beyond 4 GB");
+    const uint64_t last_frame = payload_start + uint64_t(kFrames - 1) * kFrameSize;
+    const auto marker = read_at(out, last_frame, sizeof(kMarker));
+    ok &= check(marker == std::vector<uint8_t>(kMarker, kMarker + sizeof(kMarker)),
+                label + ": audio bytes at 64-bit offset");
+
+    // The title track follows the audio; its first sample is a tx3g string.
+    const uint64_t title_chunk = be(co64[1].data() + 8, 8);
+    ok &= check(title_chunk == layout.tracks[1].offset &&
+                    title_chunk == payload_start + uint64_t(kFrames) * kFrameSize,
+                label + ": title chunk offset");
+    const auto title = read_at(out, title_chunk, 11);
+    ok &= check(title.size() == 11 && be(title.data(), 2) == 9 &&
+                    std::string(title.begin() + 2, title.end()) == "Chapter 1",
+                label + ": title sample at 64-bit offset");
+    return ok;
+}
+
+// Read the 64-bit output back and remux it: co64 must be parsed natively, without the recovery
+// scan, and the audio must land at the same 64-bit positions again.
+bool read_back(const std::filesystem::path &in, const std::filesystem::path &out,
+               bool fast_start) {
+    const std::string label = std::string(fast_start ? "faststart" : "moov-at-end") + " read";
+    const auto parsed = parse_mp4(in.string());
+    bool ok = check(parsed && parsed->co64 && !parsed->used_fallback_stbl,
+                    label + ": structured co64 parse");
+    const auto read = chapterforge::read_m4a(in.string());
+    ok &= check(read.status.ok && read.titles.size() == 2 && read.titles[0].text == "Chapter 1" &&
+                    read.titles[1].start_ms == 60000,
+                label + ": chapter titles");
+    const auto probe = chapterforge::probe_m4a(in.string());
+    ok &= check(probe.status.ok && !probe.tracks.empty() &&
+                    probe.tracks[0].sample_count == kFrames,
+                label + ": probe");
+
+    std::vector<ChapterTextSample> titles(1);
+    titles[0].text = "Remuxed";
+    const auto plan = chapterforge::plan_m4a(in.string(), titles, {}, {}, MetadataSet{}, true);
+    const auto st = chapterforge::mux_file_to_m4a(in.string(), titles, MetadataSet{},
+                                                  out.string(), true);
+    ok &= check(plan.status.ok && st.ok, label + ": remux: " + st.message);
+    if (!ok) {
+        return false;
+    }
+    ok &= check(std::filesystem::file_size(out) == plan.file_size, label + ": remux size");
+    const uint64_t last_frame = plan.tracks[0].offset + uint64_t(kFrames - 1) * kFrameSize;
+    ok &= check(read_at(out, last_frame, sizeof(kMarker)) ==
+                    std::vector<uint8_t>(kMarker, kMarker + sizeof(kMarker)),
+                label + ": remuxed audio bytes at 64-bit offset");
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto source_path = dir / "chapterforge_large_output_src.bin";
+    const auto out = dir / "chapterforge_large_output.m4a";
+    const auto remux = dir / "chapterforge_large_output_remux.m4a";
+    const uint64_t source_size = uint64_t(kFrames) * kFrameSize;
+    {
+        std::ofstream src(source_path, std::ios::binary | std::ios::trunc);
+    }
+    std::error_code ec;
+    std::filesystem::resize_file(source_path, source_size, ec);
+    if (!check(!ec, "create sparse source")) {
+        return 1;
+    }
+    {
+        std::fstream src(source_path, std::ios::binary | std::ios::in | std::ios::out);
+        src.seekp(static_cast<std::streamoff>(source_size - kFrameSize));
+        src.write(kMarker, sizeof(kMarker));
+    }
+
+    bool ok = true;
+    {
+        AacExtractResult aac;
+        aac.sample_rate = 44100;
+        aac.sampling_index = 4;
+        aac.channel_config = 2;
+        aac.audio_object_type = 2;
+        aac.frames = FrameStore::view(MappedFile::open(source_path.string()));
+        for (uint32_t i = 0; i < kFrames && ok; ++i) {
+            ok &= check(aac.frames.add(uint64_t(i) * kFrameSize, kFrameSize), "add frame");
+        }
+        if (ok) {
+            ok &= mux_large(aac, out, true) && read_back(out, remux, true);
+            ok &= mux_large(aac, out, false) && read_back(out, remux, false);
+        }
+    }
+    std::filesystem::remove(out);
+    std::filesystem::remove(remux);
+    std::filesystem::remove(source_path);
+    return ok ? 0 : 1;
+}
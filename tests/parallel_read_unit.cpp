@@ -0,0 +1,68 @@
+// Unit test for parallel chapter extraction: read_m4a returns identical titles, URLs, images and
+// metadata for every thread count, including more threads than tasks and the hardware default,
+// and the image track is actually split into concurrent chunks.
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "chapterforge.hpp"
+
+#define CHAPTERFORGE_TEST_NAME "parallel_read_unit"
+#include "fixture_utils.hpp"
+
+using namespace fixture_utils;
+
+namespace {
+
+// 150 chapters with ~5 MB of images (enough for several image chunks) and a cover; every fifth
+// chapter has no URL, so alignment gaps are exercised too.
+bool mux_parallel_fixture(const std::string &out_path) {
+    auto fx = make_fixture(150, "Parallel", true, 60);
+    std::vector<ChapterTextSample> urls;
+    for (size_t i = 0; i < fx.urls.size(); ++i) {
+        if (i % 5 != 4) {
+            urls.push_back(fx.urls[i]);
+        }
+    }
+    fx.urls = std::move(urls);
+    fx.meta.title = "Parallel Read Unit";
+    fx.meta.cover = load_bytes(std::filesystem::path(TESTDATA_DIR) / "images" / "cover.jpg");
+    return mux_fixture(out_path, fx);
+}
+
+// Same chapters from the same number of bytes read.
+bool same(const chapterforge::ReadResult &a, const chapterforge::ReadResult &b,
+          const std::string &label) {
+    return check(same_result(a, b), label + " result") &&
+           check(a.io.bytes == b.io.bytes, label + " bytes read");
+}
+
+}  // namespace
+
+int main() {
+    const auto path =
+        (std::filesystem::temp_directory_path() / "chapterforge_parallel_read.m4a").string();
+    if (!mux_parallel_fixture(path)) {
+        return 1;
+    }
+    const auto serial = chapterforge::read_m4a(path);
+    bool ok = check(serial.status.ok, "serial read: " + serial.status.message);
+    ok &= check(serial.titles.size() == 150 && serial.images[149].data.size() > 0,
+                "serial content");
+    ok &= check(serial.urls[4].href.empty() && !serial.urls[5].href.empty(), "url gap aligned");
+
+    for (unsigned threads : {2u, 4u, 16u, 0u}) {
+        const std::string label = "threads=" + std::to_string(threads);
+        const auto parallel = chapterforge::read_m4a(path, chapterforge::ReadOptions{threads});
+        ok &= same(serial, parallel, label);
+        if (threads == 4) {
+            // The image track is split into 4 chunks instead of 2 span-limited reads.
+            ok &= check(parallel.io.reads >= serial.io.reads + 2, label + " image chunks");
+        }
+        // Repeat to shake out scheduling-dependent results.
+        ok &= same(parallel, chapterforge::read_m4a(path, chapterforge::ReadOptions{threads}),
+                   label + " repeat");
+    }
+    std::filesystem::remove(path);
+    return ok ? 0 : 1;
+}
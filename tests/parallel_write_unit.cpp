@@ -0,0 +1,157 @@
+// Unit test for parallel region writes: mux outputs written with several threads are
+// byte-identical to sequential ones (fast-start and moov-at-end, M4A and ADTS input), a mapped
+// audio track cut into many chunk ranges (with and without gaps between frames) lands exactly
+// where write_mdat puts it, and FrameStore cursors can start at any frame.
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "chapterforge.hpp"
+#include "file_writer.hpp"
+#include "frame_store.hpp"
+#include "mapped_file.hpp"
+#include "mdat_writer.hpp"
+
+#define CHAPTERFORGE_TEST_NAME "parallel_write_unit"
+#include "fixture_utils.hpp"
+
+using namespace fixture_utils;
+
+namespace {
+
+bool mux(const std::string &input, const std::string &out_path, bool fast_start,
+         unsigned threads) {
+    chapterforge::MuxOptions options;
+    options.fast_start = fast_start;
+    options.write_threads = threads;
+    return mux_fixture(out_path, make_fixture(4, "Region", true, 1500), options, input);
+}
+
+bool test_mux_identical(const std::filesystem::path &dir) {
+    bool ok = true;
+    for (const char *input : {"input.m4a", "input.aac"}) {
+        for (bool fast_start : {true, false}) {
+            const std::string what =
+                std::string(input) + (fast_start ? " faststart" : " moov at end");
+            const auto seq = (dir / "chapterforge_parallel_seq.m4a").string();
+            const auto par = (dir / "chapterforge_parallel_par.m4a").string();
+            // Each call carries its own thread count, so the two may run at once.
+            bool par_ok = false;
+            std::thread par_mux([&] { par_ok = mux(input, par, fast_start, 4); });
+            ok &= mux(input, seq, fast_start, 1);
+            par_mux.join();
+            ok &= par_ok;
+            const auto a = load_bytes(seq);
+            ok &= check(!a.empty() && a == load_bytes(par), what + ": parallel output identical");
+            ok &= check(chapterforge::read_m4a(par).titles.size() == 4, what + ": reads back");
+            std::filesystem::remove(seq);
+            std::filesystem::remove(par);
+        }
+    }
+    return ok;
+}
+
+// Frames of varying size inside a source file, `gap` bytes apart.
+FrameStore make_frames(const std::shared_ptr<const MappedFile> &source, uint32_t gap) {
+    FrameStore store = FrameStore::view(source);
+    uint64_t at = 64;
+    for (uint32_t i = 0;; ++i) {
+        const uint32_t size = 700 + (i * 37) % 500;
+        if (at + size > source->size()) {
+            break;
+        }
+        store.add(at, size);
+        at += size + gap;
+    }
+    return store;
+}
+
+bool test_cursor_start(const FrameStore &store) {
+    std::vector<std::span<const uint8_t>> frames;
+    FrameStore::Cursor all(store);
+    for (size_t i = 0; i < store.size(); ++i) {
+        frames.push_back(all.next());
+    }
+    bool ok = true;
+    for (size_t first : {size_t(0), size_t(1), size_t(2), store.size() / 3, store.size() - 1}) {
+        FrameStore::Cursor cursor(store, first);
+        for (size_t i = first; i < std::min(store.size(), first + 3); ++i) {
+            const auto f = cursor.next();
+            ok &= f.data() == frames[i].data() && f.size() == frames[i].size();
+        }
+    }
+    return check(ok, "cursor starting mid-store matches a full walk");
+}
+
+bool test_regions(const std::filesystem::path &dir, uint32_t gap) {
+    const auto src_path = dir / "chapterforge_parallel_src.bin";
+    const auto seq_path = dir / "chapterforge_parallel_seq.bin";
+    const auto par_path = dir / "chapterforge_parallel_par.bin";
+    {
+        const auto bytes = pattern(3 * 1024 * 1024 + 123, gap);
+        std::ofstream src(src_path, std::ios::binary | std::ios::trunc);
+        src.write(reinterpret_cast<const char *>(bytes.data()), std::streamsize(bytes.size()));
+    }
+    std::shared_ptr<const MappedFile> source = MappedFile::open(src_path.string());
+    if (!check(source != nullptr, "map source")) {
+        return false;
+    }
+    const FrameStore audio = make_frames(source, gap);
+    bool ok = test_cursor_start(audio);
+    const std::vector<uint32_t> audio_plan(audio.size() / 97 + 1, 97);  // last chunk partial
+    const std::vector<std::vector<std::vector<uint8_t>>> text{
+        {pattern(20, 1), pattern(30, 2), pattern(0, 3)}, {pattern(12, 4)}};
+    const std::vector<std::vector<uint8_t>> images{pattern(40000, 5), pattern(70000, 6)};
+    const std::vector<std::vector<uint32_t>> text_plans{{1, 2}, {}};
+    const std::vector<uint32_t> image_plan{1, 1};
+
+    MdatOffsets planned;
+    uint64_t payload_size = 0;
+    {
+        auto writer = FileWriter::create(seq_path.string());
+        std::ostream out(writer.get());
+        out.write("prefix", 6);
+        planned = write_mdat(out, audio, text, images, audio_plan, text_plans, image_plan);
+        payload_size = static_cast<uint64_t>(out.tellp()) - planned.payload_start;
+        ok &= check(static_cast<bool>(out) && writer->close(), "sequential write");
+    }
+    {
+        auto writer = FileWriter::create(par_path.string());
+        std::ostream out(writer.get());
+        out.write("prefix", 6);
+        write_mdat_header(out, payload_size);
+        ok &= check(static_cast<bool>(out) && writer->close(), "header write");
+    }
+    FileWriter::Stats stats;
+    ok &= check(write_mdat_payload_parallel(par_path.string(), 4, planned, audio, text, images,
+                                            audio_plan, text_plans, image_plan, &stats, 1),
+                "parallel payload write");
+    ok &= check(load_bytes(seq_path) == load_bytes(par_path),
+                "regions identical to sequential mdat, gap=" + std::to_string(gap));
+    ok &= check(stats.syscalls > 0 && stats.bytes_written > 0, "region stats summed");
+
+    // Offsets that disagree with the written layout are reported.
+    MdatOffsets wrong = planned;
+    wrong.audio_offsets[1] += 1;
+    ok &= check(!write_mdat_payload_parallel(par_path.string(), 2, wrong, audio, text, images,
+                                             audio_plan, text_plans, image_plan, nullptr, 1),
+                "misplaced region detected");
+    source.reset();
+    std::filesystem::remove(src_path);
+    std::filesystem::remove(seq_path);
+    std::filesystem::remove(par_path);
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path();
+    bool ok = test_mux_identical(dir);
+    ok &= test_regions(dir, 0);
+    ok &= test_regions(dir, 7);
+    return ok ? 0 : 1;
+}
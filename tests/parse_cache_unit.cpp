@@ -0,0 +1,172 @@
+// Unit test for the parse cache: a second read_m4a of the same file is a hit that skips moov,
+// muxing from a file already read reuses its entry, a rewritten file misses, invalidation and a
+// small byte budget drop entries, concurrent readers agree, and disabling empties the cache.
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "chapterforge.hpp"
+
+#define CHAPTERFORGE_TEST_NAME "parse_cache_unit"
+#include "fixture_utils.hpp"
+
+using namespace fixture_utils;
+
+namespace {
+
+constexpr uint64_t kCapacity = 64ull * 1024 * 1024;
+
+bool test_hits(const std::string &path, const std::string &remux) {
+    chapterforge::clear_parse_cache();
+    const auto before = chapterforge::parse_cache_stats();
+    const auto first = chapterforge::read_m4a(path);
+    const auto second = chapterforge::read_m4a(path);
+    auto stats = chapterforge::parse_cache_stats();
+    bool ok = check(first.status.ok && first.titles.size() == 4, "first read");
+    ok &= check(same_result(first, second), "cached read matches");
+    ok &= check(stats.misses == before.misses + 1 && stats.hits == before.hits + 1,
+                "one miss then one hit");
+    ok &= check(stats.entries == 1 && stats.bytes > 0 && stats.bytes <= stats.max_bytes,
+                "entry held within budget");
+    // A hit reads chapter samples only: no header walk, no moov.
+    ok &= check(second.io.reads < first.io.reads && second.io.bytes < first.io.bytes,
+                "hit skips moov");
+    std::printf("[parse_cache_unit] miss reads=%llu bytes=%llu, hit reads=%llu bytes=%llu, "
+                "entry=%llu bytes\n",
+                static_cast<unsigned long long>(first.io.reads),
+                static_cast<unsigned long long>(first.io.bytes),
+                static_cast<unsigned long long>(second.io.reads),
+                static_cast<unsigned long long>(second.io.bytes),
+                static_cast<unsigned long long>(stats.bytes));
+
+    // Muxing from the same file reuses the entry and adds its audio sample table.
+    const uint64_t bytes_before_mux = stats.bytes;
+    std::vector<ChapterTextSample> titles(1);
+    titles[0].text = "Remuxed";
+    auto st = chapterforge::mux_file_to_m4a(path, titles, {}, {}, MetadataSet{}, remux, true);
+    ok &= check(st.ok, "remux: " + st.message);
+    stats = chapterforge::parse_cache_stats();
+    ok &= check(stats.hits == before.hits + 2, "mux input is a hit");
+    ok &= check(stats.bytes > bytes_before_mux, "audio sample table cached");
+    const auto remuxed = chapterforge::read_m4a(remux);
+    ok &= check(remuxed.status.ok && remuxed.titles.size() == 1 &&
+                    remuxed.titles[0].text == "Remuxed",
+                "remuxed output");
+    return ok;
+}
+
+bool test_identity(const std::string &path) {
+    chapterforge::clear_parse_cache();
+    const auto old_read = chapterforge::read_m4a(path);
+    // Rewriting the file changes size and mtime; the old entry must not be served.
+    bool ok = mux_fixture(path, 6, "Rewritten");
+    const auto before = chapterforge::parse_cache_stats();
+    const auto fresh = chapterforge::read_m4a(path);
+    const auto after = chapterforge::parse_cache_stats();
+    ok &= check(after.misses == before.misses + 1 && after.hits == before.hits,
+                "rewritten file misses");
+    ok &= check(fresh.status.ok && fresh.titles.size() == 6 &&
+                    fresh.titles[0].text == "Rewritten 1" && old_read.titles.size() == 4,
+                "rewritten content");
+
+    // The rewrite itself cached input.m4a through the mux path; that entry stays.
+    const uint64_t entries = chapterforge::parse_cache_stats().entries;
+    ok &= check(chapterforge::invalidate_parse_cache(path) == 2, "invalidate drops both entries");
+    ok &= check(chapterforge::parse_cache_stats().entries == entries - 2,
+                "other entries survive invalidate");
+    const auto again = chapterforge::read_m4a(path);
+    ok &= check(chapterforge::parse_cache_stats().misses == after.misses + 1,
+                "read after invalidate misses");
+    ok &= check(same_result(fresh, again), "read after invalidate");
+    return ok;
+}
+
+bool test_budget(const std::string &a, const std::string &b) {
+    chapterforge::clear_parse_cache();
+    chapterforge::read_m4a(a);
+    const uint64_t one = chapterforge::parse_cache_stats().bytes;
+    // Room for one entry only: the second file evicts the first.
+    chapterforge::set_parse_cache_capacity(one + one / 2);
+    const auto before = chapterforge::parse_cache_stats();
+    chapterforge::read_m4a(b);
+    auto stats = chapterforge::parse_cache_stats();
+    bool ok = check(stats.entries == 1 && stats.evictions == before.evictions + 1,
+                    "least recently used entry evicted");
+    ok &= check(stats.bytes <= stats.max_bytes, "budget respected");
+    chapterforge::read_m4a(a);
+    ok &= check(chapterforge::parse_cache_stats().misses == stats.misses + 1,
+                "evicted file misses");
+
+    // An entry larger than the whole budget is not kept.
+    chapterforge::set_parse_cache_capacity(16);
+    chapterforge::read_m4a(a);
+    ok &= check(chapterforge::parse_cache_stats().entries == 0, "oversized entry not kept");
+    chapterforge::set_parse_cache_capacity(kCapacity);
+    return ok;
+}
+
+bool test_concurrent(const std::string &path) {
+    chapterforge::clear_parse_cache();
+    const auto expected = chapterforge::read_m4a(path);
+    const auto before = chapterforge::parse_cache_stats();
+    constexpr int kThreads = 4;
+    constexpr int kReads = 10;
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> pool;
+    for (int t = 0; t < kThreads; ++t) {
+        pool.emplace_back([&] {
+            for (int i = 0; i < kReads; ++i) {
+                if (!same_result(expected, chapterforge::read_m4a(path))) {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for (auto &t : pool) {
+        t.join();
+    }
+    const auto stats = chapterforge::parse_cache_stats();
+    bool ok = check(mismatches == 0, "concurrent reads match");
+    ok &= check(stats.hits == before.hits + kThreads * kReads && stats.misses == before.misses,
+                "concurrent reads all hit");
+    return ok;
+}
+
+bool test_disabled(const std::string &path) {
+    chapterforge::set_parse_cache_capacity(0);
+    const auto before = chapterforge::parse_cache_stats();
+    bool ok = check(before.entries == 0 && before.bytes == 0, "disabling empties the cache");
+    chapterforge::read_m4a(path);
+    chapterforge::read_m4a(path);
+    const auto after = chapterforge::parse_cache_stats();
+    ok &= check(after.hits == before.hits && after.misses == before.misses &&
+                    after.entries == 0,
+                "disabled cache is not consulted");
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto a = (dir / "chapterforge_parse_cache_a.m4a").string();
+    const auto b = (dir / "chapterforge_parse_cache_b.m4a").string();
+    const auto remux = (dir / "chapterforge_parse_cache_remux.m4a").string();
+    bool ok = check(chapterforge::parse_cache_stats().max_bytes == 0, "disabled by default");
+    chapterforge::set_parse_cache_capacity(kCapacity);
+    ok &= mux_fixture(a, 4, "Cached") && mux_fixture(b, 4, "Other");
+    if (ok) {
+        ok &= test_hits(a, remux);
+        ok &= test_budget(a, b);
+        ok &= test_concurrent(b);
+        ok &= test_identity(a);
+        ok &= test_disabled(b);
+    }
+    std::filesystem::remove(a);
+    std::filesystem::remove(b);
+    std::filesystem::remove(remux);
+    return ok ? 0 : 1;
+}
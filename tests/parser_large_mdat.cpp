@@ -0,0 +1,141 @@
+// Regression: non-faststart files whose mdat exceeds the old blanket 512 MB atom bound must still
+// reach the trailing moov through structured parsing (no fallback scan). Uses sparse files so the
+// multi-GB payload costs no disk space on filesystems with hole support.
+#include "fourcc_utils.hpp"
+#include "parser.hpp"
+#include "parser_test_utils.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace parser_test_utils;
+
+namespace {
+
+constexpr uint32_t kTimescale = 44100;
+constexpr uint32_t kSamples = 64;
+
+std::vector<uint8_t> make_moov_bytes() {
+    std::vector<uint8_t> stbl;
+    append_atom(stbl, fourcc("stsd"), make_stsd());
+    append_atom(stbl, fourcc("stts"), make_stts_single(kSamples, 1024));
+    std::vector<uint8_t> stsc{0, 0, 0, 0};
+    write_u32_be(stsc, 1);
+    write_u32_be(stsc, 1);
+    write_u32_be(stsc, kSamples);
+    write_u32_be(stsc, 1);
+    append_atom(stbl, fourcc("stsc"), stsc);
+    append_atom(stbl, fourcc("stsz"), make_stsz(kSamples, 0));
+    std::vector<uint8_t> stco{0, 0, 0, 0};
+    write_u32_be(stco, 1);
+    write_u32_be(stco, 64);
+    append_atom(stbl, fourcc("stco"), stco);
+
+    auto mdia = make_mdia(kTimescale, kSamples * 1024, stbl, fourcc("soun"));
+    std::vector<uint8_t> moov;
+    append_atom(moov, fourcc("moov"), make_moov(make_trak(mdia)));
+    return moov;
+}
+
+// ftyp + mdat (sparse, `mdat_payload` bytes) + moov. Uses a 64-bit largesize header when the
+// atom does not fit 32 bits.
+bool write_fixture(const std::filesystem::path &p, uint64_t mdat_payload) {
+    std::vector<uint8_t> head;
+    std::vector<uint8_t> ftyp_payload{'M', '4', 'A', ' ', 0, 0, 0, 0, 'i', 's', 'o', 'm'};
+    append_atom(head, fourcc("ftyp"), ftyp_payload);
+    if (mdat_payload + 8 <= UINT32_MAX) {
+        write_u32_be(head, static_cast<uint32_t>(mdat_payload + 8));
+        write_u32_be(head, fourcc("mdat"));
+    } else {
+        write_u32_be(head, 1);
+        write_u32_be(head, fourcc("mdat"));
+        write_u64_be(head, mdat_payload + 16);
+    }
+    {
+        std::ofstream out(p, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        out.write(reinterpret_cast<const char *>(head.data()),
+                  static_cast<std::streamsize>(head.size()));
+    }
+    std::error_code ec;
+    std::filesystem::resize_file(p, head.size() + mdat_payload, ec);
+    if (ec) {
+        return false;
+    }
+    auto moov = make_moov_bytes();
+    std::ofstream out(p, std::ios::binary | std::ios::app);
+    out.write(reinterpret_cast<const char *>(moov.data()),
+              static_cast<std::streamsize>(moov.size()));
+    return static_cast<bool>(out);
+}
+
+int run_case(const char *name, uint64_t mdat_payload) {
+    const auto p = std::filesystem::temp_directory_path() / (std::string("parser_") + name + ".mp4");
+    if (!write_fixture(p, mdat_payload)) {
+        std::cout << "[parser_large_mdat] skipping " << name << ": cannot create sparse fixture\n";
+        std::filesystem::remove(p);
+        return 0;
+    }
+    auto parsed = parse_mp4(p.string());
+    std::filesystem::remove(p);
+    if (!parsed) {
+        std::cerr << "[parser_large_mdat] " << name << ": parse_mp4 returned nullopt\n";
+        return 1;
+    }
+    if (parsed->used_fallback_stbl) {
+        std::cerr << "[parser_large_mdat] " << name << ": fell back to flat scan\n";
+        return 1;
+    }
+    if (parsed->audio_timescale != kTimescale || parsed->stsz.size() < 12 ||
+        parsed->tracks.size() != 1 || parsed->tracks[0].sample_count != kSamples) {
+        std::cerr << "[parser_large_mdat] " << name << ": moov not parsed\n";
+        return 1;
+    }
+    return 0;
+}
+
+// ftyp + an mdat whose largesize (2^64 - 16) makes `offset + size` wrap to the mdat's own offset.
+// The top-level walk must reject it instead of wrapping around and looping forever.
+int run_wrapping_largesize() {
+    const auto p = std::filesystem::temp_directory_path() / "parser_mdat_wrap.mp4";
+    std::vector<uint8_t> bytes;
+    std::vector<uint8_t> ftyp_payload{'M', '4', 'A', ' ', 0, 0, 0, 0};
+    append_atom(bytes, fourcc("ftyp"), ftyp_payload);
+    write_u32_be(bytes, 1);
+    write_u32_be(bytes, fourcc("mdat"));
+    write_u64_be(bytes, UINT64_MAX - 15);
+    bytes.resize(bytes.size() + 64, 0);
+    {
+        std::ofstream out(p, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(bytes.data()),
+                  static_cast<std::streamsize>(bytes.size()));
+    }
+    auto parsed = parse_mp4(p.string());
+    std::filesystem::remove(p);
+    if (parsed && !parsed->stsz.empty()) {
+        std::cerr << "[parser_large_mdat] mdat_wrap: sample tables from a file without moov\n";
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace
+
+int main() {
+    // 3 GiB mdat with a plain 32-bit size, then 5 GiB with a 64-bit largesize header.
+    int rc = run_case("mdat_3g", 3ull << 30);
+    if (rc != 0) {
+        return rc;
+    }
+    rc = run_case("mdat_5g", 5ull << 30);
+    if (rc != 0) {
+        return rc;
+    }
+    return run_wrapping_largesize();
+}
@@ -20,9 +20,10 @@ bool make_huge_atom_file(const std::filesystem::path &p) {
     if (!out.is_open()) {
         return false;
     }
+    // mdat is only bounded by the file, so use moov (parsed in memory) to hit the size guard.
     const uint32_t huge_size = 0x20000010;  // payload >512MB; triggers size guard
     write_u32(out, huge_size);
-    out.write("mdat", 4);
+    out.write("moov", 4);
     // No payload is written; size guard in parser will zero the atom and bail.
     return true;
 }
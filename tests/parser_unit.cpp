@@ -4,7 +4,6 @@
 #include <cassert>
 #include <cstdint>
 #include <filesystem>
-#include <sstream>
 #include <string>
 #include <vector>
 
@@ -65,11 +64,9 @@ int main() {
         auto mdia = make_mdia(timescale, duration, stbl, 'soun');
         std::vector<uint8_t> trak_buf;
         append_atom(trak_buf, 'trak', make_trak(mdia));
-        std::string trak_str(trak_buf.begin() + 8, trak_buf.end());  // drop outer header
-        std::istringstream trak_stream(trak_str);
+        ByteView trak_view(trak_buf);
         bool fallback = false;
-        auto track = parse_trak_for_test(trak_stream, trak_buf.size() - 8,
-                                         trak_buf.size(), fallback);
+        auto track = parse_trak_for_test(trak_view.subspan(8), fallback);  // drop outer header
         assert(track.has_value());
         assert(!fallback);
         assert(track->handler_type == 'soun');
@@ -85,11 +82,8 @@ int main() {
     {
         std::vector<uint8_t> bad_trak;
         append_atom(bad_trak, 'trak', std::vector<uint8_t>{0x00});  // too small payload
-        std::string bad_str(bad_trak.begin() + 8, bad_trak.end());
-        std::istringstream bad_stream(bad_str);
         bool fallback = false;
-        auto bad = parse_trak_for_test(bad_stream, bad_trak.size() - 8,
-                                       bad_trak.size(), fallback);
+        auto bad = parse_trak_for_test(ByteView(bad_trak).subspan(8), fallback);
         assert(!bad.has_value() || fallback);
     }
 
@@ -114,8 +108,6 @@ int main() {
 
         std::vector<uint8_t> file2;
         append_atom(file2, 'moov', moov_payload);
-        std::string moov_str(file2.begin() + 8, file2.end());
-        std::istringstream moov_stream(moov_str);
         Mp4AtomInfo atom{};
         atom.type = 'moov';
         atom.offset = 0;
@@ -123,7 +115,7 @@ int main() {
         ParsedMp4 parsed2{};
         uint32_t best_samples = 0;
         bool fallback = false;
-        parse_moov_for_test(moov_stream, atom, file2.size(), parsed2, best_samples, fallback);
+        parse_moov_for_test(file2, atom, parsed2, best_samples, fallback);
         assert(!fallback);
         assert(parsed2.audio_timescale == timescale);
         assert(parsed2.audio_duration == duration);
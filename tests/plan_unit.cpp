@@ -0,0 +1,110 @@
+// Unit test for plan_m4a: the dry-run layout (file size, moov/mdat placement, per-track mdat
+// ranges) matches the file mux_file_to_m4a writes for ADTS and M4A input in both layouts, and
+// planning never creates the output.
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "chapterforge.hpp"
+
+#ifndef TESTDATA_DIR
+#error "TESTDATA_DIR must be defined"
+#endif
+
+namespace {
+
+bool check(bool cond, const std::string &msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[plan_unit] FAIL: %s\n", msg.c_str());
+    }
+    return cond;
+}
+
+std::vector<uint8_t> load_bytes(const std::filesystem::path &p) {
+    std::ifstream in(p, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(in)),
+                                std::istreambuf_iterator<char>());
+}
+
+uint32_t be32(const std::vector<uint8_t> &b, size_t pos) {
+    return (uint32_t(b[pos]) << 24) | (uint32_t(b[pos + 1]) << 16) | (uint32_t(b[pos + 2]) << 8) |
+           uint32_t(b[pos + 3]);
+}
+
+// Top-level atoms as type -> (offset, size).
+std::map<std::string, std::pair<uint64_t, uint64_t>> top_level(const std::vector<uint8_t> &b) {
+    std::map<std::string, std::pair<uint64_t, uint64_t>> atoms;
+    size_t pos = 0;
+    while (pos + 8 <= b.size()) {
+        const uint32_t size = be32(b, pos);
+        if (size < 8) {
+            break;
+        }
+        atoms[std::string(reinterpret_cast<const char *>(&b[pos + 4]), 4)] = {pos, size};
+        pos += size;
+    }
+    return atoms;
+}
+
+bool plan_matches_mux(const std::string &input, bool fast_start) {
+    const std::filesystem::path testdata(TESTDATA_DIR);
+    const auto json = (testdata / "chapters.json").string();
+    const auto out = std::filesystem::temp_directory_path() / "chapterforge_plan_unit.m4a";
+    const std::string label = input + (fast_start ? " faststart" : " moov-at-end");
+    std::filesystem::remove(out);
+
+    const auto plan = chapterforge::plan_m4a((testdata / input).string(), json, fast_start);
+    bool ok = check(plan.status.ok, label + ": plan failed: " + plan.status.message);
+    ok &= check(!std::filesystem::exists(out), label + ": plan must not write output");
+    const auto st =
+        chapterforge::mux_file_to_m4a((testdata / input).string(), json, out.string(), fast_start);
+    if (!check(ok && st.ok, label + ": mux failed: " + st.message)) {
+        return false;
+    }
+
+    const auto bytes = load_bytes(out);
+    const auto atoms = top_level(bytes);
+    ok &= check(plan.file_size == bytes.size(), label + ": file size");
+    ok &= check(atoms.count("moov") && atoms.at("moov").first == plan.moov_offset &&
+                    atoms.at("moov").second == plan.moov_size,
+                label + ": moov placement");
+    ok &= check(atoms.count("mdat") && atoms.at("mdat").first == plan.mdat_offset &&
+                    atoms.at("mdat").second == plan.mdat_size,
+                label + ": mdat placement");
+    ok &= check(fast_start == (plan.moov_offset < plan.mdat_offset), label + ": layout order");
+
+    // Tracks tile the mdat payload back to back in the planned order.
+    uint64_t next = plan.mdat_offset + 8;
+    for (const auto &t : plan.tracks) {
+        ok &= check(t.offset == next, label + ": " + t.name + " offset");
+        next += t.bytes;
+    }
+    ok &= check(next == plan.mdat_offset + plan.mdat_size, label + ": tracks fill mdat");
+    ok &= check(plan.tracks.size() >= 3 && plan.tracks[0].handler == "soun" &&
+                    plan.tracks[1].handler == "text",
+                label + ": track order");
+
+    const auto read = chapterforge::read_m4a(out.string());
+    ok &= check(read.status.ok && plan.tracks.size() >= 2 &&
+                    plan.tracks[1].sample_count == read.titles.size(),
+                label + ": title sample count");
+    std::filesystem::remove(out);
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+    for (const char *input : {"input.m4a", "input.aac"}) {
+        ok &= plan_matches_mux(input, true);
+        ok &= plan_matches_mux(input, false);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+// Unit test for probe_m4a: summaries match read_m4a while only the moov atom (plus top-level
+// headers) is read, for faststart and trailing-moov layouts, and via the tail search when a
+// damaged mdat size breaks the header walk.
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "chapterforge.hpp"
+#include "logging.hpp"
+
+#define CHAPTERFORGE_TEST_NAME "probe_unit"
+#include "fixture_utils.hpp"
+
+using namespace fixture_utils;
+
+namespace {
+
+// Header walk: up to 16 bytes per top-level atom (ftyp, mdat, free, ...).
+constexpr uint64_t kHeaderSlack = 4096;
+
+// Three chapters 3 s apart with URLs, images and a cover.
+bool mux_probe_fixture(const std::string &out_path, bool fast_start) {
+    auto fx = make_fixture(3, "Probe Title", true, 3000);
+    fx.meta.cover = load_bytes(std::filesystem::path(TESTDATA_DIR) / "images" / "cover.jpg");
+    return mux_fixture(out_path, fx, fast_start);
+}
+
+bool verify(const std::string &path, const std::string &label) {
+    const auto probe = chapterforge::probe_m4a(path);
+    bool ok = check(probe.status.ok, label + " probe ok: " + probe.status.message);
+    if (!probe.status.ok) {
+        return false;
+    }
+    ok &= check(probe.chapter_count == 3, label + " chapter count");
+    ok &= check(probe.chapter_starts_ms == std::vector<uint32_t>({0, 3000, 6000}),
+                label + " chapter starts");
+    ok &= check(probe.has_urls && probe.has_images && probe.has_cover, label + " flags");
+    ok &= check(probe.audio_duration_ms > 9000, label + " audio duration");
+
+    bool has_audio = false;
+    for (const auto &t : probe.tracks) {
+        has_audio |= t.handler == "soun" && t.sample_count > 0 && t.duration_ms > 0;
+    }
+    ok &= check(has_audio, label + " audio track listed");
+
+    // The whole point: cost is O(moov), not O(file).
+    const auto file_size = std::filesystem::file_size(path);
+    ok &= check(probe.moov_size > 0 && probe.moov_size < file_size, label + " moov size");
+    ok &= check(probe.bytes_read <= probe.moov_size + kHeaderSlack,
+                label + " bytes_read " + std::to_string(probe.bytes_read) + " vs moov " +
+                    std::to_string(probe.moov_size));
+
+    // Cross-check against the full reader.
+    const auto full = chapterforge::read_m4a(path);
+    ok &= check(full.status.ok && full.titles.size() == probe.chapter_count,
+                label + " matches read_m4a");
+    return ok;
+}
+
+// Overwrite the mdat size field with garbage so the header walk cannot step over it; the moov at
+// the end of the file must then be found by the tail search.
+bool test_tail_recovery(const std::string &src, const std::string &dst) {
+    auto bytes = load_bytes(src);
+    size_t mdat = 0;
+    for (size_t i = 4; i + 4 <= bytes.size(); ++i) {
+        if (std::string(reinterpret_cast<const char *>(bytes.data() + i), 4) == "mdat") {
+            mdat = i - 4;
+            break;
+        }
+    }
+    if (!check(mdat != 0, "mdat located in trailing-moov fixture")) {
+        return false;
+    }
+    bytes[mdat] = 0x7F;
+    bytes[mdat + 1] = 0xFF;
+    std::ofstream(dst, std::ios::binary)
+        .write(reinterpret_cast<const char *>(bytes.data()),
+               static_cast<std::streamsize>(bytes.size()));
+
+    const auto probe = chapterforge::probe_m4a(dst);
+    bool ok = check(probe.status.ok, "tail probe ok: " + probe.status.message);
+    ok &= check(probe.chapter_count == 3, "tail chapter count");
+    ok &= check(probe.bytes_read < bytes.size(), "tail search reads less than the file");
+    return ok;
+}
+
+// A title sample too short for the tx3g length field is no chapter, for probe_m4a as for
+// read_m4a: emptying the last one leaves two chapters.
+bool test_empty_title_sample(const std::string &src, const std::string &dst) {
+    const auto bytes = with_text_sample_size(load_bytes(src), 0, 2);
+    std::ofstream(dst, std::ios::binary)
+        .write(reinterpret_cast<const char *>(bytes.data()),
+               static_cast<std::streamsize>(bytes.size()));
+
+    const auto probe = chapterforge::probe_m4a(dst);
+    const auto full = chapterforge::read_m4a(dst);
+    bool ok = check(probe.status.ok && full.status.ok, "empty title sample read");
+    ok &= check(probe.chapter_count == 2 &&
+                    probe.chapter_starts_ms == std::vector<uint32_t>({0, 3000}),
+                "empty title sample not counted by probe");
+    ok &= check(full.titles.size() == probe.chapter_count, "empty title sample: matches read_m4a");
+    for (size_t i = 0; ok && i < full.titles.size(); ++i) {
+        ok &= check(full.titles[i].start_ms == probe.chapter_starts_ms[i],
+                    "empty title sample: start " + std::to_string(i));
+    }
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    chapterforge::set_log_verbosity(chapterforge::LogVerbosity::Debug);
+    const auto out_dir = std::filesystem::path("test_outputs");
+    std::filesystem::create_directories(out_dir);
+    const auto faststart = (out_dir / "probe_faststart.m4a").string();
+    const auto trailing = (out_dir / "probe_trailing_moov.m4a").string();
+
+    bool ok = true;
+    ok &= mux_probe_fixture(faststart, true) && verify(faststart, "faststart");
+    ok &= mux_probe_fixture(trailing, false) && verify(trailing, "trailing moov");
+    ok &= test_tail_recovery(trailing, (out_dir / "probe_damaged_mdat.m4a").string());
+    ok &= test_empty_title_sample(faststart, (out_dir / "probe_empty_title.m4a").string());
+
+    const auto missing = chapterforge::probe_m4a((out_dir / "does_not_exist.m4a").string());
+    ok &= check(!missing.status.ok, "missing file reports failure");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+// Unit test for read_m4a's single-open input: one open per call, I/O statistics that cover
+// parsing and sample extraction without touching audio payloads, an exact byte budget (enough
+// succeeds, one byte less fails cleanly), and a damaged file whose recovery scan maps the already
+// open file and is refused when the budget cannot cover it.
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "chapterforge.hpp"
+
+#define CHAPTERFORGE_TEST_NAME "read_budget_unit"
+#include "fixture_utils.hpp"
+
+using namespace fixture_utils;
+
+namespace {
+
+bool mux_budget_fixture(const std::string &out_path, bool fast_start) {
+    auto fx = make_fixture(4, "Budget", false, 2000);
+    fx.meta.title = "Read Budget Unit";
+    return mux_fixture(out_path, fx, fast_start);
+}
+
+bool test_budget(const std::string &path, const std::string &label) {
+    const uint64_t file_size = std::filesystem::file_size(path);
+    const auto full = chapterforge::read_m4a(path);
+    bool ok = check(full.status.ok, label + " read: " + full.status.message);
+    ok &= check(full.titles.size() == 4 && full.metadata.title == "Read Budget Unit",
+                label + " content");
+    ok &= check(full.io.opens == 1, label + " single open");
+    // moov plus chapter samples; the audio payload is never read.
+    ok &= check(full.io.bytes < file_size / 2, label + " audio untouched");
+    std::printf("[read_budget_unit] %s: file=%llu opens=%llu reads=%llu bytes=%llu\n",
+                label.c_str(), static_cast<unsigned long long>(file_size),
+                static_cast<unsigned long long>(full.io.opens),
+                static_cast<unsigned long long>(full.io.reads),
+                static_cast<unsigned long long>(full.io.bytes));
+
+    chapterforge::ReadOptions exact;
+    exact.max_bytes = full.io.bytes;
+    const auto fits = chapterforge::read_m4a(path, exact);
+    ok &= check(fits.status.ok && fits.titles.size() == 4 && fits.images[3].data.size() > 0,
+                label + " exact budget suffices");
+
+    chapterforge::ReadOptions tight;
+    tight.max_bytes = full.io.bytes - 1;
+    const auto over = chapterforge::read_m4a(path, tight);
+    ok &= check(!over.status.ok && over.status.message.find("budget") != std::string::npos,
+                label + " budget exceeded reported: " + over.status.message);
+    ok &= check(over.io.bytes <= tight.max_bytes, label + " budget never overrun");
+    return ok;
+}
+
+// Damage the mdat size so the header walk stops before the trailing moov: the sample tables and
+// ilst can then only be recovered by scanning the whole file.
+bool test_recovery_scan(const std::string &src, const std::string &dst) {
+    auto bytes = load_bytes(src);
+    size_t mdat = 0;
+    for (size_t i = 4; i + 4 <= bytes.size(); ++i) {
+        if (std::string(reinterpret_cast<const char *>(bytes.data() + i), 4) == "mdat") {
+            mdat = i - 4;
+            break;
+        }
+    }
+    if (!check(mdat != 0, "mdat located")) {
+        return false;
+    }
+    bytes[mdat] = 0x7F;
+    bytes[mdat + 1] = 0xFF;
+    std::ofstream(dst, std::ios::binary)
+        .write(reinterpret_cast<const char *>(bytes.data()), std::streamsize(bytes.size()));
+
+    const auto res = chapterforge::read_m4a(dst);
+    bool ok = check(res.status.ok, "damaged read: " + res.status.message);
+    ok &= check(res.metadata.title == "Read Budget Unit", "ilst recovered by scan");
+    ok &= check(res.io.opens == 1, "recovery maps the open file");
+    ok &= check(res.io.bytes >= bytes.size(), "recovery scan counted");
+
+    chapterforge::ReadOptions tight;
+    tight.max_bytes = bytes.size() / 2;
+    const auto over = chapterforge::read_m4a(dst, tight);
+    ok &= check(!over.status.ok && over.status.message.find("budget") != std::string::npos,
+                "recovery scan refused over budget: " + over.status.message);
+    ok &= check(over.io.bytes <= tight.max_bytes, "refused scan not counted");
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto fast = (dir / "chapterforge_read_budget_fast.m4a").string();
+    const auto tail = (dir / "chapterforge_read_budget_tail.m4a").string();
+    const auto damaged = (dir / "chapterforge_read_budget_damaged.m4a").string();
+    bool ok = mux_budget_fixture(fast, true) && mux_budget_fixture(tail, false);
+    if (ok) {
+        ok &= test_budget(fast, "faststart");
+        ok &= test_budget(tail, "moov-at-end");
+        ok &= test_recovery_scan(tail, damaged);
+    }
+    std::filesystem::remove(fast);
+    std::filesystem::remove(tail);
+    std::filesystem::remove(damaged);
+    return ok ? 0 : 1;
+}
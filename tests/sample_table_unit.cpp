@@ -0,0 +1,178 @@
+// Unit coverage for SampleTable: offsets/chunk plans agree with the independent test_utils
+// oracle, co64 tables carry offsets past 4 GB, time lookups bracket sample boundaries, and
+// inconsistent tables are rejected.
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "parser_test_utils.hpp"
+#include "sample_table.hpp"
+#include "test_utils.hpp"
+
+using namespace parser_test_utils;
+
+namespace {
+
+bool check(bool cond, const std::string &msg) {
+    if (!cond) {
+        std::cerr << "[sample_table_unit] FAIL: " << msg << "\n";
+    }
+    return cond;
+}
+
+std::vector<uint8_t> make_stsz_table(const std::vector<uint32_t> &sizes) {
+    std::vector<uint8_t> p{0, 0, 0, 0};
+    write_u32_be(p, 0);
+    write_u32_be(p, static_cast<uint32_t>(sizes.size()));
+    for (auto s : sizes) {
+        write_u32_be(p, s);
+    }
+    return p;
+}
+
+std::vector<uint8_t> make_stsc_table(const std::vector<std::pair<uint32_t, uint32_t>> &entries) {
+    std::vector<uint8_t> p{0, 0, 0, 0};
+    write_u32_be(p, static_cast<uint32_t>(entries.size()));
+    for (const auto &[first_chunk, per_chunk] : entries) {
+        write_u32_be(p, first_chunk);
+        write_u32_be(p, per_chunk);
+        write_u32_be(p, 1);
+    }
+    return p;
+}
+
+std::vector<uint8_t> make_stco_table(const std::vector<uint32_t> &offsets) {
+    std::vector<uint8_t> p{0, 0, 0, 0};
+    write_u32_be(p, static_cast<uint32_t>(offsets.size()));
+    for (auto o : offsets) {
+        write_u32_be(p, o);
+    }
+    return p;
+}
+
+std::vector<uint8_t> make_co64_table(const std::vector<uint64_t> &offsets) {
+    std::vector<uint8_t> p{0, 0, 0, 0};
+    write_u32_be(p, static_cast<uint32_t>(offsets.size()));
+    for (auto o : offsets) {
+        write_u64_be(p, o);
+    }
+    return p;
+}
+
+bool test_co64_offsets() {
+    const auto stsz = make_stsz_table({100, 200, 300, 400});
+    const auto stsc = make_stsc_table({{1, 2}});
+    const uint64_t high = 0x1'2345'6780ULL;  // beyond 4 GB
+    const auto co64 = make_co64_table({4096, high});
+    auto table = SampleTable::build(stsz, stsc, co64, {}, true);
+    if (!check(table.has_value(), "co64 table builds")) {
+        return false;
+    }
+    bool ok = check(std::vector<uint64_t>(table->offsets().begin(), table->offsets().end()) ==
+                        std::vector<uint64_t>({4096, 4196, high, high + 300}),
+                    "co64 sample offsets");
+    auto chunks = SampleTable::build_chunks(stsz, stsc, co64, true);
+    ok &= check(chunks && chunks->chunk_offsets().size() == 2 && chunks->chunk_offsets()[1] == high,
+                "co64 chunk offsets");
+    // Two 64-bit entries need 16 bytes; one entry's worth would pass as a 32-bit stco.
+    auto truncated = co64;
+    truncated.resize(truncated.size() - 8);
+    ok &= check(!SampleTable::build(stsz, stsc, truncated, {}, true), "truncated co64");
+    return ok;
+}
+
+bool test_offsets_match_oracle() {
+    // 10 samples: chunks 1-2 hold 3 samples, chunk 3 onward 2 (last chunk partially used).
+    std::vector<uint32_t> sizes{10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+    const auto stsz = make_stsz_table(sizes);
+    const auto stsc = make_stsc_table({{1, 3}, {3, 2}});
+    const auto stco = make_stco_table({1000, 2000, 3000, 4000});
+    const auto stts = make_stts_single(10, 1024);
+
+    auto table = SampleTable::build(stsz, stsc, stco, stts);
+    bool ok = check(table.has_value(), "build");
+    if (!table) {
+        return false;
+    }
+    ok &= check(table->sample_count() == 10, "sample count");
+    ok &= check(std::vector<uint32_t>(table->sizes().begin(), table->sizes().end()) ==
+                    *test_utils::parse_stsz_sizes(stsz),
+                "sizes match oracle");
+    ok &= check(std::vector<uint32_t>(table->samples_per_chunk().begin(),
+                                      table->samples_per_chunk().end()) ==
+                    std::vector<uint32_t>({3, 3, 2, 2}),
+                "chunk plan trimmed to samples");
+    ok &= check(test_utils::derive_chunk_plan(stsc, 10) == std::vector<uint32_t>({3, 3, 2, 2}),
+                "oracle agrees on chunk plan");
+    const std::vector<uint64_t> expected{1000, 1010, 1021, 2000, 2013, 2027,
+                                         3000, 3016, 4000, 4018};
+    ok &= check(std::vector<uint64_t>(table->offsets().begin(), table->offsets().end()) ==
+                    expected,
+                "per-sample offsets");
+    ok &= check(table->decode_times().size() == 10 && table->decode_times()[9] == 9 * 1024,
+                "decode times");
+    ok &= check(SampleTable::derive_chunk_plan(stsc, 10) ==
+                    std::vector<uint32_t>({3, 3, 2, 2}),
+                "stsc-only plan");
+    return ok;
+}
+
+bool test_time_lookup() {
+    const auto stsz = make_stsz(4, 100);
+    const auto stsc = make_stsc_table({{1, 1}});
+    const auto stco = make_stco_table({0, 100, 200, 300});
+    // Variable deltas: samples start at 0, 500, 1000, 3000.
+    std::vector<uint8_t> stts{0, 0, 0, 0};
+    write_u32_be(stts, 2);
+    write_u32_be(stts, 2);
+    write_u32_be(stts, 500);
+    write_u32_be(stts, 2);
+    write_u32_be(stts, 2000);
+    auto table = SampleTable::build(stsz, stsc, stco, stts);
+    bool ok = check(table.has_value(), "build timed table");
+    if (!table) {
+        return false;
+    }
+    ok &= check(table->sample_at_time(0) == 0u, "t=0");
+    ok &= check(table->sample_at_time(499) == 0u, "t=499");
+    ok &= check(table->sample_at_time(500) == 1u, "t=500");
+    ok &= check(table->sample_at_time(2999) == 2u, "t=2999");
+    ok &= check(table->sample_at_time(1000000) == 3u, "past end maps to last sample");
+    return ok;
+}
+
+bool test_rejects_inconsistent_tables() {
+    const auto stsz = make_stsz(10, 4);
+    bool ok = true;
+    // Two chunks of 3 samples cannot hold 10 samples.
+    ok &= check(!SampleTable::build(stsz, make_stsc_table({{1, 3}}), make_stco_table({0, 64})),
+                "too few chunks rejected");
+    // stsc must start at chunk 1.
+    ok &= check(!SampleTable::build(stsz, make_stsc_table({{2, 5}}), make_stco_table({0, 64, 128})),
+                "stsc starting past chunk 1 rejected");
+    // Truncated stco.
+    auto stco = make_stco_table({0, 64});
+    stco.resize(stco.size() - 2);
+    ok &= check(!SampleTable::build(stsz, make_stsc_table({{1, 5}}), stco), "truncated stco");
+    // A huge declared sample count must be rejected before per-sample arrays are allocated.
+    std::vector<uint8_t> huge_stsz{0, 0, 0, 0};
+    write_u32_be(huge_stsz, 1);            // constant sample size
+    write_u32_be(huge_stsz, 0xFFFFFFF0u);  // sample_count
+    ok &= check(!SampleTable::build(huge_stsz, make_stsc_table({{1, 1}}), make_stco_table({0})),
+                "huge constant-size count rejected");
+    ok &= check(SampleTable::derive_chunk_plan(make_stsc_table({{1, 0}}), 10).empty(),
+                "zero samples per chunk yields no plan");
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+    ok &= test_offsets_match_oracle();
+    ok &= test_time_lookup();
+    ok &= test_co64_offsets();
+    ok &= test_rejects_inconsistent_tables();
+    return ok ? 0 : 1;
+}
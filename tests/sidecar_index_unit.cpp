@@ -0,0 +1,133 @@
+// Unit test for the sidecar index: a read through a written index skips the moov entirely and
+// matches a parsed read, muxing from an indexed input produces the same bytes, and an index that
+// is stale (rewritten or touched source) or damaged (corrupt body, truncation) is ignored, and
+// concurrent writers of one index neither fail nor leave temp files behind.
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "chapterforge.hpp"
+
+#define CHAPTERFORGE_TEST_NAME "sidecar_index_unit"
+#include "fixture_utils.hpp"
+
+using namespace fixture_utils;
+
+namespace {
+
+void store_bytes(const std::filesystem::path &p, const std::vector<uint8_t> &bytes) {
+    std::ofstream out(p, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(bytes.data()),
+              static_cast<std::streamsize>(bytes.size()));
+}
+
+std::vector<uint8_t> remux(const std::string &input, const std::string &out) {
+    std::vector<ChapterTextSample> titles(2);
+    titles[0].text = "One";
+    titles[1].text = "Two";
+    titles[1].start_ms = 1500;
+    auto st = chapterforge::mux_file_to_m4a(input, titles, {}, {}, MetadataSet{}, out, true);
+    check(st.ok, "remux: " + st.message);
+    return st.ok ? load_bytes(out) : std::vector<uint8_t>{};
+}
+
+// Reads `path` with its index in place; the index must be ignored and the result still correct.
+bool ignored(const std::string &path, const chapterforge::ReadResult &expected,
+             const std::string &what) {
+    const auto res = chapterforge::read_m4a(path);
+    bool ok = check(same_result(expected, res), what + ": read matches");
+    ok &= check(res.io.reads > 1, what + ": index ignored");
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto path = (dir / "chapterforge_sidecar.m4a").string();
+    const auto index = path + ".cfidx";
+    const auto out_parsed = (dir / "chapterforge_sidecar_parsed.m4a").string();
+    const auto out_indexed = (dir / "chapterforge_sidecar_indexed.m4a").string();
+    std::filesystem::remove(index);
+
+    bool ok = mux_fixture(path, 4, "Indexed");
+    if (ok) {
+        const auto parsed = chapterforge::read_m4a(path);
+        const auto parsed_mux = remux(path, out_parsed);
+
+        ok &= check(chapterforge::write_index(path).ok, "write index");
+        ok &= check(std::filesystem::exists(index), "index file exists");
+        const auto indexed = chapterforge::read_m4a(path);
+        ok &= check(same_result(parsed, indexed), "indexed read matches");
+        // Only the chapter samples are read: no header walk, no moov.
+        ok &= check(indexed.io.reads == 1 && indexed.io.bytes < parsed.io.bytes,
+                    "indexed read skips moov");
+        std::printf("[sidecar_index_unit] parsed reads=%llu bytes=%llu, indexed reads=%llu "
+                    "bytes=%llu, index=%llu bytes\n",
+                    static_cast<unsigned long long>(parsed.io.reads),
+                    static_cast<unsigned long long>(parsed.io.bytes),
+                    static_cast<unsigned long long>(indexed.io.reads),
+                    static_cast<unsigned long long>(indexed.io.bytes),
+                    static_cast<unsigned long long>(std::filesystem::file_size(index)));
+        const auto indexed_mux = remux(path, out_indexed);
+        ok &= check(!indexed_mux.empty() && indexed_mux == parsed_mux,
+                    "mux from indexed input is identical");
+
+        // Damaged indexes: a flipped body byte, then a truncated file.
+        const auto good = load_bytes(index);
+        auto bad = good;
+        bad[bad.size() - 1] ^= 0xff;
+        store_bytes(index, bad);
+        ok &= ignored(path, parsed, "corrupt index");
+        store_bytes(index, std::vector<uint8_t>(good.begin(), good.begin() + good.size() / 2));
+        ok &= ignored(path, parsed, "truncated index");
+
+        // Touching the source changes its mtime only.
+        store_bytes(index, good);
+        ok &= check(chapterforge::read_m4a(path).io.reads == 1, "restored index used");
+        std::filesystem::last_write_time(
+            path, std::filesystem::last_write_time(path) + std::chrono::seconds(2));
+        ok &= ignored(path, parsed, "touched source");
+
+        // A rewritten source with the old index beside it reads its own content.
+        ok &= check(chapterforge::write_index(path).ok, "rewrite index");
+        ok &= mux_fixture(path, 6, "Rewritten");
+        const auto rewritten = chapterforge::read_m4a(path);
+        ok &= check(rewritten.status.ok && rewritten.titles.size() == 6 &&
+                        rewritten.titles[0].text == "Rewritten 1" && rewritten.io.reads > 1,
+                    "rewritten source ignores stale index");
+
+        // Writers racing on the same index each use their own temp file.
+        std::vector<std::thread> writers;
+        std::vector<int> written(4, 0);
+        for (size_t i = 0; i < written.size(); ++i) {
+            writers.emplace_back([&, i] { written[i] = chapterforge::write_index(path).ok; });
+        }
+        for (auto &t : writers) {
+            t.join();
+        }
+        for (size_t i = 0; i < written.size(); ++i) {
+            ok &= check(written[i] == 1, "concurrent write " + std::to_string(i));
+        }
+        ok &= check(chapterforge::read_m4a(path).io.reads == 1, "concurrently written index used");
+        for (const auto &entry : std::filesystem::directory_iterator(dir)) {
+            const auto name = entry.path().filename().string();
+            ok &= check(name.rfind("chapterforge_sidecar.m4a.cfidx.", 0) != 0,
+                        "temp file left behind: " + name);
+        }
+
+        const auto junk = (dir / "chapterforge_sidecar_junk.m4a").string();
+        store_bytes(junk, std::vector<uint8_t>(256, 0x5a));
+        ok &= check(!chapterforge::write_index(junk).ok, "invalid input refused");
+        ok &= check(!std::filesystem::exists(junk + ".cfidx"), "no index for invalid input");
+        std::filesystem::remove(junk);
+    }
+    for (const auto &p : {path, index, out_parsed, out_indexed}) {
+        std::filesystem::remove(p);
+    }
+    return ok ? 0 : 1;
+}
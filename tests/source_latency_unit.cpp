@@ -0,0 +1,277 @@
+// Unit test for read_m4a over a RandomAccessSource: memory and callback sources give the same
+// result as reading the file by path, a source with artificial per-request latency is read in
+// fewer round trips once it reports a minimum request size, a damaged input is recovered from a
+// source that cannot be mapped by scanning it window by window, and budgets and missing sources
+// fail cleanly.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "chapterforge.hpp"
+#include "input_file.hpp"
+#include "parser.hpp"
+
+#define CHAPTERFORGE_TEST_NAME "source_latency_unit"
+#include "fixture_utils.hpp"
+
+using namespace fixture_utils;
+
+namespace {
+
+constexpr uint32_t kChapters = 120;
+constexpr auto kLatency = std::chrono::milliseconds(2);
+constexpr uint64_t kMinRequest = 256 * 1024;
+
+// Every chapter has a URL, every eighth one an image.
+bool mux_remote_fixture(const std::string &out_path, bool fast_start) {
+    auto fx = make_fixture(kChapters, "Remote", true, 50);
+    const auto jpeg = fx.images.front().data;
+    fx.images.clear();
+    for (uint32_t i = 0; i < kChapters; i += 8) {
+        fx.images.push_back({jpeg, fx.titles[i].start_ms});
+    }
+    fx.meta.title = "Source Latency Unit";
+    return mux_fixture(out_path, fx, fast_start);
+}
+
+// Remote-like source over in-memory bytes: every request sleeps and is counted.
+struct LatencySource {
+    std::shared_ptr<const std::vector<uint8_t>> bytes;
+    std::shared_ptr<std::atomic<uint64_t>> round_trips = std::make_shared<std::atomic<uint64_t>>(0);
+
+    std::shared_ptr<chapterforge::RandomAccessSource> make(uint64_t min_request) const {
+        return std::make_shared<chapterforge::CallbackSource>(
+            bytes->size(),
+            [data = bytes, trips = round_trips](uint64_t offset, void *dst, size_t length) {
+                trips->fetch_add(1);
+                std::this_thread::sleep_for(kLatency);
+                if (offset > data->size() || length > data->size() - offset) {
+                    return false;
+                }
+                std::memcpy(dst, data->data() + offset, length);
+                return true;
+            },
+            min_request);
+    }
+};
+
+bool test_sources(const std::string &path, const std::string &label) {
+    const auto expected = chapterforge::read_m4a(path);
+    bool ok = check(expected.status.ok && expected.titles.size() == kChapters,
+                    label + " read by path: " + expected.status.message);
+    const auto bytes = std::make_shared<const std::vector<uint8_t>>(load_bytes(path));
+
+    const auto memory =
+        chapterforge::read_m4a(std::make_shared<chapterforge::MemorySource>(*bytes));
+    ok &= check(same_result(expected, memory), label + " memory");
+    ok &= check(memory.io.opens == 0, label + " memory source opens nothing");
+    ok &= check(memory.io.reads == expected.io.reads && memory.io.bytes == expected.io.bytes,
+                label + " memory source issues the file's reads");
+
+    // Without a hint the source sees the same requests as a file.
+    LatencySource plain{bytes};
+    auto t0 = std::chrono::steady_clock::now();
+    const auto slow = chapterforge::read_m4a(plain.make(0));
+    const auto plain_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    ok &= check(same_result(expected, slow), label + " latency");
+    ok &= check(slow.io.reads == plain.round_trips->load(), label + " round trips counted");
+
+    // With a minimum request size the header walk and moov come from read-ahead and the chapter
+    // tracks are fetched together.
+    LatencySource hinted{bytes};
+    t0 = std::chrono::steady_clock::now();
+    const auto fast = chapterforge::read_m4a(hinted.make(kMinRequest));
+    const auto hinted_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    ok &= check(same_result(expected, fast), label + " latency hinted");
+    ok &= check(fast.io.reads == hinted.round_trips->load(), label + " hinted round trips counted");
+    ok &= check(hinted.round_trips->load() < plain.round_trips->load(),
+                label + " hint saves round trips");
+    ok &= check(hinted.round_trips->load() <= 4, label + " hinted round trips");
+    std::printf("[source_latency_unit] %s: round trips %llu -> %llu, %.1f ms -> %.1f ms\n",
+                label.c_str(), static_cast<unsigned long long>(plain.round_trips->load()),
+                static_cast<unsigned long long>(hinted.round_trips->load()), plain_ms, hinted_ms);
+
+    // Concurrent extraction reads the same source from several threads.
+    LatencySource threaded{bytes};
+    chapterforge::ReadOptions options;
+    options.threads = 4;
+    const auto threaded_read = chapterforge::read_m4a(threaded.make(kMinRequest), options);
+    ok &= check(same_result(expected, threaded_read), label + " latency threaded");
+    return ok;
+}
+
+// Read-ahead requests of different threads overlap: the block cache is locked around lookups and
+// inserts only, never across a round trip. Each request waits until another one is in flight.
+bool test_concurrent_fetches() {
+    std::mutex mutex;
+    std::condition_variable cv;
+    int inside = 0;
+    int most = 0;
+    auto source = std::make_shared<chapterforge::CallbackSource>(
+        1024 * 1024,
+        [&](uint64_t, void *dst, size_t length) {
+            std::unique_lock<std::mutex> lock(mutex);
+            most = std::max(most, ++inside);
+            cv.notify_all();
+            cv.wait_for(lock, std::chrono::seconds(2), [&] { return most >= 2; });
+            --inside;
+            std::memset(dst, 0, length);
+            return true;
+        },
+        64 * 1024);
+    auto input = InputFile::wrap(source, "concurrent");
+    uint8_t a[16];
+    uint8_t b[16];
+    std::thread other([&] { input->read_at(512 * 1024, b, sizeof(b)); });
+    input->read_at(0, a, sizeof(a));
+    other.join();
+    return check(most == 2, "read-ahead requests of two threads overlap");
+}
+
+// Damage the mdat size so the sample tables can only be recovered by scanning everything; a
+// source is then read whole in one request instead of being mapped.
+bool test_recovery(const std::string &path) {
+    auto bytes = load_bytes(path);
+    size_t mdat = 0;
+    for (size_t i = 4; i + 4 <= bytes.size(); ++i) {
+        if (std::memcmp(bytes.data() + i, "mdat", 4) == 0) {
+            mdat = i - 4;
+            break;
+        }
+    }
+    if (!check(mdat != 0, "mdat located")) {
+        return false;
+    }
+    bytes[mdat] = 0x7F;
+    bytes[mdat + 1] = 0xFF;
+    const uint64_t size = bytes.size();
+    auto source = std::make_shared<chapterforge::MemorySource>(std::move(bytes));
+    const auto res = chapterforge::read_m4a(source);
+    bool ok = check(res.status.ok, "damaged source read: " + res.status.message);
+    ok &= check(res.metadata.title == "Source Latency Unit", "ilst recovered from source");
+    ok &= check(res.io.bytes >= size, "whole source counted");
+
+    chapterforge::ReadOptions tight;
+    tight.max_bytes = size / 2;
+    const auto over = chapterforge::read_m4a(source, tight);
+    ok &= check(!over.status.ok && over.status.message.find("budget") != std::string::npos,
+                "source recovery refused over budget: " + over.status.message);
+    ok &= check(over.io.bytes <= tight.max_bytes, "refused load not counted");
+    return ok;
+}
+
+// A damaged input larger than one recovery window, padded in front of moov so that one of the
+// boxes the scan looks for straddles the boundary of the third 8 MB window. Read from a source it
+// is scanned window by window, with no request larger than a window, and yields exactly the
+// tables the scan of the mapped file finds.
+bool test_windowed_recovery(const std::string &path, const std::filesystem::path &dir) {
+    const auto bytes = load_bytes(path);
+    size_t mdat = 0;
+    size_t moov = 0;
+    for (size_t i = 4; i + 4 <= bytes.size(); ++i) {
+        if (mdat == 0 && std::memcmp(bytes.data() + i, "mdat", 4) == 0) {
+            mdat = i - 4;
+        } else if (mdat != 0 && std::memcmp(bytes.data() + i, "moov", 4) == 0) {
+            moov = i - 4;
+            break;
+        }
+    }
+    if (!check(mdat != 0 && moov > mdat, "mdat and trailing moov located")) {
+        return false;
+    }
+    constexpr uint64_t kWindow = 8 * 1024 * 1024;
+    constexpr uint64_t kBoundary = 3 * kWindow - 16;  // windows overlap by a box header
+    const auto damaged_path = dir / "chapterforge_source_latency_damaged.m4a";
+    bool ok = true;
+    for (const char *type : {"stsd", "stts", "stsc", "stsz", "stco", "ilst"}) {
+        const auto at = std::search(bytes.begin() + moov, bytes.end(), type, type + 4);
+        if (!check(at != bytes.end(), std::string(type) + " located")) {
+            return false;
+        }
+        // Put the boundary 4 bytes into the box's payload.
+        const uint64_t box = static_cast<uint64_t>(at - bytes.begin()) - 4;
+        const uint64_t pad = kBoundary - 12 - (box - moov) - moov;
+        std::vector<uint8_t> damaged(bytes.size() + pad);
+        std::copy(bytes.begin(), bytes.begin() + moov, damaged.begin());
+        std::copy(bytes.begin() + moov, bytes.end(), damaged.begin() + moov + pad);
+        for (int b = 0; b < 4; ++b) {
+            damaged[moov + b] = static_cast<uint8_t>(pad >> (24 - 8 * b));
+        }
+        std::memcpy(damaged.data() + moov + 4, "free", 4);
+        damaged[mdat] = 0x7F;
+        damaged[mdat + 1] = 0xFF;
+        {
+            std::ofstream out(damaged_path, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char *>(damaged.data()),
+                      static_cast<std::streamsize>(damaged.size()));
+        }
+
+        const auto data = std::make_shared<const std::vector<uint8_t>>(std::move(damaged));
+        auto largest = std::make_shared<std::atomic<uint64_t>>(0);
+        auto source = std::make_shared<chapterforge::CallbackSource>(
+            data->size(), [data, largest](uint64_t offset, void *dst, size_t length) {
+                if (offset > data->size() || length > data->size() - offset) {
+                    return false;
+                }
+                uint64_t seen = largest->load();
+                while (length > seen && !largest->compare_exchange_weak(seen, length)) {
+                }
+                std::memcpy(dst, data->data() + offset, length);
+                return true;
+            });
+        auto input = InputFile::wrap(source, "damaged");
+        const auto windowed = parse_mp4(*input);
+        const auto mapped = parse_mp4(damaged_path.string());
+        const std::string what = std::string("windowed recovery, ") + type + " cut";
+        if (!check(windowed && mapped && windowed->used_fallback_stbl, what + ": parsed")) {
+            ok = false;
+            continue;
+        }
+        auto same = [](ByteView a, ByteView b) {
+            return !a.empty() && std::equal(a.begin(), a.end(), b.begin(), b.end());
+        };
+        ok &= check(same(windowed->stsd, mapped->stsd) && same(windowed->stts, mapped->stts) &&
+                        same(windowed->stsc, mapped->stsc) &&
+                        same(windowed->stsz, mapped->stsz) &&
+                        same(windowed->stco, mapped->stco) &&
+                        same(windowed->ilst_payload, mapped->ilst_payload),
+                    what + ": tables match the mapped scan");
+        ok &= check(largest->load() <= kWindow, what + ": request larger than a window");
+    }
+    std::filesystem::remove(damaged_path);
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto fast = (dir / "chapterforge_source_latency_fast.m4a").string();
+    const auto tail = (dir / "chapterforge_source_latency_tail.m4a").string();
+    bool ok = mux_remote_fixture(fast, true) && mux_remote_fixture(tail, false);
+    if (ok) {
+        ok &= test_sources(fast, "faststart");
+        ok &= test_sources(tail, "moov-at-end");
+        ok &= test_recovery(tail);
+        ok &= test_windowed_recovery(tail, dir);
+        ok &= test_concurrent_fetches();
+    }
+    const auto missing =
+        chapterforge::read_m4a(std::shared_ptr<chapterforge::RandomAccessSource>{});
+    ok &= check(!missing.status.ok, "missing source rejected");
+    std::filesystem::remove(fast);
+    std::filesystem::remove(tail);
+    return ok ? 0 : 1;
+}
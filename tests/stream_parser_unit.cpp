@@ -0,0 +1,165 @@
+// Unit test for reading from a non-seekable stream: fast-start and moov-at-end files read from
+// a stream match the file reads, a trailing moov spills the buffered prefix to a temporary file
+// and resolves against it, byte-by-byte feeding works, and truncated, garbage, empty and
+// over-budget streams fail cleanly.
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "chapterforge.hpp"
+#include "fourcc_utils.hpp"
+#include "parse_cache.hpp"
+#include "stream_parser.hpp"
+
+#define CHAPTERFORGE_TEST_NAME "stream_parser_unit"
+#include "fixture_utils.hpp"
+
+using namespace fixture_utils;
+
+namespace {
+
+chapterforge::ReadResult read_stream(const std::vector<uint8_t> &bytes,
+                                     const chapterforge::ReadOptions &options = {}) {
+    std::istringstream in(std::string(bytes.begin(), bytes.end()));
+    return chapterforge::read_m4a(in, options);
+}
+
+bool test_matches_file(const std::string &path, const std::string &what) {
+    const auto bytes = load_bytes(path);
+    const auto expected = chapterforge::read_m4a(path);
+    const auto streamed = read_stream(bytes);
+    bool ok = check(expected.status.ok && expected.titles.size() == 5, what + ": file read");
+    ok &= check(same_result(expected, streamed), what + ": stream read matches file read");
+    ok &= check(streamed.io.opens == 0 && streamed.io.bytes <= bytes.size(),
+                what + ": stream io");
+    std::printf("[stream_parser_unit] %s: file=%zu bytes, consumed=%llu bytes in %llu chunks\n",
+                what.c_str(), bytes.size(), static_cast<unsigned long long>(streamed.io.bytes),
+                static_cast<unsigned long long>(streamed.io.reads));
+    return ok;
+}
+
+// Trailing moov: the prefix spills once it outgrows a tiny threshold; events arrive in order.
+bool test_spill(const std::string &path) {
+    const auto bytes = load_bytes(path);
+    std::vector<uint32_t> atoms;
+    int tables = 0;
+    bool spilled_before_moov = false;
+    StreamParser::Events events;
+    StreamParser *self = nullptr;
+    events.atom = [&](const Mp4AtomInfo &atom) {
+        atoms.push_back(atom.type);
+        if (atom.type == fourcc("moov")) {
+            spilled_before_moov = self->spilled();
+        }
+    };
+    events.tables = [&](const ParsedInput &input) {
+        ++tables;
+        check(!input.parsed().tracks.empty(), "tables event carries tracks");
+    };
+    StreamParser parser(4096, events);
+    self = &parser;
+    bool ok = true;
+    for (size_t at = 0; at < bytes.size() && ok; at += 1000) {
+        const size_t n = std::min<size_t>(1000, bytes.size() - at);
+        ok &= check(parser.feed(ByteView(bytes).subspan(at, n)), "feed: " + parser.error());
+    }
+    ok &= check(spilled_before_moov, "prefix spilled before moov");
+    ok &= check(!parser.spilled() && parser.done(), "spool dropped once moov parsed");
+    ok &= check(tables == 1, "one tables event");
+    ok &= check(!atoms.empty() && atoms.front() == fourcc("ftyp") &&
+                    atoms.back() == fourcc("moov"),
+                "atom events ftyp .. moov");
+    const auto result = parser.finish();
+    ok &= check(result.parsed != nullptr && result.source != nullptr, "finish");
+
+    chapterforge::ReadOptions options;
+    options.spill_threshold = 4096;
+    std::istringstream in(std::string(bytes.begin(), bytes.end()));
+    ok &= check(same_result(chapterforge::read_m4a(path), chapterforge::read_m4a(in, options)),
+                "spilled stream read matches file read");
+    return ok;
+}
+
+bool test_byte_by_byte(const std::string &path) {
+    const auto bytes = load_bytes(path);
+    StreamParser parser;
+    size_t fed = 0;
+    while (fed < bytes.size() && !parser.done()) {
+        if (!parser.feed(ByteView(bytes).subspan(fed, 1))) {
+            break;
+        }
+        ++fed;
+    }
+    bool ok = check(parser.done(), "byte-by-byte feeding completes: " + parser.error());
+    ok &= check(parser.buffered() < bytes.size(), "only chapter samples retained");
+    const auto result = parser.finish();
+    ok &= check(result.parsed != nullptr && result.source != nullptr, "byte-by-byte finish");
+    return ok;
+}
+
+bool test_failures(const std::string &fast, const std::string &tail) {
+    const auto bytes = load_bytes(fast);
+    bool ok = true;
+    // Cut one byte short of the last chapter sample: moov is parsed, the samples never complete.
+    StreamParser parser;
+    size_t needed = 0;
+    while (needed < bytes.size() && !parser.done()) {
+        parser.feed(ByteView(bytes).subspan(needed++, 1));
+    }
+    const std::vector<uint8_t> truncated(bytes.begin(), bytes.begin() + (needed - 1));
+    const auto res = read_stream(truncated);
+    ok &= check(!res.status.ok && res.status.message.find("ended") != std::string::npos,
+                "truncated stream fails: " + res.status.message);
+
+    // Trailing moov cut off: the whole stream is kept and the recovery path gets to try.
+    const auto tail_bytes = load_bytes(tail);
+    const auto no_moov =
+        read_stream(std::vector<uint8_t>(tail_bytes.begin(), tail_bytes.end() - 64));
+    ok &= check(no_moov.titles.empty(), "stream without moov yields no chapters");
+
+    // Garbage is handed to the file read path whole and, as there, yields nothing.
+    const auto garbage = read_stream(std::vector<uint8_t>(4096, 0x5a));
+    ok &= check(garbage.titles.empty() && garbage.images.empty(), "garbage yields no chapters");
+    ok &= check(!read_stream({}).status.ok, "empty stream fails");
+
+    chapterforge::ReadOptions options;
+    options.max_bytes = 1000;
+    const auto budget = read_stream(bytes, options);
+    ok &= check(!budget.status.ok && budget.status.message.find("budget") != std::string::npos &&
+                    budget.io.bytes <= options.max_bytes,
+                "stream budget enforced");
+
+    // Sample tables claiming ~4 GB text samples: rejected before anything is held for them.
+    const auto claimed = read_stream(with_text_sample_size(bytes, 0xF0000000u));
+    ok &= check(!claimed.status.ok && claimed.io.bytes < bytes.size(),
+                "oversized chapter samples fail: " + claimed.status.message);
+    options.max_bytes = bytes.size();
+    const auto claimed_budget = read_stream(with_text_sample_size(bytes, 0xF0000000u), options);
+    ok &= check(!claimed_budget.status.ok &&
+                    claimed_budget.status.message.find("budget") != std::string::npos,
+                "oversized chapter samples charged to the budget: " +
+                    claimed_budget.status.message);
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto fast = (dir / "chapterforge_stream_fast.m4a").string();
+    const auto tail = (dir / "chapterforge_stream_tail.m4a").string();
+    bool ok = mux_fixture(fast, 5, "Streamed", true) && mux_fixture(tail, 5, "Streamed", false);
+    if (ok) {
+        ok &= test_matches_file(fast, "faststart");
+        ok &= test_matches_file(tail, "moov at end");
+        ok &= test_spill(tail);
+        ok &= test_byte_by_byte(fast);
+        ok &= test_failures(fast, tail);
+    }
+    std::filesystem::remove(fast);
+    std::filesystem::remove(tail);
+    return ok ? 0 : 1;
+}
@@ -4,12 +4,13 @@
 
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <vector>
 
 namespace test_utils {
 
 inline std::optional<std::vector<uint32_t>> parse_stsz_sizes(
-    const std::vector<uint8_t> &stsz_payload) {
+    std::span<const uint8_t> stsz_payload) {
     if (stsz_payload.size() < 12) {
         return std::nullopt;
     }
@@ -34,7 +35,7 @@ inline std::optional<std::vector<uint32_t>> parse_stsz_sizes(
     return sizes;
 }
 
-inline std::vector<uint32_t> derive_chunk_plan(const std::vector<uint8_t> &stsc_payload,
+inline std::vector<uint32_t> derive_chunk_plan(std::span<const uint8_t> stsc_payload,
                                                uint32_t sample_count) {
     std::vector<uint32_t> plan;
     if (stsc_payload.size() < 16) {
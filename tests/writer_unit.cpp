@@ -67,11 +67,11 @@ bool test_build_audio_chunk_plan() {
 
 bool test_derive_chunk_plan() {
     bool ok = true;
-    // Single-entry table: chunk 1..N use 3 samples each.
+    // Single-entry table: chunk 1..N use 3 samples each; the last chunk holds the remainder.
     auto stsc_single = make_stsc_payload({{1, 3, 1}});
     ok &= check(derive_chunk_plan_for_test(stsc_single, 10) ==
-                    std::vector<uint32_t>({3, 3, 3}),
-                "derive_chunk_plan single entry (clamped to sample_count)");
+                    std::vector<uint32_t>({3, 3, 3, 1}),
+                "derive_chunk_plan single entry (trimmed to sample_count)");
 
     // Two entries: chunks 1-3 use 2 samples, from chunk 4 onward use 4.
     auto stsc_multi = make_stsc_payload({{1, 2, 1}, {4, 4, 1}});
@@ -111,7 +111,9 @@ bool test_encode_track_counts() {
 bool test_compute_durations() {
     AacExtractResult aac{};
     aac.sample_rate = 1000;
-    aac.frames.resize(10);  // audio_duration_ts = 10 * 1024 = 10240
+    for (int i = 0; i < 10; ++i) {  // audio_duration_ts = 10 * 1024 = 10240
+        aac.frames.append({});
+    }
     Mp4aConfig cfg{};
 
     ChapterTextSample t0{.text = "t0", .start_ms = 0};